@@ -0,0 +1,33 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+static int square (int v){
+  return v * v;
+}
+
+int main (int argc, char *argv[]){
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s ELEMENTS\n", argv[0]);
+    return 1;
+  }
+  int size = atoi(argv[1]);
+
+  int *a = (int *)malloc(sizeof(int) * size);
+  int *b = (int *)malloc(sizeof(int) * size);
+  int scale = atoi(argv[1]) + 1;
+  long long sum = 0;
+  for (int i=0; i < size; i++){
+    a[i] = square(i) * scale;
+    b[i] = i;
+    sum += b[i];
+    for (int j=0; j < 10; j++){
+      sum += a[i] * (scale * j);
+    }
+  }
+
+  printf("Result = %lld\n", sum);
+
+  free(a);
+  free(b);
+  return 0;
+}
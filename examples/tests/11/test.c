@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ROWS 64
+
+/*
+ * The outer loop cannot be parallelized: every iteration updates the same
+ * elements of "columns" in the inner loop.
+ */
+static void accumulateColumns (long long *columns, long long *matrix, long long cols){
+  for (long long i=0; i < ROWS; i++){
+    for (long long j=0; j < cols; j++){
+      columns[j] += matrix[i * cols + j];
+    }
+  }
+}
+
+/*
+ * Both loops can be parallelized, but only one per invocation of DOALL.
+ */
+static long long scaleAndSum (long long *values, long long size){
+  for (long long i=0; i < size; i++){
+    values[i] = values[i] * 3;
+  }
+
+  long long sum = 0;
+  for (long long i=0; i < size; i++){
+    sum += values[i];
+  }
+
+  return sum;
+}
+
+int main (int argc, char *argv[]){
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s ELEMENTS\n", argv[0]);
+    return 1;
+  }
+  long long size = atoll(argv[1]);
+
+  long long *matrix = (long long *)malloc(sizeof(long long) * ROWS * size);
+  long long *columns = (long long *)calloc(size, sizeof(long long));
+  for (long long i=0; i < ROWS * size; i++){
+    matrix[i] = i % 1000;
+  }
+
+  accumulateColumns(columns, matrix, size);
+  long long checksum = 0;
+  for (long long j=0; j < size; j++){
+    checksum = checksum * 31 + columns[j];
+  }
+  printf("Columns = %lld\n", checksum);
+
+  printf("Sum = %lld\n", scaleAndSum(columns, size));
+
+  free(columns);
+  free(matrix);
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "noelle/runtime/Runtime.h"
+
+typedef struct {
+  double *values;
+  int64_t size;
+  double *partialSums;
+} Env;
+
+static double now (void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + (t.tv_nsec / 1e9);
+}
+
+static double work (double v){
+  return sqrt(v) * sin(v) + cos(v);
+}
+
+static void task (void *e, int64_t taskID, int64_t numberOfTasks){
+  Env *env = (Env *)e;
+  int64_t chunk = (env->size + numberOfTasks - 1) / numberOfTasks;
+  int64_t begin = taskID * chunk;
+  int64_t end = begin + chunk;
+  if (end > env->size){
+    end = env->size;
+  }
+
+  double sum = 0;
+  for (int64_t i=begin; i < end; i++){
+    sum += work(env->values[i]);
+  }
+  env->partialSums[taskID] = sum;
+}
+
+int main (int argc, char *argv[]){
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s ELEMENTS\n", argv[0]);
+    return 1;
+  }
+  int64_t size = atoll(argv[1]);
+
+  double *values = (double *)malloc(sizeof(double) * size);
+  for (int64_t i=0; i < size; i++){
+    values[i] = (double)(i % 1000);
+  }
+
+  /*
+   * Sequential loop.
+   */
+  double start = now();
+  double sequentialSum = 0;
+  for (int64_t i=0; i < size; i++){
+    sequentialSum += work(values[i]);
+  }
+  double sequentialTime = now() - start;
+
+  /*
+   * The same loop split in tasks that run on the NOELLE runtime.
+   */
+  int64_t cores = NOELLE_getAvailableCores();
+  int64_t numberOfTasks = cores * 4;
+  Env env;
+  env.values = values;
+  env.size = size;
+  env.partialSums = (double *)calloc(numberOfTasks, sizeof(double));
+  start = now();
+  NOELLE_DispatcherInfo info = NOELLE_dispatchTasks(task, &env, numberOfTasks);
+  double parallelSum = 0;
+  for (int64_t i=0; i < numberOfTasks; i++){
+    parallelSum += env.partialSums[i];
+  }
+  double parallelTime = now() - start;
+
+  printf("Available cores = %lld\n", (long long)cores);
+  printf("Threads used = %lld\n", (long long)info.numberOfThreadsUsed);
+  printf("Sequential: %f (%.3f s)\n", sequentialSum, sequentialTime);
+  printf("Parallel:   %f (%.3f s)\n", parallelSum, parallelTime);
+  printf("Speedup = %.2f\n", sequentialTime / parallelTime);
+
+  free(env.partialSums);
+  free(values);
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+static long long reduce (int *values, long long size){
+  long long sum = 0;
+  long long bits = 0;
+  for (long long i=0; i < size; i++){
+    sum += values[i];
+    bits |= values[i];
+  }
+
+  return sum + bits;
+}
+
+int main (int argc, char *argv[]){
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s ELEMENTS\n", argv[0]);
+    return 1;
+  }
+  long long size = atoll(argv[1]);
+
+  int *values = (int *)malloc(sizeof(int) * size);
+  for (long long i=0; i < size; i++){
+    values[i] = (int)(i % 1000);
+  }
+
+  printf("Result = %lld\n", reduce(values, size));
+
+  free(values);
+  return 0;
+}
@@ -34,6 +34,31 @@ public:
 
   virtual std::string getName(void) const = 0;
 
+  /*
+   * Alias query between two memory locations.
+   * Engines that cannot answer return MayAlias.
+   */
+  virtual AliasResult alias(const MemoryLocation &loc1,
+                            const MemoryLocation &loc2);
+
+  /*
+   * Batched alias queries.
+   *
+   * getAliasMatrix returns the matrix M where M[i][j] is the alias relation
+   * between @locations[i] and @locations[j].
+   *
+   * getMayAliasPartition splits the indices of @locations in sets such that
+   * locations that belong to different sets never alias.
+   *
+   * The default implementations issue one alias query per pair of locations.
+   * Engines that can answer in bulk override them.
+   */
+  virtual std::vector<std::vector<AliasResult>> getAliasMatrix(
+      const std::vector<MemoryLocation> &locations);
+
+  virtual std::vector<std::vector<uint32_t>> getMayAliasPartition(
+      const std::vector<MemoryLocation> &locations);
+
   virtual ~AliasAnalysisEngine();
 
 protected:
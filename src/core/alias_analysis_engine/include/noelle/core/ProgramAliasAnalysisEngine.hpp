@@ -9,9 +9,24 @@ class ProgramAliasAnalysisEngine : public AliasAnalysisEngine {
 public:
   ProgramAliasAnalysisEngine(const std::string &name, void *rawPtr);
 
+  /*
+   * @aliasQuery answers the alias queries of the engine.
+   */
+  ProgramAliasAnalysisEngine(
+      const std::string &name,
+      void *rawPtr,
+      std::function<AliasResult(const MemoryLocation &loc1,
+                                const MemoryLocation &loc2)> aliasQuery);
+
   std::string getName(void) const override;
 
+  AliasResult alias(const MemoryLocation &loc1,
+                    const MemoryLocation &loc2) override;
+
 protected:
+  std::function<AliasResult(const MemoryLocation &loc1,
+                            const MemoryLocation &loc2)>
+      aliasQuery;
 };
 
 } // namespace arcana::noelle
@@ -14,6 +14,80 @@ void *AliasAnalysisEngine::getRawPointer(void) const {
   return this->rawPtr;
 }
 
+AliasResult AliasAnalysisEngine::alias(const MemoryLocation &loc1,
+                                       const MemoryLocation &loc2) {
+  return AliasResult::MayAlias;
+}
+
+std::vector<std::vector<AliasResult>> AliasAnalysisEngine::getAliasMatrix(
+    const std::vector<MemoryLocation> &locations) {
+  auto n = locations.size();
+  std::vector<std::vector<AliasResult>> matrix(
+      n,
+      std::vector<AliasResult>(n, AliasResult::MustAlias));
+
+  /*
+   * Alias relations are symmetric: query every pair once.
+   */
+  for (auto i = 0u; i < n; i++) {
+    for (auto j = i + 1; j < n; j++) {
+      auto result = this->alias(locations[i], locations[j]);
+      matrix[i][j] = result;
+      matrix[j][i] = result;
+    }
+  }
+
+  return matrix;
+}
+
+std::vector<std::vector<uint32_t>> AliasAnalysisEngine::getMayAliasPartition(
+    const std::vector<MemoryLocation> &locations) {
+  auto matrix = this->getAliasMatrix(locations);
+
+  /*
+   * Merge the sets of locations that may alias (union-find).
+   */
+  std::vector<uint32_t> representatives(locations.size());
+  for (auto i = 0u; i < locations.size(); i++) {
+    representatives[i] = i;
+  }
+  std::function<uint32_t(uint32_t)> find = [&](uint32_t i) -> uint32_t {
+    if (representatives[i] != i) {
+      representatives[i] = find(representatives[i]);
+    }
+    return representatives[i];
+  };
+  for (auto i = 0u; i < locations.size(); i++) {
+    for (auto j = i + 1; j < locations.size(); j++) {
+      if (matrix[i][j] == AliasResult::NoAlias) {
+        continue;
+      }
+      auto repI = find(i);
+      auto repJ = find(j);
+      if (repI != repJ) {
+        representatives[std::max(repI, repJ)] = std::min(repI, repJ);
+      }
+    }
+  }
+
+  /*
+   * Collect the sets.
+   * Sets are ordered by their smallest location.
+   */
+  std::vector<std::vector<uint32_t>> partition;
+  std::unordered_map<uint32_t, uint32_t> setOfRepresentative;
+  for (auto i = 0u; i < locations.size(); i++) {
+    auto rep = find(i);
+    if (setOfRepresentative.find(rep) == setOfRepresentative.end()) {
+      setOfRepresentative[rep] = partition.size();
+      partition.push_back({});
+    }
+    partition[setOfRepresentative[rep]].push_back(i);
+  }
+
+  return partition;
+}
+
 AliasAnalysisEngine::~AliasAnalysisEngine() {
   return;
 }
@@ -8,8 +8,26 @@ ProgramAliasAnalysisEngine::ProgramAliasAnalysisEngine(const std::string &name,
   return;
 }
 
+ProgramAliasAnalysisEngine::ProgramAliasAnalysisEngine(
+    const std::string &name,
+    void *ptr,
+    std::function<AliasResult(const MemoryLocation &loc1,
+                              const MemoryLocation &loc2)> aliasQuery)
+  : AliasAnalysisEngine{ name, ptr },
+    aliasQuery{ aliasQuery } {
+  return;
+}
+
 std::string ProgramAliasAnalysisEngine::getName(void) const {
   return "ProgramAliasAnalysisEngine \"" + this->n + "\"";
 }
 
+AliasResult ProgramAliasAnalysisEngine::alias(const MemoryLocation &loc1,
+                                              const MemoryLocation &loc2) {
+  if (!this->aliasQuery) {
+    return AliasAnalysisEngine::alias(loc1, loc2);
+  }
+  return this->aliasQuery(loc1, loc2);
+}
+
 } // namespace arcana::noelle
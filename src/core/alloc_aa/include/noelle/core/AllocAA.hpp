@@ -58,10 +58,23 @@ private:
   std::set<CallInst *> allocatorCalls;
   std::set<std::string> readOnlyFunctionNames, allocatorFunctionNames,
       memorylessFunctionNames;
-  std::set<GlobalValue *> primitiveArrayGlobals;
-  std::set<Instruction *> primitiveArrayLocals;
+  DenseSet<GlobalValue *> primitiveArrayGlobals;
+  DenseSet<Instruction *> primitiveArrayLocals;
   AllocAAVerbosity verbose;
 
+  /*
+   * Primitive array accessed by a load or a store, computed once per memory
+   * instruction.
+   * The pointer operand is recorded to detect instructions that changed (or
+   * have been replaced) after their access has been classified.
+   */
+  struct PrimitiveArrayAccess {
+    Value *pointer;
+    Value *array;
+    GetElementPtrInst *gep;
+  };
+  DenseMap<Value *, PrimitiveArrayAccess> primitiveArrayAccesses;
+
   // TODO: Find a way to extract this into a helper module for all passes in the
   // PDG project
   void collectCGUnderFunctionMain(Module &M, CallGraph &callGraph);
@@ -78,7 +91,10 @@ private:
   bool isPrimitiveArray(Value *V, std::set<Instruction *> &userInstructions);
   bool isPrimitiveArrayPointer(Value *V,
                                std::set<Instruction *> &userInstructions);
-  bool doesValueNotEscape(std::set<Instruction *> checked, Instruction *I);
+  bool doesValueNotEscape(std::set<Instruction *> &checked, Instruction *I);
+  void collectPrimitiveArrayAccesses(Module &M);
+  std::pair<Value *, GetElementPtrInst *> computePrimitiveArrayAccess(
+      Value *memOp);
 
   Value *getPrimitiveArray(Value *V);
   Value *getLocalPrimitiveArray(Value *V);
@@ -71,6 +71,7 @@ bool AllocAA::runOnModule(Module &M) {
   collectCGUnderFunctionMain(M, callGraph);
   collectAllocations(M, callGraph);
   collectPrimitiveArrayValues(M);
+  collectPrimitiveArrayAccesses(M);
   collectMemorylessFunctions(M);
 
   return false;
@@ -90,6 +91,39 @@ std::pair<Value *, GetElementPtrInst *> AllocAA::getPrimitiveArrayAccess(
   if (!memOp)
     return std::make_pair(nullptr, nullptr);
 
+  /*
+   * Check if the access has already been classified.
+   */
+  auto it = this->primitiveArrayAccesses.find(V);
+  if (true && (it != this->primitiveArrayAccesses.end())
+      && (it->second.pointer == memOp)) {
+    return std::make_pair(it->second.array, it->second.gep);
+  }
+
+  /*
+   * Classify the access.
+   */
+  auto access = this->computePrimitiveArrayAccess(memOp);
+  this->primitiveArrayAccesses[V] = { memOp, access.first, access.second };
+
+  return access;
+}
+
+void AllocAA::collectPrimitiveArrayAccesses(Module &M) {
+  this->primitiveArrayAccesses.clear();
+  for (auto &F : M) {
+    for (auto &I : instructions(F)) {
+      if (!isa<LoadInst>(&I) && !isa<StoreInst>(&I)) {
+        continue;
+      }
+      this->getPrimitiveArrayAccess(&I);
+    }
+  }
+}
+
+std::pair<Value *, GetElementPtrInst *> AllocAA::computePrimitiveArrayAccess(
+    Value *memOp) {
+
   /*
    * The value V is a memory instruction directly on an array
    */
@@ -387,7 +421,8 @@ bool AllocAA::isPrimitiveArray(Value *V,
         continue;
     }
     if (auto GEPUser = dyn_cast<GetElementPtrInst>(I)) {
-      if (doesValueNotEscape({ GEPUser }, GEPUser))
+      std::set<Instruction *> checked{ GEPUser };
+      if (doesValueNotEscape(checked, GEPUser))
         continue;
     }
     if (auto callUser = dyn_cast<CallInst>(I)) {
@@ -416,7 +451,7 @@ bool AllocAA::isPrimitiveArray(Value *V,
   return isPrimitive;
 }
 
-bool AllocAA::doesValueNotEscape(std::set<Instruction *> checked,
+bool AllocAA::doesValueNotEscape(std::set<Instruction *> &checked,
                                  Instruction *I) {
   User *unkUser = nullptr;
   for (auto user : I->users()) {
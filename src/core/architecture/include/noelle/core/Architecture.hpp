@@ -26,6 +26,26 @@
 
 namespace arcana::noelle {
 
+/*
+ * Description of the target machine.
+ *
+ * On Linux, the topology is read from /sys/devices/system/cpu and
+ * /sys/devices/system/node the first time it is needed.
+ * The environment variable NOELLE_ARCHITECTURE_FILE can point to a file that
+ * describes (or partially overrides) the target (e.g., when cross-compiling).
+ * The format of such file is one property per line:
+ *
+ *   logical_cores 64
+ *   physical_cores 32
+ *   numa_node 0 0-15,32-47
+ *   numa_node 1 16-31,48-63
+ *   cache 1 32K 64 2
+ *   cache 2 1M 64 2
+ *   cache 3 32M 64 32
+ *
+ * where a cache line is "cache LEVEL SIZE LINE_BYTES SHARING_LOGICAL_CORES".
+ * Lines that start with '#' are ignored.
+ */
 class Architecture {
 public:
   Architecture();
@@ -34,9 +54,50 @@ public:
 
   static uint32_t getNumberOfPhysicalCores(void);
 
+  static uint32_t getNumberOfNUMANodes(void);
+
+  /*
+   * Cache line size of the first level data cache.
+   */
   static int32_t getCacheLineBytes(void);
 
+  /*
+   * Data (or unified) caches are numbered starting from level 1.
+   */
+  static int32_t getCacheLineBytes(uint32_t level);
+
+  /*
+   * Bytes of the cache at @level that a single logical core can use when all
+   * logical cores sharing it are busy.
+   * Levels that do not exist have size 0.
+   */
+  static uint64_t getCacheBytesPerLogicalCore(uint32_t level);
+
+  static raw_ostream &print(raw_ostream &stream);
+
 private:
+  struct CacheLevel {
+    uint32_t level;
+    uint64_t bytes;
+    int32_t lineBytes;
+    uint32_t sharingLogicalCores;
+  };
+
+  struct Topology {
+    uint32_t logicalCores;
+    uint32_t physicalCores;
+    std::map<uint32_t, std::vector<uint32_t>> smtSiblings;
+    std::map<uint32_t, std::vector<uint32_t>> numaNodes;
+    std::map<uint32_t, CacheLevel> caches;
+  };
+
+  static const Topology &getTopology(void);
+
+  static Topology detectTopology(void);
+
+  static void overrideTopology(Topology &t, const std::string &fileName);
+
+  static const CacheLevel *getCacheLevel(uint32_t level);
 };
 
 } // namespace arcana::noelle
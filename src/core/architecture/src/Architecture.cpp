@@ -19,24 +19,379 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <fstream>
 #include "noelle/core/Architecture.hpp"
 
 namespace arcana::noelle {
 
+static const std::string cpuSysFS = "/sys/devices/system/cpu/";
+static const std::string nodeSysFS = "/sys/devices/system/node/";
+
+static bool readFirstLine(const std::string &fileName, std::string &line) {
+  std::ifstream file(fileName);
+  if (!file.is_open()) {
+    return false;
+  }
+  if (!std::getline(file, line)) {
+    return false;
+  }
+
+  return true;
+}
+
+static bool readNumber(const std::string &fileName, uint64_t &value) {
+  std::string line;
+  if (!readFirstLine(fileName, line)) {
+    return false;
+  }
+  try {
+    value = std::stoull(line);
+  } catch (...) {
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * Parse sizes like "32K", "1024K", or "32M".
+ */
+static uint64_t parseBytes(const std::string &text) {
+  if (text.empty()) {
+    return 0;
+  }
+  uint64_t value = 0;
+  size_t charsRead = 0;
+  try {
+    value = std::stoull(text, &charsRead);
+  } catch (...) {
+    return 0;
+  }
+  if (charsRead < text.size()) {
+    switch (std::toupper(text[charsRead])) {
+      case 'K':
+        value *= 1024;
+        break;
+      case 'M':
+        value *= 1024 * 1024;
+        break;
+      case 'G':
+        value *= 1024 * 1024 * 1024;
+        break;
+    }
+  }
+
+  return value;
+}
+
+/*
+ * Parse lists of CPUs like "0-3,8,10-11".
+ */
+static std::vector<uint32_t> parseCPUList(const std::string &text) {
+  std::vector<uint32_t> cpus;
+  std::stringstream stream{ text };
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    try {
+      auto dash = range.find('-');
+      if (dash == std::string::npos) {
+        cpus.push_back(std::stoul(range));
+        continue;
+      }
+      auto first = std::stoul(range.substr(0, dash));
+      auto last = std::stoul(range.substr(dash + 1));
+      for (auto cpu = first; cpu <= last; cpu++) {
+        cpus.push_back(cpu);
+      }
+    } catch (...) {
+      continue;
+    }
+  }
+
+  return cpus;
+}
+
 Architecture::Architecture() {
   return;
 }
 
 uint32_t Architecture::getNumberOfLogicalCores(void) {
-  return std::thread::hardware_concurrency();
+  return getTopology().logicalCores;
 }
 
 uint32_t Architecture::getNumberOfPhysicalCores(void) {
-  return getNumberOfLogicalCores() / 2;
+  return getTopology().physicalCores;
+}
+
+uint32_t Architecture::getNumberOfNUMANodes(void) {
+  auto &t = getTopology();
+  if (t.numaNodes.size() == 0) {
+    return 1;
+  }
+
+  return t.numaNodes.size();
 }
 
 int32_t Architecture::getCacheLineBytes(void) {
-  return 64;
+  return getCacheLineBytes(1);
+}
+
+int32_t Architecture::getCacheLineBytes(uint32_t level) {
+  auto c = getCacheLevel(level);
+  if ((c == nullptr) || (c->lineBytes <= 0)) {
+    return 64;
+  }
+
+  return c->lineBytes;
+}
+
+uint64_t Architecture::getCacheBytesPerLogicalCore(uint32_t level) {
+  auto c = getCacheLevel(level);
+  if (c == nullptr) {
+    return 0;
+  }
+  if (c->sharingLogicalCores == 0) {
+    return c->bytes;
+  }
+
+  return c->bytes / c->sharingLogicalCores;
+}
+
+raw_ostream &Architecture::print(raw_ostream &stream) {
+  auto &t = getTopology();
+  stream << "Architecture\n";
+  stream << "  Logical cores: " << t.logicalCores << "\n";
+  stream << "  Physical cores: " << t.physicalCores << "\n";
+  stream << "  NUMA nodes: " << getNumberOfNUMANodes() << "\n";
+  for (auto &pair : t.numaNodes) {
+    stream << "    Node " << pair.first << ": " << pair.second.size()
+           << " logical cores\n";
+  }
+  for (auto &pair : t.caches) {
+    auto &c = pair.second;
+    stream << "  L" << c.level << ": " << c.bytes << " bytes, "
+           << c.lineBytes << " bytes per line, shared by "
+           << c.sharingLogicalCores << " logical cores\n";
+  }
+
+  return stream;
+}
+
+const Architecture::CacheLevel *Architecture::getCacheLevel(uint32_t level) {
+  auto &t = getTopology();
+  auto it = t.caches.find(level);
+  if (it == t.caches.end()) {
+    return nullptr;
+  }
+
+  return &it->second;
+}
+
+const Architecture::Topology &Architecture::getTopology(void) {
+  static const Topology topology = []() -> Topology {
+    auto t = detectTopology();
+
+    /*
+     * Check if the user described the target explicitly.
+     */
+    auto fileName = getenv("NOELLE_ARCHITECTURE_FILE");
+    if (fileName != nullptr) {
+      overrideTopology(t, fileName);
+    }
+
+    /*
+     * Make sure the description is consistent.
+     */
+    if (t.logicalCores == 0) {
+      t.logicalCores = 1;
+    }
+    if ((t.physicalCores == 0) || (t.physicalCores > t.logicalCores)) {
+      t.physicalCores = t.logicalCores;
+    }
+
+    return t;
+  }();
+
+  return topology;
+}
+
+Architecture::Topology Architecture::detectTopology(void) {
+  Topology t;
+
+  /*
+   * Fetch the logical cores that are online.
+   */
+  std::vector<uint32_t> cpus;
+  std::string line;
+  if (readFirstLine(cpuSysFS + "online", line)) {
+    cpus = parseCPUList(line);
+  }
+  if (cpus.size() == 0) {
+
+    /*
+     * The topology isn't exposed by the OS.
+     * Fall back to what the C++ runtime tells us and assume 2-way SMT.
+     */
+    t.logicalCores = std::thread::hardware_concurrency();
+    t.physicalCores = t.logicalCores / 2;
+    return t;
+  }
+  t.logicalCores = cpus.size();
+
+  /*
+   * Identify the physical cores and their SMT siblings.
+   */
+  std::set<std::pair<uint64_t, uint64_t>> physicalCores;
+  for (auto cpu : cpus) {
+    auto topologyDir = cpuSysFS + "cpu" + std::to_string(cpu) + "/topology/";
+    uint64_t packageID = 0;
+    uint64_t coreID = cpu;
+    readNumber(topologyDir + "physical_package_id", packageID);
+    readNumber(topologyDir + "core_id", coreID);
+    physicalCores.insert(std::make_pair(packageID, coreID));
+
+    if (readFirstLine(topologyDir + "thread_siblings_list", line)) {
+      t.smtSiblings[cpu] = parseCPUList(line);
+    }
+  }
+  t.physicalCores = physicalCores.size();
+
+  /*
+   * Fetch the caches seen by the first logical core.
+   * We only consider caches that hold data.
+   */
+  auto cacheDir = cpuSysFS + "cpu" + std::to_string(cpus[0]) + "/cache/";
+  for (auto index = 0u;; index++) {
+    auto indexDir = cacheDir + "index" + std::to_string(index) + "/";
+    uint64_t level = 0;
+    if (!readNumber(indexDir + "level", level)) {
+      break;
+    }
+    if (readFirstLine(indexDir + "type", line) && (line == "Instruction")) {
+      continue;
+    }
+
+    CacheLevel c{};
+    c.level = level;
+    c.bytes = 0;
+    c.lineBytes = 64;
+    c.sharingLogicalCores = 1;
+    if (readFirstLine(indexDir + "size", line)) {
+      c.bytes = parseBytes(line);
+    }
+    uint64_t lineBytes = 0;
+    if (readNumber(indexDir + "coherency_line_size", lineBytes)
+        && (lineBytes > 0)) {
+      c.lineBytes = lineBytes;
+    }
+    if (readFirstLine(indexDir + "shared_cpu_list", line)) {
+      auto sharing = parseCPUList(line).size();
+      if (sharing > 0) {
+        c.sharingLogicalCores = sharing;
+      }
+    }
+    t.caches[c.level] = c;
+  }
+
+  /*
+   * Fetch the NUMA nodes.
+   */
+  if (readFirstLine(nodeSysFS + "online", line)) {
+    for (auto node : parseCPUList(line)) {
+      std::string cpuList;
+      auto nodeFile = nodeSysFS + "node" + std::to_string(node) + "/cpulist";
+      if (!readFirstLine(nodeFile, cpuList)) {
+        continue;
+      }
+      t.numaNodes[node] = parseCPUList(cpuList);
+    }
+  }
+
+  return t;
+}
+
+void Architecture::overrideTopology(Topology &t, const std::string &fileName) {
+
+  /*
+   * Open the file.
+   */
+  std::ifstream file(fileName);
+  if (!file.is_open()) {
+    errs() << "Failed to read NOELLE_ARCHITECTURE_FILE = \"" << fileName
+           << "\"\n";
+    abort();
+  }
+
+  /*
+   * Parse the file.
+   *
+   * NUMA nodes and caches listed in the file replace all the detected ones.
+   */
+  auto numaNodesOverridden = false;
+  auto cachesOverridden = false;
+  auto physicalCoresOverridden = false;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::stringstream lineStream{ line };
+    std::string key;
+    if (!(lineStream >> key) || (key[0] == '#')) {
+      continue;
+    }
+
+    if (key == "logical_cores") {
+      lineStream >> t.logicalCores;
+      t.smtSiblings.clear();
+
+    } else if (key == "physical_cores") {
+      lineStream >> t.physicalCores;
+      physicalCoresOverridden = true;
+
+    } else if (key == "numa_node") {
+      if (!numaNodesOverridden) {
+        t.numaNodes.clear();
+        numaNodesOverridden = true;
+      }
+      uint32_t node;
+      std::string cpuList;
+      lineStream >> node >> cpuList;
+      t.numaNodes[node] = parseCPUList(cpuList);
+
+    } else if (key == "cache") {
+      if (!cachesOverridden) {
+        t.caches.clear();
+        cachesOverridden = true;
+      }
+      CacheLevel c{};
+      std::string size;
+      c.lineBytes = 64;
+      c.sharingLogicalCores = 1;
+      if (!(lineStream >> c.level >> size)) {
+        errs() << "NOELLE_ARCHITECTURE_FILE: malformed cache \"" << line
+               << "\"\n";
+        continue;
+      }
+      lineStream >> c.lineBytes >> c.sharingLogicalCores;
+      c.bytes = parseBytes(size);
+      t.caches[c.level] = c;
+
+    } else {
+      errs() << "NOELLE_ARCHITECTURE_FILE: unknown property \"" << key
+             << "\"\n";
+      abort();
+    }
+  }
+
+  /*
+   * A target that only specifies its logical cores has no SMT.
+   */
+  if (!physicalCoresOverridden && t.smtSiblings.empty()) {
+    t.physicalCores = t.logicalCores;
+  }
+
+  return;
 }
 
 } // namespace arcana::noelle
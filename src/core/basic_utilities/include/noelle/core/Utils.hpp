@@ -22,6 +22,8 @@
 #ifndef NOELLE_SRC_CORE_BASIC_UTILITIES_UTILS_H_
 #define NOELLE_SRC_CORE_BASIC_UTILITIES_UTILS_H_
 
+#include "llvm/IR/ValueHandle.h"
+
 #include "noelle/core/SystemHeaders.hpp"
 
 namespace arcana::noelle {
@@ -39,6 +41,25 @@ public:
   static Value *getAllocatedObject(CallBase *call);
 
   static Value *getFreedObject(CallBase *call);
+
+  /*
+   * Fetch handles to the instructions of @F.
+   * A handle becomes null when its instruction is erased.
+   */
+  static std::vector<std::pair<Instruction *, WeakVH>> fetchInstructionHandles(
+      Function &F);
+
+  /*
+   * Add the instructions of @F erased since @handles have been fetched to
+   * @instructionsRemoved, and those created since to @instructionsAdded.
+   * This is meant for transformations that cannot track their changes (e.g.,
+   * those implemented by LLVM).
+   */
+  static void diffInstructions(
+      Function &F,
+      std::vector<std::pair<Instruction *, WeakVH>> const &handles,
+      std::set<Instruction *> &instructionsRemoved,
+      std::set<Instruction *> &instructionsAdded);
 };
 
 } // namespace arcana::noelle
@@ -188,4 +188,49 @@ Value *Utils::getFreedObject(CallBase *call) {
   abort();
 }
 
+std::vector<std::pair<Instruction *, WeakVH>> Utils::fetchInstructionHandles(
+    Function &F) {
+  std::vector<std::pair<Instruction *, WeakVH>> handles;
+
+  for (auto &inst : instructions(F)) {
+    handles.push_back(std::make_pair(&inst, WeakVH(&inst)));
+  }
+
+  return handles;
+}
+
+void Utils::diffInstructions(
+    Function &F,
+    std::vector<std::pair<Instruction *, WeakVH>> const &handles,
+    std::set<Instruction *> &instructionsRemoved,
+    std::set<Instruction *> &instructionsAdded) {
+
+  /*
+   * Split the instructions fetched before into the erased ones and the ones
+   * that still exist.
+   * The address of an erased instruction might have been reused by a new one,
+   * so erased instructions are never looked up in @F.
+   */
+  std::unordered_set<Instruction *> survivors;
+  for (auto &pair : handles) {
+    Value *current = pair.second;
+    if (current == nullptr) {
+      instructionsRemoved.insert(pair.first);
+      continue;
+    }
+    survivors.insert(pair.first);
+  }
+
+  /*
+   * The instructions of @F that did not exist before have been added.
+   */
+  for (auto &inst : instructions(F)) {
+    if (survivors.count(&inst) == 0) {
+      instructionsAdded.insert(&inst);
+    }
+  }
+
+  return;
+}
+
 } // namespace arcana::noelle
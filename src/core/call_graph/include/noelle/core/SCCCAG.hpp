@@ -55,6 +55,12 @@ public:
   std::unordered_map<SCCCAGNode *, SCCCAGEdge *> getIncomingEdges(
       SCCCAGNode *n) const;
 
+  /*
+   * Return all nodes such that every node comes after all nodes it might
+   * invoke (i.e., callees before callers).
+   */
+  std::vector<SCCCAGNode *> getNodesInBottomUpOrder(void) const;
+
 private:
   CallGraph *cg;
   std::unordered_map<CallGraphFunctionNode *, SCCCAGNode *> fromCGNodeToSCC;
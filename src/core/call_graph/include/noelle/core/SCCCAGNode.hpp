@@ -35,6 +35,8 @@ public:
 
   virtual bool isAnSCC(void) const = 0;
 
+  virtual std::unordered_set<Function *> getFunctions(void) const = 0;
+
   virtual ~SCCCAGNode();
 
 protected:
@@ -49,6 +51,8 @@ public:
 
   std::unordered_set<CallGraphFunctionNode *> getInternalNodes(void) const;
 
+  std::unordered_set<Function *> getFunctions(void) const override;
+
   virtual ~SCCCAGNode_SCC();
 
 private:
@@ -63,6 +67,8 @@ public:
 
   CallGraphFunctionNode *getNode(void) const;
 
+  std::unordered_set<Function *> getFunctions(void) const override;
+
   virtual ~SCCCAGNode_Function();
 
 private:
@@ -294,6 +294,50 @@ std::unordered_map<SCCCAGNode *, SCCCAGEdge *> SCCCAG::getIncomingEdges(
   return inEdges;
 }
 
+std::vector<SCCCAGNode *> SCCCAG::getNodesInBottomUpOrder(void) const {
+  std::vector<SCCCAGNode *> order;
+
+  /*
+   * Count the callees of every node.
+   * Nodes without callees can be visited first.
+   */
+  std::unordered_map<SCCCAGNode *, uint64_t> calleesToVisit;
+  std::vector<SCCCAGNode *> ready;
+  for (auto node : this->nodes) {
+    uint64_t callees = 0;
+    if (this->outgoingEdges.find(node) != this->outgoingEdges.end()) {
+      callees = this->outgoingEdges.at(node).size();
+    }
+    calleesToVisit[node] = callees;
+    if (callees == 0) {
+      ready.push_back(node);
+    }
+  }
+
+  /*
+   * Visit the nodes.
+   * A node is ready when all its callees have been visited.
+   */
+  while (!ready.empty()) {
+    auto node = ready.back();
+    ready.pop_back();
+    order.push_back(node);
+    if (this->incomingEdges.find(node) == this->incomingEdges.end()) {
+      continue;
+    }
+    for (auto pair : this->incomingEdges.at(node)) {
+      auto caller = pair.first;
+      calleesToVisit[caller]--;
+      if (calleesToVisit[caller] == 0) {
+        ready.push_back(caller);
+      }
+    }
+  }
+  assert(order.size() == this->nodes.size());
+
+  return order;
+}
+
 SCCCAGEdge *SCCCAG::newEdge(SCCCAGNode *from, SCCCAGNode *to) {
 
   /*
@@ -39,6 +39,10 @@ CallGraphFunctionNode *SCCCAGNode_Function::getNode(void) const {
   return this->node;
 }
 
+std::unordered_set<Function *> SCCCAGNode_Function::getFunctions(void) const {
+  return { this->node->getFunction() };
+}
+
 SCCCAGNode_Function::~SCCCAGNode_Function() {
   return;
 }
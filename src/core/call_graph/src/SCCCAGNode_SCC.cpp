@@ -40,6 +40,15 @@ std::unordered_set<CallGraphFunctionNode *> SCCCAGNode_SCC::getInternalNodes(
   return this->nodes;
 }
 
+std::unordered_set<Function *> SCCCAGNode_SCC::getFunctions(void) const {
+  std::unordered_set<Function *> functions;
+  for (auto node : this->nodes) {
+    functions.insert(node->getFunction());
+  }
+
+  return functions;
+}
+
 SCCCAGNode_SCC::~SCCCAGNode_SCC() {
   return;
 }
@@ -34,16 +34,35 @@
 
 namespace arcana::noelle {
 
+/*
+ * Nodes and edges of a graph are ordered by their IDs, which the graph assigns
+ * in insertion order. Hence, iterating over them is deterministic.
+ */
+template <class T>
+struct DGNodeIDOrder {
+  bool operator()(const DGNode<T> *n1, const DGNode<T> *n2) const {
+    return n1->getID() < n2->getID();
+  }
+};
+
+template <class T>
+struct DGEdgeIDOrder {
+  bool operator()(const DGEdge<T, T> *e1, const DGEdge<T, T> *e2) const {
+    return e1->getID() < e2->getID();
+  }
+};
+
 template <class T>
 class DG {
 public:
   DG();
 
-  using nodes_iterator = typename std::set<DGNode<T> *>::iterator;
-  using nodes_const_iterator = typename std::set<DGNode<T> *>::const_iterator;
-  using edges_iterator = typename std::set<DGEdge<T, T> *>::iterator;
-  using edges_const_iterator =
-      typename std::set<DGEdge<T, T> *>::const_iterator;
+  using nodes_set = std::set<DGNode<T> *, DGNodeIDOrder<T>>;
+  using edges_set = std::set<DGEdge<T, T> *, DGEdgeIDOrder<T>>;
+  using nodes_iterator = typename nodes_set::iterator;
+  using nodes_const_iterator = typename nodes_set::const_iterator;
+  using edges_iterator = typename edges_set::iterator;
+  using edges_const_iterator = typename edges_set::const_iterator;
   using node_map_iterator = typename std::map<T *, DGNode<T> *>::iterator;
   typedef std::map<DGEdge<T, T> *, uint32_t> DepIdReverseMap_t;
 
@@ -187,6 +206,12 @@ public:
   std::unordered_set<DGNode<T> *> getPreviousDepthNodes(DGNode<T> *node);
   void removeNode(DGNode<T> *node);
   void removeEdge(DGEdge<T, T> *edge);
+
+  /*
+   * Remove all @edges at once.
+   * Every node and the set of edges of the graph are compacted once.
+   */
+  void removeEdges(const std::unordered_set<DGEdge<T, T> *> &edges);
   void copyNodesIntoNewGraph(DG<T> &newGraph,
                              std::set<DGNode<T> *> nodesToPartition,
                              DGNode<T> *entryNode);
@@ -194,13 +219,18 @@ public:
 
   raw_ostream &print(raw_ostream &stream);
 
-  static std::vector<DGEdge<T, T> *> sortDependences(
-      const std::set<DGEdge<T, T> *> &set);
+  /*
+   * Dependences of @set in a deterministic order (their insertion order).
+   */
+  static std::vector<DGEdge<T, T> *> sortDependences(const edges_set &set);
 
 protected:
   int32_t nodeIdCounter;
-  std::set<DGNode<T> *> allNodes;
-  std::set<DGEdge<T, T> *> allEdges;
+  uint64_t edgeIdCounter;
+  nodes_set allNodes;
+  edges_set allEdges;
+
+  void insertEdge(DGEdge<T, T> *edge);
   DGNode<T> *entryNode;
   std::map<T *, DGNode<T> *> internalNodeMap;
   std::map<T *, DGNode<T> *> externalNodeMap;
@@ -212,6 +242,7 @@ protected:
  */
 template <class T>
 DG<T>::DG() : nodeIdCounter{ 0 },
+              edgeIdCounter{ 0 },
               depLookupMap{ nullptr } {
 
   return;
@@ -280,7 +311,7 @@ DGEdge<T, T> *DG<T>::addVariableDataDependenceEdge(T *from,
   auto fromNode = this->fetchNode(from);
   auto toNode = this->fetchNode(to);
   auto edge = new VariableDependence<T, T>(fromNode, toNode, t);
-  allEdges.insert(edge);
+  this->insertEdge(edge);
   fromNode->addOutgoingEdge(edge);
   toNode->addIncomingEdge(edge);
   return edge;
@@ -301,7 +332,7 @@ DGEdge<T, T> *DG<T>::addMemoryDataDependenceEdge(T *from,
   }
   assert(edge != nullptr);
 
-  allEdges.insert(edge);
+  this->insertEdge(edge);
   fromNode->addOutgoingEdge(edge);
   toNode->addIncomingEdge(edge);
   return edge;
@@ -312,7 +343,7 @@ DGEdge<T, T> *DG<T>::addControlDependenceEdge(T *from, T *to) {
   auto fromNode = this->fetchNode(from);
   auto toNode = this->fetchNode(to);
   auto edge = new ControlDependence<T, T>(fromNode, toNode);
-  allEdges.insert(edge);
+  this->insertEdge(edge);
   fromNode->addOutgoingEdge(edge);
   toNode->addIncomingEdge(edge);
   return edge;
@@ -323,12 +354,20 @@ DGEdge<T, T> *DG<T>::addUndefinedDependenceEdge(T *from, T *to) {
   auto fromNode = this->fetchNode(from);
   auto toNode = this->fetchNode(to);
   auto edge = new UndefinedDependence<T, T>(fromNode, toNode);
-  allEdges.insert(edge);
+  this->insertEdge(edge);
   fromNode->addOutgoingEdge(edge);
   toNode->addIncomingEdge(edge);
   return edge;
 }
 
+template <class T>
+void DG<T>::insertEdge(DGEdge<T, T> *edge) {
+  edge->setID(this->edgeIdCounter++);
+  this->allEdges.insert(edge);
+
+  return;
+}
+
 template <class T>
 std::unordered_set<DGEdge<T, T> *> DG<T>::fetchEdges(DGNode<T> *From,
                                                      DGNode<T> *To) {
@@ -361,7 +400,7 @@ DGEdge<T, T> *DG<T>::copyAddEdge(DGEdge<T, T> &edgeToCopy) {
       edge = new MustMemoryDependence<T, T>(*edgeToCopyAsMD);
     }
   }
-  allEdges.insert(edge);
+  this->insertEdge(edge);
 
   /*
    * Point copy of edge to equivalent nodes in this graph
@@ -561,6 +600,44 @@ void DG<T>::removeEdge(DGEdge<T, T> *edge) {
   delete edge;
 }
 
+template <class T>
+void DG<T>::removeEdges(const std::unordered_set<DGEdge<T, T> *> &edges) {
+  if (edges.empty()) {
+    return;
+  }
+
+  /*
+   * Detach the edges from their nodes.
+   */
+  std::unordered_set<DGNode<T> *> nodes;
+  for (auto edge : edges) {
+    nodes.insert(edge->getSrcNode());
+    nodes.insert(edge->getDstNode());
+  }
+  for (auto node : nodes) {
+    node->removeConnectedEdges(edges);
+  }
+
+  /*
+   * Compact the edges of the graph.
+   * allEdges is visited in order, so every insertion is at its end.
+   */
+  edges_set remainingEdges;
+  for (auto edge : allEdges) {
+    if (edges.find(edge) == edges.end()) {
+      remainingEdges.insert(remainingEdges.end(), edge);
+    }
+  }
+  allEdges = std::move(remainingEdges);
+
+  /*
+   * Free the memory.
+   */
+  for (auto edge : edges) {
+    delete edge;
+  }
+}
+
 template <class T>
 void DG<T>::copyNodesIntoNewGraph(DG<T> &newGraph,
                                   std::set<DGNode<T> *> nodesToPartition,
@@ -630,52 +707,12 @@ inline std::string DGNode<Instruction>::toString(void) const {
 }
 
 template <class T>
-std::vector<DGEdge<T, T> *> DG<T>::sortDependences(
-    const std::set<DGEdge<T, T> *> &set) {
-  std::vector<DGEdge<T, T> *> v;
-
-  /*
-   * Fetch all edges.
-   */
-  for (auto edge : set) {
-    assert(edge != nullptr);
-    v.push_back(edge);
-  }
+std::vector<DGEdge<T, T> *> DG<T>::sortDependences(const edges_set &set) {
 
   /*
-   * Sort
+   * The set is already ordered by the IDs of the edges.
    */
-  auto sortingFunction = [](DGEdge<T, T> *d1, DGEdge<T, T> *d2) -> bool {
-    assert(d1 != nullptr);
-    assert(d2 != nullptr);
-
-    auto src1 = d1->getSrc();
-    auto src2 = d2->getSrc();
-    assert(src1 != nullptr);
-    assert(src2 != nullptr);
-    if (src1 < src2) {
-      return true;
-    }
-    if (src1 > src2) {
-      return false;
-    }
-    assert(src1 == src2);
-
-    auto dst1 = d1->getDst();
-    auto dst2 = d2->getDst();
-    assert(dst1 != nullptr);
-    assert(dst2 != nullptr);
-    if (dst1 < dst2) {
-      return true;
-    }
-    if (dst1 > dst2) {
-      return false;
-    }
-    assert(dst1 == dst2);
-
-    return false;
-  };
-  std::sort(v.begin(), v.end(), sortingFunction);
+  std::vector<DGEdge<T, T> *> v(set.begin(), set.end());
 
   return v;
 }
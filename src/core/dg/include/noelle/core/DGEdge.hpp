@@ -93,6 +93,15 @@ public:
 
   DependenceKind getKind(void) const;
 
+  /*
+   * ID of the edge within its graph.
+   * IDs are assigned by the graph when the edge is added to it, in insertion
+   * order.
+   */
+  uint64_t getID(void) const;
+
+  void setID(uint64_t id);
+
   virtual ~DGEdge();
 
 protected:
@@ -105,6 +114,7 @@ private:
   std::unordered_set<DGEdge<SubT, SubT> *> *subEdges;
   DependenceKind kind;
   bool isLoopCarried;
+  uint64_t ID;
 };
 
 template <class T, class SubT>
@@ -113,13 +123,15 @@ DGEdge<T, SubT>::DGEdge(DependenceKind k, DGNode<T> *src, DGNode<T> *dst)
     to{ dst },
     subEdges{ nullptr },
     kind{ k },
-    isLoopCarried(false) {
+    isLoopCarried(false),
+    ID{ 0 } {
   return;
 }
 
 template <class T, class SubT>
 DGEdge<T, SubT>::DGEdge(const DGEdge<T, SubT> &edgeToCopy)
-  : subEdges{ nullptr } {
+  : subEdges{ nullptr },
+    ID{ 0 } {
 
   /*
    * Copy the vertices.
@@ -283,6 +295,18 @@ typename DGEdge<T, SubT>::DependenceKind DGEdge<T, SubT>::getKind(void) const {
   return this->kind;
 }
 
+template <class T, class SubT>
+uint64_t DGEdge<T, SubT>::getID(void) const {
+  return this->ID;
+}
+
+template <class T, class SubT>
+void DGEdge<T, SubT>::setID(uint64_t id) {
+  this->ID = id;
+
+  return;
+}
+
 template <class T, class SubT>
 DGEdge<T, SubT>::~DGEdge() {
   return;
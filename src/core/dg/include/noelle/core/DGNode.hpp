@@ -36,6 +36,12 @@ public:
 
   T *getT(void) const;
 
+  /*
+   * ID of the node within its graph.
+   * IDs are assigned in creation order.
+   */
+  int32_t getID(void) const;
+
   using nodes_iterator = typename std::vector<DGNode<T> *>::iterator;
   using edges_iterator = typename std::unordered_set<DGEdge<T, T> *>::iterator;
   using edges_const_iterator =
@@ -89,6 +95,8 @@ public:
 
   void removeConnectedEdge(DGEdge<T, T> *edge);
 
+  void removeConnectedEdges(const std::unordered_set<DGEdge<T, T> *> &edges);
+
   void removeConnectedNode(DGNode<T> *node);
 
   std::string toString(void) const;
@@ -113,6 +121,11 @@ T *DGNode<T>::getT(void) const {
   return theT;
 }
 
+template <class T>
+int32_t DGNode<T>::getID(void) const {
+  return this->ID;
+}
+
 template <class T>
 raw_ostream &DGNode<T>::print(raw_ostream &stream) {
   theT->print(stream);
@@ -140,6 +153,24 @@ void DGNode<T>::removeConnectedEdge(DGEdge<T, T> *edge) {
   return ;
 }
 
+template <class T>
+void DGNode<T>::removeConnectedEdges(
+    const std::unordered_set<DGEdge<T, T> *> &edges) {
+  auto compact = [&edges](std::unordered_set<DGEdge<T, T> *> &nodeEdges) {
+    for (auto it = nodeEdges.begin(); it != nodeEdges.end();) {
+      if (edges.find(*it) != edges.end()) {
+        it = nodeEdges.erase(it);
+      } else {
+        it++;
+      }
+    }
+  };
+  compact(outgoingEdges);
+  compact(incomingEdges);
+
+  return;
+}
+
 template <class T>
 void DGNode<T>::removeConnectedNode(DGNode<T> *node) {
   std::unordered_set<DGEdge<T, T> *> outgoingEdgesToRemove{};
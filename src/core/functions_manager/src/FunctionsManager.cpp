@@ -141,6 +141,12 @@ Function *FunctionsManager::newFunction(const std::string &name,
     abort();
   }
 
+  /*
+   * New functions are typically created to be invoked indirectly (e.g., tasks
+   * given to a runtime). So we conservatively consider them as escaped.
+   */
+  this->pdgAnalysis.addFunctionThatMightEscape(*newFunction);
+
   return newFunction;
 }
 
@@ -269,7 +275,18 @@ void FunctionsManager::sortByHotness(std::vector<Function *> &functions) {
 }
 
 void FunctionsManager::removeFunction(Function &f) {
+
+  /*
+   * Forget @f in the table of functions that might escape.
+   */
+  this->pdgAnalysis.removeFunctionThatMightEscape(f);
+
+  /*
+   * Remove @f.
+   */
   f.eraseFromParent();
+
+  return;
 }
 
 } // namespace arcana::noelle
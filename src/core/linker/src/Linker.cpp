@@ -85,6 +85,9 @@ void Linker::linkTransformedLoopToOriginalFunction(
 
     /*
      * Compute how many values can fit in a cache line.
+     *
+     * The exit block variable is written by the tasks, so it has its own cache
+     * line in the environment (see LoopEnvironmentLayout).
      */
     auto valuesInCacheLine =
         Architecture::getCacheLineBytes() / sizeof(int64_t);
@@ -41,6 +41,29 @@ public:
 
   uint32_t getMaximumNumberOfCores(void) const;
 
+  /*
+   * How reducible live-out variables are combined after the parallel loop.
+   */
+  ReductionStrategy getReductionStrategy(void) const;
+
+  void setReductionStrategy(ReductionStrategy strategy);
+
+  /*
+   * Number of iterations of a tile when the loop is tiled.
+   * 0 means that no size has been requested for the loop.
+   */
+  uint32_t getTileSize(void) const;
+
+  void setTileSize(uint32_t tileSize);
+
+  /*
+   * Number of copies of the body of the loop when the loop is unrolled.
+   * 0 and 1 mean that the loop should not be unrolled.
+   */
+  uint32_t getUnrollFactor(void) const;
+
+  void setUnrollFactor(uint32_t unrollFactor);
+
   /*
    * Check whether a transformation is enabled.
    */
@@ -67,6 +90,9 @@ public:
 private:
   uint32_t chunkSize;
   uint32_t maxCores;
+  ReductionStrategy reductionStrategy;
+  uint32_t tileSize;
+  uint32_t unrollFactor;
   std::set<Transformation>
       enabledTransformations; /* Transformations enabled. */
   std::unordered_set<LoopContentOptimization>
@@ -30,6 +30,9 @@ LoopTransformationsManager::LoopTransformationsManager(
     bool enableLoopAwareDependenceAnalyses)
   : chunkSize{ chunkSize },
     maxCores{ maxNumberOfCores },
+    reductionStrategy{ ReductionStrategy::Serial },
+    tileSize{ 0 },
+    unrollFactor{ 0 },
     enabledTransformations{},
     enabledOptimizations{ optimizations } {
 
@@ -40,6 +43,9 @@ LoopTransformationsManager::LoopTransformationsManager(
     const LoopTransformationsManager &other) {
   this->chunkSize = other.chunkSize;
   this->maxCores = other.maxCores;
+  this->reductionStrategy = other.reductionStrategy;
+  this->tileSize = other.tileSize;
+  this->unrollFactor = other.unrollFactor;
   this->enabledTransformations = other.enabledTransformations;
 
   return;
@@ -53,6 +59,38 @@ uint32_t LoopTransformationsManager::getChunkSize(void) const {
   return this->chunkSize;
 }
 
+ReductionStrategy LoopTransformationsManager::getReductionStrategy(
+    void) const {
+  return this->reductionStrategy;
+}
+
+void LoopTransformationsManager::setReductionStrategy(
+    ReductionStrategy strategy) {
+  this->reductionStrategy = strategy;
+
+  return;
+}
+
+uint32_t LoopTransformationsManager::getTileSize(void) const {
+  return this->tileSize;
+}
+
+void LoopTransformationsManager::setTileSize(uint32_t tileSize) {
+  this->tileSize = tileSize;
+
+  return;
+}
+
+uint32_t LoopTransformationsManager::getUnrollFactor(void) const {
+  return this->unrollFactor;
+}
+
+void LoopTransformationsManager::setUnrollFactor(uint32_t unrollFactor) {
+  this->unrollFactor = unrollFactor;
+
+  return;
+}
+
 bool LoopTransformationsManager::isTransformationEnabled(
     Transformation transformation) {
   auto exist = this->enabledTransformations.find(transformation)
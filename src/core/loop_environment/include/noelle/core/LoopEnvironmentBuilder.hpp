@@ -23,8 +23,10 @@
 #define NOELLE_SRC_CORE_LOOP_ENVIRONMENT_LOOPENVIRONMENTBUILDER_H_
 
 #include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/Transformations.hpp"
 #include "noelle/core/BinaryReductionSCC.hpp"
 #include "noelle/core/LoopEnvironment.hpp"
+#include "noelle/core/LoopEnvironmentLayout.hpp"
 #include "noelle/core/LoopEnvironmentUser.hpp"
 
 namespace arcana::noelle {
@@ -70,9 +72,26 @@ public:
   virtual void allocateEnvironmentArray(IRBuilder<> &builder);
   virtual void generateEnvVariables(IRBuilder<> &builder);
 
+  /*
+   * Generate code to clear the flags that reducers use to signal each other
+   * that their private copies are final.
+   * This must run before every dispatch of the tasks and after the
+   * environment variables have been generated.
+   */
+  virtual void clearReadyFlagsOfReducers(IRBuilder<> &builder);
+
+  /*
+   * Select how the private copies of the reducable variables are combined.
+   * This must be done before generating the environment variables.
+   */
+  virtual void setReductionStrategy(ReductionStrategy strategy);
+  virtual ReductionStrategy getReductionStrategy(void) const;
+
   /*
    * Reduce live out variables given binary operators to reduce
-   * with and initial values to start at
+   * with and initial values to start at.
+   * Only the private copies of the first "numberOfThreadsExecuted" reducers
+   * are combined.
    */
   virtual BasicBlock *reduceLiveOutVariables(
       BasicBlock *bb,
@@ -89,6 +108,11 @@ public:
   virtual Value *getEnvironmentArray(void) const;
   virtual ArrayType *getEnvironmentArrayType(void) const;
 
+  /*
+   * Placement of the variables inside the environment and its footprint.
+   */
+  virtual const LoopEnvironmentLayout *getLayout(void) const;
+
   virtual LoopEnvironmentUser *getUser(uint32_t user) const;
   virtual uint32_t getNumberOfUsers(void) const;
 
@@ -127,6 +151,8 @@ protected:
   std::unordered_map<uint32_t, std::vector<Value *>> envIndexToReducableVar;
   std::unordered_map<uint32_t, AllocaInst *> envIndexToVectorOfReducableVar;
   uint64_t numReducers;
+  LoopEnvironmentLayout *layout;
+  ReductionStrategy reductionStrategy;
 
   /*
    * Information on a specific user (a function, stage, chunk, etc...)
@@ -135,11 +161,22 @@ protected:
 
   virtual void initializeBuilder(const std::vector<Type *> &varTypes,
                                  const std::set<uint32_t> &singleVarIDs,
+                                 const std::set<uint32_t> &readOnlyVarIDs,
                                  const std::set<uint32_t> &reducableVarIDs,
                                  uint64_t reducerCount,
                                  uint64_t numberOfUsers);
 
   virtual void createUsers(uint32_t numUsers);
+
+  virtual bool canReduceWithVectors(
+      const std::unordered_map<uint32_t, BinaryReductionSCC *> &reductions)
+      const;
+
+  virtual BasicBlock *reduceLiveOutVariablesWithVectors(
+      BasicBlock *bb,
+      const std::unordered_map<uint32_t, BinaryReductionSCC *> &reductions,
+      Value *numberOfThreadsExecuted,
+      std::function<Value *(ReductionSCC *scc)> castingInitialValue);
 };
 
 } // namespace arcana::noelle
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_CORE_LOOP_ENVIRONMENT_LOOPENVIRONMENTLAYOUT_H_
+#define NOELLE_SRC_CORE_LOOP_ENVIRONMENT_LOOPENVIRONMENTLAYOUT_H_
+
+#include "noelle/core/SystemHeaders.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Placement of the environment variables inside the environment array.
+ *
+ * Offsets are expressed in 64-bit values.
+ * The array is organized as follows:
+ * 1) Variables written by tasks (e.g., live-outs, exit block ID): one cache
+ *    line each to avoid false sharing. Their offset is their environment index
+ *    times the number of values per cache line.
+ * 2) Variables only read by tasks (e.g., live-ins, pointers to the reducible
+ *    variables): packed together.
+ *
+ * Private copies of reducible variables are stored in a separate array.
+ * By default, the array is grouped by reducer: all copies that belong to the
+ * same reducer are packed in the same cache line(s), and different reducers
+ * never share a line.
+ * Each reducer also has a flag that signals its copies are final (used when
+ * reducers combine their values in a tree).
+ * Alternatively, the array can be grouped by variable: the copies of a
+ * variable are contiguous (so they can be loaded as a vector), and different
+ * variables never share a line.
+ */
+class LoopEnvironmentLayout {
+public:
+  LoopEnvironmentLayout(const std::vector<uint32_t> &writtenIndices,
+                        const std::vector<uint32_t> &readOnlyIndices,
+                        const std::vector<uint32_t> &reducibleIndices,
+                        uint64_t numberOfReducers,
+                        uint32_t valuesInCacheLine);
+
+  LoopEnvironmentLayout() = delete;
+
+  /*
+   * Add a variable that has its own cache line after all others.
+   */
+  void appendPaddedVariable(uint32_t envIndex);
+
+  bool isPadded(uint32_t envIndex) const;
+
+  uint64_t getOffset(uint32_t envIndex) const;
+
+  uint64_t getNumberOfValues(void) const;
+
+  /*
+   * Private copies of reducible variables.
+   */
+  bool isReducible(uint32_t envIndex) const;
+
+  uint64_t getNumberOfReducers(void) const;
+
+  void groupPrivateCopiesByVariable(void);
+
+  bool arePrivateCopiesGroupedByVariable(void) const;
+
+  /*
+   * Number of values that separate the private copies of a variable that
+   * belong to two consecutive reducers.
+   */
+  uint64_t getReducerStride(void) const;
+
+  /*
+   * Position of the copy of the first reducer.
+   */
+  uint64_t getPositionWithinReducer(uint32_t envIndex) const;
+
+  /*
+   * The following two methods are available only if the private copies are
+   * grouped by reducer.
+   */
+  uint64_t getValuesPerReducer(void) const;
+
+  uint64_t getPositionOfReadyFlagWithinReducer(void) const;
+
+  uint64_t getReducerOffset(uint32_t envIndex, uint64_t reducer) const;
+
+  uint64_t getNumberOfReducerValues(void) const;
+
+  /*
+   * Footprint.
+   */
+  uint64_t getNumberOfCacheLines(void) const;
+
+  uint64_t getNumberOfReducerCacheLines(void) const;
+
+  uint64_t getFootprintInBytes(void) const;
+
+  raw_ostream &print(raw_ostream &stream, std::string prefixToUse) const;
+
+private:
+  uint32_t valuesInCacheLine;
+  uint64_t numberOfValues;
+  uint64_t numberOfReducers;
+  uint64_t valuesPerReducer;
+  bool groupedByVariable;
+  uint64_t valuesPerVariable;
+  std::unordered_map<uint32_t, uint64_t> offsets;
+  std::unordered_set<uint32_t> paddedIndices;
+  std::unordered_map<uint32_t, uint64_t> reducerPositions;
+
+  uint64_t roundUpToCacheLine(uint64_t values) const;
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_CORE_LOOP_ENVIRONMENT_LOOPENVIRONMENTLAYOUT_H_
@@ -23,6 +23,7 @@
 #define NOELLE_SRC_CORE_LOOP_ENVIRONMENT_LOOPENVIRONMENTUSER_H_
 
 #include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopEnvironmentLayout.hpp"
 
 namespace arcana::noelle {
 
@@ -30,6 +31,9 @@ class LoopEnvironmentUser {
 public:
   LoopEnvironmentUser(std::unordered_map<uint32_t, uint32_t> &envIDToIndex);
 
+  LoopEnvironmentUser(std::unordered_map<uint32_t, uint32_t> &envIDToIndex,
+                      const LoopEnvironmentLayout *layout);
+
   LoopEnvironmentUser() = delete;
 
   virtual void setEnvironmentArray(Value *envArr);
@@ -44,6 +48,24 @@ public:
                                      uint32_t reducerCount,
                                      Value *reducerIndV);
 
+  /*
+   * Combine the private copies of the reducable variables of all users
+   * following a binary tree.
+   * User "reducerIndV" waits for the private copies of the users it is
+   * responsible for, accumulates them into its own copies, and then signals its
+   * own parent. At the end, the first user holds the accumulated values.
+   *
+   * All users must run concurrently and the pointers of their private copies
+   * must have been created already (see createReducableEnvPtr).
+   * The code is appended to @bb and the returned basic block is where the
+   * execution continues.
+   */
+  virtual BasicBlock *createTreeReduction(
+      BasicBlock *bb,
+      const std::unordered_map<uint32_t, Instruction::BinaryOps> &reductions,
+      Value *reducerIndV,
+      Value *numberOfReducersV);
+
   virtual void addLiveIn(uint32_t id);
 
   virtual void addLiveOut(uint32_t id);
@@ -68,6 +90,12 @@ protected:
   std::set<uint32_t> liveInIDs;
   std::set<uint32_t> liveOutIDs;
   std::unordered_map<uint32_t, uint32_t> &envIDToIndex;
+  const LoopEnvironmentLayout *layout;
+
+  /*
+   * Offset (in 64-bit values) of a variable within the environment array.
+   */
+  virtual uint64_t getOffsetOfEnvironmentVariable(uint32_t envIndex) const;
 };
 
 } // namespace arcana::noelle
@@ -70,8 +70,11 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
 
   /*
    * Group environment variables into reducable and not.
+   * Moreover, keep track of the variables that tasks only read (i.e., live-ins)
+   * so they can share cache lines.
    */
   std::set<uint32_t> nonReducableVars;
+  std::set<uint32_t> readOnlyVars;
   std::set<uint32_t> reducableVars;
   for (auto liveInVariableID : environment->getEnvIDsOfLiveInVars()) {
     if (shouldThisVariableBeSkipped(liveInVariableID, false)) {
@@ -81,6 +84,7 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
       reducableVars.insert(liveInVariableID);
     } else {
       nonReducableVars.insert(liveInVariableID);
+      readOnlyVars.insert(liveInVariableID);
     }
   }
   for (auto liveOutVariableID : environment->getEnvIDsOfLiveOutVars()) {
@@ -106,6 +110,7 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
    */
   this->initializeBuilder(environment->getTypesOfEnvironmentLocations(),
                           nonReducableVars,
+                          readOnlyVars,
                           reducableVars,
                           reducerCount,
                           numberOfUsers);
@@ -123,10 +128,14 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
   : CXT{ cxt } {
 
   /*
-   * Initialize the builder
+   * Initialize the builder.
+   *
+   * We don't know which variables are only read by the tasks, so all of them
+   * get their own cache line.
    */
   this->initializeBuilder(varTypes,
                           singleVarIDs,
+                          {},
                           reducableVarIDs,
                           reducerCount,
                           numberOfUsers);
@@ -137,22 +146,43 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
 void LoopEnvironmentBuilder::initializeBuilder(
     const std::vector<Type *> &varTypes,
     const std::set<uint32_t> &singleVarIDs,
+    const std::set<uint32_t> &readOnlyVarIDs,
     const std::set<uint32_t> &reducableVarIDs,
     uint64_t reducerCount,
     uint64_t numberOfUsers) {
 
   /*
-   * Build up envID to index map and reverse map
+   * Build up envID to index map and reverse map.
+   *
+   * Variables written by the tasks come first, then those only read, and
+   * finally the reducable ones.
    */
   uint32_t index = 0;
+  std::vector<uint32_t> writtenIndices;
+  std::vector<uint32_t> readOnlyIndices;
+  std::vector<uint32_t> reducableIndices;
+  for (auto singleVarID : singleVarIDs) {
+    if (readOnlyVarIDs.count(singleVarID) > 0) {
+      continue;
+    }
+    this->envIDToIndex[singleVarID] = index;
+    this->indexToEnvID[index] = singleVarID;
+    writtenIndices.push_back(index);
+    index++;
+  }
   for (auto singleVarID : singleVarIDs) {
+    if (readOnlyVarIDs.count(singleVarID) == 0) {
+      continue;
+    }
     this->envIDToIndex[singleVarID] = index;
     this->indexToEnvID[index] = singleVarID;
+    readOnlyIndices.push_back(index);
     index++;
   }
   for (auto reducableVarID : reducableVarIDs) {
     this->envIDToIndex[reducableVarID] = index;
     this->indexToEnvID[index] = reducableVarID;
+    reducableIndices.push_back(index);
     index++;
   }
 
@@ -164,6 +194,7 @@ void LoopEnvironmentBuilder::initializeBuilder(
   this->envSize = singleVarIDs.size() + reducableVarIDs.size();
   this->envArrayType = nullptr;
   this->numReducers = reducerCount;
+  this->reductionStrategy = ReductionStrategy::Serial;
 
   /*
    * Build up partial/all environment types array based on envSize
@@ -180,11 +211,21 @@ void LoopEnvironmentBuilder::initializeBuilder(
    */
   auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
 
+  /*
+   * Place the variables inside the environment.
+   */
+  this->layout = new LoopEnvironmentLayout(writtenIndices,
+                                           readOnlyIndices,
+                                           reducableIndices,
+                                           this->numReducers,
+                                           valuesInCacheLine);
+
   /*
    * Define the LLVM type for the array of environment values.
    */
   auto int64 = IntegerType::get(this->CXT, 64);
-  this->envArrayType = ArrayType::get(int64, this->envSize * valuesInCacheLine);
+  this->envArrayType =
+      ArrayType::get(int64, this->layout->getNumberOfValues());
 
   /*
    * Initialize the index-to-variable map.
@@ -208,7 +249,8 @@ void LoopEnvironmentBuilder::initializeBuilder(
 
 void LoopEnvironmentBuilder::createUsers(uint32_t numUsers) {
   for (auto i = 0u; i < numUsers; ++i) {
-    this->envUsers.push_back(new LoopEnvironmentUser(this->envIDToIndex));
+    this->envUsers.push_back(
+        new LoopEnvironmentUser(this->envIDToIndex, this->layout));
   }
 
   return;
@@ -235,20 +277,22 @@ void LoopEnvironmentBuilder::addVariableToEnvironment(uint64_t varID,
   this->envTypes.push_back(varType);
 
   /*
-   * Compute how many values can fit in a cache line.
+   * We don't know whether tasks will write the new variable.
+   * So, it gets its own cache line.
    */
-  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
+  auto varIndex = this->envIDToIndex[varID];
+  this->layout->appendPaddedVariable(varIndex);
 
   /*
    * Define the LLVM type for the array of environment values.
    */
   auto int64 = IntegerType::get(this->CXT, 64);
-  this->envArrayType = ArrayType::get(int64, this->envSize * valuesInCacheLine);
+  this->envArrayType =
+      ArrayType::get(int64, this->layout->getNumberOfValues());
 
   /*
    * Set the index-to-var map for the new variable.
    */
-  auto varIndex = this->envIDToIndex[varID];
   this->envIndexToVar[varIndex] = nullptr;
 
   return;
@@ -289,20 +333,14 @@ void LoopEnvironmentBuilder::generateEnvVariables(IRBuilder<> &builder) {
   auto int64 = IntegerType::get(builder.getContext(), 64);
   auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
   auto fetchCastedEnvPtr =
-      [&](Value *arr, uint32_t envIndex, Type *ptrType) -> Value * {
+      [&](Value *arr, uint64_t offset, Type *ptrType) -> Value * {
     /*
-     * Compute the offset of the variable with index "envIndex" that is stored
-     * inside the environment.
-     *
-     * Compute how many values can fit in a cache line.
+     * Fetch the offset of the variable that is stored inside the array.
      */
-    auto valuesInCacheLine =
-        Architecture::getCacheLineBytes() / sizeof(int64_t);
-    auto indValue =
-        cast<Value>(ConstantInt::get(int64, envIndex * valuesInCacheLine));
+    auto indValue = cast<Value>(ConstantInt::get(int64, offset));
 
     /*
-     * Compute the address of the variable with index "envIndex".
+     * Compute the address of the variable.
      */
     auto envPtr =
         builder.CreateInBoundsGEP(arr, ArrayRef<Value *>({ zeroV, indValue }));
@@ -327,8 +365,9 @@ void LoopEnvironmentBuilder::generateEnvVariables(IRBuilder<> &builder) {
   }
   for (auto envIndex : singleIndices) {
     auto ptrType = PointerType::getUnqual(this->envTypes[envIndex]);
+    auto offset = this->layout->getOffset(envIndex);
     this->envIndexToVar[envIndex] =
-        fetchCastedEnvPtr(this->envArray, envIndex, ptrType);
+        fetchCastedEnvPtr(this->envArray, offset, ptrType);
   }
 
   /*
@@ -342,6 +381,23 @@ void LoopEnvironmentBuilder::generateEnvVariables(IRBuilder<> &builder) {
   for (auto indexVarPair : this->envIndexToReducableVar) {
     reducableIndices.insert(indexVarPair.first);
   }
+  if (reducableIndices.size() == 0) {
+    return;
+  }
+
+  /*
+   * Allocate the private copies of all reducable variables on the stack.
+   *
+   * The private copies are grouped either by reducer or by variable (see
+   * LoopEnvironmentLayout).
+   */
+  auto reduceArrType =
+      ArrayType::get(int64, this->layout->getNumberOfReducerValues());
+  auto reduceArrAlloca =
+      builder.CreateAlloca(reduceArrType,
+                           nullptr,
+                           "noelle.private_variables_for_all_tasks");
+  reduceArrAlloca->setAlignment(Architecture::getCacheLineBytes());
   for (auto envIndex : reducableIndices) {
 
     /*
@@ -349,38 +405,23 @@ void LoopEnvironmentBuilder::generateEnvVariables(IRBuilder<> &builder) {
      */
     auto varType = this->envTypes[envIndex];
     auto ptrType = PointerType::getUnqual(varType);
-
-    /*
-     * Define the type of the vectorized form of the reducable variable.
-     */
-    auto valuesInCacheLine =
-        Architecture::getCacheLineBytes() / sizeof(int64_t);
-    auto reduceArrType =
-        ArrayType::get(int64, this->numReducers * valuesInCacheLine);
-
-    /*
-     * Allocate the vectorized form of the current reducable variable on the
-     * stack.
-     */
-    auto reduceArrAlloca =
-        builder.CreateAlloca(reduceArrType,
-                             nullptr,
-                             "noelle.private_variable_for_all_tasks");
     this->envIndexToVectorOfReducableVar[envIndex] = reduceArrAlloca;
 
     /*
-     * Store the pointer of the vector of the reducable variable inside the
-     * environment.
+     * Store the pointer of the private copies inside the environment.
      */
     auto reduceArrPtrType = PointerType::getUnqual(reduceArrAlloca->getType());
-    auto envPtr = fetchCastedEnvPtr(this->envArray, envIndex, reduceArrPtrType);
+    auto offset = this->layout->getOffset(envIndex);
+    auto envPtr = fetchCastedEnvPtr(this->envArray, offset, reduceArrPtrType);
     builder.CreateStore(reduceArrAlloca, envPtr);
 
     /*
-     * Compute and cache the pointer of each element of the vectorized variable.
+     * Compute and cache the pointer of each private copy of the variable.
      */
     for (auto i = 0u; i < this->numReducers; ++i) {
-      auto reducePtr = fetchCastedEnvPtr(reduceArrAlloca, i, ptrType);
+      auto reducerOffset = this->layout->getReducerOffset(envIndex, i);
+      auto reducePtr =
+          fetchCastedEnvPtr(reduceArrAlloca, reducerOffset, ptrType);
       this->envIndexToReducableVar[envIndex].push_back(reducePtr);
     }
   }
@@ -388,6 +429,59 @@ void LoopEnvironmentBuilder::generateEnvVariables(IRBuilder<> &builder) {
   return;
 }
 
+void LoopEnvironmentBuilder::clearReadyFlagsOfReducers(IRBuilder<> &builder) {
+
+  /*
+   * Only reducers that combine their private copies in a tree signal each
+   * other when their copies are final.
+   */
+  if (this->reductionStrategy != ReductionStrategy::Tree) {
+    return;
+  }
+  if (this->envIndexToVectorOfReducableVar.size() == 0) {
+    return;
+  }
+
+  /*
+   * Clear the flags.
+   * All reducable variables share the same array of private copies.
+   */
+  auto int64 = IntegerType::get(builder.getContext(), 64);
+  auto int64PtrType = PointerType::getUnqual(int64);
+  auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
+  auto reduceArr = this->envIndexToVectorOfReducableVar.begin()->second;
+  auto flagPosition = this->layout->getPositionOfReadyFlagWithinReducer();
+  for (auto i = 0u; i < this->numReducers; ++i) {
+    auto flagOffset = (i * this->layout->getValuesPerReducer()) + flagPosition;
+    auto flagOffsetValue = cast<Value>(ConstantInt::get(int64, flagOffset));
+    auto flagPtr = builder.CreateInBoundsGEP(
+        reduceArr,
+        ArrayRef<Value *>({ zeroV, flagOffsetValue }));
+    auto flagPtrProperlyCasted = builder.CreateBitCast(flagPtr, int64PtrType);
+    builder.CreateStore(zeroV, flagPtrProperlyCasted);
+  }
+
+  return;
+}
+
+void LoopEnvironmentBuilder::setReductionStrategy(ReductionStrategy strategy) {
+  this->reductionStrategy = strategy;
+
+  /*
+   * Private copies are loaded as a vector only if they are next to each
+   * other.
+   */
+  if (strategy == ReductionStrategy::Vectorized) {
+    this->layout->groupPrivateCopiesByVariable();
+  }
+
+  return;
+}
+
+ReductionStrategy LoopEnvironmentBuilder::getReductionStrategy(void) const {
+  return this->reductionStrategy;
+}
+
 BasicBlock *LoopEnvironmentBuilder::reduceLiveOutVariables(
     BasicBlock *bb,
     IRBuilder<> &builder,
@@ -403,6 +497,21 @@ BasicBlock *LoopEnvironmentBuilder::reduceLiveOutVariables(
     return bb;
   }
 
+  /*
+   * Check if the private copies should be loaded as vectors.
+   *
+   * When tasks combine their private copies in a tree, the caller sets
+   * "numberOfThreadsExecuted" to 1 as only the copy of the first task is left
+   * to walk.
+   */
+  if (true && (this->reductionStrategy == ReductionStrategy::Vectorized)
+      && this->canReduceWithVectors(reductions)) {
+    return this->reduceLiveOutVariablesWithVectors(bb,
+                                                   reductions,
+                                                   numberOfThreadsExecuted,
+                                                   castingInitialValue);
+  }
+
   /*
    * Fetch the function that "bb" belongs to.
    */
@@ -474,9 +583,10 @@ BasicBlock *LoopEnvironmentBuilder::reduceLiveOutVariables(
   }
 
   /*
-   * Compute how many values can fit in a cache line.
+   * Compute how many values separate the private copies of two consecutive
+   * threads.
    */
-  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
+  auto valuesPerReducer = this->layout->getReducerStride();
 
   /*
    * Load the values stored in the private copies of the threads.
@@ -490,11 +600,18 @@ BasicBlock *LoopEnvironmentBuilder::reduceLiveOutVariables(
     /*
      * Compute the pointer of the private copy of the current thread.
      *
-     * First, we compute the offset, which is "index" times 8 because
-     * environment values are 64 byte aligned.
+     * First, we compute the offset, which is "index" times the stride between
+     * reducers plus the position of the copy of the first reducer.
      */
-    auto eightValue = ConstantInt::get(int32Type, valuesInCacheLine);
-    auto offsetValue = loopBodyBuilder.CreateMul(IVReductionLoop, eightValue);
+    auto strideValue = ConstantInt::get(int32Type, valuesPerReducer);
+    Value *offsetValue =
+        loopBodyBuilder.CreateMul(IVReductionLoop, strideValue);
+    auto position = this->layout->getPositionWithinReducer(envIndex);
+    if (position > 0) {
+      offsetValue =
+          loopBodyBuilder.CreateAdd(offsetValue,
+                                    ConstantInt::get(int32Type, position));
+    }
 
     /*
      * Now, we compute the effective address.
@@ -611,6 +728,169 @@ BasicBlock *LoopEnvironmentBuilder::reduceLiveOutVariables(
   return afterReductionBB;
 }
 
+bool LoopEnvironmentBuilder::canReduceWithVectors(
+    const std::unordered_map<uint32_t, BinaryReductionSCC *> &reductions)
+    const {
+
+  /*
+   * Private copies of threads that did not run are replaced by the identity
+   * value of the reduction.
+   * So, we need the identity to be a constant of the type of the variable.
+   *
+   * Moreover, the private copies of a variable are loaded as a vector, so they
+   * must fill their 64-bit slots and the reduction must have an intrinsic.
+   */
+  for (auto envIDReduction : reductions) {
+    auto envID = envIDReduction.first;
+    auto envIndex = this->envIDToIndex.at(envID);
+    auto varType = this->envTypes[envIndex];
+    if (false || (!VectorType::isValidElementType(varType))
+        || (varType->getPrimitiveSizeInBits() != 64)) {
+      return false;
+    }
+    auto identity = envIDReduction.second->getIdentityValue();
+    if ((identity == nullptr) || (!isa<Constant>(identity))
+        || (identity->getType() != varType)) {
+      return false;
+    }
+    switch (envIDReduction.second->getReductionOperation()) {
+      case Instruction::Add:
+      case Instruction::Mul:
+      case Instruction::And:
+      case Instruction::Or:
+      case Instruction::Xor:
+      case Instruction::FAdd:
+      case Instruction::FMul:
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+BasicBlock *LoopEnvironmentBuilder::reduceLiveOutVariablesWithVectors(
+    BasicBlock *bb,
+    const std::unordered_map<uint32_t, BinaryReductionSCC *> &reductions,
+    Value *numberOfThreadsExecuted,
+    std::function<Value *(ReductionSCC *scc)> castingInitialValue) {
+  assert(this->layout->arePrivateCopiesGroupedByVariable());
+
+  /*
+   * Create a new basic block that will include the code after the reduction.
+   */
+  auto f = bb->getParent();
+  assert(f != nullptr);
+  auto afterReductionBB = BasicBlock::Create(this->CXT, "AfterReduction", f);
+
+  /*
+   * The reduction is appended to "bb".
+   */
+  auto bbTerminator = bb->getTerminator();
+  if (bbTerminator != nullptr) {
+    bbTerminator->eraseFromParent();
+  }
+  IRBuilder<> reductionBuilder{ bb };
+
+  /*
+   * Compute which lanes belong to threads that have executed.
+   */
+  auto lanes = this->numReducers;
+  auto int64Type = IntegerType::get(this->CXT, 64);
+  auto zeroV = cast<Value>(ConstantInt::get(int64Type, 0));
+  auto threadsExecuted =
+      reductionBuilder.CreateZExtOrTrunc(numberOfThreadsExecuted, int64Type);
+  std::vector<Constant *> laneIDs;
+  for (auto i = 0u; i < lanes; ++i) {
+    laneIDs.push_back(ConstantInt::get(int64Type, i));
+  }
+  auto hasExecuted = reductionBuilder.CreateICmpULT(
+      ConstantVector::get(laneIDs),
+      reductionBuilder.CreateVectorSplat(lanes, threadsExecuted));
+
+  for (auto envIDReduction : reductions) {
+    auto envID = envIDReduction.first;
+    auto envIndex = this->envIDToIndex[envID];
+    auto red = envIDReduction.second;
+    auto binOp = red->getReductionOperation();
+    auto identity = red->getIdentityValue();
+    auto varType = this->envTypes[envIndex];
+    auto vectorType = VectorType::get(varType, lanes);
+    auto vectorPtrType = PointerType::getUnqual(vectorType);
+
+    /*
+     * Load the private copies of all threads with a single vector load.
+     * The copies of a variable are next to each other and they start at the
+     * beginning of a cache line (see LoopEnvironmentLayout).
+     */
+    auto baseAddressOfReducedVar =
+        this->envIndexToVectorOfReducableVar.at(envIndex);
+    auto offset = this->layout->getReducerOffset(envIndex, 0);
+    auto offsetValue = cast<Value>(ConstantInt::get(int64Type, offset));
+    auto privateCopiesPtr = reductionBuilder.CreateInBoundsGEP(
+        baseAddressOfReducedVar,
+        ArrayRef<Value *>({ zeroV, offsetValue }));
+    auto privateCopiesPtrProperlyCasted =
+        reductionBuilder.CreateBitCast(privateCopiesPtr, vectorPtrType);
+    auto privateCopies =
+        reductionBuilder.CreateAlignedLoad(privateCopiesPtrProperlyCasted,
+                                           Architecture::getCacheLineBytes());
+
+    /*
+     * Lanes of threads that did not execute hold the identity value.
+     */
+    auto identities = reductionBuilder.CreateVectorSplat(lanes, identity);
+    auto lanesToReduce =
+        reductionBuilder.CreateSelect(hasExecuted, privateCopies, identities);
+
+    /*
+     * Combine the lanes and the initial value.
+     */
+    auto initialValue = castingInitialValue(red);
+    Value *accumulatedValue = nullptr;
+    switch (binOp) {
+      case Instruction::FAdd:
+        accumulatedValue =
+            reductionBuilder.CreateFAddReduce(initialValue, lanesToReduce);
+        break;
+      case Instruction::FMul:
+        accumulatedValue =
+            reductionBuilder.CreateFMulReduce(initialValue, lanesToReduce);
+        break;
+      default: {
+        Value *reducedValue = nullptr;
+        switch (binOp) {
+          case Instruction::Add:
+            reducedValue = reductionBuilder.CreateAddReduce(lanesToReduce);
+            break;
+          case Instruction::Mul:
+            reducedValue = reductionBuilder.CreateMulReduce(lanesToReduce);
+            break;
+          case Instruction::And:
+            reducedValue = reductionBuilder.CreateAndReduce(lanesToReduce);
+            break;
+          case Instruction::Or:
+            reducedValue = reductionBuilder.CreateOrReduce(lanesToReduce);
+            break;
+          case Instruction::Xor:
+            reducedValue = reductionBuilder.CreateXorReduce(lanesToReduce);
+            break;
+          default:
+            abort();
+        }
+        accumulatedValue =
+            reductionBuilder.CreateBinOp(binOp, initialValue, reducedValue);
+        break;
+      }
+    }
+    this->envIndexToAccumulatedReducableVar[envIndex] = accumulatedValue;
+  }
+  reductionBuilder.CreateBr(afterReductionBB);
+
+  return afterReductionBB;
+}
+
 Value *LoopEnvironmentBuilder::getEnvironmentArrayVoidPtr(void) const {
   assert(this->envArrayInt8Ptr != nullptr);
 
@@ -713,9 +993,14 @@ ArrayType *LoopEnvironmentBuilder::getEnvironmentArrayType(void) const {
   return envArrayType;
 }
 
+const LoopEnvironmentLayout *LoopEnvironmentBuilder::getLayout(void) const {
+  return this->layout;
+}
+
 LoopEnvironmentBuilder::~LoopEnvironmentBuilder() {
   for (auto user : envUsers)
     delete user;
+  delete this->layout;
 }
 
 } // namespace arcana::noelle
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopEnvironmentLayout.hpp"
+
+namespace arcana::noelle {
+
+LoopEnvironmentLayout::LoopEnvironmentLayout(
+    const std::vector<uint32_t> &writtenIndices,
+    const std::vector<uint32_t> &readOnlyIndices,
+    const std::vector<uint32_t> &reducibleIndices,
+    uint64_t numberOfReducers,
+    uint32_t valuesInCacheLine)
+  : valuesInCacheLine{ valuesInCacheLine },
+    numberOfValues{ 0 },
+    numberOfReducers{ numberOfReducers },
+    valuesPerReducer{ 0 },
+    groupedByVariable{ false },
+    valuesPerVariable{ 0 } {
+  assert(this->valuesInCacheLine > 0);
+
+  /*
+   * Variables written by tasks come first, one per cache line.
+   *
+   * The offset of these variables must be their index times the cache line
+   * (see Linker).
+   */
+  for (auto envIndex : writtenIndices) {
+    assert(envIndex == (this->numberOfValues / this->valuesInCacheLine));
+    this->offsets[envIndex] = this->numberOfValues;
+    this->paddedIndices.insert(envIndex);
+    this->numberOfValues += this->valuesInCacheLine;
+  }
+
+  /*
+   * Variables only read by tasks are packed.
+   * Pointers to the reducible variables belong to this group.
+   */
+  for (auto envIndex : readOnlyIndices) {
+    this->offsets[envIndex] = this->numberOfValues;
+    this->numberOfValues++;
+  }
+  for (auto envIndex : reducibleIndices) {
+    this->offsets[envIndex] = this->numberOfValues;
+    this->numberOfValues++;
+  }
+  this->numberOfValues = this->roundUpToCacheLine(this->numberOfValues);
+
+  /*
+   * Private copies of reducible variables are grouped by reducer.
+   * The ready flag of a reducer follows its private copies.
+   */
+  uint64_t position = 0;
+  for (auto envIndex : reducibleIndices) {
+    this->reducerPositions[envIndex] = position;
+    position++;
+  }
+  if (position > 0) {
+    this->valuesPerReducer = this->roundUpToCacheLine(position + 1);
+  }
+
+  return;
+}
+
+void LoopEnvironmentLayout::appendPaddedVariable(uint32_t envIndex) {
+  assert(this->offsets.find(envIndex) == this->offsets.end());
+
+  this->offsets[envIndex] = this->numberOfValues;
+  this->paddedIndices.insert(envIndex);
+  this->numberOfValues += this->valuesInCacheLine;
+
+  return;
+}
+
+bool LoopEnvironmentLayout::isPadded(uint32_t envIndex) const {
+  return this->paddedIndices.find(envIndex) != this->paddedIndices.end();
+}
+
+uint64_t LoopEnvironmentLayout::getOffset(uint32_t envIndex) const {
+  assert(this->offsets.find(envIndex) != this->offsets.end()
+         && "The environment variable is not included in the layout\n");
+
+  return this->offsets.at(envIndex);
+}
+
+uint64_t LoopEnvironmentLayout::getNumberOfValues(void) const {
+  return this->numberOfValues;
+}
+
+bool LoopEnvironmentLayout::isReducible(uint32_t envIndex) const {
+  return this->reducerPositions.find(envIndex) != this->reducerPositions.end();
+}
+
+uint64_t LoopEnvironmentLayout::getNumberOfReducers(void) const {
+  return this->numberOfReducers;
+}
+
+void LoopEnvironmentLayout::groupPrivateCopiesByVariable(void) {
+
+  /*
+   * The copies of a variable are contiguous.
+   * Each variable starts from its own cache line.
+   */
+  this->groupedByVariable = true;
+  this->valuesPerVariable = this->roundUpToCacheLine(this->numberOfReducers);
+
+  return;
+}
+
+bool LoopEnvironmentLayout::arePrivateCopiesGroupedByVariable(void) const {
+  return this->groupedByVariable;
+}
+
+uint64_t LoopEnvironmentLayout::getReducerStride(void) const {
+  if (this->groupedByVariable) {
+    return 1;
+  }
+
+  return this->valuesPerReducer;
+}
+
+uint64_t LoopEnvironmentLayout::getValuesPerReducer(void) const {
+  assert(!this->groupedByVariable);
+
+  return this->valuesPerReducer;
+}
+
+uint64_t LoopEnvironmentLayout::getPositionWithinReducer(
+    uint32_t envIndex) const {
+  assert(this->isReducible(envIndex));
+
+  /*
+   * When the private copies are grouped by variable, the position is the one
+   * of the copy of the first reducer.
+   */
+  auto position = this->reducerPositions.at(envIndex);
+  if (this->groupedByVariable) {
+    return position * this->valuesPerVariable;
+  }
+
+  return position;
+}
+
+uint64_t LoopEnvironmentLayout::getPositionOfReadyFlagWithinReducer(
+    void) const {
+  assert(!this->groupedByVariable);
+  assert(this->reducerPositions.size() > 0);
+
+  return this->reducerPositions.size();
+}
+
+uint64_t LoopEnvironmentLayout::getReducerOffset(uint32_t envIndex,
+                                                 uint64_t reducer) const {
+  assert(reducer < this->numberOfReducers);
+
+  auto offset = (reducer * this->getReducerStride())
+                + this->getPositionWithinReducer(envIndex);
+
+  return offset;
+}
+
+uint64_t LoopEnvironmentLayout::getNumberOfReducerValues(void) const {
+  if (this->groupedByVariable) {
+    return this->reducerPositions.size() * this->valuesPerVariable;
+  }
+
+  return this->numberOfReducers * this->valuesPerReducer;
+}
+
+uint64_t LoopEnvironmentLayout::getNumberOfCacheLines(void) const {
+  return this->numberOfValues / this->valuesInCacheLine;
+}
+
+uint64_t LoopEnvironmentLayout::getNumberOfReducerCacheLines(void) const {
+  return this->getNumberOfReducerValues() / this->valuesInCacheLine;
+}
+
+uint64_t LoopEnvironmentLayout::getFootprintInBytes(void) const {
+  auto values = this->numberOfValues + this->getNumberOfReducerValues();
+
+  return values * sizeof(int64_t);
+}
+
+raw_ostream &LoopEnvironmentLayout::print(raw_ostream &stream,
+                                          std::string prefixToUse) const {
+  auto readOnly = this->offsets.size() - this->paddedIndices.size();
+  stream << prefixToUse << "Environment layout\n";
+  stream << prefixToUse << "  Padded variables: " << this->paddedIndices.size()
+         << "\n";
+  stream << prefixToUse << "  Packed variables: " << readOnly << "\n";
+  stream << prefixToUse << "  Reducible variables: "
+         << this->reducerPositions.size() << " (" << this->numberOfReducers
+         << " reducers)\n";
+  stream << prefixToUse << "  Cache lines: " << this->getNumberOfCacheLines()
+         << " for the environment, " << this->getNumberOfReducerCacheLines()
+         << " for the reducers\n";
+  stream << prefixToUse << "  Footprint: " << this->getFootprintInBytes()
+         << " bytes\n";
+
+  return stream;
+}
+
+uint64_t LoopEnvironmentLayout::roundUpToCacheLine(uint64_t values) const {
+  auto lines = (values + this->valuesInCacheLine - 1) / this->valuesInCacheLine;
+
+  return lines * this->valuesInCacheLine;
+}
+
+} // namespace arcana::noelle
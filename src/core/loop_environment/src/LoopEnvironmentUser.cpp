@@ -26,10 +26,19 @@ namespace arcana::noelle {
 
 LoopEnvironmentUser::LoopEnvironmentUser(
     std::unordered_map<uint32_t, uint32_t> &envIDToIndex)
+  : LoopEnvironmentUser{ envIDToIndex, nullptr } {
+
+  return;
+}
+
+LoopEnvironmentUser::LoopEnvironmentUser(
+    std::unordered_map<uint32_t, uint32_t> &envIDToIndex,
+    const LoopEnvironmentLayout *layout)
   : envIndexToPtr{},
     liveInIDs{},
     liveOutIDs{},
-    envIDToIndex{ envIDToIndex } {
+    envIDToIndex{ envIDToIndex },
+    layout{ layout } {
   envIndexToPtr.clear();
   liveInIDs.clear();
   liveOutIDs.clear();
@@ -70,16 +79,11 @@ Instruction *LoopEnvironmentUser::createEnvironmentVariablePointer(
   auto int64 = IntegerType::get(builder.getContext(), 64);
   auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
 
-  /*
-   * Compute how many values can fit in a cache line.
-   */
-  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
-
   /*
    * Compute the offset of the environment variable.
    */
-  auto envIndV =
-      cast<Value>(ConstantInt::get(int64, envIndex * valuesInCacheLine));
+  auto envOffset = this->getOffsetOfEnvironmentVariable(envIndex);
+  auto envIndV = cast<Value>(ConstantInt::get(int64, envOffset));
 
   /*
    * Compute the address of the environment variable
@@ -121,22 +125,41 @@ void LoopEnvironmentUser::createReducableEnvPtr(IRBuilder<> &builder,
    */
   auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
 
+  /*
+   * Compute how many values separate the private copies of two consecutive
+   * reducers and where the copy of the first reducer is.
+   *
+   * Without a layout, each reducible variable has its own array with one cache
+   * line per reducer.
+   */
+  uint64_t valuesPerReducer = valuesInCacheLine;
+  uint64_t positionWithinReducer = 0;
+  uint64_t reducerValues = reducerCount * valuesPerReducer;
+  if (this->layout != nullptr) {
+    valuesPerReducer = this->layout->getReducerStride();
+    positionWithinReducer = this->layout->getPositionWithinReducer(envIndex);
+    reducerValues = this->layout->getNumberOfReducerValues();
+  }
+
   auto int64 = IntegerType::get(builder.getContext(), 64);
   auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
-  auto envIndV =
-      cast<Value>(ConstantInt::get(int64, envIndex * valuesInCacheLine));
+  auto envOffset = this->getOffsetOfEnvironmentVariable(envIndex);
+  auto envIndV = cast<Value>(ConstantInt::get(int64, envOffset));
 
   auto envReduceGEP =
       builder.CreateInBoundsGEP(this->envArray,
                                 ArrayRef<Value *>({ zeroV, envIndV }));
-  auto arrPtr = PointerType::getUnqual(
-      ArrayType::get(int64, reducerCount * valuesInCacheLine));
+  auto arrPtr = PointerType::getUnqual(ArrayType::get(int64, reducerValues));
   auto envReducePtr =
       builder.CreateBitCast(envReduceGEP, PointerType::getUnqual(arrPtr));
 
   auto reduceIndAlignedV =
-      builder.CreateMul(reducerIndV,
-                        ConstantInt::get(int64, valuesInCacheLine));
+      builder.CreateMul(reducerIndV, ConstantInt::get(int64, valuesPerReducer));
+  if (positionWithinReducer > 0) {
+    reduceIndAlignedV =
+        builder.CreateAdd(reduceIndAlignedV,
+                          ConstantInt::get(int64, positionWithinReducer));
+  }
   auto envGEP = builder.CreateInBoundsGEP(
       builder.CreateLoad(envReducePtr),
       ArrayRef<Value *>({ zeroV, reduceIndAlignedV }));
@@ -145,6 +168,151 @@ void LoopEnvironmentUser::createReducableEnvPtr(IRBuilder<> &builder,
   this->envIndexToPtr[envIndex] = cast<Instruction>(envPtr);
 }
 
+BasicBlock *LoopEnvironmentUser::createTreeReduction(
+    BasicBlock *bb,
+    const std::unordered_map<uint32_t, Instruction::BinaryOps> &reductions,
+    Value *reducerIndV,
+    Value *numberOfReducersV) {
+  assert(bb != nullptr);
+  assert(this->layout != nullptr);
+
+  /*
+   * Check if there is something to reduce.
+   */
+  if (reductions.size() == 0) {
+    return bb;
+  }
+
+  /*
+   * Fetch the function that "bb" belongs to.
+   */
+  auto f = bb->getParent();
+  assert(f != nullptr);
+  auto &cxt = f->getContext();
+
+  /*
+   * Create the basic blocks of the tree reduction.
+   */
+  auto levelBB = BasicBlock::Create(cxt, "TreeReductionLevel", f);
+  auto checkChildBB = BasicBlock::Create(cxt, "TreeReductionCheckChild", f);
+  auto waitBB = BasicBlock::Create(cxt, "TreeReductionWait", f);
+  auto combineBB = BasicBlock::Create(cxt, "TreeReductionCombine", f);
+  auto nextLevelBB = BasicBlock::Create(cxt, "TreeReductionNextLevel", f);
+  auto signalBB = BasicBlock::Create(cxt, "TreeReductionSignal", f);
+  auto afterReductionBB = BasicBlock::Create(cxt, "AfterTreeReduction", f);
+
+  /*
+   * Fetch the base address of the private copies of all users.
+   * The environment stores it in the location of every reducable variable.
+   */
+  auto bbTerminator = bb->getTerminator();
+  if (bbTerminator != nullptr) {
+    bbTerminator->eraseFromParent();
+  }
+  IRBuilder<> bbBuilder{ bb };
+  auto int64 = IntegerType::get(cxt, 64);
+  auto int64PtrType = PointerType::getUnqual(int64);
+  auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
+  auto oneV = cast<Value>(ConstantInt::get(int64, 1));
+  auto firstEnvIndex = this->envIDToIndex.at(reductions.begin()->first);
+  auto envOffset = this->getOffsetOfEnvironmentVariable(firstEnvIndex);
+  auto envReduceGEP = bbBuilder.CreateInBoundsGEP(
+      this->envArray,
+      ArrayRef<Value *>({ zeroV, ConstantInt::get(int64, envOffset) }));
+  auto envReducePtr =
+      bbBuilder.CreateBitCast(envReduceGEP,
+                              PointerType::getUnqual(int64PtrType));
+  auto privateCopies = bbBuilder.CreateLoad(envReducePtr);
+  auto reducer = bbBuilder.CreateZExtOrTrunc(reducerIndV, int64);
+  auto reducers = bbBuilder.CreateZExtOrTrunc(numberOfReducersV, int64);
+  bbBuilder.CreateBr(levelBB);
+
+  /*
+   * Compute the address of a value that belongs to a given reducer.
+   */
+  auto valuesPerReducer = this->layout->getValuesPerReducer();
+  auto fetchPrivateCopyPtr = [&](IRBuilder<> &builder,
+                                 Value *reducerV,
+                                 uint64_t position,
+                                 Type *type) -> Value * {
+    auto offset =
+        builder.CreateMul(reducerV, ConstantInt::get(int64, valuesPerReducer));
+    offset = builder.CreateAdd(offset, ConstantInt::get(int64, position));
+    auto ptr =
+        builder.CreateInBoundsGEP(privateCopies, ArrayRef<Value *>({ offset }));
+    return builder.CreateBitCast(ptr, PointerType::getUnqual(type));
+  };
+  auto flagPosition = this->layout->getPositionOfReadyFlagWithinReducer();
+
+  /*
+   * At each level, a reducer either signals its parent and stops, or it
+   * accumulates the values of its child (if it exists).
+   */
+  IRBuilder<> levelBuilder{ levelBB };
+  auto stride = levelBuilder.CreatePHI(int64, 2);
+  stride->addIncoming(oneV, bb);
+  auto strideBit = levelBuilder.CreateAnd(reducer, stride);
+  auto isChild = levelBuilder.CreateICmpNE(strideBit, zeroV);
+  levelBuilder.CreateCondBr(isChild, signalBB, checkChildBB);
+
+  IRBuilder<> checkChildBuilder{ checkChildBB };
+  auto child = checkChildBuilder.CreateAdd(reducer, stride);
+  auto childExists = checkChildBuilder.CreateICmpULT(child, reducers);
+  checkChildBuilder.CreateCondBr(childExists, waitBB, nextLevelBB);
+
+  /*
+   * Wait for the values of the child to be final.
+   */
+  IRBuilder<> waitBuilder{ waitBB };
+  auto childFlagPtr =
+      fetchPrivateCopyPtr(waitBuilder, child, flagPosition, int64);
+  auto childFlag = waitBuilder.CreateAlignedLoad(childFlagPtr, 8);
+  childFlag->setAtomic(AtomicOrdering::Acquire);
+  auto isChildDone = waitBuilder.CreateICmpNE(childFlag, zeroV);
+  waitBuilder.CreateCondBr(isChildDone, combineBB, waitBB);
+
+  /*
+   * Accumulate the values of the child.
+   */
+  IRBuilder<> combineBuilder{ combineBB };
+  for (auto reduction : reductions) {
+    auto envID = reduction.first;
+    auto binOp = reduction.second;
+    auto envIndex = this->envIDToIndex.at(envID);
+    auto myPtr = this->getEnvPtr(envID);
+    auto varType = cast<PointerType>(myPtr->getType())->getElementType();
+    auto position = this->layout->getPositionWithinReducer(envIndex);
+    auto childPtr =
+        fetchPrivateCopyPtr(combineBuilder, child, position, varType);
+    auto myValue = combineBuilder.CreateLoad(myPtr);
+    auto childValue = combineBuilder.CreateLoad(childPtr);
+    auto newValue = combineBuilder.CreateBinOp(binOp, myValue, childValue);
+    combineBuilder.CreateStore(newValue, myPtr);
+  }
+  combineBuilder.CreateBr(nextLevelBB);
+
+  /*
+   * Move to the next level of the tree.
+   */
+  IRBuilder<> nextLevelBuilder{ nextLevelBB };
+  auto nextStride = nextLevelBuilder.CreateShl(stride, oneV);
+  stride->addIncoming(nextStride, nextLevelBB);
+  auto isLastLevel = nextLevelBuilder.CreateICmpUGE(nextStride, reducers);
+  nextLevelBuilder.CreateCondBr(isLastLevel, afterReductionBB, levelBB);
+
+  /*
+   * Signal the parent that the values of this reducer are final.
+   */
+  IRBuilder<> signalBuilder{ signalBB };
+  auto myFlagPtr =
+      fetchPrivateCopyPtr(signalBuilder, reducer, flagPosition, int64);
+  auto signal = signalBuilder.CreateAlignedStore(oneV, myFlagPtr, 8);
+  signal->setAtomic(AtomicOrdering::Release);
+  signalBuilder.CreateBr(afterReductionBB);
+
+  return afterReductionBB;
+}
+
 void LoopEnvironmentUser::addLiveIn(uint32_t id) {
   if (this->envIDToIndex.find(id) != this->envIDToIndex.end()) {
     liveInIDs.insert(id);
@@ -186,6 +354,20 @@ iterator_range<std::set<uint32_t>::iterator> LoopEnvironmentUser::
   return make_range(liveOutIDs.begin(), liveOutIDs.end());
 }
 
+uint64_t LoopEnvironmentUser::getOffsetOfEnvironmentVariable(
+    uint32_t envIndex) const {
+  if (this->layout != nullptr) {
+    return this->layout->getOffset(envIndex);
+  }
+
+  /*
+   * Without a layout, every variable has its own cache line.
+   */
+  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
+
+  return envIndex * valuesInCacheLine;
+}
+
 LoopEnvironmentUser::~LoopEnvironmentUser() {
   return;
 }
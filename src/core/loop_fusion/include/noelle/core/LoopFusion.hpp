@@ -0,0 +1,124 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_CORE_LOOP_FUSION_LOOPFUSION_H_
+#define NOELLE_SRC_CORE_LOOP_FUSION_LOOPFUSION_H_
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/PDG.hpp"
+#include "noelle/core/Dominators.hpp"
+#include "noelle/core/LoopContent.hpp"
+#include "noelle/core/Hot.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Fusion of two adjacent loops: the loop that follows another one becomes the
+ * continuation of the body of the latter.
+ *
+ * This is the opposite of loop distribution: it trades the parallelism of the
+ * two loops for the locality of the data they share.
+ */
+class LoopFusion {
+public:
+  /*
+   * Constructor
+   */
+  LoopFusion();
+
+  /*
+   * Check whether @second can be fused into @first.
+   *
+   * The two loops must be adjacent (the exit of @first is the pre-header of
+   * @second), they must be control-flow equivalent, they must execute the same
+   * number of iterations, and no dependence between them can be reversed by
+   * executing the iteration i of @second before the iteration i+1 of @first.
+   */
+  bool canFuseLoops(LoopContent &first,
+                    LoopContent &second,
+                    PDG &dg,
+                    DominatorSummary &DS,
+                    LoopInfo &LI,
+                    ScalarEvolution &SE) const;
+
+  /*
+   * Fuse @second into @first.
+   *
+   * The fused loop keeps the header (and therefore the ID) of @first.
+   * The instructions removed are added to @instructionsRemoved (they are
+   * erased), the instructions added are added to @instructionsAdded, and the
+   * instructions between the two loops, which are hoisted to the pre-header of
+   * @first, are added to @instructionsMoved.
+   * @LI is not updated.
+   */
+  bool fuseLoops(LoopContent &first,
+                 LoopContent &second,
+                 PDG &dg,
+                 DominatorSummary &DS,
+                 LoopInfo &LI,
+                 ScalarEvolution &SE,
+                 std::set<Instruction *> &instructionsRemoved,
+                 std::set<Instruction *> &instructionsAdded,
+                 std::set<Instruction *> &instructionsMoved);
+
+  /*
+   * Estimate the bytes that @second does not need to bring back from memory
+   * once fused with @first: these are the bytes @second accesses of the
+   * objects that @first accesses as well.
+   *
+   * The estimate uses the number of executions of the accesses of @second
+   * measured by @profiles, and it is 0 if profiles are not available.
+   */
+  uint64_t estimateBytesSaved(LoopContent &first,
+                              LoopContent &second,
+                              ScalarEvolution &SE,
+                              Hot &profiles) const;
+
+private:
+  bool areAdjacent(LoopStructure *first, LoopStructure *second) const;
+
+  bool haveTheSameTripCount(LoopContent &first,
+                            LoopContent &second,
+                            LoopInfo &LI,
+                            ScalarEvolution &SE) const;
+
+  bool hasLiveOuts(LoopStructure *loop) const;
+
+  bool hasFusionPreventingDependences(LoopContent &first,
+                                      LoopContent &second,
+                                      PDG &dg,
+                                      LoopInfo &LI,
+                                      ScalarEvolution &SE) const;
+
+  bool isFusionPreventing(Instruction *accessOfFirst,
+                          Loop *first,
+                          Instruction *accessOfSecond,
+                          Loop *second,
+                          ScalarEvolution &SE) const;
+
+  Value *getPointerOperandOfAccess(Instruction *i) const;
+
+  uint64_t getSizeOfAccess(Instruction *i) const;
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_CORE_LOOP_FUSION_LOOPFUSION_H_
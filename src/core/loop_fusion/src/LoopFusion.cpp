@@ -0,0 +1,552 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/ControlFlowEquivalence.hpp"
+#include "noelle/core/LoopFusion.hpp"
+
+namespace arcana::noelle {
+
+LoopFusion::LoopFusion() {
+  return;
+}
+
+bool LoopFusion::canFuseLoops(LoopContent &first,
+                              LoopContent &second,
+                              PDG &dg,
+                              DominatorSummary &DS,
+                              LoopInfo &LI,
+                              ScalarEvolution &SE) const {
+
+  /*
+   * Fetch the loops.
+   */
+  auto firstLS = first.getLoopStructure();
+  auto secondLS = second.getLoopStructure();
+  if (firstLS->getFunction() != secondLS->getFunction()) {
+    return false;
+  }
+
+  /*
+   * Check the second loop starts right after the first one ends.
+   */
+  if (!this->areAdjacent(firstLS, secondLS)) {
+    return false;
+  }
+
+  /*
+   * Check the values computed by the first loop are not used after it.
+   * Otherwise, the second loop would observe them while the first loop is
+   * still running.
+   */
+  if (this->hasLiveOuts(firstLS)) {
+    return false;
+  }
+
+  /*
+   * Check the two loops are control-flow equivalent: every time the first
+   * loop is executed, the second loop is executed as well and vice versa.
+   */
+  auto firstPreHeader = firstLS->getPreHeader();
+  auto secondPreHeader = secondLS->getPreHeader();
+  if (LI.getLoopFor(firstPreHeader) != LI.getLoopFor(secondPreHeader)) {
+    return false;
+  }
+  ControlFlowEquivalence cfe(&DS,
+                             first.getLoopHierarchyStructures(),
+                             *firstLS->getFunction());
+  if (cfe.getEquivalences(firstPreHeader).count(secondPreHeader) == 0) {
+    return false;
+  }
+
+  /*
+   * Check the two loops execute the same number of iterations.
+   */
+  if (!this->haveTheSameTripCount(first, second, LI, SE)) {
+    return false;
+  }
+
+  /*
+   * Check the fusion preserves the dependences between the two loops.
+   */
+  if (this->hasFusionPreventingDependences(first, second, dg, LI, SE)) {
+    return false;
+  }
+
+  return true;
+}
+
+bool LoopFusion::fuseLoops(LoopContent &first,
+                           LoopContent &second,
+                           PDG &dg,
+                           DominatorSummary &DS,
+                           LoopInfo &LI,
+                           ScalarEvolution &SE,
+                           std::set<Instruction *> &instructionsRemoved,
+                           std::set<Instruction *> &instructionsAdded,
+                           std::set<Instruction *> &instructionsMoved) {
+
+  /*
+   * Check if the loops can be fused.
+   */
+  if (!this->canFuseLoops(first, second, dg, DS, LI, SE)) {
+    return false;
+  }
+
+  /*
+   * Fetch the basic blocks involved.
+   * The exit block of the first loop is the pre-header of the second one.
+   */
+  auto firstLS = first.getLoopStructure();
+  auto secondLS = second.getLoopStructure();
+  auto firstPreHeader = firstLS->getPreHeader();
+  auto firstHeader = firstLS->getHeader();
+  auto firstLatch = *firstLS->getLatches().begin();
+  auto middle = secondLS->getPreHeader();
+  auto secondHeader = secondLS->getHeader();
+  auto secondLatch = *secondLS->getLatches().begin();
+
+  /*
+   * Hoist the code between the two loops to the pre-header of the first loop.
+   */
+  std::vector<Instruction *> instructionsToHoist;
+  for (auto &inst : *middle) {
+    if (inst.isTerminator()) {
+      continue;
+    }
+    instructionsToHoist.push_back(&inst);
+  }
+  auto firstPreHeaderTerminator = firstPreHeader->getTerminator();
+  for (auto inst : instructionsToHoist) {
+    inst->moveBefore(firstPreHeaderTerminator);
+    instructionsMoved.insert(inst);
+  }
+
+  /*
+   * Fetch the PHIs of the header of the first loop before adding the ones of
+   * the second loop.
+   */
+  std::vector<PHINode *> firstPHIs;
+  for (auto &phi : firstHeader->phis()) {
+    firstPHIs.push_back(&phi);
+  }
+
+  /*
+   * Move the PHIs of the header of the second loop to the header of the first
+   * loop.
+   * Their initial values are now available in the pre-header of the first
+   * loop.
+   */
+  std::vector<PHINode *> secondPHIs;
+  for (auto &phi : secondHeader->phis()) {
+    secondPHIs.push_back(&phi);
+  }
+  auto firstHeaderInsertionPoint = firstHeader->getFirstNonPHI();
+  for (auto phi : secondPHIs) {
+    auto fusedPHI = PHINode::Create(phi->getType(),
+                                    2,
+                                    phi->getName(),
+                                    firstHeaderInsertionPoint);
+    fusedPHI->addIncoming(phi->getIncomingValueForBlock(middle),
+                          firstPreHeader);
+    fusedPHI->addIncoming(phi->getIncomingValueForBlock(secondLatch),
+                          secondLatch);
+    phi->replaceAllUsesWith(fusedPHI);
+    instructionsAdded.insert(fusedPHI);
+
+    instructionsRemoved.insert(phi);
+    phi->eraseFromParent();
+  }
+
+  /*
+   * The latch of the second loop is now the latch of the fused loop.
+   */
+  for (auto phi : firstPHIs) {
+    auto latchIndex = phi->getBasicBlockIndex(firstLatch);
+    phi->setIncomingBlock(latchIndex, secondLatch);
+  }
+  auto secondLatchTerminator = secondLatch->getTerminator();
+  secondLatchTerminator->replaceUsesOfWith(secondHeader, firstHeader);
+
+  /*
+   * The fused loop keeps the ID of the first loop.
+   * The ID of the second loop is attached to the terminator of its header.
+   */
+  secondHeader->getTerminator()->setMetadata(LoopStructure::metadataKeyID,
+                                             nullptr);
+
+  /*
+   * Continue the body of the first loop with the body of the second one.
+   * The exit condition of the first loop is now dead.
+   */
+  auto firstLatchTerminator = firstLatch->getTerminator();
+  auto newFirstLatchTerminator =
+      BranchInst::Create(secondHeader, firstLatchTerminator);
+  newFirstLatchTerminator->setDebugLoc(firstLatchTerminator->getDebugLoc());
+  if (auto loopID =
+          firstLatchTerminator->getMetadata(LoopStructure::metadataKeyID)) {
+    newFirstLatchTerminator->setMetadata(LoopStructure::metadataKeyID, loopID);
+  }
+  instructionsAdded.insert(newFirstLatchTerminator);
+  instructionsRemoved.insert(firstLatchTerminator);
+  firstLatchTerminator->eraseFromParent();
+
+  /*
+   * Remove the basic block between the two loops, which is now unreachable.
+   */
+  instructionsRemoved.insert(middle->getTerminator());
+  middle->eraseFromParent();
+
+  return true;
+}
+
+uint64_t LoopFusion::estimateBytesSaved(LoopContent &first,
+                                        LoopContent &second,
+                                        ScalarEvolution &SE,
+                                        Hot &profiles) const {
+  if (!profiles.isAvailable()) {
+    return 0;
+  }
+
+  /*
+   * Collect the objects accessed by the first loop.
+   */
+  std::set<const SCEV *> objectsOfFirst;
+  for (auto bb : first.getLoopStructure()->getBasicBlocks()) {
+    for (auto &inst : *bb) {
+      auto pointer = this->getPointerOperandOfAccess(&inst);
+      if (pointer == nullptr) {
+        continue;
+      }
+      objectsOfFirst.insert(SE.getPointerBase(SE.getSCEV(pointer)));
+    }
+  }
+
+  /*
+   * Sum the bytes the second loop accesses of the same objects.
+   * Once the loops are fused, these bytes are likely to be in cache already.
+   */
+  uint64_t bytes = 0;
+  for (auto bb : second.getLoopStructure()->getBasicBlocks()) {
+    for (auto &inst : *bb) {
+      auto pointer = this->getPointerOperandOfAccess(&inst);
+      if (pointer == nullptr) {
+        continue;
+      }
+      auto object = SE.getPointerBase(SE.getSCEV(pointer));
+      if (objectsOfFirst.count(object) == 0) {
+        continue;
+      }
+      bytes += this->getSizeOfAccess(&inst) * profiles.getInvocations(&inst);
+    }
+  }
+
+  return bytes;
+}
+
+bool LoopFusion::areAdjacent(LoopStructure *first,
+                             LoopStructure *second) const {
+
+  /*
+   * Check both loops have a single latch, which is also their single exiting
+   * basic block.
+   */
+  for (auto loop : { first, second }) {
+    auto latches = loop->getLatches();
+    if (latches.size() != 1) {
+      return false;
+    }
+    auto latch = *latches.begin();
+    auto latchBr = dyn_cast<BranchInst>(latch->getTerminator());
+    if ((latchBr == nullptr) || (!latchBr->isConditional())) {
+      return false;
+    }
+    auto exitEdges = loop->getLoopExitEdges();
+    if ((exitEdges.size() != 1) || (exitEdges[0].first != latch)) {
+      return false;
+    }
+  }
+
+  /*
+   * Check the first loop exits to the pre-header of the second loop.
+   */
+  auto exitBlocks = first->getLoopExitBasicBlocks();
+  auto middle = second->getPreHeader();
+  if ((exitBlocks.size() != 1) || (exitBlocks[0] != middle)) {
+    return false;
+  }
+  if (middle->getSinglePredecessor() == nullptr) {
+    return false;
+  }
+
+  /*
+   * Check the code between the two loops can be hoisted before the first loop.
+   */
+  auto middleBr = dyn_cast<BranchInst>(middle->getTerminator());
+  if ((middleBr == nullptr) || (middleBr->isConditional())) {
+    return false;
+  }
+  for (auto &inst : *middle) {
+    if (&inst == middleBr) {
+      continue;
+    }
+    if (isa<PHINode>(&inst)) {
+      return false;
+    }
+    if (inst.mayReadOrWriteMemory() || inst.mayHaveSideEffects()) {
+      return false;
+    }
+    for (auto &op : inst.operands()) {
+      auto opInst = dyn_cast<Instruction>(op.get());
+      if ((opInst != nullptr) && first->isIncluded(opInst)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool LoopFusion::hasLiveOuts(LoopStructure *loop) const {
+  for (auto bb : loop->getBasicBlocks()) {
+    for (auto &inst : *bb) {
+      for (auto user : inst.users()) {
+        auto userInst = dyn_cast<Instruction>(user);
+        if ((userInst != nullptr) && !loop->isIncluded(userInst)) {
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+bool LoopFusion::haveTheSameTripCount(LoopContent &first,
+                                      LoopContent &second,
+                                      LoopInfo &LI,
+                                      ScalarEvolution &SE) const {
+
+  /*
+   * Fetch the loop-governing IVs.
+   */
+  auto firstGIV = first.getInductionVariableManager()
+                      ->getLoopGoverningInductionVariable();
+  auto secondGIV = second.getInductionVariableManager()
+                       ->getLoopGoverningInductionVariable();
+  if ((firstGIV == nullptr) || (secondGIV == nullptr)) {
+    return false;
+  }
+
+  /*
+   * Check whether the two loop-governing IVs evolve in the same way and they
+   * are compared in the same way against the same exit condition.
+   */
+  auto firstCmp = firstGIV->getHeaderCompareInstructionToComputeExitCondition();
+  auto secondCmp =
+      secondGIV->getHeaderCompareInstructionToComputeExitCondition();
+  auto firstCompared = firstGIV->getValueToCompareAgainstExitConditionValue();
+  auto secondCompared =
+      secondGIV->getValueToCompareAgainstExitConditionValue();
+  auto firstEvolution = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(firstCompared));
+  auto secondEvolution = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(secondCompared));
+  if (true && (firstEvolution != nullptr) && (secondEvolution != nullptr)
+      && (firstEvolution->getStart() == secondEvolution->getStart())
+      && (firstEvolution->getStepRecurrence(SE)
+          == secondEvolution->getStepRecurrence(SE))
+      && (SE.getSCEV(firstGIV->getExitConditionValue())
+          == SE.getSCEV(secondGIV->getExitConditionValue()))
+      && (firstCmp->getPredicate() == secondCmp->getPredicate())
+      && ((firstCmp->getOperand(0) == firstCompared)
+          == (secondCmp->getOperand(0) == secondCompared))
+      && (firstGIV->valueOfExitConditionToJumpToTheLoopBody()
+          == secondGIV->valueOfExitConditionToJumpToTheLoopBody())) {
+    return true;
+  }
+
+  /*
+   * Fall back to the trip counts computed by SCEV.
+   */
+  auto firstLoop = LI.getLoopFor(first.getLoopStructure()->getHeader());
+  auto secondLoop = LI.getLoopFor(second.getLoopStructure()->getHeader());
+  auto firstCount = SE.getBackedgeTakenCount(firstLoop);
+  auto secondCount = SE.getBackedgeTakenCount(secondLoop);
+  if (isa<SCEVCouldNotCompute>(firstCount)) {
+    return false;
+  }
+
+  return firstCount == secondCount;
+}
+
+bool LoopFusion::hasFusionPreventingDependences(LoopContent &first,
+                                                LoopContent &second,
+                                                PDG &dg,
+                                                LoopInfo &LI,
+                                                ScalarEvolution &SE) const {
+  auto firstLS = first.getLoopStructure();
+  auto secondLS = second.getLoopStructure();
+  auto firstLoop = LI.getLoopFor(firstLS->getHeader());
+  auto secondLoop = LI.getLoopFor(secondLS->getHeader());
+
+  /*
+   * Check the memory dependences between the two loops.
+   * The lack of live-outs of the first loop guarantees there are no variable
+   * dependences between them.
+   */
+  for (auto bb : firstLS->getBasicBlocks()) {
+    for (auto &inst : *bb) {
+      if (!inst.mayReadOrWriteMemory()) {
+        continue;
+      }
+      if (!dg.isInGraph(&inst)) {
+        continue;
+      }
+      auto node = dg.fetchNode(&inst);
+
+      /*
+       * Dependences from the first loop to the second one.
+       */
+      for (auto edge : node->getOutgoingEdges()) {
+        if (!isa<MemoryDependence<Value, Value>>(edge)) {
+          continue;
+        }
+        auto otherInst = dyn_cast<Instruction>(edge->getDst());
+        if ((otherInst == nullptr) || !secondLS->isIncluded(otherInst)) {
+          continue;
+        }
+        if (this->isFusionPreventing(&inst,
+                                     firstLoop,
+                                     otherInst,
+                                     secondLoop,
+                                     SE)) {
+          return true;
+        }
+      }
+
+      /*
+       * Dependences from the second loop to the first one.
+       */
+      for (auto edge : node->getIncomingEdges()) {
+        if (!isa<MemoryDependence<Value, Value>>(edge)) {
+          continue;
+        }
+        auto otherInst = dyn_cast<Instruction>(edge->getSrc());
+        if ((otherInst == nullptr) || !secondLS->isIncluded(otherInst)) {
+          continue;
+        }
+        if (this->isFusionPreventing(&inst,
+                                     firstLoop,
+                                     otherInst,
+                                     secondLoop,
+                                     SE)) {
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+bool LoopFusion::isFusionPreventing(Instruction *accessOfFirst,
+                                    Loop *first,
+                                    Instruction *accessOfSecond,
+                                    Loop *second,
+                                    ScalarEvolution &SE) const {
+
+  /*
+   * Fetch the evolution of the addresses accessed by the two instructions.
+   */
+  auto firstPointer = this->getPointerOperandOfAccess(accessOfFirst);
+  auto secondPointer = this->getPointerOperandOfAccess(accessOfSecond);
+  if ((firstPointer == nullptr) || (secondPointer == nullptr)) {
+    return true;
+  }
+  auto firstAccess = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(firstPointer));
+  auto secondAccess = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(secondPointer));
+  if ((firstAccess == nullptr) || (secondAccess == nullptr)
+      || (firstAccess->getLoop() != first) || (!firstAccess->isAffine())
+      || (secondAccess->getLoop() != second) || (!secondAccess->isAffine())) {
+    return true;
+  }
+
+  /*
+   * The two accesses must move through memory with the same positive stride.
+   */
+  auto stride = dyn_cast<SCEVConstant>(firstAccess->getStepRecurrence(SE));
+  if ((stride == nullptr)
+      || (stride != secondAccess->getStepRecurrence(SE))) {
+    return true;
+  }
+  auto strideValue = stride->getAPInt().getSExtValue();
+  if (strideValue <= 0) {
+    return true;
+  }
+
+  /*
+   * Compute the distance between the addresses accessed by the same iteration
+   * of the two loops.
+   */
+  auto distance = dyn_cast<SCEVConstant>(
+      SE.getMinusSCEV(secondAccess->getStart(), firstAccess->getStart()));
+  if (distance == nullptr) {
+    return true;
+  }
+  auto distanceValue = distance->getAPInt().getSExtValue();
+
+  /*
+   * The fusion executes the iteration i of the second loop before the
+   * iterations of the first loop after i.
+   * This reverses the dependence if the bytes accessed by the iteration i of
+   * the second loop overlap with the ones accessed by the iteration i+1 of the
+   * first loop, which starts at a distance equal to the stride.
+   */
+  auto secondSize = static_cast<int64_t>(this->getSizeOfAccess(accessOfSecond));
+  if (distanceValue > (strideValue - secondSize)) {
+    return true;
+  }
+
+  return false;
+}
+
+Value *LoopFusion::getPointerOperandOfAccess(Instruction *i) const {
+  if (auto load = dyn_cast<LoadInst>(i)) {
+    return load->getPointerOperand();
+  }
+  if (auto store = dyn_cast<StoreInst>(i)) {
+    return store->getPointerOperand();
+  }
+
+  return nullptr;
+}
+
+uint64_t LoopFusion::getSizeOfAccess(Instruction *i) const {
+  auto &DL = i->getModule()->getDataLayout();
+  if (auto load = dyn_cast<LoadInst>(i)) {
+    return DL.getTypeStoreSize(load->getType());
+  }
+  if (auto store = dyn_cast<StoreInst>(i)) {
+    return DL.getTypeStoreSize(store->getValueOperand()->getType());
+  }
+
+  return 0;
+}
+
+} // namespace arcana::noelle
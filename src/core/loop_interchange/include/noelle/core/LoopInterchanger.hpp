@@ -0,0 +1,83 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_CORE_LOOP_INTERCHANGE_LOOPINTERCHANGER_H_
+#define NOELLE_SRC_CORE_LOOP_INTERCHANGE_LOOPINTERCHANGER_H_
+
+#include "llvm/Analysis/ScalarEvolutionExpander.h"
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopContent.hpp"
+#include "noelle/core/PerfectLoopNest.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Interchange of the two loops of perfect loop nests of depth two.
+ *
+ * The control flow of the nest does not change.
+ * Instead, the outer loop iterates over the iteration space of the inner loop
+ * and vice versa: each loop gets a counter that controls its exit, and the
+ * induction variables of the two loops are recomputed from the counter of the
+ * other loop.
+ * Hence, the loop structures (and their IDs) of the nest stay valid.
+ */
+class LoopInterchanger {
+public:
+  /*
+   * Constructor
+   */
+  LoopInterchanger();
+
+  /*
+   * Interchange the loop @loop with its sub-loop if this makes the innermost
+   * subscripts of more memory accesses evolve with the innermost loop.
+   *
+   * The instructions added are added to @instructionsAdded.
+   * @LI and @DT are not updated, while @SE forgets the loops of the nest.
+   */
+  bool interchangeLoop(LoopContent &loop,
+                       LoopInfo &LI,
+                       DominatorTree &DT,
+                       ScalarEvolution &SE,
+                       std::set<Instruction *> &instructionsAdded);
+
+private:
+  bool canBeInterchanged(LoopContent &loop,
+                         LoopInfo &LI,
+                         DominatorTree &DT,
+                         ScalarEvolution &SE) const;
+
+  bool isWorthInterchanging(LoopContent &loop) const;
+
+  Value *generateCodeToComputeTheValueAtIteration(IRBuilder<> &builder,
+                                                  Value *start,
+                                                  Value *step,
+                                                  Value *iteration) const;
+
+  Value *generateCodeToControlTheExit(LoopStructure *loop,
+                                      Value *tripCount,
+                                      Type *counterType) const;
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_CORE_LOOP_INTERCHANGE_LOOPINTERCHANGER_H_
@@ -0,0 +1,381 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopInterchanger.hpp"
+
+namespace arcana::noelle {
+
+LoopInterchanger::LoopInterchanger() {
+  return;
+}
+
+bool LoopInterchanger::interchangeLoop(
+    LoopContent &loop,
+    LoopInfo &LI,
+    DominatorTree &DT,
+    ScalarEvolution &SE,
+    std::set<Instruction *> &instructionsAdded) {
+
+  /*
+   * Check if the loops can and should be interchanged.
+   */
+  if (!this->canBeInterchanged(loop, LI, DT, SE)) {
+    return false;
+  }
+  if (!this->isWorthInterchanging(loop)) {
+    return false;
+  }
+
+  /*
+   * Fetch the loops.
+   */
+  auto loopNode = loop.getLoopHierarchyStructures();
+  auto outerLS = loop.getLoopStructure();
+  auto innerLS = (*loopNode->getChildren().begin())->getLoop();
+  auto outerLoop = LI.getLoopFor(outerLS->getHeader());
+  auto innerLoop = LI.getLoopFor(innerLS->getHeader());
+  auto outerPreheader = outerLS->getPreHeader();
+  auto innerPreheader = innerLS->getPreHeader();
+  auto innerHeader = innerLS->getHeader();
+  auto f = outerLS->getFunction();
+  auto int64Type = IntegerType::get(f->getContext(), 64);
+
+  /*
+   * Fetch the trip counts of the two loops, and the starts and steps of their
+   * induction variables.
+   * They are all invariant in the nest, so they are computed before the nest
+   * starts.
+   * Check that they can be computed there before changing the code.
+   */
+  std::vector<const SCEV *> tripCountSCEVs;
+  for (auto llvmLoop : { outerLoop, innerLoop }) {
+    auto backedgeTakenCount = SE.getBackedgeTakenCount(llvmLoop);
+    if (isa<SCEVCouldNotCompute>(backedgeTakenCount)) {
+      return false;
+    }
+    auto tripCountSCEV =
+        SE.getAddExpr(SE.getNoopOrZeroExtend(backedgeTakenCount, int64Type),
+                      SE.getOne(int64Type));
+    if (!isSafeToExpand(tripCountSCEV, SE)) {
+      return false;
+    }
+    tripCountSCEVs.push_back(tripCountSCEV);
+  }
+  for (auto llvmLoop : { outerLoop, innerLoop }) {
+    for (auto &phi : llvmLoop->getHeader()->phis()) {
+      auto ivSCEV = cast<SCEVAddRecExpr>(SE.getSCEV(&phi));
+      if (!isSafeToExpand(ivSCEV->getStepRecurrence(SE), SE)) {
+        return false;
+      }
+      if ((llvmLoop == innerLoop)
+          && !isSafeToExpand(ivSCEV->getStart(), SE)) {
+        return false;
+      }
+    }
+  }
+
+  /*
+   * Keep track of the current instructions to identify the new ones.
+   */
+  std::set<Instruction *> originalInstructions;
+  for (auto &inst : instructions(*f)) {
+    originalInstructions.insert(&inst);
+  }
+
+  /*
+   * Compute the trip counts of the two loops, and the starts and steps of
+   * their induction variables, before the nest starts.
+   */
+  auto &DL = f->getParent()->getDataLayout();
+  SCEVExpander expander(SE, DL, "noelle.interchange");
+  auto outerPreheaderTerminator = outerPreheader->getTerminator();
+  std::vector<Value *> tripCounts;
+  for (auto tripCountSCEV : tripCountSCEVs) {
+    auto tripCount = expander.expandCodeFor(tripCountSCEV,
+                                            int64Type,
+                                            outerPreheaderTerminator);
+    tripCounts.push_back(tripCount);
+  }
+  auto outerTripCount = tripCounts[0];
+  auto innerTripCount = tripCounts[1];
+  std::map<PHINode *, std::pair<Value *, Value *>> outerIVs;
+  std::map<PHINode *, std::pair<Value *, Value *>> innerIVs;
+  for (auto ls : { outerLS, innerLS }) {
+    auto &ivs = (ls == outerLS) ? outerIVs : innerIVs;
+    for (auto &phi : ls->getHeader()->phis()) {
+      auto ivSCEV = cast<SCEVAddRecExpr>(SE.getSCEV(&phi));
+      auto stepSCEV = ivSCEV->getStepRecurrence(SE);
+      auto step = expander.expandCodeFor(stepSCEV,
+                                         stepSCEV->getType(),
+                                         outerPreheaderTerminator);
+      Value *start = nullptr;
+      if (ls == outerLS) {
+        start = phi.getIncomingValueForBlock(outerPreheader);
+      } else {
+        start = expander.expandCodeFor(ivSCEV->getStart(),
+                                       phi.getType(),
+                                       outerPreheaderTerminator);
+      }
+      ivs[&phi] = std::make_pair(start, step);
+    }
+  }
+
+  /*
+   * The outer loop iterates over the iteration space of the inner loop and
+   * vice versa.
+   */
+  auto outerCounter =
+      this->generateCodeToControlTheExit(outerLS, innerTripCount, int64Type);
+  auto innerCounter =
+      this->generateCodeToControlTheExit(innerLS, outerTripCount, int64Type);
+
+  /*
+   * Recompute the induction variables of the outer loop within the inner loop.
+   */
+  IRBuilder<> innerHeaderBuilder(innerHeader->getFirstNonPHI());
+  for (auto &pair : outerIVs) {
+    auto phi = pair.first;
+    auto value =
+        this->generateCodeToComputeTheValueAtIteration(innerHeaderBuilder,
+                                                       pair.second.first,
+                                                       pair.second.second,
+                                                       innerCounter);
+    std::vector<Use *> usesToReplace;
+    for (auto &use : phi->uses()) {
+      auto userInst = cast<Instruction>(use.getUser());
+      if (innerLS->isIncluded(userInst) && (userInst != value)) {
+        usesToReplace.push_back(&use);
+      }
+    }
+    for (auto use : usesToReplace) {
+      use->set(value);
+    }
+  }
+
+  /*
+   * Recompute the induction variables of the inner loop before it starts.
+   */
+  IRBuilder<> innerPreheaderBuilder(innerPreheader->getTerminator());
+  for (auto &pair : innerIVs) {
+    auto phi = pair.first;
+    auto value =
+        this->generateCodeToComputeTheValueAtIteration(innerPreheaderBuilder,
+                                                       pair.second.first,
+                                                       pair.second.second,
+                                                       outerCounter);
+    phi->replaceAllUsesWith(value);
+  }
+
+  /*
+   * The trip counts and the evolutions of the variables of the nest cached by
+   * ScalarEvolution are not valid anymore.
+   * Forgetting the outer loop forgets the inner one as well.
+   */
+  expander.clear();
+  SE.forgetLoop(outerLoop);
+
+  /*
+   * Keep track of the new instructions.
+   */
+  for (auto &inst : instructions(*f)) {
+    if (originalInstructions.find(&inst) == originalInstructions.end()) {
+      instructionsAdded.insert(&inst);
+    }
+  }
+
+  return true;
+}
+
+bool LoopInterchanger::canBeInterchanged(LoopContent &loop,
+                                         LoopInfo &LI,
+                                         DominatorTree &DT,
+                                         ScalarEvolution &SE) const {
+
+  /*
+   * The interchange reorders all iterations of the nest.
+   */
+  if (!PerfectLoopNest::canReorderIterations(loop, LI, DT, SE)) {
+    return false;
+  }
+  auto outerLS = loop.getLoopStructure();
+  auto innerLS = PerfectLoopNest::getInnerLoop(loop);
+  auto outerLoop = LI.getLoopFor(outerLS->getHeader());
+  auto innerLoop = LI.getLoopFor(innerLS->getHeader());
+
+  /*
+   * Check the shape of the two loops.
+   * Their latches must decide whether to start another iteration, as the
+   * counters added by the interchange control the exits from there.
+   */
+  for (auto ls : { outerLS, innerLS }) {
+    auto latch = *ls->getLatches().begin();
+    if (ls->getLoopExitEdges().front().first != latch) {
+      return false;
+    }
+    auto latchBranch = dyn_cast<BranchInst>(latch->getTerminator());
+    if ((latchBranch == nullptr) || !latchBranch->isConditional()) {
+      return false;
+    }
+  }
+
+  /*
+   * Only the induction variables of the outer loop can be used by the inner
+   * loop.
+   */
+  auto outerHeader = outerLS->getHeader();
+  for (auto inst : outerLS->getInstructions()) {
+    if (innerLS->isIncluded(inst)) {
+      continue;
+    }
+    if (isa<PHINode>(inst) && (inst->getParent() == outerHeader)) {
+      continue;
+    }
+    for (auto user : inst->users()) {
+      auto userInst = cast<Instruction>(user);
+      if (innerLS->isIncluded(userInst)) {
+        return false;
+      }
+    }
+  }
+
+  /*
+   * The starts of the variables carried by the two loops must be invariant in
+   * the nest to recompute them from the counters.
+   * Moreover, the number of iterations of the outer loop must be invariant in
+   * the nest as well.
+   */
+  for (auto llvmLoop : { outerLoop, innerLoop }) {
+    for (auto &phi : llvmLoop->getHeader()->phis()) {
+      auto phiSCEV = cast<SCEVAddRecExpr>(SE.getSCEV(&phi));
+      if (!SE.isLoopInvariant(phiSCEV->getStart(), outerLoop)) {
+        return false;
+      }
+    }
+  }
+  auto backedgeTakenCount = SE.getBackedgeTakenCount(outerLoop);
+  if (isa<SCEVCouldNotCompute>(backedgeTakenCount)) {
+    return false;
+  }
+
+  return true;
+}
+
+bool LoopInterchanger::isWorthInterchanging(LoopContent &loop) const {
+
+  /*
+   * Fetch the loops.
+   */
+  auto loopNode = loop.getLoopHierarchyStructures();
+  auto outerLS = loop.getLoopStructure();
+  auto innerLS = (*loopNode->getChildren().begin())->getLoop();
+
+  /*
+   * Count the accesses whose innermost subscript evolves with each loop.
+   * These accesses have unit stride when the loop that drives their innermost
+   * subscript is the innermost one.
+   */
+  auto iterationSpace = loop.getLoopIterationSpaceAnalysis();
+  uint32_t unitStrideAccessesNow = 0;
+  uint32_t unitStrideAccessesAfter = 0;
+  for (auto inst : innerLS->getInstructions()) {
+    if (!isa<LoadInst>(inst) && !isa<StoreInst>(inst)) {
+      continue;
+    }
+    auto ivs = iterationSpace->getSubscriptIVs(inst);
+    if ((ivs.size() == 0) || (ivs.back() == nullptr)) {
+      continue;
+    }
+    auto ivHeader = ivs.back()->getLoopEntryPHI()->getParent();
+    if (ivHeader == innerLS->getHeader()) {
+      unitStrideAccessesNow++;
+    } else if (ivHeader == outerLS->getHeader()) {
+      unitStrideAccessesAfter++;
+    }
+  }
+
+  return unitStrideAccessesAfter > unitStrideAccessesNow;
+}
+
+Value *LoopInterchanger::generateCodeToComputeTheValueAtIteration(
+    IRBuilder<> &builder,
+    Value *start,
+    Value *step,
+    Value *iteration) const {
+
+  /*
+   * Compute the offset from the start.
+   */
+  auto iterationOfStepType =
+      builder.CreateZExtOrTrunc(iteration, step->getType());
+  auto offset = builder.CreateMul(iterationOfStepType, step);
+
+  /*
+   * Add the offset to the start.
+   * Steps of pointers are in bytes.
+   */
+  auto startType = dyn_cast<PointerType>(start->getType());
+  if (startType == nullptr) {
+    return builder.CreateAdd(start, offset);
+  }
+  auto &context = start->getContext();
+  auto bytePointerType =
+      Type::getInt8PtrTy(context, startType->getAddressSpace());
+  auto startAsBytes = builder.CreateBitCast(start, bytePointerType);
+  auto valueAsBytes =
+      builder.CreateGEP(Type::getInt8Ty(context), startAsBytes, offset);
+  auto value = builder.CreateBitCast(valueAsBytes, startType);
+
+  return value;
+}
+
+Value *LoopInterchanger::generateCodeToControlTheExit(LoopStructure *loop,
+                                                      Value *tripCount,
+                                                      Type *counterType) const {
+
+  /*
+   * Add the counter of iterations.
+   */
+  auto header = loop->getHeader();
+  auto preheader = loop->getPreHeader();
+  auto latch = *loop->getLatches().begin();
+  IRBuilder<> headerBuilder(&*header->begin());
+  auto counter = headerBuilder.CreatePHI(counterType, 2, "interchange.counter");
+  IRBuilder<> latchBuilder(latch->getTerminator());
+  auto nextCounter =
+      latchBuilder.CreateAdd(counter, ConstantInt::get(counterType, 1));
+  counter->addIncoming(ConstantInt::get(counterType, 0), preheader);
+  counter->addIncoming(nextCounter, latch);
+
+  /*
+   * Exit the loop after @tripCount iterations.
+   * The branch is kept to preserve its metadata (e.g., the loop ID).
+   */
+  auto latchBranch = cast<BranchInst>(latch->getTerminator());
+  auto predicate = (latchBranch->getSuccessor(0) == header)
+                       ? ICmpInst::ICMP_ULT
+                       : ICmpInst::ICMP_UGE;
+  auto condition = latchBuilder.CreateICmp(predicate, nextCounter, tripCount);
+  latchBranch->setCondition(condition);
+
+  return counter;
+}
+
+} // namespace arcana::noelle
@@ -44,6 +44,20 @@ public:
       Instruction *from,
       Instruction *to) const;
 
+  /*
+   * Return the instruction that computes the address accessed by @I (e.g., a
+   * GEP) if the memory space accessed by @I is known, nullptr otherwise.
+   */
+  Instruction *getMemoryAccessor(Instruction *I) const;
+
+  /*
+   * Return the induction variables that drive the subscripts of the memory
+   * accessed by @I, from the outermost dimension to the innermost one.
+   * Dimensions that are not driven by an induction variable have nullptr.
+   * The vector is empty if the subscripts of @I are unknown.
+   */
+  std::vector<InductionVariable *> getSubscriptIVs(Instruction *I) const;
+
   ~LoopIterationSpaceAnalysis();
 
 private:
@@ -108,6 +108,40 @@ bool LoopIterationSpaceAnalysis::
   return perfectlyAligned;
 }
 
+Instruction *LoopIterationSpaceAnalysis::getMemoryAccessor(
+    Instruction *I) const {
+  auto spaceIt = this->accessSpaceByInstruction.find(I);
+  if (spaceIt == this->accessSpaceByInstruction.end()) {
+    return nullptr;
+  }
+  auto accessSpace = spaceIt->second;
+
+  return accessSpace->memoryAccessor;
+}
+
+std::vector<InductionVariable *> LoopIterationSpaceAnalysis::getSubscriptIVs(
+    Instruction *I) const {
+  std::vector<InductionVariable *> ivs;
+
+  /*
+   * Fetch the memory space accessed by @I.
+   */
+  auto spaceIt = this->accessSpaceByInstruction.find(I);
+  if (spaceIt == this->accessSpaceByInstruction.end()) {
+    return ivs;
+  }
+  auto accessSpace = spaceIt->second;
+
+  /*
+   * Fetch the induction variables of the subscripts.
+   */
+  for (auto &pair : accessSpace->subscriptIVs) {
+    ivs.push_back(pair.second);
+  }
+
+  return ivs;
+}
+
 bool LoopIterationSpaceAnalysis::
     isMemoryAccessSpaceEquivalentForTopLoopIVSubscript(
         MemoryAccessSpace *space1,
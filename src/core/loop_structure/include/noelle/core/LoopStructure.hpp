@@ -82,6 +82,12 @@ public:
 
   void print(raw_ostream &stream);
 
+  /*
+   * Name of the metadata that stores the ID of a loop.
+   * It is attached to the terminator of the header of the loop.
+   */
+  static const std::string metadataKeyID;
+
 private:
   BasicBlock *header;
   BasicBlock *preHeader;
@@ -100,8 +106,6 @@ private:
   std::vector<BasicBlock *> exitBlocks;
   std::vector<std::pair<BasicBlock *, BasicBlock *>> exitEdges;
 
-  static const std::string metadataKeyID;
-
   void instantiateIDsAndBasicBlocks(Loop *llvmLoop);
 
   bool isContainedInstructionLoopInvariant(Instruction *inst) const;
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_CORE_LOOP_TILING_LOOPTILER_H_
+#define NOELLE_SRC_CORE_LOOP_TILING_LOOPTILER_H_
+
+#include "llvm/Analysis/ScalarEvolutionExpander.h"
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopContent.hpp"
+#include "noelle/core/PerfectLoopNest.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Tiling of the inner loop of perfect loop nests of depth two.
+ *
+ * The nest
+ *   for (i...)
+ *     for (j...)
+ *       body
+ * becomes
+ *   for (jj = 0; jj < iterations of j; jj += tileSize)
+ *     for (i...)
+ *       for (j = jj; j < min(jj + tileSize, iterations of j); j++)
+ *         body
+ * so the cache lines loaded by a tile of j are reused by the iterations of i.
+ */
+class LoopTiler {
+public:
+  /*
+   * Constructor
+   */
+  LoopTiler();
+
+  /*
+   * Tile the inner loop of @loop.
+   *
+   * @tileSize is the number of iterations of the inner loop per tile; 0 means
+   * that it is computed from the caches of the target architecture.
+   * The loop is tiled only if some of its accesses reuse cache lines between
+   * iterations of the outer loop.
+   * The instructions added are added to @instructionsAdded.
+   * @LI and @DT are not updated, while @SE forgets the loops of the nest.
+   */
+  bool tileLoop(LoopContent &loop,
+                LoopInfo &LI,
+                DominatorTree &DT,
+                ScalarEvolution &SE,
+                uint32_t tileSize,
+                std::set<Instruction *> &instructionsAdded);
+
+  /*
+   * Number of iterations of a tile that keep a cache line per iteration for
+   * each one of @accesses in the first level cache.
+   */
+  uint32_t computeTileSize(uint32_t accesses) const;
+
+private:
+  bool canBeTiled(LoopContent &loop,
+                  LoopInfo &LI,
+                  DominatorTree &DT,
+                  ScalarEvolution &SE) const;
+
+  uint32_t countAccessesThatReuseCacheLines(LoopContent &loop,
+                                            Loop *outerLoop,
+                                            Loop *innerLoop,
+                                            ScalarEvolution &SE) const;
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_CORE_LOOP_TILING_LOOPTILER_H_
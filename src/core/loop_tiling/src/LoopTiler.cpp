@@ -0,0 +1,399 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopTiler.hpp"
+#include "noelle/core/Architecture.hpp"
+
+namespace arcana::noelle {
+
+LoopTiler::LoopTiler() {
+  return;
+}
+
+bool LoopTiler::tileLoop(LoopContent &loop,
+                         LoopInfo &LI,
+                         DominatorTree &DT,
+                         ScalarEvolution &SE,
+                         uint32_t tileSize,
+                         std::set<Instruction *> &instructionsAdded) {
+
+  /*
+   * Check if the loop nest can be tiled.
+   */
+  if (!this->canBeTiled(loop, LI, DT, SE)) {
+    return false;
+  }
+
+  /*
+   * Fetch the loops.
+   */
+  auto loopNode = loop.getLoopHierarchyStructures();
+  auto outerLS = loop.getLoopStructure();
+  auto innerLS = (*loopNode->getChildren().begin())->getLoop();
+  auto outerLoop = LI.getLoopFor(outerLS->getHeader());
+  auto innerLoop = LI.getLoopFor(innerLS->getHeader());
+
+  /*
+   * Check if tiling the loop is worth it.
+   */
+  auto accesses =
+      this->countAccessesThatReuseCacheLines(loop, outerLoop, innerLoop, SE);
+  if (accesses == 0) {
+    return false;
+  }
+  if (tileSize == 0) {
+    tileSize = this->computeTileSize(accesses);
+  }
+  if (tileSize < 2) {
+    return false;
+  }
+
+  /*
+   * Fetch the basic blocks involved.
+   */
+  auto outerPreheader = outerLS->getPreHeader();
+  auto outerHeader = outerLS->getHeader();
+  auto outerExitEdge = outerLS->getLoopExitEdges().front();
+  auto outerExitingBB = outerExitEdge.first;
+  auto outerExitBB = outerExitEdge.second;
+  auto innerPreheader = innerLS->getPreHeader();
+  auto innerHeader = innerLS->getHeader();
+  auto innerLatch = *innerLS->getLatches().begin();
+  auto innerExitEdge = innerLS->getLoopExitEdges().front();
+  auto innerExitingBB = innerExitEdge.first;
+  auto innerExitBB = innerExitEdge.second;
+  auto f = outerHeader->getParent();
+  auto &context = f->getContext();
+  auto int64Type = IntegerType::get(context, 64);
+
+  /*
+   * Fetch the number of iterations of the inner loop and the steps of its
+   * induction variables.
+   * They are invariant in the outer loop, so they are computed before it
+   * starts.
+   * Check that they can be computed there before changing the code.
+   */
+  auto backedgeTakenCount = SE.getBackedgeTakenCount(innerLoop);
+  if (isa<SCEVCouldNotCompute>(backedgeTakenCount)) {
+    return false;
+  }
+  auto tripCountSCEV =
+      SE.getAddExpr(SE.getNoopOrZeroExtend(backedgeTakenCount, int64Type),
+                    SE.getOne(int64Type));
+  if (!isSafeToExpand(tripCountSCEV, SE)) {
+    return false;
+  }
+  std::vector<std::pair<PHINode *, const SCEV *>> innerIVSteps;
+  for (auto &phi : innerHeader->phis()) {
+    auto ivSCEV = cast<SCEVAddRecExpr>(SE.getSCEV(&phi));
+    auto stepSCEV = ivSCEV->getStepRecurrence(SE);
+    if (!isSafeToExpand(stepSCEV, SE)) {
+      return false;
+    }
+    innerIVSteps.push_back(std::make_pair(&phi, stepSCEV));
+  }
+
+  /*
+   * Keep track of the current instructions to identify the new ones.
+   */
+  std::set<Instruction *> originalInstructions;
+  for (auto &inst : instructions(*f)) {
+    originalInstructions.insert(&inst);
+  }
+
+  /*
+   * Compute the number of iterations of the inner loop and the steps of its
+   * induction variables before the outer loop starts.
+   */
+  auto &DL = f->getParent()->getDataLayout();
+  SCEVExpander expander(SE, DL, "noelle.tiling");
+  auto outerPreheaderTerminator = outerPreheader->getTerminator();
+  auto tripCount = expander.expandCodeFor(tripCountSCEV,
+                                          int64Type,
+                                          outerPreheaderTerminator);
+  std::vector<std::pair<PHINode *, Value *>> innerIVs;
+  for (auto &pair : innerIVSteps) {
+    auto &phi = *pair.first;
+    auto stepSCEV = pair.second;
+    auto step = expander.expandCodeFor(stepSCEV,
+                                       stepSCEV->getType(),
+                                       outerPreheaderTerminator);
+    innerIVs.push_back(std::make_pair(&phi, step));
+  }
+
+  /*
+   * Add the loop that iterates over tiles around the outer loop.
+   */
+  auto tileHeader = BasicBlock::Create(context, "tile.header", f, outerHeader);
+  auto tileLatch = BasicBlock::Create(context, "tile.latch", f, outerExitBB);
+  IRBuilder<> tileHeaderBuilder(tileHeader);
+  auto tileStart = tileHeaderBuilder.CreatePHI(int64Type, 2, "tile.start");
+  tileHeaderBuilder.CreateBr(outerHeader);
+  IRBuilder<> tileLatchBuilder(tileLatch);
+  auto nextTileStart =
+      tileLatchBuilder.CreateAdd(tileStart,
+                                 ConstantInt::get(int64Type, tileSize));
+  auto isThereAnotherTile =
+      tileLatchBuilder.CreateICmpULT(nextTileStart, tripCount);
+  tileLatchBuilder.CreateCondBr(isThereAnotherTile, tileHeader, outerExitBB);
+  tileStart->addIncoming(ConstantInt::get(int64Type, 0), outerPreheader);
+  tileStart->addIncoming(nextTileStart, tileLatch);
+
+  /*
+   * Enter the outer loop from the tile loop.
+   */
+  outerPreheaderTerminator->replaceUsesOfWith(outerHeader, tileHeader);
+  for (auto &phi : outerHeader->phis()) {
+    auto index = phi.getBasicBlockIndex(outerPreheader);
+    phi.setIncomingBlock(index, tileHeader);
+  }
+
+  /*
+   * Go to the next tile when the outer loop ends.
+   * The outer loop has no live-out values, so the values merged in its exit
+   * block are defined before the tile loop.
+   */
+  outerExitingBB->getTerminator()->replaceUsesOfWith(outerExitBB, tileLatch);
+  for (auto &phi : outerExitBB->phis()) {
+    auto index = phi.getBasicBlockIndex(outerExitingBB);
+    phi.setIncomingBlock(index, tileLatch);
+  }
+
+  /*
+   * Start the inner loop from the first iteration of the tile.
+   */
+  IRBuilder<> innerPreheaderBuilder(innerPreheader->getTerminator());
+  for (auto &pair : innerIVs) {
+    auto phi = pair.first;
+    auto step = pair.second;
+    auto index = phi->getBasicBlockIndex(innerPreheader);
+    auto start = phi->getIncomingValue(index);
+    auto iterations =
+        innerPreheaderBuilder.CreateZExtOrTrunc(tileStart, step->getType());
+    auto offset = innerPreheaderBuilder.CreateMul(iterations, step);
+    Value *tileFirstValue = nullptr;
+    if (auto startType = dyn_cast<PointerType>(start->getType())) {
+      auto bytePointerType =
+          Type::getInt8PtrTy(context, startType->getAddressSpace());
+      auto startAsBytes =
+          innerPreheaderBuilder.CreateBitCast(start, bytePointerType);
+      auto firstAsBytes =
+          innerPreheaderBuilder.CreateGEP(Type::getInt8Ty(context),
+                                          startAsBytes,
+                                          offset);
+      tileFirstValue =
+          innerPreheaderBuilder.CreateBitCast(firstAsBytes, startType);
+    } else {
+      tileFirstValue = innerPreheaderBuilder.CreateAdd(start, offset);
+    }
+    phi->setIncomingValue(index, tileFirstValue);
+  }
+
+  /*
+   * Leave the inner loop at the end of the tile.
+   */
+  auto tileCheck = BasicBlock::Create(context, "tile.check", f, innerExitBB);
+  innerLatch->getTerminator()->replaceUsesOfWith(innerHeader, tileCheck);
+  for (auto &phi : innerHeader->phis()) {
+    auto index = phi.getBasicBlockIndex(innerLatch);
+    phi.setIncomingBlock(index, tileCheck);
+  }
+  IRBuilder<> innerHeaderBuilder(&*innerHeader->begin());
+  auto tileIteration =
+      innerHeaderBuilder.CreatePHI(int64Type, 2, "tile.iteration");
+  IRBuilder<> tileCheckBuilder(tileCheck);
+  auto nextTileIteration =
+      tileCheckBuilder.CreateAdd(tileIteration, ConstantInt::get(int64Type, 1));
+  auto isTheTileNotOver = tileCheckBuilder.CreateICmpULT(
+      nextTileIteration,
+      ConstantInt::get(int64Type, tileSize));
+  tileCheckBuilder.CreateCondBr(isTheTileNotOver, innerHeader, innerExitBB);
+  tileIteration->addIncoming(ConstantInt::get(int64Type, 0), innerPreheader);
+  tileIteration->addIncoming(nextTileIteration, tileCheck);
+  for (auto &phi : innerExitBB->phis()) {
+    auto value = phi.getIncomingValueForBlock(innerExitingBB);
+    phi.addIncoming(value, tileCheck);
+  }
+
+  /*
+   * The trip counts and the evolutions of the variables of the nest cached by
+   * ScalarEvolution are not valid anymore.
+   * Forgetting the outer loop forgets the inner one as well.
+   */
+  expander.clear();
+  SE.forgetLoop(outerLoop);
+
+  /*
+   * Keep track of the new instructions.
+   */
+  for (auto &inst : instructions(*f)) {
+    if (originalInstructions.find(&inst) == originalInstructions.end()) {
+      instructionsAdded.insert(&inst);
+    }
+  }
+
+  return true;
+}
+
+uint32_t LoopTiler::computeTileSize(uint32_t accesses) const {
+  assert(accesses > 0);
+
+  /*
+   * Fetch the first level cache.
+   */
+  auto cacheBytes = Architecture::getCacheBytesPerLogicalCore(1);
+  if (cacheBytes == 0) {
+    cacheBytes = 32 * 1024;
+  }
+  auto lineBytes = Architecture::getCacheLineBytes(1);
+
+  /*
+   * Use half of the cache for the lines reused between iterations of the outer
+   * loop.
+   * The rest is left to the other accesses of the loop.
+   */
+  auto lines = cacheBytes / (2 * lineBytes);
+  auto iterations = lines / accesses;
+
+  /*
+   * Round the size to a power of two.
+   */
+  uint32_t tileSize = 1;
+  while ((tileSize * 2) <= iterations) {
+    tileSize *= 2;
+  }
+
+  return tileSize;
+}
+
+bool LoopTiler::canBeTiled(LoopContent &loop,
+                           LoopInfo &LI,
+                           DominatorTree &DT,
+                           ScalarEvolution &SE) const {
+
+  /*
+   * Tiling runs iterations of the outer loop before iterations of the inner
+   * loop of previous iterations of the outer loop.
+   * The order of the iterations of the inner loop within an iteration of the
+   * outer loop does not change.
+   */
+  if (!PerfectLoopNest::canReorderIterations(loop, LI, DT, SE)) {
+    return false;
+  }
+  auto outerLS = loop.getLoopStructure();
+  auto innerLS = PerfectLoopNest::getInnerLoop(loop);
+
+  /*
+   * The latch of the inner loop is redirected to the check of the end of the
+   * tile.
+   */
+  auto innerLatch = *innerLS->getLatches().begin();
+  if (!isa<BranchInst>(innerLatch->getTerminator())) {
+    return false;
+  }
+
+  /*
+   * The accesses to memory must be affine.
+   */
+  auto iterationSpace = loop.getLoopIterationSpaceAnalysis();
+  for (auto inst : outerLS->getInstructions()) {
+    if (!inst->mayReadOrWriteMemory()) {
+      continue;
+    }
+    if (!isa<LoadInst>(inst) && !isa<StoreInst>(inst)) {
+      return false;
+    }
+    if (iterationSpace->getMemoryAccessor(inst) == nullptr) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+uint32_t LoopTiler::countAccessesThatReuseCacheLines(
+    LoopContent &loop,
+    Loop *outerLoop,
+    Loop *innerLoop,
+    ScalarEvolution &SE) const {
+
+  /*
+   * An access can reuse cache lines between iterations of the outer loop if it
+   * touches a different line in every iteration of the inner loop, while the
+   * next iteration of the outer loop touches the same lines (e.g., a column of
+   * a row-major array).
+   */
+  auto lineBytes = Architecture::getCacheLineBytes(1);
+  auto iterationSpace = loop.getLoopIterationSpaceAnalysis();
+  uint32_t accesses = 0;
+  for (auto bb : innerLoop->blocks()) {
+    for (auto &inst : *bb) {
+      auto accessor = iterationSpace->getMemoryAccessor(&inst);
+      if (accessor == nullptr) {
+        continue;
+      }
+
+      /*
+       * Fetch the stride of the access in the inner loop.
+       */
+      auto innerAccess = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(accessor));
+      if ((innerAccess == nullptr) || (innerAccess->getLoop() != innerLoop)
+          || !innerAccess->isAffine()) {
+        continue;
+      }
+      auto innerStride =
+          dyn_cast<SCEVConstant>(innerAccess->getStepRecurrence(SE));
+      if (innerStride == nullptr) {
+        continue;
+      }
+      if (std::abs(innerStride->getAPInt().getSExtValue()) < lineBytes) {
+        continue;
+      }
+
+      /*
+       * Fetch the stride of the access in the outer loop.
+       */
+      auto start = innerAccess->getStart();
+      if (auto outerAccess = dyn_cast<SCEVAddRecExpr>(start)) {
+        if ((outerAccess->getLoop() != outerLoop) || !outerAccess->isAffine()) {
+          continue;
+        }
+        auto outerStride =
+            dyn_cast<SCEVConstant>(outerAccess->getStepRecurrence(SE));
+        if (outerStride == nullptr) {
+          continue;
+        }
+        if (std::abs(outerStride->getAPInt().getSExtValue()) >= lineBytes) {
+          continue;
+        }
+
+      } else if (!SE.isLoopInvariant(start, outerLoop)) {
+        continue;
+      }
+
+      accesses++;
+    }
+  }
+
+  return accesses;
+}
+
+} // namespace arcana::noelle
@@ -27,6 +27,8 @@
 
 #include "noelle/core/SystemHeaders.hpp"
 #include "noelle/core/LoopContent.hpp"
+#include "noelle/core/Hot.hpp"
+#include "noelle/core/Utils.hpp"
 
 namespace arcana::noelle {
 
@@ -38,17 +40,118 @@ public:
 
   void setPDG(PDG *programDependenceGraph);
 
+  /*
+   * Set how to compute the content of the loop whose header is @header from
+   * the dependence graph @functionDG of its function.
+   */
+  void setLoopContentBuilder(
+      std::function<LoopContent *(BasicBlock *header,
+                                  PDG *functionDG,
+                                  LoopTransformationsManager *ltm)> builder);
+
+  /*
+   * Set how to update the dependences of the function @f after the
+   * instructions @instructionsRemoved, @instructionsAdded, and
+   * @instructionsMoved changed.
+   * Unrolling, whilifying, and splitting a loop update the dependences of its
+   * function through it.
+   */
+  void setDependencesUpdater(
+      std::function<void(Function *f,
+                         std::set<Instruction *> const &instructionsRemoved,
+                         std::set<Instruction *> const &instructionsAdded,
+                         std::set<Instruction *> const &instructionsMoved)>
+          updater);
+
+  /*
+   * Unroll @loop @unrollFactor times.
+   * The trip count of @loop does not need to be known at compile time: a
+   * remainder loop, which gets a new ID, executes the iterations left.
+   */
   LoopUnrollResult unrollLoop(LoopContent *loop, uint32_t unrollFactor);
 
+  /*
+   * Unroll @loop by the factor requested for it (INDEX_FILE).
+   */
+  LoopUnrollResult unrollLoop(LoopContent *loop);
+
   bool fullyUnrollLoop(LoopContent *loop);
 
   bool whilifyLoop(LoopContent *loop);
 
+  /*
+   * Move @SCCsToPullOut from @loop to a new loop.
+   * The dependences of the function are updated; the instructions removed and
+   * added are added to the related sets as well.
+   */
   bool splitLoop(LoopContent *loop,
                  std::set<SCC *> const &SCCsToPullOut,
                  std::set<Instruction *> &instructionsRemoved,
                  std::set<Instruction *> &instructionsAdded);
 
+  /*
+   * Version @loop on run-time checks that the memory ranges accessed by the
+   * ends of its may memory dependences do not overlap.
+   *
+   * The original loop becomes the fast path.
+   * Return the content of the fast path, which is computed without the
+   * guarded dependences (they are not removed from the PDG of the program, as
+   * they still hold in the slow path), or nullptr if @loop is not versioned.
+   * The caller owns the returned content; @loop is stale afterwards.
+   * The instructions of the checks and of the slow path are added to
+   * @instructionsAdded, which the caller must use to update the dependences of
+   * the function.
+   */
+  LoopContent *versionLoopWithAliasChecks(
+      LoopContent *loop,
+      std::set<Instruction *> &instructionsAdded);
+
+  /*
+   * Tile the inner loop of the perfect loop nest @loop to reuse cache lines
+   * between iterations of the outer loop.
+   *
+   * The tile size is the one requested for @loop (INDEX_FILE) if any, or it is
+   * derived from the caches of the target architecture otherwise.
+   * The instructions added are added to @instructionsAdded, which the caller
+   * must use to update the dependences of the function.
+   */
+  bool tileLoop(LoopContent *loop, std::set<Instruction *> &instructionsAdded);
+
+  /*
+   * Interchange the perfect loop nest @loop if this gives unit-stride accesses
+   * to the innermost loop.
+   *
+   * The loops of the nest keep their basic blocks, so the loop structures, the
+   * loop forest, and the loop IDs stay valid; the contents of the loops (e.g.,
+   * their induction variables) must be fetched again.
+   * The instructions added are added to @instructionsAdded, which the caller
+   * must use to update the dependences of the function.
+   */
+  bool interchangeLoop(LoopContent *loop,
+                       std::set<Instruction *> &instructionsAdded);
+
+  /*
+   * Fuse the loop @second, which must follow @first, into @first.
+   *
+   * The fused loop keeps the basic blocks and the ID of @first; @second and
+   * the loop structures and contents of the function are stale afterwards.
+   * The instructions removed, added, and moved are added to the related sets,
+   * which the caller must use to update the dependences of the function.
+   */
+  bool fuseLoops(LoopContent *first,
+                 LoopContent *second,
+                 std::set<Instruction *> &instructionsRemoved,
+                 std::set<Instruction *> &instructionsAdded,
+                 std::set<Instruction *> &instructionsMoved);
+
+  /*
+   * Estimate the bytes that fusing @second into @first saves from being
+   * brought back from memory, based on @profiles.
+   */
+  uint64_t estimateBytesSavedByFusion(LoopContent *first,
+                                      LoopContent *second,
+                                      Hot *profiles);
+
   virtual ~LoopTransformer();
 
   bool doInitialization(Module &M) override;
@@ -59,6 +162,26 @@ public:
 
 private:
   PDG *pdg;
+  std::function<LoopContent *(BasicBlock *header,
+                              PDG *functionDG,
+                              LoopTransformationsManager *ltm)>
+      loopContentBuilder;
+  std::function<void(Function *f,
+                     std::set<Instruction *> const &instructionsRemoved,
+                     std::set<Instruction *> const &instructionsAdded,
+                     std::set<Instruction *> const &instructionsMoved)>
+      dependencesUpdater;
+
+  /*
+   * Update the dependences of @f after a transformation that rewrote the CFG
+   * of one of its loops.
+   * @handles are the instructions of @f, and @terminators the terminators of
+   * the loop, before the transformation.
+   */
+  void updateDependencesAfterRewritingLoop(
+      Function &f,
+      std::vector<std::pair<Instruction *, WeakVH>> const &handles,
+      std::vector<WeakVH> const &terminators);
 };
 
 } // namespace arcana::noelle
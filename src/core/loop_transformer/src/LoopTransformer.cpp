@@ -24,6 +24,10 @@
 #include "noelle/core/LoopWhilify.hpp"
 #include "noelle/core/LoopUnroll.hpp"
 #include "noelle/core/LoopDistribution.hpp"
+#include "noelle/core/LoopVersioner.hpp"
+#include "noelle/core/LoopTiler.hpp"
+#include "noelle/core/LoopInterchanger.hpp"
+#include "noelle/core/LoopFusion.hpp"
 
 namespace arcana::noelle {
 
@@ -38,6 +42,65 @@ void LoopTransformer::setPDG(PDG *programDependenceGraph) {
   return;
 }
 
+void LoopTransformer::setLoopContentBuilder(
+    std::function<LoopContent *(BasicBlock *header,
+                                PDG *functionDG,
+                                LoopTransformationsManager *ltm)> builder) {
+  this->loopContentBuilder = builder;
+
+  return;
+}
+
+void LoopTransformer::setDependencesUpdater(
+    std::function<void(Function *f,
+                       std::set<Instruction *> const &instructionsRemoved,
+                       std::set<Instruction *> const &instructionsAdded,
+                       std::set<Instruction *> const &instructionsMoved)>
+        updater) {
+  this->dependencesUpdater = updater;
+
+  return;
+}
+
+void LoopTransformer::updateDependencesAfterRewritingLoop(
+    Function &f,
+    std::vector<std::pair<Instruction *, WeakVH>> const &handles,
+    std::vector<WeakVH> const &terminators) {
+  assert(this->dependencesUpdater);
+
+  /*
+   * Collect the instructions erased and created by the transformation.
+   */
+  std::set<Instruction *> instructionsRemoved;
+  std::set<Instruction *> instructionsAdded;
+  Utils::diffInstructions(f, handles, instructionsRemoved, instructionsAdded);
+
+  /*
+   * The terminators of the loop that survived might branch elsewhere now.
+   */
+  std::set<Instruction *> instructionsMoved;
+  for (auto &terminator : terminators) {
+    Value *current = terminator;
+    if (current == nullptr) {
+      continue;
+    }
+    auto terminatorInst = cast<Instruction>(current);
+    if (instructionsAdded.count(terminatorInst) == 0) {
+      instructionsMoved.insert(terminatorInst);
+    }
+  }
+
+  /*
+   * Update the dependences.
+   */
+  this->dependencesUpdater(&f,
+                           instructionsRemoved,
+                           instructionsAdded,
+                           instructionsMoved);
+
+  return;
+}
+
 LoopUnrollResult LoopTransformer::unrollLoop(LoopContent *loop,
                                              uint32_t unrollFactor) {
 
@@ -47,11 +110,6 @@ LoopUnrollResult LoopTransformer::unrollLoop(LoopContent *loop,
   auto ls = loop->getLoopStructure();
   auto lsFunction = ls->getFunction();
 
-  /*
-   * Fetch the trip count.
-   */
-  auto loopTripCount = (uint32_t)loop->getCompileTimeTripCount();
-
   /*
    * Fetch the LLVM loop abstractions.
    */
@@ -62,33 +120,44 @@ LoopUnrollResult LoopTransformer::unrollLoop(LoopContent *loop,
       getAnalysis<AssumptionCacheTracker>().getAssumptionCache(*lsFunction);
 
   /*
-   * Fetch the LLVM loop.
+   * Remember the code before unrolling it.
    */
-  auto h = ls->getHeader();
-  auto llvmLoop = LLVMLoops.getLoopFor(h);
-  assert(llvmLoop != nullptr);
+  auto handles = Utils::fetchInstructionHandles(*lsFunction);
+  std::vector<WeakVH> terminators;
+  for (auto bb : ls->getBasicBlocks()) {
+    terminators.push_back(WeakVH(bb->getTerminator()));
+  }
 
   /*
    * Try to unroll the loop
    */
-  UnrollLoopOptions opts;
-  opts.Count = unrollFactor;
-  opts.TripCount = loopTripCount;
-  opts.Force = false;
-  opts.AllowRuntime = false;
-  opts.AllowExpensiveTripCount = true;
-  opts.PreserveCondBr = false;
-  opts.TripMultiple = SE.getSmallConstantTripMultiple(llvmLoop);
-  opts.PeelCount = 0;
-  opts.UnrollRemainder = false;
-  opts.ForgetAllSCEV = true;
-  OptimizationRemarkEmitter ORE(lsFunction);
+  LoopUnroll unroller;
   auto unrolled =
-      UnrollLoop(llvmLoop, opts, &LLVMLoops, &SE, &DT, &AC, &ORE, true);
+      unroller.unrollLoop(*loop, unrollFactor, LLVMLoops, DT, SE, AC);
+
+  /*
+   * Update the dependences of the function.
+   */
+  if (unrolled != LoopUnrollResult::Unmodified) {
+    this->updateDependencesAfterRewritingLoop(*lsFunction,
+                                              handles,
+                                              terminators);
+  }
 
   return unrolled;
 }
 
+LoopUnrollResult LoopTransformer::unrollLoop(LoopContent *loop) {
+
+  /*
+   * Fetch the unroll factor requested for the loop (INDEX_FILE).
+   */
+  auto ltm = loop->getLoopTransformationsManager();
+  auto unrollFactor = ltm->getUnrollFactor();
+
+  return this->unrollLoop(loop, unrollFactor);
+}
+
 bool LoopTransformer::fullyUnrollLoop(LoopContent *loop) {
 
   /*
@@ -106,8 +175,30 @@ bool LoopTransformer::fullyUnrollLoop(LoopContent *loop) {
   auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(loopFunction).getSE();
   auto &AC =
       getAnalysis<AssumptionCacheTracker>().getAssumptionCache(loopFunction);
+
+  /*
+   * Remember the code before unrolling it.
+   */
+  auto handles = Utils::fetchInstructionHandles(loopFunction);
+  std::vector<WeakVH> terminators;
+  for (auto bb : ls->getBasicBlocks()) {
+    terminators.push_back(WeakVH(bb->getTerminator()));
+  }
+
+  /*
+   * Unroll the loop.
+   */
   auto modified = loopUnroll.fullyUnrollLoop(*loop, LS, DT, SE, AC);
 
+  /*
+   * Update the dependences of the function.
+   */
+  if (modified) {
+    this->updateDependencesAfterRewritingLoop(loopFunction,
+                                              handles,
+                                              terminators);
+  }
+
   return modified;
 }
 
@@ -133,7 +224,27 @@ bool LoopTransformer::whilifyLoop(LoopContent *loop) {
   /*
    * Whilify the loop.
    */
-  auto modified = loopWhilify.whilifyLoop(*loop, scheduler, DS, FDG);
+  std::set<Instruction *> instructionsRemoved;
+  std::set<Instruction *> instructionsAdded;
+  std::set<Instruction *> instructionsMoved;
+  auto modified = loopWhilify.whilifyLoop(*loop,
+                                          scheduler,
+                                          DS,
+                                          FDG,
+                                          instructionsRemoved,
+                                          instructionsAdded,
+                                          instructionsMoved);
+
+  /*
+   * Update the dependences of the function.
+   */
+  if (modified) {
+    assert(this->dependencesUpdater);
+    this->dependencesUpdater(func,
+                             instructionsRemoved,
+                             instructionsAdded,
+                             instructionsMoved);
+  }
 
   return modified;
 }
@@ -163,7 +274,212 @@ bool LoopTransformer::splitLoop(LoopContent *loop,
                                instructionsRemoved,
                                instructionsAdded);
 
+  /*
+   * Update the dependences of the function.
+   * Splitting a loop does not move instructions: it clones them.
+   */
+  if (modified) {
+    assert(this->dependencesUpdater);
+    auto loopFunction = loop->getLoopStructure()->getFunction();
+    std::set<Instruction *> instructionsMoved;
+    this->dependencesUpdater(loopFunction,
+                             instructionsRemoved,
+                             instructionsAdded,
+                             instructionsMoved);
+  }
+
+  return modified;
+}
+
+LoopContent *LoopTransformer::versionLoopWithAliasChecks(
+    LoopContent *loop,
+    std::set<Instruction *> &instructionsAdded) {
+  assert(this->pdg != nullptr);
+  assert(this->loopContentBuilder);
+
+  /*
+   * Check trivial cases
+   */
+  if (loop == nullptr) {
+    return nullptr;
+  }
+
+  /*
+   * Fetch the LLVM abstractions of the function.
+   */
+  auto ls = loop->getLoopStructure();
+  auto &loopFunction = *ls->getFunction();
+  auto &LI = getAnalysis<LoopInfoWrapperPass>(loopFunction).getLoopInfo();
+  auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(loopFunction).getSE();
+
+  /*
+   * Version the loop.
+   */
+  LoopVersioner versioner;
+  std::set<std::pair<Instruction *, Instruction *>> guardedInstructions;
+  auto modified = versioner.versionLoopWithAliasChecks(*loop,
+                                                       LI,
+                                                       SE,
+                                                       guardedInstructions,
+                                                       instructionsAdded);
+  if (!modified) {
+    return nullptr;
+  }
+
+  /*
+   * The dependences guarded by the checks do not exist in the fast path.
+   * They still exist in the slow path, so only the dependence graph used for
+   * the fast path loses them.
+   */
+  auto functionDG = this->pdg->createFunctionSubgraph(loopFunction);
+  for (auto pair : guardedInstructions) {
+    for (auto dep : functionDG->getDependences(pair.first, pair.second)) {
+      if (isa<MayMemoryDependence<Value, Value>>(dep)) {
+        functionDG->removeEdge(dep);
+      }
+    }
+  }
+
+  /*
+   * Compute the content of the fast path from scratch, so that its SCCs and
+   * its loop structure (e.g., its new pre-header) reflect the new code.
+   * The fast path keeps the header of the original loop.
+   */
+  auto ltm = loop->getLoopTransformationsManager();
+  auto fastLoop = this->loopContentBuilder(ls->getHeader(), functionDG, ltm);
+  fastLoop->copyParallelizationOptionsFrom(loop);
+
+  return fastLoop;
+}
+
+bool LoopTransformer::tileLoop(LoopContent *loop,
+                               std::set<Instruction *> &instructionsAdded) {
+
+  /*
+   * Check trivial cases
+   */
+  if (loop == nullptr) {
+    return false;
+  }
+
+  /*
+   * Fetch the LLVM abstractions of the function.
+   */
+  auto ls = loop->getLoopStructure();
+  auto &loopFunction = *ls->getFunction();
+  auto &LI = getAnalysis<LoopInfoWrapperPass>(loopFunction).getLoopInfo();
+  auto &DT = getAnalysis<DominatorTreeWrapperPass>(loopFunction).getDomTree();
+  auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(loopFunction).getSE();
+
+  /*
+   * Fetch the tile size requested for the loop.
+   */
+  auto ltm = loop->getLoopTransformationsManager();
+  auto tileSize = ltm->getTileSize();
+
+  /*
+   * Tile the loop.
+   */
+  LoopTiler tiler;
+  auto modified =
+      tiler.tileLoop(*loop, LI, DT, SE, tileSize, instructionsAdded);
+
+  return modified;
+}
+
+bool LoopTransformer::interchangeLoop(
+    LoopContent *loop,
+    std::set<Instruction *> &instructionsAdded) {
+
+  /*
+   * Check trivial cases
+   */
+  if (loop == nullptr) {
+    return false;
+  }
+
+  /*
+   * Fetch the LLVM abstractions of the function.
+   */
+  auto ls = loop->getLoopStructure();
+  auto &loopFunction = *ls->getFunction();
+  auto &LI = getAnalysis<LoopInfoWrapperPass>(loopFunction).getLoopInfo();
+  auto &DT = getAnalysis<DominatorTreeWrapperPass>(loopFunction).getDomTree();
+  auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(loopFunction).getSE();
+
+  /*
+   * Interchange the loops.
+   */
+  LoopInterchanger interchanger;
+  auto modified =
+      interchanger.interchangeLoop(*loop, LI, DT, SE, instructionsAdded);
+
+  return modified;
+}
+
+bool LoopTransformer::fuseLoops(LoopContent *first,
+                                LoopContent *second,
+                                std::set<Instruction *> &instructionsRemoved,
+                                std::set<Instruction *> &instructionsAdded,
+                                std::set<Instruction *> &instructionsMoved) {
+
+  /*
+   * Check trivial cases
+   */
+  if ((first == nullptr) || (second == nullptr)) {
+    return false;
+  }
+  assert(this->pdg != nullptr);
+
+  /*
+   * Fetch the LLVM abstractions of the function.
+   */
+  auto ls = first->getLoopStructure();
+  auto &loopFunction = *ls->getFunction();
+  auto &LI = getAnalysis<LoopInfoWrapperPass>(loopFunction).getLoopInfo();
+  auto &DT = getAnalysis<DominatorTreeWrapperPass>(loopFunction).getDomTree();
+  auto &PDT =
+      getAnalysis<PostDominatorTreeWrapperPass>(loopFunction).getPostDomTree();
+  auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(loopFunction).getSE();
+  DominatorSummary DS(DT, PDT);
+
+  /*
+   * Fuse the loops.
+   */
+  LoopFusion fusion;
+  auto modified = fusion.fuseLoops(*first,
+                                   *second,
+                                   *this->pdg,
+                                   DS,
+                                   LI,
+                                   SE,
+                                   instructionsRemoved,
+                                   instructionsAdded,
+                                   instructionsMoved);
+
   return modified;
 }
 
+uint64_t LoopTransformer::estimateBytesSavedByFusion(LoopContent *first,
+                                                     LoopContent *second,
+                                                     Hot *profiles) {
+
+  /*
+   * Check trivial cases
+   */
+  if ((first == nullptr) || (second == nullptr) || (profiles == nullptr)) {
+    return 0;
+  }
+
+  /*
+   * Estimate the bytes saved.
+   */
+  auto &loopFunction = *first->getLoopStructure()->getFunction();
+  auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(loopFunction).getSE();
+  LoopFusion fusion;
+  auto bytes = fusion.estimateBytesSaved(*first, *second, SE, *profiles);
+
+  return bytes;
+}
+
 } // namespace arcana::noelle
@@ -22,6 +22,8 @@
 #ifndef NOELLE_SRC_CORE_LOOP_UNROLL_LOOPUNROLL_H_
 #define NOELLE_SRC_CORE_LOOP_UNROLL_LOOPUNROLL_H_
 
+#include "llvm/Transforms/Utils/UnrollLoop.h"
+
 #include "noelle/core/SystemHeaders.hpp"
 #include "noelle/core/SCC.hpp"
 #include "noelle/core/LoopContent.hpp"
@@ -44,6 +46,24 @@ public:
                        ScalarEvolution &SE,
                        AssumptionCache &AC);
 
+  /*
+   * Unroll the loop @unrollFactor times.
+   *
+   * The trip count of the loop does not need to be known at compile time: the
+   * iterations that do not fill an unrolled iteration are executed by a
+   * remainder loop.
+   * The unrolled loop keeps the ID of the original loop, while the remainder
+   * loop gets a new ID, so the IDs of the other loops do not change.
+   * The NOELLE metadata of the original loop (not those of the PDG, which
+   * belong to instructions) are kept in both loops.
+   */
+  LoopUnrollResult unrollLoop(LoopContent const &LDI,
+                              uint32_t unrollFactor,
+                              LoopInfo &LI,
+                              DominatorTree &DT,
+                              ScalarEvolution &SE,
+                              AssumptionCache &AC);
+
 private:
   /*
    * Fields
@@ -52,6 +72,14 @@ private:
   /*
    * Methods
    */
+  std::vector<std::pair<unsigned, MDNode *>> fetchNOELLEMetadata(
+      Instruction *headerTerminator) const;
+
+  void setNOELLEMetadata(
+      Loop *loop,
+      std::vector<std::pair<unsigned, MDNode *>> const &metadata) const;
+
+  uint64_t fetchNextLoopID(Module &M) const;
 };
 
 } // namespace arcana::noelle
@@ -106,4 +106,187 @@ bool LoopUnroll::fullyUnrollLoop(LoopContent const &LDI,
   return modified;
 }
 
+LoopUnrollResult LoopUnroll::unrollLoop(LoopContent const &LDI,
+                                        uint32_t unrollFactor,
+                                        LoopInfo &LI,
+                                        DominatorTree &DT,
+                                        ScalarEvolution &SE,
+                                        AssumptionCache &AC) {
+
+  /*
+   * Check if there is something to unroll.
+   */
+  if (unrollFactor < 2) {
+    return LoopUnrollResult::Unmodified;
+  }
+
+  /*
+   * Fetch the loop summary
+   */
+  auto ls = LDI.getLoopStructure();
+  auto loopFunction = ls->getFunction();
+
+  /*
+   * Fetch the LLVM loop.
+   */
+  auto h = ls->getHeader();
+  auto llvmLoop = LI.getLoopFor(h);
+  assert(llvmLoop != nullptr);
+
+  /*
+   * Fetch the NOELLE metadata of the loop.
+   * The unrolling can replace the terminator of the header that holds them,
+   * and it clones them in every copy of the header.
+   */
+  auto noelleMetadata = this->fetchNOELLEMetadata(h->getTerminator());
+  auto hasID = ls->doesHaveID();
+
+  /*
+   * Fetch the trip count.
+   * 0 means that the trip count is not known at compile time.
+   */
+  uint32_t tripCount = 0;
+  if (LDI.doesHaveCompileTimeKnownTripCount()) {
+    tripCount = LDI.getCompileTimeTripCount();
+  }
+
+  /*
+   * Try to unroll the loop
+   *
+   * The iterations left by the unrolled loop are executed by a remainder loop,
+   * which is not unrolled.
+   */
+  UnrollLoopOptions opts;
+  opts.Count = unrollFactor;
+  opts.TripCount = tripCount;
+  opts.Force = false;
+  opts.AllowRuntime = true;
+  opts.AllowExpensiveTripCount = true;
+  opts.PreserveCondBr = false;
+  opts.TripMultiple = SE.getSmallConstantTripMultiple(llvmLoop);
+  opts.PeelCount = 0;
+  opts.UnrollRemainder = false;
+  opts.ForgetAllSCEV = true;
+  OptimizationRemarkEmitter ORE(loopFunction);
+  Loop *remainderLoop = nullptr;
+  auto unrolled = UnrollLoop(llvmLoop,
+                             opts,
+                             &LI,
+                             &SE,
+                             &DT,
+                             &AC,
+                             &ORE,
+                             true,
+                             &remainderLoop);
+  if (unrolled != LoopUnrollResult::PartiallyUnrolled) {
+    return unrolled;
+  }
+
+  /*
+   * The unrolled loop keeps the header, and therefore the ID, of the original
+   * loop.
+   */
+  this->setNOELLEMetadata(llvmLoop, noelleMetadata);
+
+  /*
+   * The remainder loop gets the NOELLE metadata of the original loop and a new
+   * ID.
+   */
+  if (remainderLoop != nullptr) {
+    this->setNOELLEMetadata(remainderLoop, noelleMetadata);
+    if (hasID) {
+      auto remainderID = this->fetchNextLoopID(*loopFunction->getParent());
+      LoopStructure remainderLS{ remainderLoop };
+      remainderLS.setID(remainderID);
+    }
+  }
+
+  return unrolled;
+}
+
+std::vector<std::pair<unsigned, MDNode *>> LoopUnroll::fetchNOELLEMetadata(
+    Instruction *headerTerminator) const {
+
+  /*
+   * Fetch the names of the metadata kinds.
+   */
+  SmallVector<StringRef, 8> kindNames;
+  headerTerminator->getContext().getMDKindNames(kindNames);
+
+  /*
+   * Collect the metadata of NOELLE that describe the loop.
+   *
+   * The metadata of the PDG (e.g., noelle.pdg.inst.id) describe the
+   * terminator itself rather than the loop, so they are left alone.
+   */
+  std::vector<std::pair<unsigned, MDNode *>> noelleMetadata;
+  SmallVector<std::pair<unsigned, MDNode *>, 4> allMetadata;
+  headerTerminator->getAllMetadata(allMetadata);
+  for (auto &kindAndNode : allMetadata) {
+    auto kindName = kindNames[kindAndNode.first];
+    if (false || (!kindName.startswith("noelle."))
+        || kindName.startswith("noelle.pdg.")) {
+      continue;
+    }
+    noelleMetadata.push_back(kindAndNode);
+  }
+
+  return noelleMetadata;
+}
+
+void LoopUnroll::setNOELLEMetadata(
+    Loop *loop,
+    std::vector<std::pair<unsigned, MDNode *>> const &metadata) const {
+
+  /*
+   * Only the terminator of the header holds the metadata of the loop.
+   * The headers of the sub-loops hold the metadata of the sub-loops.
+   */
+  std::unordered_set<BasicBlock *> blocksOfSubLoops;
+  for (auto subLoop : loop->getSubLoops()) {
+    blocksOfSubLoops.insert(subLoop->block_begin(), subLoop->block_end());
+  }
+  auto header = loop->getHeader();
+  for (auto bb : loop->blocks()) {
+    if (blocksOfSubLoops.count(bb) > 0) {
+      continue;
+    }
+    auto terminator = bb->getTerminator();
+    for (auto &kindAndNode : metadata) {
+      if (bb == header) {
+        terminator->setMetadata(kindAndNode.first, kindAndNode.second);
+      } else {
+        terminator->setMetadata(kindAndNode.first, nullptr);
+      }
+    }
+  }
+
+  return;
+}
+
+uint64_t LoopUnroll::fetchNextLoopID(Module &M) const {
+
+  /*
+   * Find the highest loop ID of the module.
+   */
+  uint64_t nextID = 0;
+  for (auto &F : M) {
+    for (auto &bb : F) {
+      auto terminator = bb.getTerminator();
+      if (terminator == nullptr) {
+        continue;
+      }
+      auto node = terminator->getMetadata(LoopStructure::metadataKeyID);
+      if (node == nullptr) {
+        continue;
+      }
+      auto idAsString = cast<MDString>(node->getOperand(0))->getString();
+      uint64_t id = std::stoull(idAsString.str());
+      nextID = std::max(nextID, id + 1);
+    }
+  }
+
+  return nextID;
+}
+
 } // namespace arcana::noelle
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_CORE_LOOP_VERSIONING_LOOPVERSIONER_H_
+#define NOELLE_SRC_CORE_LOOP_VERSIONING_LOOPVERSIONER_H_
+
+#include "llvm/Analysis/ScalarEvolutionExpander.h"
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopContent.hpp"
+
+namespace arcana::noelle {
+
+class LoopVersioner {
+public:
+  /*
+   * Constructor
+   */
+  LoopVersioner();
+
+  /*
+   * Version @loop on the condition that the memory ranges accessed by the two
+   * ends of some of its may memory dependences do not overlap.
+   *
+   * A check of these ranges is added to the pre-header of @loop.
+   * When the check succeeds, the original loop runs; this is the fast path, as
+   * the dependences guarded by the check do not exist.
+   * A copy of @loop runs otherwise.
+   * Each version is reached through a new, dedicated pre-header.
+   *
+   * The pairs of instructions whose dependences are guarded by the check are
+   * added to @guardedInstructions.
+   * The instructions of the check and of the copy are added to
+   * @instructionsAdded.
+   * @loop must be in LCSSA form. @LI is not updated.
+   */
+  bool versionLoopWithAliasChecks(
+      LoopContent &loop,
+      LoopInfo &LI,
+      ScalarEvolution &SE,
+      std::set<std::pair<Instruction *, Instruction *>> &guardedInstructions,
+      std::set<Instruction *> &instructionsAdded);
+
+private:
+  /*
+   * Range of addresses accessed by a memory instruction during all iterations
+   * of a loop: [begin, end).
+   */
+  struct MemoryRange {
+    const SCEV *base;
+    const SCEV *begin;
+    const SCEV *end;
+  };
+
+  /*
+   * Fields
+   */
+  const uint32_t maximumNumberOfChecks = 8;
+
+  /*
+   * Methods
+   */
+  std::optional<MemoryRange> computeAccessedRange(LoopContent &loop,
+                                                  Loop *llvmLoop,
+                                                  ScalarEvolution &SE,
+                                                  Instruction *memoryInst);
+
+  bool isInLCSSAForm(LoopStructure *loop) const;
+
+  Value *generateCodeToCheckForOverlaps(
+      Instruction *insertPoint,
+      ScalarEvolution &SE,
+      std::vector<std::pair<MemoryRange, MemoryRange>> const &checks);
+
+  BasicBlock *createPreheader(BasicBlock *predecessor,
+                              BasicBlock *header,
+                              const Twine &name);
+
+  BasicBlock *cloneLoop(LoopStructure *loop, ValueToValueMapTy &clones);
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_CORE_LOOP_VERSIONING_LOOPVERSIONER_H_
@@ -0,0 +1,428 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopVersioner.hpp"
+#include "noelle/core/MayMemoryDependence.hpp"
+
+namespace arcana::noelle {
+
+LoopVersioner::LoopVersioner() {
+  return;
+}
+
+bool LoopVersioner::versionLoopWithAliasChecks(
+    LoopContent &loop,
+    LoopInfo &LI,
+    ScalarEvolution &SE,
+    std::set<std::pair<Instruction *, Instruction *>> &guardedInstructions,
+    std::set<Instruction *> &instructionsAdded) {
+
+  /*
+   * Fetch the loop.
+   */
+  auto ls = loop.getLoopStructure();
+  auto header = ls->getHeader();
+  auto preheader = ls->getPreHeader();
+  auto llvmLoop = LI.getLoopFor(header);
+  assert(llvmLoop != nullptr);
+
+  /*
+   * Check the shape of the loop.
+   * The pre-header will host the check, so it must lead only to the header.
+   * Values produced by the loop must reach the rest of the function only
+   * through PHIs of the exit blocks, which can merge the values of the copy.
+   */
+  if (preheader == nullptr) {
+    return false;
+  }
+  auto preheaderTerminator = dyn_cast<BranchInst>(preheader->getTerminator());
+  if ((preheaderTerminator == nullptr)
+      || (preheaderTerminator->getNumSuccessors() != 1)) {
+    return false;
+  }
+  if (!this->isInLCSSAForm(ls)) {
+    return false;
+  }
+
+  /*
+   * Collect the may memory dependences that a check of the accessed ranges can
+   * remove.
+   * They must relate accesses to different objects.
+   */
+  std::unordered_map<Instruction *, std::optional<MemoryRange>> ranges;
+  auto fetchRange = [&](Instruction *inst) -> std::optional<MemoryRange> {
+    if (ranges.find(inst) == ranges.end()) {
+      ranges[inst] = this->computeAccessedRange(loop, llvmLoop, SE, inst);
+    }
+    return ranges[inst];
+  };
+  std::vector<std::pair<MemoryRange, MemoryRange>> checks;
+  std::set<std::pair<const SCEV *, const SCEV *>> checkedBases;
+  std::set<std::pair<Instruction *, Instruction *>> guardable;
+  auto isLoopCarriedDependenceGuarded = false;
+  auto loopDG = loop.getLoopDG();
+  for (auto edge : loopDG->getSortedDependences()) {
+    if (!isa<MayMemoryDependence<Value, Value>>(edge)) {
+      continue;
+    }
+    auto src = dyn_cast<Instruction>(edge->getSrc());
+    auto dst = dyn_cast<Instruction>(edge->getDst());
+    if ((src == nullptr) || (dst == nullptr)) {
+      continue;
+    }
+    if (!ls->isIncluded(src) || !ls->isIncluded(dst)) {
+      continue;
+    }
+
+    /*
+     * Compute the ranges of addresses accessed by the two instructions.
+     */
+    auto srcRange = fetchRange(src);
+    auto dstRange = fetchRange(dst);
+    if (!srcRange.has_value() || !dstRange.has_value()) {
+      continue;
+    }
+    if (srcRange->base == dstRange->base) {
+      continue;
+    }
+
+    /*
+     * The dependence can be guarded.
+     * Ranges of the same pair of objects are checked once.
+     */
+    auto basePair = std::make_pair(std::min(srcRange->base, dstRange->base),
+                                   std::max(srcRange->base, dstRange->base));
+    if (checkedBases.find(basePair) == checkedBases.end()) {
+      if (checks.size() == this->maximumNumberOfChecks) {
+        continue;
+      }
+      checks.push_back(std::make_pair(srcRange.value(), dstRange.value()));
+      checkedBases.insert(basePair);
+    }
+    guardable.insert(std::make_pair(src, dst));
+    if (edge->isLoopCarriedDependence()) {
+      isLoopCarriedDependenceGuarded = true;
+    }
+  }
+
+  /*
+   * Check if versioning the loop is worth it.
+   * Dependences within an iteration do not prevent the parallelization of the
+   * loop.
+   */
+  if (!isLoopCarriedDependenceGuarded) {
+    return false;
+  }
+
+  /*
+   * Make sure the ranges checked are the ones of the objects accessed.
+   * Ranges of different accesses to the same pair of objects are merged.
+   */
+  for (auto &check : checks) {
+    for (auto &range : ranges) {
+      if (!range.second.has_value()) {
+        continue;
+      }
+      auto &r = range.second.value();
+      for (auto checkedRange : { &check.first, &check.second }) {
+        if (r.base != checkedRange->base) {
+          continue;
+        }
+        checkedRange->begin = SE.getUMinExpr(checkedRange->begin, r.begin);
+        checkedRange->end = SE.getUMaxExpr(checkedRange->end, r.end);
+      }
+    }
+  }
+
+  /*
+   * Generate the check in the pre-header.
+   */
+  std::set<Instruction *> preheaderInstructions;
+  for (auto &inst : *preheader) {
+    preheaderInstructions.insert(&inst);
+  }
+  auto overlap =
+      this->generateCodeToCheckForOverlaps(preheaderTerminator, SE, checks);
+
+  /*
+   * Create the slow path.
+   */
+  ValueToValueMapTy clones;
+  auto headerClone = this->cloneLoop(ls, clones);
+
+  /*
+   * Give each version a dedicated pre-header.
+   * The block that hosts the check has two successors, so it cannot be the
+   * pre-header of either version.
+   */
+  auto fastPreheader =
+      this->createPreheader(preheader, header, "noelle.versioning.fast");
+  auto slowPreheader =
+      this->createPreheader(preheader, headerClone, "noelle.versioning.slow");
+  instructionsAdded.insert(fastPreheader->getTerminator());
+  instructionsAdded.insert(slowPreheader->getTerminator());
+
+  /*
+   * Jump to the slow path if the ranges overlap.
+   */
+  IRBuilder<> preheaderBuilder(preheaderTerminator);
+  preheaderBuilder.CreateCondBr(overlap, slowPreheader, fastPreheader);
+  preheaderInstructions.erase(preheaderTerminator);
+  preheaderTerminator->eraseFromParent();
+
+  /*
+   * Keep track of the changes.
+   */
+  guardedInstructions.insert(guardable.begin(), guardable.end());
+  for (auto &inst : *preheader) {
+    if (preheaderInstructions.find(&inst) == preheaderInstructions.end()) {
+      instructionsAdded.insert(&inst);
+    }
+  }
+  for (auto bb : ls->getBasicBlocks()) {
+    auto bbClone = cast<BasicBlock>(clones[bb]);
+    for (auto &inst : *bbClone) {
+      instructionsAdded.insert(&inst);
+    }
+  }
+
+  return true;
+}
+
+std::optional<LoopVersioner::MemoryRange> LoopVersioner::computeAccessedRange(
+    LoopContent &loop,
+    Loop *llvmLoop,
+    ScalarEvolution &SE,
+    Instruction *memoryInst) {
+
+  /*
+   * Fetch the type accessed.
+   */
+  Type *accessedType = nullptr;
+  if (auto load = dyn_cast<LoadInst>(memoryInst)) {
+    accessedType = load->getType();
+  } else if (auto store = dyn_cast<StoreInst>(memoryInst)) {
+    accessedType = store->getValueOperand()->getType();
+  } else {
+    return std::nullopt;
+  }
+
+  /*
+   * Fetch the instruction that computes the address accessed.
+   * Its access function must be known.
+   */
+  auto iterationSpace = loop.getLoopIterationSpaceAnalysis();
+  auto accessor = iterationSpace->getMemoryAccessor(memoryInst);
+  if (accessor == nullptr) {
+    return std::nullopt;
+  }
+  auto accessFunction = SE.getSCEV(accessor);
+
+  /*
+   * The object accessed must be the same for all iterations.
+   */
+  auto base = dyn_cast<SCEVUnknown>(SE.getPointerBase(accessFunction));
+  if ((base == nullptr) || !SE.isLoopInvariant(base, llvmLoop)) {
+    return std::nullopt;
+  }
+
+  /*
+   * Compute the first and last addresses accessed.
+   * The access function must be invariant or affine in the loop.
+   */
+  const SCEV *first = nullptr;
+  const SCEV *last = nullptr;
+  if (SE.isLoopInvariant(accessFunction, llvmLoop)) {
+    first = accessFunction;
+    last = accessFunction;
+
+  } else {
+    auto addRec = dyn_cast<SCEVAddRecExpr>(accessFunction);
+    if ((addRec == nullptr) || (addRec->getLoop() != llvmLoop)
+        || !addRec->isAffine()) {
+      return std::nullopt;
+    }
+    auto backedgeTakenCount = SE.getBackedgeTakenCount(llvmLoop);
+    if (isa<SCEVCouldNotCompute>(backedgeTakenCount)) {
+      return std::nullopt;
+    }
+    first = addRec->getStart();
+    last = addRec->evaluateAtIteration(backedgeTakenCount, SE);
+  }
+
+  /*
+   * The step might be negative.
+   * So, the range goes from the lowest address to the highest one plus the
+   * bytes accessed.
+   */
+  auto &DL = memoryInst->getModule()->getDataLayout();
+  auto intPtrType = DL.getIntPtrType(accessor->getType());
+  auto bytes = SE.getConstant(intPtrType, DL.getTypeStoreSize(accessedType));
+  MemoryRange range;
+  range.base = base;
+  range.begin = SE.getUMinExpr(first, last);
+  range.end = SE.getAddExpr(SE.getUMaxExpr(first, last), bytes);
+
+  return range;
+}
+
+bool LoopVersioner::isInLCSSAForm(LoopStructure *loop) const {
+  for (auto inst : loop->getInstructions()) {
+    for (auto user : inst->users()) {
+      auto userInst = cast<Instruction>(user);
+      if (loop->isIncluded(userInst)) {
+        continue;
+      }
+
+      /*
+       * The user is outside the loop.
+       * It must be a PHI of an exit block that merges the value with the ones
+       * of other paths.
+       */
+      auto phi = dyn_cast<PHINode>(userInst);
+      if (phi == nullptr) {
+        return false;
+      }
+      for (auto i = 0u; i < phi->getNumIncomingValues(); i++) {
+        if (phi->getIncomingValue(i) != inst) {
+          continue;
+        }
+        if (!loop->isIncluded(phi->getIncomingBlock(i))) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+Value *LoopVersioner::generateCodeToCheckForOverlaps(
+    Instruction *insertPoint,
+    ScalarEvolution &SE,
+    std::vector<std::pair<MemoryRange, MemoryRange>> const &checks) {
+  assert(checks.size() > 0);
+
+  /*
+   * Compare addresses as integers.
+   */
+  auto &DL = insertPoint->getModule()->getDataLayout();
+  auto intPtrType = DL.getIntPtrType(insertPoint->getContext());
+  SCEVExpander expander(SE, DL, "noelle.versioning");
+  IRBuilder<> builder(insertPoint);
+
+  /*
+   * Two ranges overlap if each one starts before the other one ends.
+   */
+  Value *overlap = nullptr;
+  for (auto &check : checks) {
+    auto &r1 = check.first;
+    auto &r2 = check.second;
+    auto begin1 = expander.expandCodeFor(r1.begin, intPtrType, insertPoint);
+    auto end1 = expander.expandCodeFor(r1.end, intPtrType, insertPoint);
+    auto begin2 = expander.expandCodeFor(r2.begin, intPtrType, insertPoint);
+    auto end2 = expander.expandCodeFor(r2.end, intPtrType, insertPoint);
+    auto r1BeforeEndOfR2 = builder.CreateICmpULT(begin1, end2);
+    auto r2BeforeEndOfR1 = builder.CreateICmpULT(begin2, end1);
+    auto rangesOverlap = builder.CreateAnd(r1BeforeEndOfR2, r2BeforeEndOfR1);
+    overlap = (overlap == nullptr) ? rangesOverlap
+                                   : builder.CreateOr(overlap, rangesOverlap);
+  }
+
+  return overlap;
+}
+
+BasicBlock *LoopVersioner::createPreheader(BasicBlock *predecessor,
+                                           BasicBlock *header,
+                                           const Twine &name) {
+
+  /*
+   * Create the pre-header.
+   */
+  auto &cxt = header->getContext();
+  auto f = header->getParent();
+  auto preheader = BasicBlock::Create(cxt, name, f, header);
+  BranchInst::Create(header, preheader);
+
+  /*
+   * The header is now reached from the new pre-header.
+   */
+  for (auto &phi : header->phis()) {
+    auto index = phi.getBasicBlockIndex(predecessor);
+    if (index >= 0) {
+      phi.setIncomingBlock(index, preheader);
+    }
+  }
+
+  return preheader;
+}
+
+BasicBlock *LoopVersioner::cloneLoop(LoopStructure *loop,
+                                     ValueToValueMapTy &clones) {
+
+  /*
+   * Clone the basic blocks of the loop.
+   */
+  auto header = loop->getHeader();
+  auto f = header->getParent();
+  SmallVector<BasicBlock *, 16> clonedBBs;
+  for (auto bb : loop->getBasicBlocks()) {
+    auto clonedBB = CloneBasicBlock(bb, clones, ".slow", f);
+    clones[bb] = clonedBB;
+    clonedBBs.push_back(clonedBB);
+  }
+
+  /*
+   * Make the clones use each other.
+   * Values defined outside the loop are shared by the two versions.
+   */
+  remapInstructionsInBlocks(clonedBBs, clones);
+
+  /*
+   * The ID of the loop belongs to the original one.
+   */
+  auto headerClone = cast<BasicBlock>(clones[header]);
+  headerClone->getTerminator()->setMetadata(LoopStructure::metadataKeyID,
+                                            nullptr);
+
+  /*
+   * Merge the values produced by the two versions in the exit blocks.
+   */
+  for (auto exitEdge : loop->getLoopExitEdges()) {
+    auto exitingBB = exitEdge.first;
+    auto exitBB = exitEdge.second;
+    auto exitingBBClone = cast<BasicBlock>(clones[exitingBB]);
+    for (auto &phi : exitBB->phis()) {
+      if (phi.getBasicBlockIndex(exitingBBClone) >= 0) {
+        continue;
+      }
+      auto value = phi.getIncomingValueForBlock(exitingBB);
+      if (clones.find(value) != clones.end()) {
+        value = clones[value];
+      }
+      phi.addIncoming(value, exitingBBClone);
+    }
+  }
+
+  return headerClone;
+}
+
+} // namespace arcana::noelle
@@ -87,10 +87,19 @@ public:
    */
   LoopWhilifier();
 
+  /*
+   * Shrink the prologue of the loop of @LDI or, if it cannot be shrunk,
+   * transform the loop into a while loop.
+   * The instructions removed, added, and moved are added to the related sets,
+   * which the caller must use to update the dependences of the function.
+   */
   bool whilifyLoop(LoopContent &LDI,
                    Scheduler &scheduler,
                    DominatorSummary *DS,
-                   PDG *FDG);
+                   PDG *FDG,
+                   std::set<Instruction *> &instructionsRemoved,
+                   std::set<Instruction *> &instructionsAdded,
+                   std::set<Instruction *> &instructionsMoved);
 
 private:
   /*
@@ -104,7 +113,10 @@ private:
   bool whilifyLoopDriver(LoopStructure *const LS,
                          Scheduler &scheduler,
                          DominatorSummary *DS,
-                         PDG *FDG);
+                         PDG *FDG,
+                         std::set<Instruction *> &InstructionsRemoved,
+                         std::set<Instruction *> &InstructionsAdded,
+                         std::set<Instruction *> &InstructionsMoved);
 
   bool containsInOriginalLoop(WhilifierContext const &WC, BasicBlock *const BB);
 
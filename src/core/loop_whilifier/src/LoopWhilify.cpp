@@ -19,6 +19,7 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include "noelle/core/Utils.hpp"
 #include "noelle/core/LoopWhilify.hpp"
 
 namespace arcana::noelle {
@@ -27,10 +28,14 @@ LoopWhilifier::LoopWhilifier() : outputPrefix{ "Whilifier: " } {
   return;
 }
 
-bool LoopWhilifier::whilifyLoop(LoopContent &LDI,
-                                Scheduler &scheduler,
-                                DominatorSummary *DS,
-                                PDG *FDG) {
+bool LoopWhilifier::whilifyLoop(
+    LoopContent &LDI,
+    Scheduler &scheduler,
+    DominatorSummary *DS,
+    PDG *FDG,
+    std::set<Instruction *> &instructionsRemoved,
+    std::set<Instruction *> &instructionsAdded,
+    std::set<Instruction *> &instructionsMoved) {
 
   /*
    * Execute on target loop from @LDI
@@ -40,7 +45,13 @@ bool LoopWhilifier::whilifyLoop(LoopContent &LDI,
   errs() << outputPrefix << " Try to whilify the target loop\n";
 
   auto LS = LDI.getLoopStructure();
-  AnyTransformed |= whilifyLoopDriver(LS, scheduler, DS, FDG);
+  AnyTransformed |= whilifyLoopDriver(LS,
+                                      scheduler,
+                                      DS,
+                                      FDG,
+                                      instructionsRemoved,
+                                      instructionsAdded,
+                                      instructionsMoved);
 
   errs() << outputPrefix << " Transformed = " << AnyTransformed << "\n";
   errs() << outputPrefix << "Exit\n";
@@ -48,10 +59,14 @@ bool LoopWhilifier::whilifyLoop(LoopContent &LDI,
   return AnyTransformed;
 }
 
-bool LoopWhilifier::whilifyLoopDriver(LoopStructure *const LS,
-                                      Scheduler &scheduler,
-                                      DominatorSummary *DS,
-                                      PDG *FDG) {
+bool LoopWhilifier::whilifyLoopDriver(
+    LoopStructure *const LS,
+    Scheduler &scheduler,
+    DominatorSummary *DS,
+    PDG *FDG,
+    std::set<Instruction *> &InstructionsRemoved,
+    std::set<Instruction *> &InstructionsAdded,
+    std::set<Instruction *> &InstructionsMoved) {
   auto Transformed = false;
 
   /*
@@ -76,12 +91,25 @@ bool LoopWhilifier::whilifyLoopDriver(LoopStructure *const LS,
   /*
    * Shrink the loop prologue (with debugging), return true immediately
    */
-  Transformed |= LSched.shrinkLoopPrologue();
+  Transformed |= LSched.shrinkLoopPrologue(InstructionsRemoved,
+                                           InstructionsAdded,
+                                           InstructionsMoved);
   if (Transformed) {
     errs() << outputPrefix << "       The prologue has shrunk\n";
     return Transformed;
   }
 
+  /*
+   * Remember the instructions of the function and the terminators
+   * of the loop --- whilifying rewrites the CFG, so the changes
+   * are collected at the end rather than tracked one by one
+   */
+  auto Handles = Utils::fetchInstructionHandles(*LS->getFunction());
+  std::vector<WeakVH> Terminators;
+  for (auto Block : LS->getBasicBlocks()) {
+    Terminators.push_back(WeakVH(Block->getTerminator()));
+  }
+
   /*
    * Check if the loop can be whilified
    */
@@ -167,6 +195,22 @@ bool LoopWhilifier::whilifyLoopDriver(LoopStructure *const LS,
   (WC.OriginalLatch)->eraseFromParent();
   WC.ResolvedLatch |= true;
 
+  /*
+   * Report the changes --- the surviving terminators of the
+   * original loop now branch elsewhere
+   */
+  Utils::diffInstructions(*F, Handles, InstructionsRemoved, InstructionsAdded);
+  for (auto &Terminator : Terminators) {
+    Value *Current = Terminator;
+    if (Current == nullptr) {
+      continue;
+    }
+    auto TerminatorInst = cast<Instruction>(Current);
+    if (InstructionsAdded.count(TerminatorInst) == 0) {
+      InstructionsMoved.insert(TerminatorInst);
+    }
+  }
+
   Transformed |= true;
   return Transformed;
 }
@@ -22,7 +22,9 @@
 #ifndef NOELLE_SRC_CORE_MAY_POINTS_TO_ANALYSIS_MAYPOINTSTOANALYSIS_H_
 #define NOELLE_SRC_CORE_MAY_POINTS_TO_ANALYSIS_MAYPOINTSTOANALYSIS_H_
 
+#include "llvm/ADT/SparseBitVector.h"
 #include "noelle/core/Utils.hpp"
+#include "noelle/core/CallGraph.hpp"
 
 namespace arcana::noelle {
 
@@ -32,6 +34,12 @@ class MpaSummary {
 public:
   MpaSummary(Function *currentF);
 
+  /*
+   * Whole-program summary: the summaries of all functions of @program are
+   * linked through the call and return edges of @programCallGraph.
+   */
+  MpaSummary(Module &program, CallGraph *programCallGraph);
+
   Function *currentF;
 
   std::unordered_set<StoreInst *> storeInsts;
@@ -43,11 +51,32 @@ public:
   bool mayBePointedByUnknown(Value *memobj);
   bool mayBePointedByReturnValue(Value *memobj);
   std::unordered_set<Value *> getPointeeMemobjs(Value *ptr);
+  bool hasPointer(Value *ptr);
+
+  /*
+   * Pointees of @ptr as IDs of memory objects of this summary.
+   */
+  SparseBitVector<> getPointeeMemobjIds(Value *ptr);
+
+  /*
+   * Whole-program summaries only.
+   *
+   * mayOutlive returns true if the memory object @memobj might be reachable
+   * after @f returns through memory that isn't a stack object of @f.
+   * This is meaningful only if @f isn't recursive.
+   */
+  bool mayOutlive(Value *memobj, Function *f);
+  bool isRecursive(Function *f) const;
 
   void doMayPointsToAnalysis(void);
   void doMayPointsToAnalysisFor(GlobalVariable *globalVar);
   void clearPointsToSummary(void);
 
+  /*
+   * Time spent by the last may points-to analysis of the current function.
+   */
+  uint64_t getSolveTimeInMicroseconds(void) const;
+
 private:
   /*
    * All pointers may be used as return value of the current function.
@@ -61,6 +90,24 @@ private:
   bool mpaFinished = false;
   const NodeID UnknownMemobjId = 0;
   NodeID nextNodeId = 1;
+  uint64_t solveTime = 0;
+
+  /*
+   * Whole-program summaries only.
+   *
+   * In a whole-program summary, global variables are memory objects like the
+   * allocations, arguments point to the objects passed by the call sites, and
+   * calls to functions with a body point to what the callees return.
+   * Arguments and return values of functions that might be invoked from
+   * outside the program are also linked to the "unknown" memory object.
+   *
+   * resolvedCallees maps every call whose callees all have a body to them.
+   * Functions are listed callees first, as they are solved bottom-up.
+   */
+  Module *program = nullptr;
+  std::unordered_map<CallBase *, std::vector<Function *>> resolvedCallees;
+  std::vector<Function *> bottomUpFunctions;
+  std::unordered_set<Function *> recursiveFunctions;
 
   /*
    * Assign node id to each pointer in current function.
@@ -95,10 +142,10 @@ private:
   /*
    * The points-to graph.
    * The key of the points-to graph is a NodeID that reresents one pointer or
-   * memory object. The value is a bitvector containing the NodeIDs of the
-   * pointee memory objects.
+   * memory object. The value is a sparse bitvector containing the NodeIDs of
+   * the pointee memory objects.
    */
-  std::unordered_map<NodeID, BitVector> pointsTo;
+  std::unordered_map<NodeID, SparseBitVector<>> pointsTo;
 
   /*
    * A copy edge (src => dest) means that dest may point to the same memory
@@ -130,6 +177,18 @@ private:
    */
   std::unordered_set<NodeID> usedAsFuncArg;
 
+  /*
+   * Nodes in a cycle of copy edges end up with the same points-to set, so
+   * they are collapsed into a single node, their representative.
+   * A node without an entry is its own representative.
+   *
+   * Cycles are detected lazily: when a copy edge (src => dest) doesn't change
+   * pts(dest) and pts(dest) = pts(src), dest may reach src.
+   * Every copy edge triggers at most one detection.
+   */
+  std::unordered_map<NodeID, NodeID> representatives;
+  std::unordered_set<uint64_t> checkedCopyEdges;
+
   /*
    * privatizeCandidate is a global variable that we want to privatize into the
    * current function. "Privatize" means we want to transform the global
@@ -170,38 +229,87 @@ private:
   GlobalVariable *privatizeCandidate = nullptr;
 
   std::queue<NodeID> worklist;
+  std::unordered_set<NodeID> inWorklist;
 
-  BitVector getEmptyBitVector(void);
-  BitVector onlyPointsTo(NodeID memobjId);
+  SparseBitVector<> onlyPointsTo(NodeID memobjId);
   std::unordered_set<Value *> getAllocations(void);
   NodeID getPtrId(Value *v);
   bool addCopyEdge(NodeID src, NodeID dst);
+  NodeID getRepresentative(NodeID nodeId);
+  void pushToWorklist(NodeID nodeId);
 
+  void collectPointers(Function &F);
   void initPtInfo(void);
+  void initProgramPtInfo(void);
+  void escape(NodeID ptrId);
   void solveWorklist(void);
 
   void handleLoadStore(NodeID ptrId);
   void handleFuncUsers(NodeID ptrId);
   void handleCopyEdges(NodeID srcId);
 
-  BitVector getPointeeBitVector(NodeID nodeId);
+  SparseBitVector<> getPointeeBitVector(NodeID nodeId);
   std::unordered_set<NodeID> getreachableMemobjIds(NodeID ptrId);
   bool unionPts(NodeID srcId, NodeID dstId);
+  bool collapseCyclesReachableFrom(NodeID rootId);
+  void collapse(NodeID repId, NodeID nodeId);
 };
 
 class MayPointsToAnalysis {
 public:
   MayPointsToAnalysis();
 
+  /*
+   * Interprocedural, context-insensitive analysis of @program.
+   * Queries about functions that are not recursive are answered by a single
+   * whole-program summary; the others fall back to the intra-procedural one.
+   */
+  MayPointsToAnalysis(Module &program, CallGraph *programCallGraph);
+
+  /*
+   * Queries about functions whose summary has already been computed (see
+   * doMayPointsToAnalysis) only read the analysis, so they can be issued by
+   * multiple threads.
+   */
   bool mayAlias(Value *ptr1, Value *ptr2);
+
+  /*
+   * Batched version of mayAlias: the entry (i, j) of the returned matrix is
+   * mayAlias(@pointers[i], @pointers[j]).
+   * The pointees of every pointer are fetched once and compared as bitsets.
+   */
+  std::vector<std::vector<bool>> mayAlias(const std::vector<Value *> &pointers);
+
   bool mayEscape(Instruction *inst);
   bool notPrivatizable(GlobalVariable *globalVar, Function *currentF);
   std::unordered_set<Value *> getPointees(Value *ptr, Function *currentF);
 
+  /*
+   * Compute the summaries of @functions in parallel.
+   * Summaries are intra-procedural, so they are independent from each other.
+   */
+  void doMayPointsToAnalysis(std::vector<Function *> const &functions);
+
+  /*
+   * Time spent to compute the summary of @currentF (0 if it hasn't been
+   * computed).
+   */
+  uint64_t getSolveTimeInMicroseconds(Function *currentF) const;
+
+  /*
+   * Forget what has been computed about @currentF because its code changed.
+   * The summaries of the other functions are kept; the whole-program summary,
+   * which includes @currentF, is computed again when needed.
+   */
+  void invalidate(Function *currentF);
+
   ~MayPointsToAnalysis();
 
 private:
   std::unordered_map<Function *, MpaSummary *> functionSummaries;
+  std::shared_ptr<MpaSummary> programSummary;
+  Module *program = nullptr;
+  CallGraph *programCallGraph = nullptr;
 
   MpaSummary *getFunctionSummary(Function *currentF);
 };
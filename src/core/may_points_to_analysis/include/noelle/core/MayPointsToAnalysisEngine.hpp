@@ -0,0 +1,53 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_CORE_MAY_POINTS_TO_ANALYSIS_MAYPOINTSTOANALYSISENGINE_H_
+#define NOELLE_SRC_CORE_MAY_POINTS_TO_ANALYSIS_MAYPOINTSTOANALYSISENGINE_H_
+
+#include "noelle/core/ProgramAliasAnalysisEngine.hpp"
+#include "noelle/core/MayPointsToAnalysis.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Alias analysis engine backed by the may points-to analysis.
+ * Batched queries are answered natively by comparing points-to bitsets.
+ * The engine takes the ownership of @mpa.
+ */
+class MayPointsToAnalysisEngine : public ProgramAliasAnalysisEngine {
+public:
+  MayPointsToAnalysisEngine(MayPointsToAnalysis *mpa);
+
+  AliasResult alias(const MemoryLocation &loc1,
+                    const MemoryLocation &loc2) override;
+
+  std::vector<std::vector<AliasResult>> getAliasMatrix(
+      const std::vector<MemoryLocation> &locations) override;
+
+  ~MayPointsToAnalysisEngine();
+
+protected:
+  MayPointsToAnalysis *mpa;
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_CORE_MAY_POINTS_TO_ANALYSIS_MAYPOINTSTOANALYSISENGINE_H_
@@ -19,25 +19,55 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <atomic>
 #include "noelle/core/MayPointsToAnalysis.hpp"
 #include "MpaUtils.hpp"
 
 namespace arcana::noelle {
 
+static Function *getOwnerFunction(Value *ptr) {
+  if (isa<Instruction>(ptr)) {
+    return dyn_cast<Instruction>(ptr)->getFunction();
+  } else if (isa<Argument>(ptr)) {
+    return dyn_cast<Argument>(ptr)->getParent();
+  } else {
+    return nullptr;
+  }
+}
+
 MayPointsToAnalysis::MayPointsToAnalysis() {}
 
+MayPointsToAnalysis::MayPointsToAnalysis(Module &program,
+                                         CallGraph *programCallGraph)
+  : programSummary{ std::make_shared<MpaSummary>(program, programCallGraph) },
+    program{ &program },
+    programCallGraph{ programCallGraph } {}
+
 bool MayPointsToAnalysis::mayAlias(Value *ptr1, Value *ptr2) {
   assert(ptr1->getType()->isPointerTy() && ptr2->getType()->isPointerTy());
 
-  auto getOwnerFunction = [](Value *ptr) -> Function * {
-    if (isa<Instruction>(ptr)) {
-      return dyn_cast<Instruction>(ptr)->getFunction();
-    } else if (isa<Argument>(ptr)) {
-      return dyn_cast<Argument>(ptr)->getParent();
-    } else {
-      return nullptr;
+  /*
+   * Whole-program mode: pointers of different functions and global variables
+   * are all in the same summary.
+   */
+  if (programSummary) {
+    programSummary->doMayPointsToAnalysis();
+    if (!programSummary->hasPointer(ptr1)
+        || !programSummary->hasPointer(ptr2)) {
+      return true;
     }
-  };
+    auto ptes1 = programSummary->getPointeeMemobjs(ptr1);
+    auto ptes2 = programSummary->getPointeeMemobjs(ptr2);
+    if (ptes1.empty() || ptes2.empty()) {
+      return true;
+    }
+    for (auto pte1 : ptes1) {
+      if (ptes2.count(pte1) > 0) {
+        return true;
+      }
+    }
+    return false;
+  }
 
   auto stripped1 = strip(ptr1);
   auto stripped2 = strip(ptr2);
@@ -82,9 +112,68 @@ bool MayPointsToAnalysis::mayAlias(Value *ptr1, Value *ptr2) {
   }
 }
 
+std::vector<std::vector<bool>> MayPointsToAnalysis::mayAlias(
+    const std::vector<Value *> &pointers) {
+  auto n = pointers.size();
+  std::vector<std::vector<bool>> matrix(n, std::vector<bool>(n, true));
+
+  /*
+   * Fetch the summary and the pointees of every pointer once.
+   */
+  std::vector<Value *> stripped(n);
+  std::vector<MpaSummary *> summaries(n, nullptr);
+  std::vector<SparseBitVector<>> pointees(n);
+  for (auto i = 0u; i < n; i++) {
+    assert(pointers[i]->getType()->isPointerTy());
+    stripped[i] = strip(pointers[i]);
+    MpaSummary *funcSum = nullptr;
+    if (programSummary) {
+      programSummary->doMayPointsToAnalysis();
+      if (programSummary->hasPointer(stripped[i])) {
+        funcSum = programSummary.get();
+      }
+    } else if (auto f = getOwnerFunction(stripped[i])) {
+      funcSum = getFunctionSummary(f);
+      funcSum->doMayPointsToAnalysis();
+    }
+    if (funcSum != nullptr) {
+      summaries[i] = funcSum;
+      pointees[i] = funcSum->getPointeeMemobjIds(stripped[i]);
+    }
+  }
+
+  /*
+   * Pointees of the same summary can be compared directly.
+   * The other pairs are answered by the single-pair query.
+   */
+  for (auto i = 0u; i < n; i++) {
+    for (auto j = i + 1; j < n; j++) {
+      bool result;
+      if ((summaries[i] == nullptr) || (summaries[i] != summaries[j])
+          || (stripped[i] == stripped[j])) {
+        result = this->mayAlias(pointers[i], pointers[j]);
+      } else if (programSummary
+                 && (pointees[i].empty() || pointees[j].empty())) {
+        result = true;
+      } else {
+        result = pointees[i].intersects(pointees[j]);
+      }
+      matrix[i][j] = result;
+      matrix[j][i] = result;
+    }
+  }
+
+  return matrix;
+}
+
 bool MayPointsToAnalysis::mayEscape(Instruction *inst) {
   assert(isAllocation(inst));
   auto currentF = inst->getFunction();
+  if (programSummary && !programSummary->isRecursive(currentF)
+      && programSummary->hasPointer(inst)) {
+    programSummary->doMayPointsToAnalysis();
+    return programSummary->mayOutlive(inst, currentF);
+  }
   auto funcSum = getFunctionSummary(currentF);
   funcSum->doMayPointsToAnalysis();
   return funcSum->mayBePointedByUnknown(inst)
@@ -93,6 +182,11 @@ bool MayPointsToAnalysis::mayEscape(Instruction *inst) {
 
 bool MayPointsToAnalysis::notPrivatizable(GlobalVariable *globalVar,
                                           Function *currentF) {
+  if (programSummary && !programSummary->isRecursive(currentF)
+      && programSummary->hasPointer(globalVar)) {
+    programSummary->doMayPointsToAnalysis();
+    return programSummary->mayOutlive(globalVar, currentF);
+  }
   auto funcSum = getFunctionSummary(currentF);
   funcSum->doMayPointsToAnalysisFor(globalVar);
 
@@ -106,11 +200,103 @@ std::unordered_set<Value *> MayPointsToAnalysis::getPointees(
     Value *ptr,
     Function *currentF) {
   assert(ptr->getType()->isPointerTy());
+  if (programSummary && programSummary->hasPointer(ptr)) {
+    programSummary->doMayPointsToAnalysis();
+    return programSummary->getPointeeMemobjs(ptr);
+  }
   auto funcSum = getFunctionSummary(currentF);
   funcSum->doMayPointsToAnalysis();
   return funcSum->getPointeeMemobjs(ptr);
 }
 
+void MayPointsToAnalysis::doMayPointsToAnalysis(
+    std::vector<Function *> const &functions) {
+
+  /*
+   * Create the summaries to compute.
+   * This is done sequentially as it changes functionSummaries.
+   */
+  std::vector<MpaSummary *> toSolve;
+  for (auto f : functions) {
+    if (f->empty()) {
+      continue;
+    }
+    toSolve.push_back(getFunctionSummary(f));
+  }
+
+  /*
+   * Start from the largest functions to balance the work among threads.
+   */
+  std::stable_sort(toSolve.begin(),
+                   toSolve.end(),
+                   [](MpaSummary *s1, MpaSummary *s2) -> bool {
+                     return s1->currentF->getInstructionCount()
+                            > s2->currentF->getInstructionCount();
+                   });
+
+  /*
+   * Compute the summaries in parallel.
+   * Every summary only reads the IR and writes its own state.
+   */
+  std::atomic<uint64_t> nextSummary{ 0 };
+  auto solve = [&toSolve, &nextSummary]() {
+    while (true) {
+      auto i = nextSummary++;
+      if (i >= toSolve.size()) {
+        return;
+      }
+      toSolve[i]->doMayPointsToAnalysis();
+    }
+  };
+  uint64_t threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min<uint64_t>(threads, toSolve.size());
+  std::vector<std::thread> workers;
+  for (uint64_t t = 1; t < threads; t++) {
+    workers.emplace_back(solve);
+  }
+  solve();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  /*
+   * The whole-program summary is shared by all functions.
+   */
+  if (programSummary) {
+    programSummary->doMayPointsToAnalysis();
+  }
+}
+
+uint64_t MayPointsToAnalysis::getSolveTimeInMicroseconds(
+    Function *currentF) const {
+  auto it = functionSummaries.find(currentF);
+  if (it == functionSummaries.end()) {
+    return 0;
+  }
+  return it->second->getSolveTimeInMicroseconds();
+}
+
+void MayPointsToAnalysis::invalidate(Function *currentF) {
+
+  /*
+   * Drop the summary of @currentF.
+   * It is computed again the next time a query needs it.
+   */
+  auto it = functionSummaries.find(currentF);
+  if (it != functionSummaries.end()) {
+    delete it->second;
+    functionSummaries.erase(it);
+  }
+
+  /*
+   * The whole-program summary cannot be updated for a single function.
+   * Replace it with a new one, which is solved the next time a query needs it.
+   */
+  if (programSummary) {
+    programSummary = std::make_shared<MpaSummary>(*program, programCallGraph);
+  }
+}
+
 MayPointsToAnalysis::~MayPointsToAnalysis() {
   for (auto &[f, funcSum] : functionSummaries) {
     delete funcSum;
@@ -119,10 +305,13 @@ MayPointsToAnalysis::~MayPointsToAnalysis() {
 }
 
 MpaSummary *MayPointsToAnalysis::getFunctionSummary(Function *currentF) {
-  if (functionSummaries.find(currentF) == functionSummaries.end()) {
-    functionSummaries[currentF] = new MpaSummary(currentF);
+  auto it = functionSummaries.find(currentF);
+  if (it != functionSummaries.end()) {
+    return it->second;
   }
-  return functionSummaries[currentF];
+  auto funcSum = new MpaSummary(currentF);
+  functionSummaries[currentF] = funcSum;
+  return funcSum;
 }
 
 } // namespace arcana::noelle
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/MayPointsToAnalysisEngine.hpp"
+
+namespace arcana::noelle {
+
+MayPointsToAnalysisEngine::MayPointsToAnalysisEngine(MayPointsToAnalysis *mpa)
+  : ProgramAliasAnalysisEngine{ "MPA", mpa },
+    mpa{ mpa } {
+  return;
+}
+
+AliasResult MayPointsToAnalysisEngine::alias(const MemoryLocation &loc1,
+                                             const MemoryLocation &loc2) {
+  auto ptr1 = const_cast<Value *>(loc1.Ptr);
+  auto ptr2 = const_cast<Value *>(loc2.Ptr);
+  if (!this->mpa->mayAlias(ptr1, ptr2)) {
+    return AliasResult::NoAlias;
+  }
+  return AliasResult::MayAlias;
+}
+
+std::vector<std::vector<AliasResult>> MayPointsToAnalysisEngine::
+    getAliasMatrix(const std::vector<MemoryLocation> &locations) {
+
+  /*
+   * Answer all queries at once.
+   */
+  std::vector<Value *> pointers;
+  for (auto &loc : locations) {
+    pointers.push_back(const_cast<Value *>(loc.Ptr));
+  }
+  auto mayAliasMatrix = this->mpa->mayAlias(pointers);
+
+  /*
+   * Translate the answers.
+   */
+  auto n = locations.size();
+  std::vector<std::vector<AliasResult>> matrix(
+      n,
+      std::vector<AliasResult>(n, AliasResult::MayAlias));
+  for (auto i = 0u; i < n; i++) {
+    for (auto j = 0u; j < n; j++) {
+      if (i == j) {
+        matrix[i][j] = AliasResult::MustAlias;
+      } else if (!mayAliasMatrix[i][j]) {
+        matrix[i][j] = AliasResult::NoAlias;
+      }
+    }
+  }
+
+  return matrix;
+}
+
+MayPointsToAnalysisEngine::~MayPointsToAnalysisEngine() {
+  delete this->mpa;
+
+  return;
+}
+
+} // namespace arcana::noelle
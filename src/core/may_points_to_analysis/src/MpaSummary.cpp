@@ -19,14 +19,106 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <chrono>
+#include "llvm/Analysis/ValueTracking.h"
 #include "noelle/core/MayPointsToAnalysis.hpp"
+#include "noelle/core/SCCCAG.hpp"
 #include "MpaUtils.hpp"
 
 using namespace std;
 
 namespace arcana::noelle {
 
+/*
+ * A function is closed if it can only be invoked by direct calls within the
+ * program: all its arguments come from call sites we can see.
+ */
+static bool isClosed(Function &f) {
+  if (!f.hasLocalLinkage() || f.isVarArg()) {
+    return false;
+  }
+  for (auto &use : f.uses()) {
+    auto call = dyn_cast<CallBase>(use.getUser());
+    if (!call || !call->isCallee(&use)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static vector<Value *> getReturnPointers(Function &f) {
+  vector<Value *> returnPointers;
+  for (auto &bb : f) {
+    if (auto returnInst = dyn_cast<ReturnInst>(bb.getTerminator())) {
+      auto retVal = returnInst->getReturnValue();
+      if (retVal && retVal->getType()->isPointerTy()) {
+        returnPointers.push_back(retVal);
+      }
+    }
+  }
+  return returnPointers;
+}
+
 MpaSummary::MpaSummary(Function *currentF) : currentF(currentF) {
+  collectPointers(*currentF);
+}
+
+MpaSummary::MpaSummary(Module &program, CallGraph *programCallGraph)
+  : currentF(nullptr),
+    program(&program) {
+
+  /*
+   * Order the functions bottom-up and identify the recursive ones.
+   */
+  SCCCAG scccag(programCallGraph);
+  for (auto node : scccag.getNodesInBottomUpOrder()) {
+    for (auto f : node->getFunctions()) {
+      if (f->empty()) {
+        continue;
+      }
+      bottomUpFunctions.push_back(f);
+      if (node->isAnSCC()) {
+        recursiveFunctions.insert(f);
+      }
+    }
+  }
+
+  /*
+   * Identify the callees of every call.
+   */
+  unordered_set<CallBase *> unresolvedCalls;
+  for (auto callerNode : programCallGraph->getFunctionNodes(true)) {
+    for (auto edge : programCallGraph->getOutgoingEdges(callerNode)) {
+      auto callee = edge->getCallee()->getFunction();
+      for (auto subEdge : edge->getSubEdges()) {
+        auto callInst = cast<CallBase>(subEdge->getCaller()->getInstruction());
+        if (callee->empty()) {
+          unresolvedCalls.insert(callInst);
+        }
+        resolvedCallees[callInst].push_back(callee);
+      }
+    }
+  }
+
+  /*
+   * Only calls whose callees all have a body can be linked to them.
+   */
+  for (auto callInst : unresolvedCalls) {
+    resolvedCallees.erase(callInst);
+  }
+
+  /*
+   * Collect the pointers of the program.
+   */
+  for (auto f : bottomUpFunctions) {
+    collectPointers(*f);
+  }
+  for (auto &globalVar : program.globals()) {
+    pointers.insert(&globalVar);
+  }
+}
+
+void MpaSummary::collectPointers(Function &F) {
 
   auto insertPointer = [&](Value *v) {
     if (v->getType()->isPointerTy()) {
@@ -57,11 +149,11 @@ MpaSummary::MpaSummary(Function *currentF) : currentF(currentF) {
    * 3. Collect all pointers may be returned by the function.
    */
 
-  for (auto &arg : currentF->args()) {
+  for (auto &arg : F.args()) {
     insertPointer(&arg);
   }
 
-  for (auto &bb : *currentF) {
+  for (auto &bb : F) {
     for (auto &inst : bb) {
       if (isa<LoadInst>(&inst)) {
         auto loadInst = dyn_cast<LoadInst>(&inst);
@@ -132,20 +224,83 @@ unordered_set<Value *> MpaSummary::getPointeeMemobjs(Value *ptr) {
   auto stripped = strip(ptr);
   assert(ptr2nodeId.find(stripped) != ptr2nodeId.end());
 
-  auto ptrId = ptr2nodeId[stripped];
+  auto ptrId = ptr2nodeId.at(stripped);
   unordered_set<Value *> pointees;
 
   auto pointeeBitVec = getPointeeBitVector(ptrId);
-  for (auto memobjId : pointeeBitVec.set_bits()) {
+  for (auto memobjId : pointeeBitVec) {
     if (memobjId == UnknownMemobjId) {
       pointees.insert(nullptr);
     } else {
-      pointees.insert(nodeId2memobj[memobjId]);
+      pointees.insert(nodeId2memobj.at(memobjId));
     }
   }
   return pointees;
 }
 
+SparseBitVector<> MpaSummary::getPointeeMemobjIds(Value *ptr) {
+  assert(mpaFinished);
+  auto stripped = strip(ptr);
+  assert(ptr2nodeId.find(stripped) != ptr2nodeId.end());
+  return getPointeeBitVector(ptr2nodeId.at(stripped));
+}
+
+bool MpaSummary::hasPointer(Value *ptr) {
+  return ptr2nodeId.find(strip(ptr)) != ptr2nodeId.end();
+}
+
+bool MpaSummary::isRecursive(Function *f) const {
+  return recursiveFunctions.find(f) != recursiveFunctions.end();
+}
+
+bool MpaSummary::mayOutlive(Value *memobj, Function *f) {
+  assert(mpaFinished);
+  assert(program != nullptr);
+  auto memobjId = memobj2nodeId.at(memobj);
+
+  /*
+   * Collect the memory objects that might be reachable after @f returns.
+   * They are pointed directly or indirectly by the arguments of @f, by its
+   * return values, or by any memory object other than @memobj and the stack
+   * objects of @f.
+   */
+  SparseBitVector<> reachable;
+  queue<NodeID> todolist;
+  auto reach = [&](SparseBitVector<> const &pointees) {
+    for (auto pointeeId : pointees) {
+      if (!reachable.test(pointeeId)) {
+        reachable.set(pointeeId);
+        todolist.push(pointeeId);
+      }
+    }
+  };
+  for (auto &arg : f->args()) {
+    if (arg.getType()->isPointerTy()) {
+      reach(getPointeeBitVector(getPtrId(&arg)));
+    }
+  }
+  for (auto retPtr : getReturnPointers(*f)) {
+    reach(getPointeeBitVector(getPtrId(retPtr)));
+  }
+  for (auto &[object, objectId] : memobj2nodeId) {
+    if (objectId == memobjId) {
+      continue;
+    }
+    if (object != nullptr && isa<AllocaInst>(object)
+        && cast<AllocaInst>(object)->getFunction() == f) {
+      continue;
+    }
+    reach(getPointeeBitVector(objectId));
+  }
+  while (!todolist.empty()) {
+    auto nodeId = todolist.front();
+    todolist.pop();
+    reach(getPointeeBitVector(nodeId));
+  }
+
+  return reachable.test(memobjId);
+}
+
 bool MpaSummary::mayBePointedByUnknown(Value *memobj) {
   assert(mpaFinished);
   assert(getAllocations().count(memobj) > 0);
@@ -173,11 +328,13 @@ bool MpaSummary::mayBePointedByReturnValue(Value *memobj) {
   return false;
 }
 
-BitVector MpaSummary::getPointeeBitVector(NodeID nodeId) {
-  if (pointsTo.find(nodeId) != pointsTo.end()) {
-    return pointsTo[nodeId];
+SparseBitVector<> MpaSummary::getPointeeBitVector(NodeID nodeId) {
+  nodeId = getRepresentative(nodeId);
+  auto it = pointsTo.find(nodeId);
+  if (it != pointsTo.end()) {
+    return it->second;
   } else {
-    return getEmptyBitVector();
+    return SparseBitVector<>();
   }
 }
 
@@ -191,7 +348,7 @@ unordered_set<NodeID> MpaSummary::getreachableMemobjIds(NodeID ptrId) {
     todolist.pop();
 
     auto pointeeBitVec = getPointeeBitVector(nodeId);
-    for (auto memObj : pointeeBitVec.set_bits()) {
+    for (auto memObj : pointeeBitVec) {
       if (reachable.find(memObj) == reachable.end()) {
         reachable.insert(memObj);
         todolist.push(memObj);
@@ -201,16 +358,10 @@ unordered_set<NodeID> MpaSummary::getreachableMemobjIds(NodeID ptrId) {
   return reachable;
 }
 
-BitVector MpaSummary::getEmptyBitVector(void) {
-  auto bitVecSize = 1 + getAllocations().size();
-  return BitVector(bitVecSize, false);
-}
-
-BitVector MpaSummary::onlyPointsTo(NodeID memobjId) {
-  auto emptyPts = getEmptyBitVector();
-  assert(memobjId < emptyPts.size());
-  emptyPts.set(memobjId);
-  return emptyPts;
+SparseBitVector<> MpaSummary::onlyPointsTo(NodeID memobjId) {
+  SparseBitVector<> pts;
+  pts.set(memobjId);
+  return pts;
 }
 
 unordered_set<Value *> MpaSummary::getAllocations(void) {
@@ -227,6 +378,11 @@ unordered_set<Value *> MpaSummary::getAllocations(void) {
   if (privatizeCandidate) {
     allocations.insert(privatizeCandidate);
   }
+  if (program) {
+    for (auto &globalVar : program->globals()) {
+      allocations.insert(&globalVar);
+    }
+  }
   return allocations;
 }
 
@@ -241,17 +397,53 @@ NodeID MpaSummary::getPtrId(Value *v) {
 }
 
 bool MpaSummary::addCopyEdge(NodeID src, NodeID dst) {
+  src = getRepresentative(src);
+  dst = getRepresentative(dst);
+  if (src == dst) {
+    return false;
+  }
   return copyOutEdges[src].insert(dst).second;
 }
 
+NodeID MpaSummary::getRepresentative(NodeID nodeId) {
+  auto it = representatives.find(nodeId);
+  if (it == representatives.end()) {
+    return nodeId;
+  }
+
+  /*
+   * Compress the path to the representative.
+   */
+  auto repId = getRepresentative(it->second);
+  if (it->second != repId) {
+    it->second = repId;
+  }
+  return repId;
+}
+
+void MpaSummary::pushToWorklist(NodeID nodeId) {
+  nodeId = getRepresentative(nodeId);
+  if (inWorklist.insert(nodeId).second) {
+    worklist.push(nodeId);
+  }
+}
+
 void MpaSummary::doMayPointsToAnalysis(void) {
   if (!mpaFinished) {
+    auto start = chrono::steady_clock::now();
     initPtInfo();
     solveWorklist();
+    auto end = chrono::steady_clock::now();
+    solveTime =
+        chrono::duration_cast<chrono::microseconds>(end - start).count();
     mpaFinished = true;
   }
 }
 
+uint64_t MpaSummary::getSolveTimeInMicroseconds(void) const {
+  return solveTime;
+}
+
 void MpaSummary::doMayPointsToAnalysisFor(GlobalVariable *globalVar) {
   clearPointsToSummary();
   privatizeCandidate = globalVar;
@@ -270,6 +462,10 @@ void MpaSummary::clearPointsToSummary(void) {
   incomingStores.clear();
   outgoingLoads.clear();
   usedAsFuncArg.clear();
+  representatives.clear();
+  checkedCopyEdges.clear();
+  worklist = {};
+  inWorklist.clear();
 }
 
 void MpaSummary::initPtInfo(void) {
@@ -345,7 +541,12 @@ void MpaSummary::initPtInfo(void) {
       auto falseValuePtrId = getPtrId(selectInst->getFalseValue());
       addCopyEdge(trueValuePtrId, ptrId);
       addCopyEdge(falseValuePtrId, ptrId);
-    } else if (isa<Argument>(ptr) || isa<GlobalVariable>(ptr)) {
+    } else if (isa<Argument>(ptr)) {
+      auto f = dyn_cast<Argument>(ptr)->getParent();
+      if (!program || !isClosed(*f)) {
+        pointsTo[ptrId] = onlyPointsTo(UnknownMemobjId);
+      }
+    } else if (isa<GlobalVariable>(ptr)) {
       pointsTo[ptrId] = onlyPointsTo(UnknownMemobjId);
     } else if (isa<CallBase>(ptr)) {
       auto callInst = dyn_cast<CallBase>(ptr);
@@ -356,6 +557,9 @@ void MpaSummary::initPtInfo(void) {
           break;
         case USER_DEFINED:
         case UNKNOWN:
+          if (resolvedCallees.find(callInst) != resolvedCallees.end()) {
+            break;
+          }
           pointsTo[ptrId] = onlyPointsTo(UnknownMemobjId);
           addCopyEdge(UnknownMemobjId, ptrId);
           break;
@@ -363,7 +567,7 @@ void MpaSummary::initPtInfo(void) {
           break;
       }
     } else if (isa<ConstantPointerNull>(ptr)) {
-      pointsTo[ptrId] = getEmptyBitVector();
+      pointsTo[ptrId] = SparseBitVector<>();
     }
 
     for (auto user : ptr->users()) {
@@ -390,8 +594,10 @@ void MpaSummary::initPtInfo(void) {
             break;
           case USER_DEFINED:
           case UNKNOWN:
-            usedAsFuncArg.insert(ptrId);
-            addCopyEdge(ptrId, UnknownMemobjId);
+            if (resolvedCallees.find(callInst) != resolvedCallees.end()) {
+              break;
+            }
+            escape(ptrId);
             break;
           default:
             break;
@@ -399,26 +605,171 @@ void MpaSummary::initPtInfo(void) {
       }
     }
   }
+
+  if (program) {
+    initProgramPtInfo();
+  }
+}
+
+void MpaSummary::initProgramPtInfo(void) {
+
+  /*
+   * Link the calls to the callees we know.
+   * (1) Actual arguments are copied to the formal arguments.
+   * (2) Returned pointers are copied to the value of the call.
+   */
+  for (auto &[callInst, callees] : resolvedCallees) {
+    for (auto callee : callees) {
+      for (auto i = 0u; i < callInst->getNumArgOperands(); i++) {
+        auto actual = callInst->getArgOperand(i);
+        if (i >= callee->arg_size()) {
+          if (actual->getType()->isPointerTy()) {
+            escape(getPtrId(actual));
+          }
+          continue;
+        }
+        auto formal = callee->arg_begin() + i;
+        auto actualIsPtr = actual->getType()->isPointerTy();
+        auto formalIsPtr = formal->getType()->isPointerTy();
+        if (actualIsPtr && formalIsPtr) {
+          addCopyEdge(getPtrId(actual), getPtrId(formal));
+        } else if (actualIsPtr) {
+          escape(getPtrId(actual));
+        } else if (formalIsPtr) {
+          pointsTo[getPtrId(formal)].set(UnknownMemobjId);
+        }
+      }
+
+      if (!callInst->getType()->isPointerTy()) {
+        continue;
+      }
+      auto callId = getPtrId(callInst);
+      if (!callee->getReturnType()->isPointerTy()) {
+        pointsTo[callId].set(UnknownMemobjId);
+        continue;
+      }
+      for (auto retPtr : getReturnPointers(*callee)) {
+        addCopyEdge(getPtrId(retPtr), callId);
+      }
+    }
+  }
+
+  /*
+   * Pointers returned by functions that can be invoked from outside the
+   * program escape.
+   */
+  for (auto f : bottomUpFunctions) {
+    if (isClosed(*f)) {
+      continue;
+    }
+    for (auto retPtr : getReturnPointers(*f)) {
+      escape(getPtrId(retPtr));
+    }
+  }
+
+  /*
+   * Global variables point to what their initializers point to.
+   * Global variables visible outside the module are reachable from (and can
+   * point to) the "unknown" memory object.
+   */
+  auto &DL = program->getDataLayout();
+  for (auto &globalVar : program->globals()) {
+    auto memobjId = memobj2nodeId.at(&globalVar);
+    if (globalVar.hasInitializer()) {
+      vector<Constant *> constants{ globalVar.getInitializer() };
+      while (!constants.empty()) {
+        auto constant = constants.back();
+        constants.pop_back();
+        if (constant->getType()->isPointerTy()) {
+
+          /*
+           * Pointers into a global variable (e.g., getelementptr(@buf, 0, 5))
+           * point to that variable.
+           * Pointers we cannot trace back to an object point to the
+           * "unknown" memory object.
+           */
+          auto pointee = GetUnderlyingObject(constant, DL);
+          if (auto pointeeGlobal = dyn_cast<GlobalVariable>(pointee)) {
+            pointsTo[memobjId].set(memobj2nodeId.at(pointeeGlobal));
+          } else if (false || isa<Function>(pointee)
+                     || isa<ConstantPointerNull>(pointee)
+                     || isa<UndefValue>(pointee)) {
+            continue;
+          } else {
+            pointsTo[memobjId].set(UnknownMemobjId);
+          }
+          continue;
+        }
+        for (auto &op : constant->operands()) {
+          constants.push_back(cast<Constant>(op));
+        }
+      }
+    }
+    if (!globalVar.hasLocalLinkage()) {
+      pointsTo[UnknownMemobjId].set(memobjId);
+      addCopyEdge(memobjId, UnknownMemobjId);
+      addCopyEdge(UnknownMemobjId, memobjId);
+    }
+  }
+}
+
+void MpaSummary::escape(NodeID ptrId) {
+  usedAsFuncArg.insert(ptrId);
+  addCopyEdge(ptrId, UnknownMemobjId);
 }
 
 void MpaSummary::solveWorklist(void) {
   worklist = {};
+  inWorklist.clear();
+
+  /*
+   * When the whole program is analyzed, callees are processed before their
+   * callers so that most of the points-to information flowing out of a
+   * callee is available when its callers are processed.
+   */
+  for (auto f : bottomUpFunctions) {
+    for (auto &arg : f->args()) {
+      if (hasPointer(&arg)) {
+        pushToWorklist(getPtrId(&arg));
+      }
+    }
+    for (auto &inst : instructions(*f)) {
+      if (hasPointer(&inst)) {
+        pushToWorklist(getPtrId(&inst));
+      }
+    }
+  }
   for (auto &[ptr, ptrId] : ptr2nodeId) {
-    worklist.push(ptrId);
+    pushToWorklist(ptrId);
   }
 
   while (!worklist.empty()) {
     auto nodeID = worklist.front();
     worklist.pop();
+    inWorklist.erase(nodeID);
+
+    /*
+     * The node might have been collapsed after being added to the worklist.
+     */
+    nodeID = getRepresentative(nodeID);
     handleLoadStore(nodeID);
     handleFuncUsers(nodeID);
     handleCopyEdges(nodeID);
   }
+
+  /*
+   * Compress all paths to the representatives.
+   * Queries on the solved summary then only read it, so they can be issued
+   * by multiple threads.
+   */
+  for (auto &[nodeId, repId] : representatives) {
+    repId = getRepresentative(repId);
+  }
 }
 
 void MpaSummary::handleLoadStore(NodeID ptrId) {
   auto pointees = getPointeeBitVector(ptrId);
-  for (auto memobjId : pointees.set_bits()) {
+  for (auto memobjId : pointees) {
     /*
      * OutgoingLoads help us add new copy edges.
      *
@@ -436,7 +787,7 @@ void MpaSummary::handleLoadStore(NodeID ptrId) {
       for (auto loadInst : outgoingLoads[ptrId]) {
         auto destId = getPtrId(loadInst);
         if (addCopyEdge(memobjId, destId)) {
-          worklist.push(memobjId);
+          pushToWorklist(memobjId);
         }
       }
     }
@@ -458,7 +809,7 @@ void MpaSummary::handleLoadStore(NodeID ptrId) {
       for (auto storeInst : incomingStores[ptrId]) {
         auto srcId = getPtrId(storeInst->getValueOperand());
         if (addCopyEdge(srcId, memobjId)) {
-          worklist.push(srcId);
+          pushToWorklist(srcId);
         }
       }
     }
@@ -515,7 +866,7 @@ void MpaSummary::handleFuncUsers(NodeID ptrId) {
     changed |= addCopyEdge(memobjId, UnknownMemobjId);
     changed |= addCopyEdge(UnknownMemobjId, memobjId);
     if (changed) {
-      worklist.push(memobjId);
+      pushToWorklist(memobjId);
     }
   }
 }
@@ -528,23 +879,181 @@ void MpaSummary::handleCopyEdges(NodeID srcId) {
    * Propogate the points-to info from srcId to destId through copy edges.
    * i.e. pts(destId) = pts(destId) U pts(srcId).
    * If pts(destId) is changed, add destId to worklist.
+   *
+   * Collapsing cycles changes the copy edges, so we iterate over a copy.
    */
-  for (auto &destId : copyOutEdges[srcId]) {
+  vector<NodeID> destIds(copyOutEdges[srcId].begin(),
+                         copyOutEdges[srcId].end());
+  for (auto destId : destIds) {
+    destId = getRepresentative(destId);
+    if (destId == srcId) {
+      continue;
+    }
     if (unionPts(srcId, destId)) {
-      worklist.push(destId);
+      pushToWorklist(destId);
+      continue;
+    }
+
+    /*
+     * pts(destId) didn't change.
+     * If pts(destId) = pts(srcId), destId might reach srcId through copy
+     * edges: look for cycles.
+     */
+    uint64_t edgeKey = (static_cast<uint64_t>(srcId) << 32) | destId;
+    if (!checkedCopyEdges.insert(edgeKey).second) {
+      continue;
+    }
+    auto srcPts = pointsTo.find(srcId);
+    auto destPts = pointsTo.find(destId);
+    auto srcHasPts = (srcPts != pointsTo.end()) && !srcPts->second.empty();
+    auto destHasPts = (destPts != pointsTo.end()) && !destPts->second.empty();
+    if (srcHasPts != destHasPts) {
+      continue;
+    }
+    if (srcHasPts && (srcPts->second != destPts->second)) {
+      continue;
     }
+    if (!collapseCyclesReachableFrom(destId)) {
+      continue;
+    }
+
+    /*
+     * Cycles have been collapsed, so the copy edges of srcId might have
+     * changed. Process its representative again.
+     */
+    pushToWorklist(srcId);
+    return;
   }
 }
 
 bool MpaSummary::unionPts(NodeID srcId, NodeID dstId) {
-  BitVector oldPts = pointsTo[dstId];
-  BitVector newPts = unite(oldPts, pointsTo[srcId]);
-  if (oldPts == newPts) {
-    return false;
-  } else {
-    pointsTo[dstId] = newPts;
-    return true;
+  return pointsTo[dstId] |= pointsTo[srcId];
+}
+
+bool MpaSummary::collapseCyclesReachableFrom(NodeID rootId) {
+  /*
+   * Tarjan's algorithm over the copy edges of the nodes reachable from
+   * rootId. It is iterative to avoid deep recursions on long pointer chains.
+   * Every strongly connected component with more than one node is collapsed.
+   */
+  unordered_map<NodeID, uint32_t> index;
+  unordered_map<NodeID, uint32_t> lowLink;
+  unordered_set<NodeID> onStack;
+  vector<NodeID> stack;
+  vector<pair<NodeID, vector<NodeID>>> visits;
+  uint32_t nextIndex = 0;
+  auto collapsed = false;
+
+  auto visit = [&](NodeID nodeId) {
+    index[nodeId] = nextIndex;
+    lowLink[nodeId] = nextIndex;
+    nextIndex++;
+    stack.push_back(nodeId);
+    onStack.insert(nodeId);
+
+    vector<NodeID> successors;
+    if (copyOutEdges.find(nodeId) != copyOutEdges.end()) {
+      for (auto destId : copyOutEdges[nodeId]) {
+        destId = getRepresentative(destId);
+        if (destId != nodeId) {
+          successors.push_back(destId);
+        }
+      }
+    }
+    visits.push_back({ nodeId, successors });
+  };
+
+  visit(rootId);
+  while (!visits.empty()) {
+    auto nodeId = visits.back().first;
+    auto &successors = visits.back().second;
+
+    /*
+     * Visit the next successor.
+     */
+    if (!successors.empty()) {
+      auto succId = successors.back();
+      successors.pop_back();
+      if (index.find(succId) == index.end()) {
+        visit(succId);
+      } else if (onStack.count(succId) > 0) {
+        lowLink[nodeId] = min(lowLink[nodeId], index[succId]);
+      }
+      continue;
+    }
+
+    /*
+     * All successors have been visited.
+     */
+    visits.pop_back();
+    if (!visits.empty()) {
+      auto parentId = visits.back().first;
+      lowLink[parentId] = min(lowLink[parentId], lowLink[nodeId]);
+    }
+    if (lowLink[nodeId] != index[nodeId]) {
+      continue;
+    }
+
+    /*
+     * nodeId is the root of a strongly connected component.
+     */
+    while (true) {
+      auto sccNodeId = stack.back();
+      stack.pop_back();
+      onStack.erase(sccNodeId);
+      if (sccNodeId == nodeId) {
+        break;
+      }
+      collapse(nodeId, sccNodeId);
+      collapsed = true;
+    }
+  }
+
+  return collapsed;
+}
+
+void MpaSummary::collapse(NodeID repId, NodeID nodeId) {
+  assert(getRepresentative(repId) == repId);
+  assert(getRepresentative(nodeId) == nodeId);
+  representatives[nodeId] = repId;
+
+  /*
+   * Merge the points-to sets.
+   */
+  if (pointsTo.find(nodeId) != pointsTo.end()) {
+    unionPts(nodeId, repId);
+    pointsTo.erase(nodeId);
   }
+
+  /*
+   * Merge the copy edges.
+   * Incoming copy edges of nodeId are redirected by getRepresentative.
+   */
+  if (copyOutEdges.find(nodeId) != copyOutEdges.end()) {
+    for (auto destId : copyOutEdges[nodeId]) {
+      addCopyEdge(repId, destId);
+    }
+    copyOutEdges.erase(nodeId);
+  }
+
+  /*
+   * Merge the uses of the pointer.
+   */
+  if (incomingStores.find(nodeId) != incomingStores.end()) {
+    incomingStores[repId].insert(incomingStores[nodeId].begin(),
+                                 incomingStores[nodeId].end());
+    incomingStores.erase(nodeId);
+  }
+  if (outgoingLoads.find(nodeId) != outgoingLoads.end()) {
+    outgoingLoads[repId].insert(outgoingLoads[nodeId].begin(),
+                                outgoingLoads[nodeId].end());
+    outgoingLoads.erase(nodeId);
+  }
+  if (usedAsFuncArg.find(nodeId) != usedAsFuncArg.end()) {
+    usedAsFuncArg.insert(repId);
+  }
+
+  pushToWorklist(repId);
 }
 
 } // namespace arcana::noelle
@@ -89,12 +89,6 @@ Value *strip(Value *pointer) {
   }
 }
 
-BitVector unite(const BitVector &lhs, const BitVector &rhs) {
-  BitVector result(lhs);
-  result |= rhs;
-  return result;
-}
-
 bool isAllocation(Instruction *allocation) {
   if (isa<AllocaInst>(allocation)) {
     return true;
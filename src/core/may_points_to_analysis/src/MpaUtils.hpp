@@ -45,8 +45,6 @@ MPAFunctionType getCalleeFunctionType(CallBase *callInst);
  */
 Value *strip(Value *pointer);
 
-BitVector unite(const BitVector &lhs, const BitVector &rhs);
-
 bool isAllocation(Instruction *allocation);
 
 } // namespace arcana::noelle
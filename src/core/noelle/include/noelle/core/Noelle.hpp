@@ -190,6 +190,25 @@ public:
 
   PDG *getProgramDependenceGraph(void);
 
+  /*
+   * Recompute the dependences of @f after its code has been modified.
+   * @previousValues are the arguments and instructions @f had before the
+   * modification.
+   */
+  void recomputeDependencesOf(Function *f,
+                              std::vector<Value *> const &previousValues);
+
+  /*
+   * Update the dependences of @f after a transformation removed, added, or
+   * moved some of its instructions (see
+   * PDGGenerator::updateDependencesOfFunction).
+   * The dependence graphs of @f created before this call are stale.
+   */
+  void updateDependencesOf(Function *f,
+                           std::set<Instruction *> const &instructionsRemoved,
+                           std::set<Instruction *> const &instructionsAdded,
+                           std::set<Instruction *> const &instructionsMoved);
+
   DataFlowAnalysis getDataFlowAnalyses(void) const;
 
   CFGAnalysis getCFGAnalysis(void) const;
@@ -200,7 +219,7 @@ public:
 
   Scheduler getScheduler(void) const;
 
-  MayPointsToAnalysis getMayPointsToAnalysis(void) const;
+  MayPointsToAnalysis getMayPointsToAnalysis(void);
 
   LoopTransformer &getLoopTransformer(void);
 
@@ -246,9 +265,12 @@ private:
   LDGGenerator ldgAnalysis;
   char *filterFileName;
   bool hasReadFilterFile;
+  bool interproceduralMPA;
   std::map<uint32_t, uint32_t> loopThreads;
   std::map<uint32_t, uint32_t> techniquesToDisable;
   std::map<uint32_t, uint32_t> DOALLChunkSize;
+  std::map<uint32_t, uint32_t> tileSizes;
+  std::map<uint32_t, uint32_t> unrollFactors;
   FunctionsManager *fm;
   GlobalsManager *gm;
   TypesManager *tm;
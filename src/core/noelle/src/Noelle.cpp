@@ -22,6 +22,7 @@
 #include "noelle/core/Architecture.hpp"
 #include "noelle/core/Noelle.hpp"
 #include "noelle/core/HotProfiler.hpp"
+#include "noelle/core/MayPointsToAnalysisEngine.hpp"
 
 namespace arcana::noelle {
 
@@ -127,7 +128,11 @@ Scheduler Noelle::getScheduler(void) const {
   return Scheduler{};
 }
 
-MayPointsToAnalysis Noelle::getMayPointsToAnalysis(void) const {
+MayPointsToAnalysis Noelle::getMayPointsToAnalysis(void) {
+  if (this->interproceduralMPA) {
+    auto fm = this->getFunctionsManager();
+    return MayPointsToAnalysis{ *this->program, fm->getProgramCallGraph() };
+  }
   return MayPointsToAnalysis{};
 }
 
@@ -135,6 +140,21 @@ LoopTransformer &Noelle::getLoopTransformer(void) {
   auto &lt = getAnalysis<LoopTransformer>();
   auto pdg = this->getProgramDependenceGraph();
   lt.setPDG(pdg);
+  lt.setLoopContentBuilder([this](BasicBlock *header,
+                                  PDG *functionDG,
+                                  LoopTransformationsManager *ltm) {
+    return this->getLoopContent(header, functionDG, ltm);
+  });
+  lt.setDependencesUpdater(
+      [this](Function *f,
+             std::set<Instruction *> const &instructionsRemoved,
+             std::set<Instruction *> const &instructionsAdded,
+             std::set<Instruction *> const &instructionsMoved) {
+        this->updateDependencesOf(f,
+                                  instructionsRemoved,
+                                  instructionsAdded,
+                                  instructionsMoved);
+      });
   return lt;
 }
 
@@ -220,6 +240,16 @@ std::set<AliasAnalysisEngine *> Noelle::getAliasAnalysisEngines(void) {
     this->aaEngines = LoopContent::getLoopAliasAnalysisEngines();
     auto programAAEngines = PDGGenerator::getProgramAliasAnalysisEngines();
     this->aaEngines.insert(programAAEngines.begin(), programAAEngines.end());
+
+    /*
+     * Add the engine of the may points-to analysis.
+     */
+    auto mpa = this->interproceduralMPA
+                   ? new MayPointsToAnalysis(
+                       *this->program,
+                       this->getFunctionsManager()->getProgramCallGraph())
+                   : new MayPointsToAnalysis();
+    this->aaEngines.insert(new MayPointsToAnalysisEngine(mpa));
   }
 
   return this->aaEngines;
@@ -31,6 +31,55 @@ PDG *Noelle::getProgramDependenceGraph(void) {
   return this->programDependenceGraph;
 }
 
+void Noelle::recomputeDependencesOf(
+    Function *f,
+    std::vector<Value *> const &previousValues) {
+  assert(f != nullptr);
+
+  /*
+   * Check if the PDG has been computed.
+   * If it hasn't, there is nothing to update.
+   */
+  if (this->programDependenceGraph == nullptr) {
+    return;
+  }
+
+  /*
+   * Update the dependences of @f in place.
+   * The rest of the PDG, and therefore the FDGs of the other functions, stay
+   * the same.
+   */
+  this->pdgAnalysis->recomputeDependencesOfFunction(*f, previousValues);
+
+  return;
+}
+
+void Noelle::updateDependencesOf(
+    Function *f,
+    std::set<Instruction *> const &instructionsRemoved,
+    std::set<Instruction *> const &instructionsAdded,
+    std::set<Instruction *> const &instructionsMoved) {
+  assert(f != nullptr);
+
+  /*
+   * Check if the PDG has been computed.
+   * If it hasn't, there is nothing to update.
+   */
+  if (this->programDependenceGraph == nullptr) {
+    return;
+  }
+
+  /*
+   * Update the dependences of the instructions that changed.
+   */
+  this->pdgAnalysis->updateDependencesOfFunction(*f,
+                                                 instructionsRemoved,
+                                                 instructionsAdded,
+                                                 instructionsMoved);
+
+  return;
+}
+
 PDG *Noelle::getFunctionDependenceGraph(Function *f) {
 
   /*
@@ -956,14 +956,21 @@ bool Noelle::checkToGetLoopFilteringInfo(void) {
    * Read the file.
    */
   auto fileAsString = indexBuf.get()->getBuffer().str();
-  std::stringstream indexString{ fileAsString };
+  std::stringstream indexFileString{ fileAsString };
 
   /*
    * Parse the file
+   *
+   * Each line describes a loop.
    */
   auto filterLoops = false;
   constexpr uint32_t maxValue{ std::numeric_limits<uint32_t>::max() };
-  while (indexString.peek() != EOF) {
+  std::string line;
+  while (std::getline(indexFileString, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::stringstream indexString{ line };
     filterLoops = true;
 
     /*
@@ -984,6 +991,7 @@ bool Noelle::checkToGetLoopFilteringInfo(void) {
     if (unrollFactor == maxValue) {
       abort();
     }
+    this->unrollFactors[loopID] = unrollFactor;
 
     /*
      * Peel factor
@@ -1026,6 +1034,14 @@ bool Noelle::checkToGetLoopFilteringInfo(void) {
     this->fetchTheNextValue(indexString);
     this->fetchTheNextValue(indexString);
 
+    /*
+     * Tile size (optional)
+     */
+    indexString >> std::ws;
+    if (!indexString.eof()) {
+      this->tileSizes[loopID] = this->fetchTheNextValue(indexString);
+    }
+
     /*
      * If the loop needs to be parallelized, then we enable it.
      */
@@ -1395,6 +1411,17 @@ LoopContent *Noelle::getLoopContentForLoop(
       abort();
   }
 
+  /*
+   * Set the tile size and the unroll factor requested for the loop.
+   */
+  auto loopID = loopNode->getLoop()->getID();
+  if (loopID && (this->tileSizes.count(loopID.value()) > 0)) {
+    ltm->setTileSize(this->tileSizes[loopID.value()]);
+  }
+  if (loopID && (this->unrollFactors.count(loopID.value()) > 0)) {
+    ltm->setUnrollFactor(this->unrollFactors[loopID.value()]);
+  }
+
   return ldi;
 }
 
@@ -95,6 +95,11 @@ static cl::opt<bool> InlinerDisableHoistToMain(
     cl::ZeroOrMore,
     cl::Hidden,
     cl::desc("Disable the function inliner"));
+static cl::opt<bool> InterproceduralMPA(
+    "noelle-interprocedural-mpa",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("Use the interprocedural may points-to analysis"));
 
 bool Noelle::doInitialization(Module &M) {
 
@@ -115,6 +120,7 @@ bool Noelle::doInitialization(Module &M) {
   this->hasReadFilterFile = false;
   this->verbose = static_cast<Verbosity>(Verbose.getValue());
   this->minHot = ((double)(MinimumHotness.getValue())) / 1000;
+  this->interproceduralMPA = (InterproceduralMPA.getNumOccurrences() > 0);
   auto optMaxCores = MaximumCores.getValue();
   if (optMaxCores == 0) {
     optMaxCores = Architecture::getNumberOfPhysicalCores();
@@ -23,6 +23,7 @@
 #define NOELLE_SRC_CORE_OUTLINER_H_
 
 #include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/FunctionsManager.hpp"
 
 namespace arcana::noelle {
 
@@ -34,9 +35,20 @@ public:
       std::unordered_set<Instruction *> const &instructionsToOutline,
       Instruction *injectCallJustBeforeThis);
 
+  /*
+   * Outline @basicBlocksToOutline into a new function.
+   *
+   * The basic blocks must have a single entry, which cannot be the entry of
+   * their function.
+   * The call to the new function replaces the basic blocks, so
+   * @injectCallJustBeforeThis must be nullptr.
+   * The new function is created through @functionsManager.
+   * Return nullptr if the basic blocks cannot be outlined.
+   */
   Function *outline(
       std::unordered_set<BasicBlock *> const &basicBlocksToOutline,
-      Instruction *injectCallJustBeforeThis);
+      Instruction *injectCallJustBeforeThis,
+      FunctionsManager &functionsManager);
 
 private:
 };
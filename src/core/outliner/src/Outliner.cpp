@@ -19,6 +19,8 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include "llvm/Transforms/Utils/CodeExtractor.h"
+
 #include "noelle/core/OutlinerPass.hpp"
 
 namespace arcana::noelle {
@@ -28,17 +30,106 @@ Outliner::Outliner() {
   return;
 }
 
-Function *outline(
+Function *Outliner::outline(
     std::unordered_set<Instruction *> const &instructionsToOutline,
     Instruction *injectCallJustBeforeThis) {
   // TODO
   return nullptr;
 }
 
-Function *outline(std::unordered_set<BasicBlock *> const &basicBlocksToOutline,
-                  Instruction *injectCallJustBeforeThis) {
-  // TODO
-  return nullptr;
+Function *Outliner::outline(
+    std::unordered_set<BasicBlock *> const &basicBlocksToOutline,
+    Instruction *injectCallJustBeforeThis,
+    FunctionsManager &functionsManager) {
+
+  /*
+   * Check trivial cases
+   */
+  if (basicBlocksToOutline.empty()) {
+    return nullptr;
+  }
+  if (injectCallJustBeforeThis != nullptr) {
+    return nullptr;
+  }
+
+  /*
+   * Find the entry of the basic blocks: the only one reachable from the rest
+   * of the function.
+   */
+  BasicBlock *entry = nullptr;
+  for (auto bb : basicBlocksToOutline) {
+    for (auto predecessor : predecessors(bb)) {
+      if (basicBlocksToOutline.count(predecessor) > 0) {
+        continue;
+      }
+      if ((entry != nullptr) && (entry != bb)) {
+        return nullptr;
+      }
+      entry = bb;
+    }
+  }
+  if (entry == nullptr) {
+    return nullptr;
+  }
+  auto f = entry->getParent();
+  if (entry == &f->getEntryBlock()) {
+    return nullptr;
+  }
+
+  /*
+   * Sort the basic blocks: the entry first, the rest in the order they have in
+   * the function.
+   */
+  std::vector<BasicBlock *> basicBlocks{ entry };
+  for (auto &bb : *f) {
+    if ((&bb == entry) || (basicBlocksToOutline.count(&bb) == 0)) {
+      continue;
+    }
+    basicBlocks.push_back(&bb);
+  }
+
+  /*
+   * Outline the basic blocks.
+   */
+  CodeExtractor extractor(basicBlocks);
+  if (!extractor.isEligible()) {
+    return nullptr;
+  }
+  auto extractedFunction = extractor.extractCodeRegion();
+  if (extractedFunction == nullptr) {
+    return nullptr;
+  }
+
+  /*
+   * Move the extracted code to a function created by the functions manager,
+   * so NOELLE knows about it.
+   * The new function takes the name of the one created by the extractor.
+   */
+  auto name = extractedFunction->getName().str();
+  extractedFunction->setName("");
+  auto outlinedFunction = functionsManager.newFunction(
+      name,
+      *extractedFunction->getFunctionType());
+  outlinedFunction->copyAttributesFrom(extractedFunction);
+  outlinedFunction->setLinkage(extractedFunction->getLinkage());
+  outlinedFunction->setSubprogram(extractedFunction->getSubprogram());
+  outlinedFunction->getBasicBlockList().splice(
+      outlinedFunction->end(),
+      extractedFunction->getBasicBlockList());
+  auto newArg = outlinedFunction->arg_begin();
+  for (auto &oldArg : extractedFunction->args()) {
+    oldArg.replaceAllUsesWith(&*newArg);
+    newArg->takeName(&oldArg);
+    newArg++;
+  }
+
+  /*
+   * Call the new function instead of the extracted one.
+   */
+  extractedFunction->replaceAllUsesWith(outlinedFunction);
+  extractedFunction->eraseFromParent();
+
+  return outlinedFunction;
 }
 
 } // namespace arcana::noelle
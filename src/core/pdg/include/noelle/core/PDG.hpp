@@ -132,6 +132,18 @@ public:
 
   std::vector<DGEdge<Value, Value> *> getSortedDependences(void);
 
+  /*
+   * Versioning of the dependences of a function.
+   *
+   * The version of @F is incremented every time the dependences of @F are
+   * updated in place. Subgraphs remember the version of their function at
+   * creation, so a subgraph created before an update is stale and using it
+   * triggers an assertion.
+   */
+  void incrementVersionOf(Function &F);
+  uint64_t getVersionOf(Function &F) const;
+  bool isStale(void) const;
+
   /*
    * Destructor
    */
@@ -142,12 +154,22 @@ protected:
 
   void setEntryPointAt(Function &F);
 
+  void inheritVersionFrom(PDG const &parent, Function *F);
+
   void copyEdgesInto(PDG *newPDG, bool linkToExternal);
 
   void copyEdgesInto(
       PDG *newPDG,
       bool linkToExternal,
       std::unordered_set<DGEdge<Value, Value> *> const &edgesToIgnore);
+
+  /*
+   * Versions of the functions.
+   * They are shared with the subgraphs, which can outlive this PDG.
+   */
+  std::shared_ptr<std::unordered_map<Function *, uint64_t>> versions;
+  Function *versionedFunction;
+  uint64_t version;
 };
 
 } // namespace arcana::noelle
@@ -33,7 +33,10 @@
 
 namespace arcana::noelle {
 
-PDG::PDG(Module &M) {
+PDG::PDG(Module &M)
+  : versions{ std::make_shared<std::unordered_map<Function *, uint64_t>>() },
+    versionedFunction{ nullptr },
+    version{ 0 } {
 
   /*
    * Create a node per instruction and function argument
@@ -58,14 +61,20 @@ PDG::PDG(Module &M) {
   return;
 }
 
-PDG::PDG(Function &F) {
+PDG::PDG(Function &F)
+  : versions{ std::make_shared<std::unordered_map<Function *, uint64_t>>() },
+    versionedFunction{ nullptr },
+    version{ 0 } {
   addNodesOf(F);
   setEntryPointAt(F);
 
   return;
 }
 
-PDG::PDG(Loop *loop) {
+PDG::PDG(Loop *loop)
+  : versions{ std::make_shared<std::unordered_map<Function *, uint64_t>>() },
+    versionedFunction{ nullptr },
+    version{ 0 } {
 
   /*
    * Create a node per instruction within loops of LI only
@@ -87,7 +96,10 @@ PDG::PDG(Loop *loop) {
   return;
 }
 
-PDG::PDG(std::vector<Value *> &values) {
+PDG::PDG(std::vector<Value *> &values)
+  : versions{ std::make_shared<std::unordered_map<Function *, uint64_t>>() },
+    versionedFunction{ nullptr },
+    version{ 0 } {
   for (auto &V : values) {
     this->addNode(V, /*inclusion=*/true);
   }
@@ -124,10 +136,13 @@ PDG *PDG::createFunctionSubgraph(Function &F) {
   if (F.empty())
     return nullptr;
 
+  assert(!this->isStale() && "The PDG is stale");
+
   /*
    * Create the sub-PDG.
    */
   auto functionPDG = new PDG(F);
+  functionPDG->inheritVersionFrom(*this, &F);
 
   /*
    * Recreate all edges connected to internal nodes of function
@@ -140,11 +155,13 @@ PDG *PDG::createFunctionSubgraph(Function &F) {
 }
 
 PDG *PDG::createLoopsSubgraph(Loop *loop) {
+  assert(!this->isStale() && "The PDG is stale");
 
   /*
    * Create a node per instruction within loops of LI only
    */
   auto loopsPDG = new PDG(loop);
+  loopsPDG->inheritVersionFrom(*this, loop->getHeader()->getParent());
 
   /*
    * Recreate all edges connected to internal nodes of loop
@@ -163,9 +180,17 @@ PDG *PDG::createSubgraphFromValues(
     std::vector<Value *> &valueList,
     bool linkToExternal,
     std::unordered_set<DGEdge<Value, Value> *> edgesToIgnore) {
+  assert(!this->isStale() && "The PDG is stale");
   if (valueList.empty())
     return nullptr;
   auto newPDG = new PDG(valueList);
+  Function *valuesFunction = nullptr;
+  if (auto inst = dyn_cast<Instruction>(valueList.front())) {
+    valuesFunction = inst->getFunction();
+  } else if (auto arg = dyn_cast<Argument>(valueList.front())) {
+    valuesFunction = arg->getParent();
+  }
+  newPDG->inheritVersionFrom(*this, valuesFunction);
 
   copyEdgesInto(newPDG, linkToExternal, edgesToIgnore);
 
@@ -232,6 +257,7 @@ bool PDG::iterateOverDependencesFrom(
     bool includeRegisterDataDependences,
     std::function<bool(Value *to, DGEdge<Value, Value> *dependence)>
         functionToInvokePerDependence) {
+  assert(!this->isStale() && "The PDG is stale");
 
   /*
    * Fetch the node in the PDG.
@@ -298,6 +324,7 @@ bool PDG::iterateOverDependencesTo(
     bool includeRegisterDataDependences,
     std::function<bool(Value *fromValue, DGEdge<Value, Value> *dependence)>
         functionToInvokePerDependence) {
+  assert(!this->isStale() && "The PDG is stale");
 
   /*
    * Fetch the node in the PDG.
@@ -377,6 +404,7 @@ std::vector<Value *> PDG::getSortedValues(void) {
 }
 
 std::vector<DGEdge<Value, Value> *> PDG::getSortedDependences(void) {
+  assert(!this->isStale() && "The PDG is stale");
 
   /*
    * Sort the edges.
@@ -388,6 +416,7 @@ std::vector<DGEdge<Value, Value> *> PDG::getSortedDependences(void) {
 
 std::unordered_set<DGEdge<Value, Value> *> PDG::getDependences(Value *from,
                                                                Value *to) {
+  assert(!this->isStale() && "The PDG is stale");
 
   /*
    * Fetch the nodes.
@@ -406,6 +435,61 @@ std::unordered_set<DGEdge<Value, Value> *> PDG::getDependences(Value *from,
   return edgeSet;
 }
 
+void PDG::incrementVersionOf(Function &F) {
+  (*this->versions)[&F]++;
+
+  return;
+}
+
+uint64_t PDG::getVersionOf(Function &F) const {
+  auto it = this->versions->find(&F);
+  if (it == this->versions->end()) {
+    return 0;
+  }
+
+  return it->second;
+}
+
+bool PDG::isStale(void) const {
+
+  /*
+   * A PDG that is not a subgraph of a single function is never stale.
+   */
+  if (this->versionedFunction == nullptr) {
+    return false;
+  }
+
+  /*
+   * Check if the dependences of the function have been updated after this
+   * subgraph has been created.
+   */
+  auto currentVersion = this->getVersionOf(*this->versionedFunction);
+
+  return currentVersion != this->version;
+}
+
+void PDG::inheritVersionFrom(PDG const &parent, Function *F) {
+
+  /*
+   * Share the versions with @parent so updates are visible to both.
+   */
+  this->versions = parent.versions;
+
+  /*
+   * A subgraph of a subgraph refers to the function of its parent.
+   */
+  if (parent.versionedFunction != nullptr) {
+    F = parent.versionedFunction;
+  }
+  if (F == nullptr) {
+    return;
+  }
+  this->versionedFunction = F;
+  this->version = this->getVersionOf(*F);
+
+  return;
+}
+
 PDG::~PDG() {
   for (auto *edge : allEdges)
     if (edge)
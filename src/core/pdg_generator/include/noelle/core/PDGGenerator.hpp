@@ -58,6 +58,37 @@ public:
 
   PDG *getPDG(void);
 
+  /*
+   * Recompute the dependences of @F in the PDG returned by getPDG after the
+   * code of @F has been modified.
+   *
+   * @previousValues must include all arguments and instructions that @F had
+   * when its dependences were last computed or updated and that are no longer
+   * in @F. Some of them might no longer exist: they are only used to find the
+   * nodes to drop.
+   */
+  void recomputeDependencesOfFunction(
+      Function &F,
+      std::vector<Value *> const &previousValues);
+
+  /*
+   * Update the dependences of @F in the PDG returned by getPDG after a
+   * transformation changed only some of its instructions.
+   *
+   * @instructionsRemoved have been erased from @F (they are never
+   * dereferenced), @instructionsAdded have been inserted in @F, and
+   * @instructionsMoved are still in @F but they have been moved or their
+   * operands have changed (e.g., a terminator whose successors changed).
+   *
+   * Only the dependences of these instructions are recomputed. When the
+   * control flow of @F might have changed, all dependences of @F are.
+   */
+  void updateDependencesOfFunction(
+      Function &F,
+      std::set<Instruction *> const &instructionsRemoved,
+      std::set<Instruction *> const &instructionsAdded,
+      std::set<Instruction *> const &instructionsMoved);
+
   noelle::CallGraph *getProgramCallGraph(void);
 
   virtual ~PDGGenerator();
@@ -74,9 +105,31 @@ public:
       Module &currentProgram);
 
   static std::set<const Function *> getFunctionsWithSignature(
-      std::set<const Function *> functions,
+      std::set<const Function *> const &functions,
       FunctionType *signature);
 
+  /*
+   * Return the functions of the program that might be invoked indirectly and
+   * whose type is @signature.
+   *
+   * The answer comes from a table built every time the pass runs, which is
+   * kept up to date by addFunctionThatMightEscape and
+   * removeFunctionThatMightEscape.
+   */
+  std::set<const Function *> const &getFunctionsThatMightEscapeWithSignature(
+      FunctionType *signature) const;
+
+  /*
+   * Conservatively consider @F as a function that might be invoked
+   * indirectly.
+   */
+  void addFunctionThatMightEscape(Function &F);
+
+  /*
+   * Forget @F before it is erased from its module.
+   */
+  void removeFunctionThatMightEscape(Function &F);
+
   void cleanAndEmbedPDGAsMetadata(PDG *pdg);
 
 private:
@@ -84,6 +137,7 @@ private:
   PDG *programDependenceGraph;
   AllocAA *allocAA;
   MayPointsToAnalysis mpa;
+  std::unordered_map<DGEdge<Value, Value> *, bool> mayAliasOfMemoryEdge;
   TalkDown *talkdown;
   DataFlowAnalysis dfa;
   PDGVerbosity verbose;
@@ -101,17 +155,50 @@ private:
   std::set<CallGraphAnalysis *> cgAnalyses;
   std::unordered_set<const Function *> internalFuncs;
   std::unordered_set<const Function *> unhandledExternalFuncs;
-  std::unordered_map<const Function *, std::unordered_set<const Function *>>
-      reachableUnhandledExternalFuncs;
+  std::vector<const Function *> indexedUnhandledExternalFuncs;
+  std::unordered_map<const Function *, uint32_t> sccOfFunction;
+  std::vector<BitVector> reachableUnhandledExternalFuncs;
+  std::unordered_set<const Function *>
+      internalFuncsThatReachUnhandledExternalFuncs;
+
+  /*
+   * Memory that a function, and the functions it might invoke, might access.
+   * Abstract locations are the global variables of the module; any other
+   * location outside the stack frame of the function is unknown.
+   */
+  struct FunctionSummary {
+    BitVector globalsRead;
+    BitVector globalsWritten;
+    bool readsUnknownMemory;
+    bool writesUnknownMemory;
+  };
+  bool summariesComputed;
+  std::unordered_map<const GlobalVariable *, uint32_t> globalIndexes;
+  std::unordered_map<const Function *, uint32_t> summaryOfFunction;
+  std::vector<FunctionSummary> summaries;
+
+  std::unordered_map<FunctionType *, std::set<const Function *>>
+      functionsThatMightEscapeBySignature;
 
   void initializeSVF(Module &M);
   void identifyFunctionsThatInvokeUnhandledLibrary(Module &M);
   void printFunctionReachabilityResult();
+  void indexFunctionsThatMightEscape(Module &currentProgram);
+  static bool mightEscape(const Function &F);
+  bool isUnresolvedIndirectCall(CallBase *call);
+  bool hasUnresolvedIndirectCall(Function &F);
   bool isSafeToQueryModRefOfSVF(CallBase *call, BitVector &bv);
   bool isUnhandledExternalFunction(const Function *F);
   bool isInternalFunctionThatReachUnhandledExternalFunction(const Function *F);
   bool cannotReachUnhandledExternalFunction(CallBase *call);
   bool hasNoMemoryOperations(CallBase *call);
+  void computeFunctionSummaries(void);
+  void invalidateFunctionSummaries(void);
+  void addToSummary(FunctionSummary &summary, Value *pointer, bool isWrite);
+  FunctionSummary getSummaryOfCall(CallBase *call);
+  ModRefInfo getModRefInfoFromSummaries(CallBase *call,
+                                        const MemoryLocation &loc);
+  ModRefInfo getModRefInfoFromSummaries(CallBase *call, CallBase *otherCall);
 
   bool comparePDGs(PDG *pdg1, PDG *pdg2);
   bool compareNodes(PDG *pdg1, PDG *pdg2);
@@ -120,6 +207,14 @@ private:
       PDG *pdg1,
       PDG *pdg2,
       std::function<void(DGEdge<Value, Value> *dependenceMissingInPdg2)> func);
+  bool compareEdges(
+      const std::vector<DGEdge<Value, Value> *> &dependences,
+      PDG *pdg2,
+      std::function<void(DGEdge<Value, Value> *dependenceMissingInPdg2)> func);
+  std::unordered_map<Function *, std::vector<DGEdge<Value, Value> *>>
+  groupDependencesByFunction(PDG *pdg);
+  uint64_t computeFingerprint(
+      const std::vector<DGEdge<Value, Value> *> &dependences);
 
   bool hasPDGAsMetadata(Module &);
 
@@ -156,10 +251,15 @@ private:
 
   PDG *constructPDGFromAnalysis(Module &M);
   void constructEdgesFromUseDefs(PDG *pdg);
+  void constructEdgesFromUseDefsForFunction(PDG *pdg, Function &F);
   void constructEdgesFromAliases(PDG *pdg, Module &M);
   void constructEdgesFromControl(PDG *pdg, Module &M);
   void constructEdgesFromAliasesForFunction(PDG *pdg, Function &F);
   void constructEdgesFromControlForFunction(PDG *pdg, Function &F);
+  void trimDependencesOf(PDG *pdg,
+                         Function &F,
+                         std::vector<Instruction *> const &insts);
+  void verifyDependencesOfFunction(PDG *pdg, Function &F);
 
   void iterateInstForStore(PDG *,
                            Function &,
@@ -176,6 +276,23 @@ private:
                           AAResults &,
                           DataFlowResult *,
                           CallBase *);
+  void addEdgesFromStore(PDG *pdg,
+                         Function &F,
+                         AAResults &AA,
+                         StoreInst *store,
+                         Instruction *inst);
+  void addEdgesFromLoad(PDG *pdg,
+                        Function &F,
+                        AAResults &AA,
+                        LoadInst *load,
+                        Instruction *inst);
+  void addEdgesFromCall(PDG *pdg,
+                        Function &F,
+                        AAResults &AA,
+                        DataFlowResult *dfr,
+                        CallBase *call,
+                        Instruction *inst);
+  bool canCallHaveMemoryDependences(CallBase *call);
 
   void addEdgeFromMemoryAlias(PDG *,
                               Function &,
@@ -203,6 +320,17 @@ private:
                                  bool);
 
   void removeEdgesNotUsedByParSchemes(PDG *pdg);
+  bool isEdgeNotUsedByParSchemes(PDG *pdg, DGEdge<Value, Value> *edge);
+
+  /*
+   * The checks of isEdgeNotUsedByParSchemes split in two groups.
+   * The thread-safe checks only read the IR, the may points-to analysis, and
+   * AllocAA. The sequential checks fetch function analyses from the pass
+   * manager.
+   */
+  bool isEdgeNotUsedByParSchemes_threadSafeChecks(PDG *pdg,
+                                                  DGEdge<Value, Value> *edge);
+  bool isEdgeNotUsedByParSchemes_sequentialChecks(DGEdge<Value, Value> *edge);
 
   AliasResult doTheyAlias(PDG *pdg,
                           Function &F,
@@ -222,6 +350,14 @@ private:
 
   bool canMemoryEdgeBeRemoved(PDG *pdg, DGEdge<Value, Value> *edge);
 
+  /*
+   * Answer the alias queries of the memory dependences between loads and
+   * stores of @edges with a batch query per function.
+   * canMemoryEdgeBeRemoved uses the answers until they are cleared.
+   */
+  void computeMayAliasOfMemoryEdges(
+      std::vector<DGEdge<Value, Value> *> const &edges);
+
   bool canThereBeAMemoryDataDependence(Instruction *fromInst,
                                        Instruction *toInst,
                                        Function &F);
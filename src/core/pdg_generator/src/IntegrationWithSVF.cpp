@@ -86,14 +86,19 @@ bool NoelleSVFIntegration::runOnModule(Module &M) {
   return false;
 }
 
-noelle::CallGraph *NoelleSVFIntegration::getProgramCallGraph(Module &M) {
+noelle::CallGraph *NoelleSVFIntegration::getProgramCallGraph(
+    Module &M,
+    PDGGenerator &pdgGenerator) {
 
   /*
    * Compute the call graph using NOELLE
    */
+  auto getCallees = [&pdgGenerator](CallBase *call) {
+    return NoelleSVFIntegration::getIndCSCallees(call, pdgGenerator);
+  };
   auto cg = new noelle::CallGraph(M,
                                   NoelleSVFIntegration::hasIndCSCallees,
-                                  NoelleSVFIntegration::getIndCSCallees);
+                                  getCallees);
 
   return cg;
 }
@@ -113,7 +118,8 @@ bool NoelleSVFIntegration::hasIndCSCallees(CallBase *call) {
 }
 
 const std::set<const Function *> NoelleSVFIntegration::getIndCSCallees(
-    CallBase *call) {
+    CallBase *call,
+    PDGGenerator &pdgGenerator) {
 
   /*
    * Check if @call is a direct call.
@@ -140,13 +146,8 @@ const std::set<const Function *> NoelleSVFIntegration::getIndCSCallees(
    * Collect all functions that escape and that are compatible with the
    * signature of the call instruction.
    */
-  auto currentProgram = call->getModule();
-  auto callees = PDGGenerator::getFunctionsThatMightEscape(*currentProgram);
   auto targetSignature = call->getFunctionType();
-  auto compatibleCallees =
-      PDGGenerator::getFunctionsWithSignature(callees, targetSignature);
-
-  return compatibleCallees;
+  return pdgGenerator.getFunctionsThatMightEscapeWithSignature(targetSignature);
 }
 
 bool NoelleSVFIntegration::isReachableBetweenFunctions(const Function *from,
@@ -216,7 +217,12 @@ std::set<AliasAnalysisEngine *> PDGGenerator::getProgramAliasAnalysisEngines(
   std::set<AliasAnalysisEngine *> s;
 
 #ifdef NOELLE_ENABLE_SVF
-  auto svf = new ProgramAliasAnalysisEngine("SVF", wpa);
+  auto svf = new ProgramAliasAnalysisEngine(
+      "SVF",
+      wpa,
+      [](const MemoryLocation &loc1, const MemoryLocation &loc2) {
+        return NoelleSVFIntegration::alias(loc1, loc2);
+      });
   s.insert(svf);
 #endif
 
@@ -36,9 +36,12 @@ public:
   void getAnalysisUsage(AnalysisUsage &AU) const override;
   bool runOnModule(Module &M) override;
 
-  static noelle::CallGraph *getProgramCallGraph(Module &M);
+  static noelle::CallGraph *getProgramCallGraph(Module &M,
+                                                PDGGenerator &pdgGenerator);
   static bool hasIndCSCallees(CallBase *call);
-  static const std::set<const Function *> getIndCSCallees(CallBase *call);
+  static const std::set<const Function *> getIndCSCallees(
+      CallBase *call,
+      PDGGenerator &pdgGenerator);
   static bool isReachableBetweenFunctions(const Function *from,
                                           const Function *to);
   static ModRefInfo getModRefInfo(CallBase *i);
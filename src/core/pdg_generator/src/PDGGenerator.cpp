@@ -19,6 +19,7 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <atomic>
 #include "noelle/core/SystemHeaders.hpp"
 #include "noelle/core/TalkDown.hpp"
 #include "noelle/core/PDGPrinter.hpp"
@@ -41,7 +42,8 @@ PDGGenerator::PDGGenerator()
     disableAllocAA{ false },
     disableRA{ false },
     printer{},
-    noelleCG{ nullptr } {
+    noelleCG{ nullptr },
+    summariesComputed{ false } {
 
   return;
 }
@@ -71,10 +73,15 @@ void PDGGenerator::printFunctionReachabilityResult() {
   /*
    * Print reachability results.
    */
-  for (auto &pair : this->reachableUnhandledExternalFuncs) {
-    errs()
-        << "Reachable external functions of " << pair.first->getName() << "\n";
-    for (auto &external : pair.second) {
+  for (auto internal : this->internalFuncs) {
+    auto sccIndex = this->sccOfFunction.at(internal);
+    auto &reachable = this->reachableUnhandledExternalFuncs[sccIndex];
+    if (reachable.none()) {
+      continue;
+    }
+    errs() << "Reachable external functions of " << internal->getName() << "\n";
+    for (auto externalIndex : reachable.set_bits()) {
+      auto external = this->indexedUnhandledExternalFuncs[externalIndex];
       errs() << "\t" << external->getName() << "\n";
     }
   }
@@ -198,6 +205,20 @@ void PDGGenerator::trimDGUsingCustomAliasAnalysis(PDG *pdg) {
    * Fetch and invoke MayPointsToAnalysis
    */
   this->mpa = MayPointsToAnalysis{};
+  std::vector<Function *> functions;
+  for (auto &F : *this->M) {
+    if (!F.empty()) {
+      functions.push_back(&F);
+    }
+  }
+  this->mpa.doMayPointsToAnalysis(functions);
+  if (this->verbose >= PDGVerbosity::Maximal) {
+    for (auto f : functions) {
+      errs() << "PDGGenerator: MayPointsToAnalysis of " << f->getName()
+             << " solved in " << this->mpa.getSolveTimeInMicroseconds(f)
+             << " us\n";
+    }
+  }
   removeEdgesNotUsedByParSchemes(pdg);
 
   /*
@@ -241,6 +262,31 @@ void PDGGenerator::constructEdgesFromUseDefs(PDG *pdg) {
   return;
 }
 
+void PDGGenerator::constructEdgesFromUseDefsForFunction(PDG *pdg,
+                                                        Function &F) {
+
+  /*
+   * Add the dependences due to the arguments and instructions of @F.
+   * Their uses are all within @F.
+   */
+  auto addEdgesFromUses = [pdg](Value *definition) {
+    for (auto &U : definition->uses()) {
+      auto user = U.getUser();
+      if (isa<Instruction>(user) || isa<Argument>(user)) {
+        pdg->addVariableDataDependenceEdge(definition, user, DG_DATA_RAW);
+      }
+    }
+  };
+  for (auto &arg : F.args()) {
+    addEdgesFromUses(&arg);
+  }
+  for (auto &inst : instructions(F)) {
+    addEdgesFromUses(&inst);
+  }
+
+  return;
+}
+
 void PDGGenerator::constructEdgesFromAliases(PDG *pdg, Module &M) {
 
   /*
@@ -321,51 +367,209 @@ void PDGGenerator::constructEdgesFromAliasesForFunction(PDG *pdg, Function &F) {
 }
 
 void PDGGenerator::removeEdgesNotUsedByParSchemes(PDG *pdg) {
-  std::set<DGEdge<Value, Value> *> removeEdges;
 
   /*
-   * Collect the edges in the PDG that can be safely removed.
+   * Fetch the edges.
    */
-  for (auto edge : pdg->getEdges()) {
+  std::vector<DGEdge<Value, Value> *> edges(pdg->begin_edges(),
+                                            pdg->end_edges());
 
-    /*
-     * Fetch the source of the dependence.
-     */
-    auto source = edge->getSrc();
-    if (!isa<Instruction>(source)) {
-      continue;
+  /*
+   * Answer the alias queries between loads and stores before the threads
+   * start, so the threads only read the answers.
+   */
+  this->computeMayAliasOfMemoryEdges(edges);
+
+  /*
+   * Run the thread-safe checks in parallel.
+   * Every thread classifies chunks of consecutive edges and writes only the
+   * entries of @canBeRemoved of its own chunks.
+   * The may points-to summaries have all been computed already (see
+   * trimDGUsingCustomAliasAnalysis), so the checks only read them.
+   */
+  std::vector<char> canBeRemoved(edges.size(), false);
+  const uint64_t chunkSize = 256;
+  std::atomic<uint64_t> nextChunk{ 0 };
+  auto classify = [this, pdg, &edges, &canBeRemoved, &nextChunk]() {
+    while (true) {
+      auto begin = (nextChunk++) * chunkSize;
+      if (begin >= edges.size()) {
+        return;
+      }
+      auto end = std::min<uint64_t>(begin + chunkSize, edges.size());
+      for (auto i = begin; i < end; i++) {
+        canBeRemoved[i] =
+            this->isEdgeNotUsedByParSchemes_threadSafeChecks(pdg, edges[i]);
+      }
     }
+  };
+  uint64_t threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min<uint64_t>(threads,
+                               (edges.size() + chunkSize - 1) / chunkSize);
+  std::vector<std::thread> workers;
+  for (uint64_t t = 1; t < threads; t++) {
+    workers.emplace_back(classify);
+  }
+  classify();
+  for (auto &worker : workers) {
+    worker.join();
+  }
 
-    /*
-     * Check if the dependence can be removed because the instructions accessing
-     * separate memory regions.
-     */
-    if (isa<MemoryDependence<Value, Value>>(edge)
-        && this->canMemoryEdgeBeRemoved(pdg, edge)) {
-      removeEdges.insert(edge);
+  /*
+   * Run the remaining checks sequentially on the edges that are still there.
+   * Every edge is classified independently from the others, so the set of
+   * edges to remove does not depend on the order of the classifications.
+   */
+  std::unordered_set<DGEdge<Value, Value> *> removeEdges;
+  for (auto i = 0u; i < edges.size(); i++) {
+    if (canBeRemoved[i]
+        || this->isEdgeNotUsedByParSchemes_sequentialChecks(edges[i])) {
+      removeEdges.insert(edges[i]);
+    }
+  }
+
+  /*
+   * Remove the tagged edges.
+   */
+  pdg->removeEdges(removeEdges);
+  this->mayAliasOfMemoryEdge.clear();
+
+  return;
+}
+
+void PDGGenerator::computeMayAliasOfMemoryEdges(
+    std::vector<DGEdge<Value, Value> *> const &edges) {
+  this->mayAliasOfMemoryEdge.clear();
+
+  /*
+   * Collect the pointers accessed by the loads and stores connected by memory
+   * dependences, per function.
+   */
+  std::unordered_map<Function *, std::vector<Value *>> pointersOfFunction;
+  std::unordered_map<Function *, std::unordered_map<Value *, uint64_t>>
+      indexesOfFunction;
+  std::vector<DGEdge<Value, Value> *> edgesToAnswer;
+  for (auto edge : edges) {
+    if (!isa<MemoryDependence<Value, Value>>(edge)) {
+      continue;
+    }
+    auto i0 = dyn_cast<Instruction>(edge->getSrc());
+    auto i1 = dyn_cast<Instruction>(edge->getDst());
+    if ((i0 == nullptr) || (i1 == nullptr)
+        || (i0->getFunction() != i1->getFunction())) {
+      continue;
+    }
+    auto p0 = getLoadStorePointerOperand(i0);
+    auto p1 = getLoadStorePointerOperand(i1);
+    if ((p0 == nullptr) || (p1 == nullptr)) {
       continue;
     }
+    auto f = i0->getFunction();
+    auto &pointers = pointersOfFunction[f];
+    auto &indexes = indexesOfFunction[f];
+    for (auto pointer : { p0, p1 }) {
+      if (indexes.count(pointer) == 0) {
+        indexes[pointer] = pointers.size();
+        pointers.push_back(pointer);
+      }
+    }
+    edgesToAnswer.push_back(edge);
+  }
 
-    /*
-     * Check if the function of the dependence destination cannot be reached
-     * from main.
-     */
-    if (edgeIsNotLoopCarriedMemoryDependency(edge)
-        || edgeIsAlongNonMemoryWritingFunctions(edge)) {
-      removeEdges.insert(edge);
+  /*
+   * Answer the queries of a function all together.
+   * The batch query answers all pairs of pointers, so functions with too many
+   * pointers are left to the single queries.
+   */
+  const uint64_t maximumPointersPerBatch = 4096;
+  std::unordered_map<Function *, std::vector<std::vector<bool>>>
+      mayAliasOfFunction;
+  for (auto &pair : pointersOfFunction) {
+    if (pair.second.size() > maximumPointersPerBatch) {
+      continue;
     }
+    mayAliasOfFunction[pair.first] = this->mpa.mayAlias(pair.second);
   }
 
   /*
-   * Remove the tagged edges.
+   * Record the answers of the dependences.
    */
-  for (auto edge : removeEdges) {
-    pdg->removeEdge(edge);
+  for (auto edge : edgesToAnswer) {
+    auto i0 = cast<Instruction>(edge->getSrc());
+    auto i1 = cast<Instruction>(edge->getDst());
+    auto f = i0->getFunction();
+    if (mayAliasOfFunction.count(f) == 0) {
+      continue;
+    }
+    auto &indexes = indexesOfFunction.at(f);
+    auto index0 = indexes.at(getLoadStorePointerOperand(i0));
+    auto index1 = indexes.at(getLoadStorePointerOperand(i1));
+    this->mayAliasOfMemoryEdge[edge] =
+        mayAliasOfFunction.at(f)[index0][index1];
   }
 
   return;
 }
 
+bool PDGGenerator::isEdgeNotUsedByParSchemes(PDG *pdg,
+                                             DGEdge<Value, Value> *edge) {
+  return this->isEdgeNotUsedByParSchemes_threadSafeChecks(pdg, edge)
+         || this->isEdgeNotUsedByParSchemes_sequentialChecks(edge);
+}
+
+bool PDGGenerator::isEdgeNotUsedByParSchemes_threadSafeChecks(
+    PDG *pdg,
+    DGEdge<Value, Value> *edge) {
+
+  /*
+   * Fetch the source of the dependence.
+   */
+  auto source = edge->getSrc();
+  if (!isa<Instruction>(source)) {
+    return false;
+  }
+
+  /*
+   * Check if the dependence can be removed because the instructions accessing
+   * separate memory regions.
+   */
+  if (isa<MemoryDependence<Value, Value>>(edge)
+      && this->canMemoryEdgeBeRemoved(pdg, edge)) {
+    return true;
+  }
+
+  /*
+   * Check if the dependence is between functions that do not write memory.
+   */
+  if (edgeIsAlongNonMemoryWritingFunctions(edge)) {
+    return true;
+  }
+
+  return false;
+}
+
+bool PDGGenerator::isEdgeNotUsedByParSchemes_sequentialChecks(
+    DGEdge<Value, Value> *edge) {
+
+  /*
+   * Fetch the source of the dependence.
+   */
+  auto source = edge->getSrc();
+  if (!isa<Instruction>(source)) {
+    return false;
+  }
+
+  /*
+   * Check if the dependence cannot be loop-carried.
+   * This check fetches the loops and the scalar evolution of functions.
+   */
+  if (edgeIsNotLoopCarriedMemoryDependency(edge)) {
+    return true;
+  }
+
+  return false;
+}
+
 bool PDGGenerator::canMemoryEdgeBeRemoved(PDG *pdg,
                                           DGEdge<Value, Value> *edge) {
   assert(pdg != nullptr);
@@ -416,7 +620,18 @@ bool PDGGenerator::canMemoryEdgeBeRemoved(PDG *pdg,
   if ((!isa<CallBase>(i0)) && (!isa<CallBase>(i1))) {
     auto p0 = getPointer(i0);
     auto p1 = getPointer(i1);
-    if (p0 && p1 && !mpa.mayAlias(p0, p1)) {
+    if (!p0 || !p1) {
+      return false;
+    }
+
+    /*
+     * Use the answer of the batch query if there is one.
+     */
+    auto answer = this->mayAliasOfMemoryEdge.find(edge);
+    auto mayAlias = (answer != this->mayAliasOfMemoryEdge.end())
+                        ? answer->second
+                        : mpa.mayAlias(p0, p1);
+    if (!mayAlias) {
       return true;
     }
     return false;
@@ -23,6 +23,7 @@
 #include "noelle/core/TalkDown.hpp"
 #include "noelle/core/PDGPrinter.hpp"
 #include "noelle/core/PDGGenerator.hpp"
+#include "noelle/core/SCCCAG.hpp"
 #include "IntegrationWithSVF.hpp"
 
 namespace arcana::noelle {
@@ -52,17 +53,13 @@ noelle::CallGraph *PDGGenerator::getProgramCallGraph(void) {
         /*
          * @call is an indirect call.
          */
-        auto callees = PDGGenerator::getFunctionsThatMightEscape(*M);
         auto targetSignature = call->getFunctionType();
-        auto compatibleCallees =
-            PDGGenerator::getFunctionsWithSignature(callees, targetSignature);
-
-        return compatibleCallees;
+        return this->getFunctionsThatMightEscapeWithSignature(targetSignature);
       };
       this->noelleCG = new noelle::CallGraph(*M, hasF, getCallees);
 
     } else {
-      this->noelleCG = NoelleSVFIntegration::getProgramCallGraph(*M);
+      this->noelleCG = NoelleSVFIntegration::getProgramCallGraph(*M, *this);
     }
   }
 
@@ -149,37 +146,98 @@ void PDGGenerator::identifyFunctionsThatInvokeUnhandledLibrary(Module &M) {
 
   /*
    * Collect internal and unhandled external functions.
+   * Unhandled external functions are indexed in module order; these indexes
+   * are the bits of the reachability sets computed below.
    */
+  std::unordered_map<const Function *, uint32_t> externalIndexes;
   for (auto &F : M) {
     if (F.empty()) {
       if (this->externalFuncsHaveNoSideEffectOrHandledBySVF.count(
               F.getName())) {
         continue;
       }
+      externalIndexes[&F] = this->indexedUnhandledExternalFuncs.size();
+      this->indexedUnhandledExternalFuncs.push_back(&F);
       this->unhandledExternalFuncs.insert(&F);
     } else {
       this->internalFuncs.insert(&F);
     }
   }
+  auto numberOfExternals = this->indexedUnhandledExternalFuncs.size();
 
   /*
-   * Identify function reachability.
+   * Condense the call graph into its SCCs.
+   * We build a call graph just for this purpose because the one cached by
+   * getProgramCallGraph is refined by call graph analyses that might not have
+   * been registered yet.
    */
-  for (auto &internal : this->internalFuncs) {
-    for (auto &external : this->unhandledExternalFuncs) {
-      if (NoelleSVFIntegration::isReachableBetweenFunctions(internal,
-                                                            external)) {
-        this->reachableUnhandledExternalFuncs[internal].insert(external);
+  auto cg = NoelleSVFIntegration::getProgramCallGraph(M, *this);
+  auto scccag = new SCCCAG(cg);
+
+  /*
+   * Compute the unhandled external functions reachable from every SCC.
+   * SCCs are visited bottom-up (callees before callers), so the set of an SCC
+   * is the union of the sets of its callees plus the unhandled external
+   * functions it contains.
+   */
+  std::unordered_map<SCCCAGNode *, uint32_t> sccIndexes;
+  for (auto node : scccag->getNodesInBottomUpOrder()) {
+    auto functions = node->getFunctions();
+
+    /*
+     * Compute the set of the current SCC.
+     */
+    BitVector reachable(numberOfExternals);
+    for (auto f : functions) {
+      if (externalIndexes.find(f) != externalIndexes.end()) {
+        reachable.set(externalIndexes.at(f));
       }
     }
+    for (auto pair : scccag->getOutgoingEdges(node)) {
+      auto callee = pair.first;
+      reachable |= this->reachableUnhandledExternalFuncs[sccIndexes.at(callee)];
+    }
+
+    /*
+     * The call graph has no edge for an indirect call without known callees.
+     * Such a call might invoke any unhandled external function.
+     */
+    for (auto f : functions) {
+      if (this->hasUnresolvedIndirectCall(*f)) {
+        reachable.set();
+        break;
+      }
+    }
+
+    /*
+     * Store the set.
+     */
+    auto sccIndex = this->reachableUnhandledExternalFuncs.size();
+    sccIndexes[node] = sccIndex;
+    for (auto f : functions) {
+      this->sccOfFunction[f] = sccIndex;
+      if (!f->empty() && reachable.any()) {
+        this->internalFuncsThatReachUnhandledExternalFuncs.insert(f);
+      }
+    }
+    this->reachableUnhandledExternalFuncs.push_back(std::move(reachable));
   }
 
+  /*
+   * Free the memory.
+   */
+  delete scccag;
+  delete cg;
+
   return;
 }
 
 bool PDGGenerator::cannotReachUnhandledExternalFunction(CallBase *call) {
+  if (this->isUnresolvedIndirectCall(call)) {
+    return false;
+  }
   if (NoelleSVFIntegration::hasIndCSCallees(call)) {
-    auto callees = NoelleSVFIntegration::getIndCSCallees(call);
+    auto callees = NoelleSVFIntegration::getIndCSCallees(call, *this);
     for (auto &callee : callees) {
       if (this->isUnhandledExternalFunction(callee)
           || isInternalFunctionThatReachUnhandledExternalFunction(callee))
@@ -196,6 +254,32 @@ bool PDGGenerator::cannotReachUnhandledExternalFunction(CallBase *call) {
   return true;
 }
 
+bool PDGGenerator::isUnresolvedIndirectCall(CallBase *call) {
+  if (false || (call->getCalledFunction() != nullptr)
+      || call->isInlineAsm()) {
+    return false;
+  }
+  if (!NoelleSVFIntegration::hasIndCSCallees(call)) {
+    return true;
+  }
+
+  return NoelleSVFIntegration::getIndCSCallees(call, *this).empty();
+}
+
+bool PDGGenerator::hasUnresolvedIndirectCall(Function &F) {
+  for (auto &inst : instructions(F)) {
+    auto call = dyn_cast<CallBase>(&inst);
+    if (call == nullptr) {
+      continue;
+    }
+    if (this->isUnresolvedIndirectCall(call)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool PDGGenerator::isUnhandledExternalFunction(const Function *F) {
   return F->empty()
          && !this->externalFuncsHaveNoSideEffectOrHandledBySVF.count(
@@ -204,11 +288,11 @@ bool PDGGenerator::isUnhandledExternalFunction(const Function *F) {
 
 bool PDGGenerator::isInternalFunctionThatReachUnhandledExternalFunction(
     const Function *F) {
-  return !F->empty() && !this->reachableUnhandledExternalFuncs[F].empty();
+  return this->internalFuncsThatReachUnhandledExternalFuncs.count(F) > 0;
 }
 
 std::set<const Function *> PDGGenerator::getFunctionsWithSignature(
-    std::set<const Function *> functions,
+    std::set<const Function *> const &functions,
     FunctionType *signature) {
   std::set<const Function *> compatibleCallees;
   for (auto f : functions) {
@@ -225,32 +309,88 @@ std::set<const Function *> PDGGenerator::getFunctionsThatMightEscape(
   std::set<const Function *> callees;
 
   /*
-   * Collect all functions that escape and that are compatible with the
-   * signature of the call instruction.
+   * Collect all functions that escape.
    */
   for (auto &F : currentProgram) {
+    if (PDGGenerator::mightEscape(F)) {
+      callees.insert(&F);
+    }
+  }
+
+  return callees;
+}
+
+bool PDGGenerator::mightEscape(const Function &F) {
+
+  /*
+   * Check if @F is used for something that isn't a direct call.
+   * In this case, we cannot exclude (without additional analysis) that @F
+   * could be invoked indirectly.
+   */
+  for (auto user : F.users()) {
+    if (auto c = dyn_cast<CallBase>(user)) {
+      if (c->getCalledFunction() == &F) {
+        continue;
+      }
+    }
 
     /*
-     * Check if @F is used for something that isn't a direct call.
-     * In this case, we cannot exclude (without additional analysis) that @F
-     * could be invoked indirectly.
+     * @F could be invoked indirectly as its address is used by a non-call
+     * instruction.
      */
-    for (auto user : F.users()) {
-      if (auto c = dyn_cast<CallBase>(user)) {
-        if (c->getCalledFunction() == &F) {
-          continue;
-        }
-      }
+    return true;
+  }
 
-      /*
-       * @F could be invoked indirectly as its address is used by a non-call
-       * instruction.
-       */
-      callees.insert(&F);
+  return false;
+}
+
+void PDGGenerator::indexFunctionsThatMightEscape(Module &currentProgram) {
+
+  /*
+   * Index the functions that escape by their signature.
+   * Every function is visited once, so this is linear in the number of uses
+   * of functions.
+   */
+  this->functionsThatMightEscapeBySignature.clear();
+  for (auto &F : currentProgram) {
+    if (PDGGenerator::mightEscape(F)) {
+      this->functionsThatMightEscapeBySignature[F.getFunctionType()].insert(
+          &F);
     }
   }
 
-  return callees;
+  return;
+}
+
+std::set<const Function *> const &PDGGenerator::
+    getFunctionsThatMightEscapeWithSignature(FunctionType *signature) const {
+  static std::set<const Function *> noFunctions{};
+
+  /*
+   * Fetch the functions with the signature requested.
+   */
+  auto it = this->functionsThatMightEscapeBySignature.find(signature);
+  if (it == this->functionsThatMightEscapeBySignature.end()) {
+    return noFunctions;
+  }
+
+  return it->second;
+}
+
+void PDGGenerator::addFunctionThatMightEscape(Function &F) {
+  this->functionsThatMightEscapeBySignature[F.getFunctionType()].insert(&F);
+
+  return;
+}
+
+void PDGGenerator::removeFunctionThatMightEscape(Function &F) {
+  auto it = this->functionsThatMightEscapeBySignature.find(F.getFunctionType());
+  if (it == this->functionsThatMightEscapeBySignature.end()) {
+    return;
+  }
+  it->second.erase(&F);
+
+  return;
 }
 
 } // namespace arcana::noelle
@@ -19,6 +19,7 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <atomic>
 #include "noelle/core/SystemHeaders.hpp"
 
 #include "noelle/core/PDGPrinter.hpp"
@@ -51,7 +52,16 @@ bool PDGGenerator::compareEdges(
     PDG *pdg1,
     PDG *pdg2,
     std::function<void(DGEdge<Value, Value> *dependenceMissingInPdg2)> func) {
-  for (auto &edge1 : pdg1->getEdges()) {
+  std::vector<DGEdge<Value, Value> *> dependences(pdg1->begin_edges(),
+                                                  pdg1->end_edges());
+  return this->compareEdges(dependences, pdg2, func);
+}
+
+bool PDGGenerator::compareEdges(
+    const std::vector<DGEdge<Value, Value> *> &dependences,
+    PDG *pdg2,
+    std::function<void(DGEdge<Value, Value> *dependenceMissingInPdg2)> func) {
+  for (auto edge1 : dependences) {
     auto edgeSet = pdg2->getDependences(edge1->getSrc(), edge1->getDst());
     if (edgeSet.empty()) {
       func(edge1);
@@ -87,6 +97,62 @@ bool PDGGenerator::compareEdges(
   return true;
 }
 
+static Function *getFunctionOfDependence(DGEdge<Value, Value> *dependence) {
+  for (auto value : { dependence->getSrc(), dependence->getDst() }) {
+    if (auto inst = dyn_cast<Instruction>(value)) {
+      return inst->getFunction();
+    }
+    if (auto arg = dyn_cast<Argument>(value)) {
+      return arg->getParent();
+    }
+  }
+
+  return nullptr;
+}
+
+std::unordered_map<Function *, std::vector<DGEdge<Value, Value> *>>
+PDGGenerator::groupDependencesByFunction(PDG *pdg) {
+  std::unordered_map<Function *, std::vector<DGEdge<Value, Value> *>> groups;
+  for (auto dependence : pdg->getEdges()) {
+    auto f = getFunctionOfDependence(dependence);
+    groups[f].push_back(dependence);
+  }
+
+  return groups;
+}
+
+uint64_t PDGGenerator::computeFingerprint(
+    const std::vector<DGEdge<Value, Value> *> &dependences) {
+
+  /*
+   * Hash every dependence: its end points, its kind, whether it is
+   * loop-carried, and its data dependence type.
+   * Both PDGs are built on top of the same module, so the address of a value
+   * identifies it across the two graphs.
+   */
+  std::vector<hash_code> hashes;
+  hashes.reserve(dependences.size());
+  for (auto dependence : dependences) {
+    auto h = hash_combine(dependence->getSrc(),
+                          dependence->getDst(),
+                          dependence->getKind(),
+                          dependence->isLoopCarriedDependence());
+    if (auto dataDep = dyn_cast<DataDependence<Value, Value>>(dependence)) {
+      h = hash_combine(h, dataDep->getDataDependenceType());
+    }
+    hashes.push_back(h);
+  }
+
+  /*
+   * Canonicalize the list of dependences by sorting their hashes.
+   * This makes the fingerprint independent of the order the dependences have
+   * been added to the PDG.
+   */
+  std::sort(hashes.begin(), hashes.end());
+
+  return hash_combine_range(hashes.begin(), hashes.end());
+}
+
 bool PDGGenerator::compareEdges(PDG *pdg1, PDG *pdg2) {
   assert(pdg1 != nullptr);
   assert(pdg2 != nullptr);
@@ -122,6 +188,7 @@ bool PDGGenerator::compareEdges(PDG *pdg1, PDG *pdg2) {
   /*
    * Check the number of dependences are the same between the two PDGs.
    */
+  auto match = true;
   if (pdg1->getNumberOfDependencesBetweenInstructions()
       != pdg2->getNumberOfDependencesBetweenInstructions()) {
     errs() << errorPrefix << "Number of PDG edges are not the same\n";
@@ -129,15 +196,92 @@ bool PDGGenerator::compareEdges(PDG *pdg1, PDG *pdg2) {
            << pdg1->getNumberOfDependencesBetweenInstructions() << "\n";
     errs() << errorPrefix << "  "
            << pdg2->getNumberOfDependencesBetweenInstructions() << "\n";
-    this->compareEdges(pdg1, pdg2, printErrorPDG1);
-    this->compareEdges(pdg2, pdg1, printErrorPDG2);
-    return false;
+    match = false;
+  }
+
+  /*
+   * Group the dependences of both PDGs by the function they belong to.
+   * Dependences that do not involve any instruction or argument are grouped
+   * together under nullptr.
+   */
+  auto dependences1 = this->groupDependencesByFunction(pdg1);
+  auto dependences2 = this->groupDependencesByFunction(pdg2);
+  std::vector<Function *> functions{ nullptr };
+  for (auto &F : *this->M) {
+    functions.push_back(&F);
   }
+  std::vector<DGEdge<Value, Value> *> noDependences;
+  auto fetchDependences =
+      [&noDependences](
+          std::unordered_map<Function *, std::vector<DGEdge<Value, Value> *>>
+              &groups,
+          Function *f) -> const std::vector<DGEdge<Value, Value> *> & {
+    auto it = groups.find(f);
+    if (it == groups.end()) {
+      return noDependences;
+    }
+    return it->second;
+  };
 
   /*
-   * Check all dependences.
+   * Compute the fingerprints of all functions in parallel.
+   * Every thread claims functions one at a time and writes only the entries
+   * of the fingerprint vectors of the functions it claimed.
    */
-  auto match = this->compareEdges(pdg1, pdg2, printErrorPDG1);
+  std::vector<uint64_t> fingerprints1(functions.size());
+  std::vector<uint64_t> fingerprints2(functions.size());
+  std::atomic<uint64_t> nextFunction{ 0 };
+  auto fingerprint = [&]() {
+    while (true) {
+      auto i = nextFunction++;
+      if (i >= functions.size()) {
+        return;
+      }
+      auto f = functions[i];
+      fingerprints1[i] =
+          this->computeFingerprint(fetchDependences(dependences1, f));
+      fingerprints2[i] =
+          this->computeFingerprint(fetchDependences(dependences2, f));
+    }
+  };
+  uint64_t threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min<uint64_t>(threads, functions.size());
+  std::vector<std::thread> workers;
+  for (uint64_t t = 1; t < threads; t++) {
+    workers.emplace_back(fingerprint);
+  }
+  fingerprint();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  /*
+   * Check in detail only the dependences of the functions whose fingerprints
+   * differ.
+   */
+  for (auto i = 0u; i < functions.size(); i++) {
+    if (fingerprints1[i] == fingerprints2[i]) {
+      continue;
+    }
+    auto f = functions[i];
+    if (verbose >= PDGVerbosity::Maximal) {
+      errs() << errorPrefix << "  Fingerprints differ for ";
+      if (f != nullptr) {
+        errs() << f->getName() << "\n";
+      } else {
+        errs() << "values outside functions\n";
+      }
+    }
+    auto &functionDependences1 = fetchDependences(dependences1, f);
+    auto &functionDependences2 = fetchDependences(dependences2, f);
+    auto pdg1IsInPdg2 =
+        this->compareEdges(functionDependences1, pdg2, printErrorPDG1);
+    auto pdg2IsInPdg1 =
+        this->compareEdges(functionDependences2, pdg1, printErrorPDG2);
+    if (!pdg1IsInPdg2 || !pdg2IsInPdg1) {
+      match = false;
+    }
+  }
 
   return match;
 }
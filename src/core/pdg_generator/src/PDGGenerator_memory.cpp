@@ -92,46 +92,64 @@ void PDGGenerator::iterateInstForStore(PDG *pdg,
     if (inst == nullptr) {
       continue;
     }
-    if (!PDGGenerator::canAccessMemory(inst)) {
-      continue;
-    }
 
     /*
-     * The instruction can access memory.
-     *
-     * Check if any of the data dependence analyses can assert the lack of
-     * dependence from @store to @I.
+     * Add the dependences from @store to @inst.
      */
-    if (!this->canThereBeAMemoryDataDependence(store, inst, F)) {
-      continue;
-    }
+    this->addEdgesFromStore(pdg, F, AA, store, inst);
+  }
 
-    /*
-     * Check stores.
-     */
-    if (auto otherStore = dyn_cast<StoreInst>(inst)) {
-      this->addEdgeFromMemoryAlias(pdg, F, AA, store, otherStore, DG_DATA_WAW);
-      continue;
-    }
+  return;
+}
 
-    /*
-     * Check loads.
-     */
-    if (auto load = dyn_cast<LoadInst>(inst)) {
-      this->addEdgeFromMemoryAlias(pdg, F, AA, store, load, DG_DATA_RAW);
-      continue;
-    }
+void PDGGenerator::addEdgesFromStore(PDG *pdg,
+                                     Function &F,
+                                     AAResults &AA,
+                                     StoreInst *store,
+                                     Instruction *inst) {
 
-    /*
-     * Check calls.
-     */
-    if (auto call = dyn_cast<CallBase>(inst)) {
-      if (!Utils::isActualCode(call)) {
-        continue;
-      }
-      this->addEdgeFromFunctionModRef(pdg, F, AA, call, store, false);
-      continue;
+  /*
+   * Check if the instruction can access memory.
+   */
+  if (!PDGGenerator::canAccessMemory(inst)) {
+    return;
+  }
+
+  /*
+   * The instruction can access memory.
+   *
+   * Check if any of the data dependence analyses can assert the lack of
+   * dependence from @store to @I.
+   */
+  if (!this->canThereBeAMemoryDataDependence(store, inst, F)) {
+    return;
+  }
+
+  /*
+   * Check stores.
+   */
+  if (auto otherStore = dyn_cast<StoreInst>(inst)) {
+    this->addEdgeFromMemoryAlias(pdg, F, AA, store, otherStore, DG_DATA_WAW);
+    return;
+  }
+
+  /*
+   * Check loads.
+   */
+  if (auto load = dyn_cast<LoadInst>(inst)) {
+    this->addEdgeFromMemoryAlias(pdg, F, AA, store, load, DG_DATA_RAW);
+    return;
+  }
+
+  /*
+   * Check calls.
+   */
+  if (auto call = dyn_cast<CallBase>(inst)) {
+    if (!Utils::isActualCode(call)) {
+      return;
     }
+    this->addEdgeFromFunctionModRef(pdg, F, AA, call, store, false);
+    return;
   }
 
   return;
@@ -152,64 +170,68 @@ void PDGGenerator::iterateInstForLoad(PDG *pdg,
     if (inst == nullptr) {
       continue;
     }
-    if (!PDGGenerator::canAccessMemory(inst)) {
-      continue;
-    }
-
-    /*
-     * The instruction can access memory.
-     *
-     * Check if any of the data dependence analyses can assert the lack of
-     * dependence from @load to @I.
-     */
-    if (!this->canThereBeAMemoryDataDependence(load, inst, F)) {
-      continue;
-    }
 
     /*
-     * Check stores.
+     * Add the dependences from @load to @inst.
      */
-    if (auto store = dyn_cast<StoreInst>(inst)) {
-      this->addEdgeFromMemoryAlias(pdg, F, AA, load, store, DG_DATA_WAR);
-      continue;
-    }
-
-    /*
-     * Check calls.
-     */
-    if (auto call = dyn_cast<CallBase>(inst)) {
-      this->addEdgeFromFunctionModRef(pdg, F, AA, call, load, false);
-      continue;
-    }
+    this->addEdgesFromLoad(pdg, F, AA, load, inst);
   }
 
   return;
 }
 
-void PDGGenerator::iterateInstForCall(PDG *pdg,
-                                      Function &F,
-                                      AAResults &AA,
-                                      DataFlowResult *dfr,
-                                      CallBase *call) {
+void PDGGenerator::addEdgesFromLoad(PDG *pdg,
+                                    Function &F,
+                                    AAResults &AA,
+                                    LoadInst *load,
+                                    Instruction *inst) {
 
   /*
-   * Check if the call instruction is not actual code.
+   * Check if the instruction can access memory.
    */
-  if (!Utils::isActualCode(call)) {
+  if (!PDGGenerator::canAccessMemory(inst)) {
     return;
   }
 
   /*
-   * Check if the call instruction is pure.
+   * The instruction can access memory.
+   *
+   * Check if any of the data dependence analyses can assert the lack of
+   * dependence from @load to @I.
    */
-  if (this->hasNoMemoryOperations(call)) {
+  if (!this->canThereBeAMemoryDataDependence(load, inst, F)) {
     return;
   }
 
   /*
-   * Check if the instruction can access memory.
+   * Check stores.
    */
-  if (!PDGGenerator::canAccessMemory(call)) {
+  if (auto store = dyn_cast<StoreInst>(inst)) {
+    this->addEdgeFromMemoryAlias(pdg, F, AA, load, store, DG_DATA_WAR);
+    return;
+  }
+
+  /*
+   * Check calls.
+   */
+  if (auto call = dyn_cast<CallBase>(inst)) {
+    this->addEdgeFromFunctionModRef(pdg, F, AA, call, load, false);
+    return;
+  }
+
+  return;
+}
+
+void PDGGenerator::iterateInstForCall(PDG *pdg,
+                                      Function &F,
+                                      AAResults &AA,
+                                      DataFlowResult *dfr,
+                                      CallBase *call) {
+
+  /*
+   * Check if the call instruction can have memory dependences.
+   */
+  if (!this->canCallHaveMemoryDependences(call)) {
     return;
   }
 
@@ -225,59 +247,104 @@ void PDGGenerator::iterateInstForCall(PDG *pdg,
     if (inst == nullptr) {
       continue;
     }
-    if (!PDGGenerator::canAccessMemory(inst)) {
-      continue;
-    }
 
     /*
-     * The instruction can access memory.
-     *
-     * Check if any of the data dependence analyses can assert the lack of
-     * dependence from @call to @I.
+     * Add the dependences from @call to @inst.
      */
-    if (!this->canThereBeAMemoryDataDependence(call, inst, F)) {
-      continue;
-    }
+    this->addEdgesFromCall(pdg, F, AA, dfr, call, inst);
+  }
 
-    /*
-     * Check stores.
-     */
-    if (auto store = dyn_cast<StoreInst>(inst)) {
-      addEdgeFromFunctionModRef(pdg, F, AA, call, store, true);
-      continue;
-    }
+  return;
+}
 
-    /*
-     * Check loads.
-     */
-    if (auto load = dyn_cast<LoadInst>(inst)) {
-      addEdgeFromFunctionModRef(pdg, F, AA, call, load, true);
-      continue;
-    }
+bool PDGGenerator::canCallHaveMemoryDependences(CallBase *call) {
+
+  /*
+   * Check if the call instruction is not actual code.
+   */
+  if (!Utils::isActualCode(call)) {
+    return false;
+  }
+
+  /*
+   * Check if the call instruction is pure.
+   */
+  if (this->hasNoMemoryOperations(call)) {
+    return false;
+  }
+
+  /*
+   * Check if the instruction can access memory.
+   */
+  if (!PDGGenerator::canAccessMemory(call)) {
+    return false;
+  }
+
+  return true;
+}
+
+void PDGGenerator::addEdgesFromCall(PDG *pdg,
+                                    Function &F,
+                                    AAResults &AA,
+                                    DataFlowResult *dfr,
+                                    CallBase *call,
+                                    Instruction *inst) {
+
+  /*
+   * Check if the instruction can access memory.
+   */
+  if (!PDGGenerator::canAccessMemory(inst)) {
+    return;
+  }
+
+  /*
+   * The instruction can access memory.
+   *
+   * Check if any of the data dependence analyses can assert the lack of
+   * dependence from @call to @I.
+   */
+  if (!this->canThereBeAMemoryDataDependence(call, inst, F)) {
+    return;
+  }
+
+  /*
+   * Check stores.
+   */
+  if (auto store = dyn_cast<StoreInst>(inst)) {
+    addEdgeFromFunctionModRef(pdg, F, AA, call, store, true);
+    return;
+  }
+
+  /*
+   * Check loads.
+   */
+  if (auto load = dyn_cast<LoadInst>(inst)) {
+    addEdgeFromFunctionModRef(pdg, F, AA, call, load, true);
+    return;
+  }
+
+  /*
+   * Check calls.
+   */
+  if (auto baseOtherCall = dyn_cast<CallBase>(inst)) {
 
     /*
-     * Check calls.
+     * Check direct calls
      */
-    if (auto baseOtherCall = dyn_cast<CallBase>(inst)) {
-
-      /*
-       * Check direct calls
-       */
-      if (auto otherCall = dyn_cast<CallInst>(baseOtherCall)) {
-        if (!Utils::isActualCode(otherCall)) {
-          continue;
-        }
+    if (auto otherCall = dyn_cast<CallInst>(baseOtherCall)) {
+      if (!Utils::isActualCode(otherCall)) {
+        return;
       }
-      bool isCallReachableFromOtherCall =
-          dfr->OUT(baseOtherCall).count(call) > 0 ? true : false;
-      this->addEdgeFromFunctionModRef(pdg,
-                                      F,
-                                      AA,
-                                      call,
-                                      baseOtherCall,
-                                      isCallReachableFromOtherCall);
-      continue;
     }
+    bool isCallReachableFromOtherCall =
+        dfr->OUT(baseOtherCall).count(call) > 0 ? true : false;
+    this->addEdgeFromFunctionModRef(pdg,
+                                    F,
+                                    AA,
+                                    call,
+                                    baseOtherCall,
+                                    isCallReachableFromOtherCall);
+    return;
   }
 
   return;
@@ -335,6 +402,15 @@ void PDGGenerator::addEdgeFromFunctionModRef(PDG *pdg,
     return;
   }
 
+  /*
+   * Check the summaries of the callees of @call.
+   */
+  auto summaryResult =
+      this->getModRefInfoFromSummaries(call, MemoryLocation::get(store));
+  if (summaryResult == ModRefInfo::NoModRef) {
+    return;
+  }
+
   /*
    * Query the LLVM alias analyses.
    */
@@ -527,6 +603,17 @@ void PDGGenerator::addEdgeFromFunctionModRef(PDG *pdg,
     return;
   }
 
+  /*
+   * Check the summaries of the callees of @call.
+   * Only writes of @call can create dependences with @load.
+   */
+  auto summaryResult =
+      this->getModRefInfoFromSummaries(call, MemoryLocation::get(load));
+  if ((summaryResult == ModRefInfo::NoModRef)
+      || (summaryResult == ModRefInfo::Ref)) {
+    return;
+  }
+
   /*
    * Query the LLVM alias analyses.
    */
@@ -681,6 +768,14 @@ void PDGGenerator::addEdgeFromFunctionModRef(
     }
   }
 
+  /*
+   * Check the summaries of the callees of the two calls.
+   */
+  if (this->getModRefInfoFromSummaries(otherCall, call)
+      == ModRefInfo::NoModRef) {
+    return;
+  }
+
   /*
    * Query the LLVM alias analyses.
    */
@@ -1230,7 +1325,7 @@ bool PDGGenerator::isSafeToQueryModRefOfSVF(CallBase *call, BitVector &bv) {
   }
 
   if (NoelleSVFIntegration::hasIndCSCallees(call)) {
-    auto callees = NoelleSVFIntegration::getIndCSCallees(call);
+    auto callees = NoelleSVFIntegration::getIndCSCallees(call, *this);
     for (auto &callee : callees) {
       if (this->isUnhandledExternalFunction(callee)
           || isInternalFunctionThatReachUnhandledExternalFunction(callee)) {
@@ -0,0 +1,382 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/PDGGenerator.hpp"
+#include "noelle/core/SCCCAG.hpp"
+#include "IntegrationWithSVF.hpp"
+
+namespace arcana::noelle {
+
+void PDGGenerator::computeFunctionSummaries(void) {
+  assert(this->M != nullptr);
+
+  /*
+   * Index the global variables of the module.
+   * These are the abstract locations of the summaries.
+   */
+  for (auto &G : this->M->globals()) {
+    auto index = this->globalIndexes.size();
+    this->globalIndexes[&G] = index;
+  }
+  auto numberOfGlobals = this->globalIndexes.size();
+
+  /*
+   * Condense the call graph into its SCCs.
+   * All functions of an SCC share the same summary.
+   */
+  auto cg = NoelleSVFIntegration::getProgramCallGraph(*this->M, *this);
+  auto scccag = new SCCCAG(cg);
+
+  /*
+   * Summarize the SCCs bottom-up (callees before callers).
+   */
+  std::unordered_map<SCCCAGNode *, uint32_t> summaryIndexes;
+  for (auto node : scccag->getNodesInBottomUpOrder()) {
+    auto functions = node->getFunctions();
+
+    /*
+     * Summarize the memory accessed by the functions of the SCC.
+     */
+    FunctionSummary summary{ BitVector(numberOfGlobals),
+                             BitVector(numberOfGlobals),
+                             false,
+                             false };
+    for (auto f : functions) {
+
+      /*
+       * Check if @f is a library function.
+       */
+      if (f->empty()) {
+        if (PDGGenerator::isTheLibraryFunctionPure(f)
+            || f->doesNotAccessMemory()) {
+          continue;
+        }
+        summary.readsUnknownMemory = true;
+        if (!f->onlyReadsMemory()) {
+          summary.writesUnknownMemory = true;
+        }
+        continue;
+      }
+
+      /*
+       * Summarize the instructions of @f.
+       * Calls are summarized by the summaries of their callees, which are
+       * merged below. This holds for the calls that have edges in the call
+       * graph: direct calls and indirect call instructions that do not invoke
+       * inline assembly and whose callees are known.
+       */
+      for (auto &inst : instructions(f)) {
+        if (!inst.mayReadOrWriteMemory()) {
+          continue;
+        }
+        if (auto load = dyn_cast<LoadInst>(&inst)) {
+          this->addToSummary(summary, load->getPointerOperand(), false);
+          continue;
+        }
+        if (auto store = dyn_cast<StoreInst>(&inst)) {
+          this->addToSummary(summary, store->getPointerOperand(), true);
+          continue;
+        }
+        if (auto rmw = dyn_cast<AtomicRMWInst>(&inst)) {
+          this->addToSummary(summary, rmw->getPointerOperand(), false);
+          this->addToSummary(summary, rmw->getPointerOperand(), true);
+          continue;
+        }
+        if (auto cmpXchg = dyn_cast<AtomicCmpXchgInst>(&inst)) {
+          this->addToSummary(summary, cmpXchg->getPointerOperand(), false);
+          this->addToSummary(summary, cmpXchg->getPointerOperand(), true);
+          continue;
+        }
+        if (auto call = dyn_cast<CallBase>(&inst)) {
+          if (call->getCalledFunction() != nullptr) {
+            continue;
+          }
+          if (true && isa<CallInst>(call) && !call->isInlineAsm()
+              && !this->isUnresolvedIndirectCall(call)) {
+            continue;
+          }
+        }
+
+        /*
+         * We don't know which memory @inst accesses.
+         */
+        if (inst.mayReadFromMemory()) {
+          summary.readsUnknownMemory = true;
+        }
+        if (inst.mayWriteToMemory()) {
+          summary.writesUnknownMemory = true;
+        }
+      }
+    }
+
+    /*
+     * Merge the summaries of the callees.
+     */
+    for (auto pair : scccag->getOutgoingEdges(node)) {
+      auto callee = pair.first;
+      auto &calleeSummary = this->summaries[summaryIndexes.at(callee)];
+      summary.globalsRead |= calleeSummary.globalsRead;
+      summary.globalsWritten |= calleeSummary.globalsWritten;
+      summary.readsUnknownMemory |= calleeSummary.readsUnknownMemory;
+      summary.writesUnknownMemory |= calleeSummary.writesUnknownMemory;
+    }
+
+    /*
+     * Store the summary.
+     */
+    auto summaryIndex = this->summaries.size();
+    summaryIndexes[node] = summaryIndex;
+    for (auto f : functions) {
+      this->summaryOfFunction[f] = summaryIndex;
+    }
+    this->summaries.push_back(std::move(summary));
+  }
+
+  /*
+   * Free the memory.
+   */
+  delete scccag;
+  delete cg;
+
+  this->summariesComputed = true;
+
+  return;
+}
+
+void PDGGenerator::invalidateFunctionSummaries(void) {
+  this->globalIndexes.clear();
+  this->summaryOfFunction.clear();
+  this->summaries.clear();
+  this->summariesComputed = false;
+
+  return;
+}
+
+void PDGGenerator::addToSummary(FunctionSummary &summary,
+                                Value *pointer,
+                                bool isWrite) {
+
+  /*
+   * Fetch the object @pointer points into.
+   */
+  auto object = pointer->stripPointerCasts();
+  while (auto gep = dyn_cast<GEPOperator>(object)) {
+    object = gep->getPointerOperand()->stripPointerCasts();
+  }
+
+  /*
+   * The stack frame of the function cannot be accessed by its callers.
+   */
+  if (isa<AllocaInst>(object)) {
+    return;
+  }
+
+  /*
+   * Check if @pointer points to a global variable.
+   */
+  if (auto global = dyn_cast<GlobalVariable>(object)) {
+    auto index = this->globalIndexes.at(global);
+    if (isWrite) {
+      summary.globalsWritten.set(index);
+    } else if (!global->isConstant()) {
+      summary.globalsRead.set(index);
+    }
+    return;
+  }
+
+  /*
+   * @pointer can point anywhere.
+   */
+  if (isWrite) {
+    summary.writesUnknownMemory = true;
+  } else {
+    summary.readsUnknownMemory = true;
+  }
+
+  return;
+}
+
+PDGGenerator::FunctionSummary PDGGenerator::getSummaryOfCall(CallBase *call) {
+  if (!this->summariesComputed) {
+    this->computeFunctionSummaries();
+  }
+  auto numberOfGlobals = this->globalIndexes.size();
+  FunctionSummary summary{ BitVector(numberOfGlobals),
+                           BitVector(numberOfGlobals),
+                           false,
+                           false };
+
+  /*
+   * Check if the call site states that it doesn't access memory.
+   */
+  if (call->doesNotAccessMemory()) {
+    return summary;
+  }
+
+  /*
+   * Fetch the possible callees.
+   */
+  std::set<const Function *> callees;
+  if (!call->isInlineAsm()) {
+    callees = NoelleSVFIntegration::getIndCSCallees(call, *this);
+  }
+
+  /*
+   * Merge the summaries of the callees.
+   * Callees without a summary (e.g., functions created after the summaries
+   * have been computed) can access any memory.
+   */
+  if (callees.empty()) {
+    summary.readsUnknownMemory = true;
+    summary.writesUnknownMemory = true;
+  }
+  for (auto callee : callees) {
+    auto it = this->summaryOfFunction.find(callee);
+    if (it == this->summaryOfFunction.end()) {
+      summary.readsUnknownMemory = true;
+      summary.writesUnknownMemory = true;
+      break;
+    }
+    auto &calleeSummary = this->summaries[it->second];
+    summary.globalsRead |= calleeSummary.globalsRead;
+    summary.globalsWritten |= calleeSummary.globalsWritten;
+    summary.readsUnknownMemory |= calleeSummary.readsUnknownMemory;
+    summary.writesUnknownMemory |= calleeSummary.writesUnknownMemory;
+  }
+
+  /*
+   * Check if the call site states that it only reads memory.
+   */
+  if (call->onlyReadsMemory()) {
+    summary.globalsWritten.reset();
+    summary.writesUnknownMemory = false;
+  }
+
+  return summary;
+}
+
+ModRefInfo PDGGenerator::getModRefInfoFromSummaries(
+    CallBase *call,
+    const MemoryLocation &loc) {
+  auto summary = this->getSummaryOfCall(call);
+
+  /*
+   * Fetch the object @loc points into.
+   */
+  auto object = loc.Ptr->stripPointerCasts();
+  while (auto gep = dyn_cast<GEPOperator>(object)) {
+    object = gep->getPointerOperand()->stripPointerCasts();
+  }
+
+  /*
+   * Check whether @call might read or write @loc.
+   *
+   * Global variables are accessed either by name, which the summaries
+   * track, or through pointers, which make the summaries unknown.
+   * Stack objects of the caller can only be accessed through pointers.
+   */
+  auto mightRead = summary.readsUnknownMemory;
+  auto mightWrite = summary.writesUnknownMemory;
+  if (auto global = dyn_cast<GlobalVariable>(object)) {
+    auto index = this->globalIndexes.find(global);
+    if (index == this->globalIndexes.end()) {
+      return ModRefInfo::ModRef;
+    }
+    mightRead |= summary.globalsRead.test(index->second);
+    mightWrite |= summary.globalsWritten.test(index->second);
+
+  } else if (!isa<AllocaInst>(object)) {
+    mightRead |= summary.globalsRead.any();
+    mightWrite |= summary.globalsWritten.any();
+  }
+
+  /*
+   * Compute the answer.
+   */
+  if (mightRead && mightWrite) {
+    return ModRefInfo::ModRef;
+  }
+  if (mightRead) {
+    return ModRefInfo::Ref;
+  }
+  if (mightWrite) {
+    return ModRefInfo::Mod;
+  }
+
+  return ModRefInfo::NoModRef;
+}
+
+ModRefInfo PDGGenerator::getModRefInfoFromSummaries(CallBase *call,
+                                                    CallBase *otherCall) {
+  auto summary = this->getSummaryOfCall(call);
+  auto otherSummary = this->getSummaryOfCall(otherCall);
+
+  /*
+   * Check if two sets of locations might overlap.
+   */
+  auto overlap = [](bool unknown,
+                    BitVector const &globals,
+                    bool otherUnknown,
+                    BitVector const &otherGlobals) -> bool {
+    if (unknown && (otherUnknown || otherGlobals.any())) {
+      return true;
+    }
+    if (otherUnknown && globals.any()) {
+      return true;
+    }
+    return globals.anyCommon(otherGlobals);
+  };
+
+  /*
+   * Check whether @call might read or write the memory accessed by
+   * @otherCall.
+   */
+  auto otherAccessesUnknownMemory = otherSummary.readsUnknownMemory
+                                    || otherSummary.writesUnknownMemory;
+  auto otherAccessedGlobals = otherSummary.globalsRead;
+  otherAccessedGlobals |= otherSummary.globalsWritten;
+  auto mightRead = overlap(summary.readsUnknownMemory,
+                           summary.globalsRead,
+                           otherSummary.writesUnknownMemory,
+                           otherSummary.globalsWritten);
+  auto mightWrite = overlap(summary.writesUnknownMemory,
+                            summary.globalsWritten,
+                            otherAccessesUnknownMemory,
+                            otherAccessedGlobals);
+
+  /*
+   * Compute the answer.
+   */
+  if (mightRead && mightWrite) {
+    return ModRefInfo::ModRef;
+  }
+  if (mightRead) {
+    return ModRefInfo::Ref;
+  }
+  if (mightWrite) {
+    return ModRefInfo::Mod;
+  }
+
+  return ModRefInfo::NoModRef;
+}
+
+} // namespace arcana::noelle
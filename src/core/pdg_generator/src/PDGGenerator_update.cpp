@@ -0,0 +1,448 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/PDGGenerator.hpp"
+
+namespace arcana::noelle {
+
+void PDGGenerator::recomputeDependencesOfFunction(
+    Function &F,
+    std::vector<Value *> const &previousValues) {
+  assert(!F.empty());
+
+  /*
+   * The code of @F changed, so the function summaries might be stale.
+   */
+  this->invalidateFunctionSummaries();
+
+  /*
+   * Check if the PDG has been computed.
+   * If it hasn't, the dependences of @F will be computed from its current code
+   * when the PDG is requested.
+   */
+  auto pdg = this->programDependenceGraph;
+  if (pdg == nullptr) {
+    return;
+  }
+  if (verbose >= PDGVerbosity::Maximal) {
+    errs() << "PDGGenerator: Recompute the dependences of " << F.getName()
+           << "\n";
+  }
+
+  /*
+   * Drop the nodes of @F as they were before its code changed.
+   * Dropping a node drops its dependences as well.
+   * The current instructions of @F might have nodes too if the PDG has been
+   * updated (see updateDependencesOfFunction) since @previousValues have been
+   * fetched, so their nodes are dropped as well.
+   *
+   * Some of these values might have been erased, so they are only used as keys
+   * of the PDG and never dereferenced.
+   * Dependences never cross functions, so the rest of the PDG is unaffected.
+   */
+  auto entryNode = pdg->getEntryNode();
+  auto entryNodeDropped = false;
+  auto dropNode = [pdg, entryNode, &entryNodeDropped](Value *value) {
+    if (!pdg->isInGraph(value)) {
+      return;
+    }
+    auto node = pdg->fetchNode(value);
+    if (node == entryNode) {
+      entryNodeDropped = true;
+    }
+    pdg->removeNode(node);
+  };
+  for (auto value : previousValues) {
+    dropNode(value);
+  }
+  for (auto &arg : F.args()) {
+    dropNode(&arg);
+  }
+  for (auto &inst : instructions(F)) {
+    dropNode(&inst);
+  }
+
+  /*
+   * Add the current arguments and instructions of @F.
+   */
+  std::vector<Instruction *> insts;
+  for (auto &arg : F.args()) {
+    assert(!pdg->isInGraph(&arg));
+    pdg->addNode(&arg, true);
+  }
+  for (auto &inst : instructions(F)) {
+    assert(!pdg->isInGraph(&inst));
+    pdg->addNode(&inst, true);
+    insts.push_back(&inst);
+  }
+  if (entryNodeDropped) {
+    auto entryInst = &*F.getEntryBlock().begin();
+    pdg->setEntryNode(pdg->fetchNode(entryInst));
+  }
+
+  /*
+   * Compute the dependences of @F the same way constructPDGFromAnalysis does
+   * for the whole program.
+   */
+  this->constructEdgesFromUseDefsForFunction(pdg, F);
+  this->constructEdgesFromAliasesForFunction(pdg, F);
+  this->constructEdgesFromControlForFunction(pdg, F);
+  this->trimDependencesOf(pdg, F, insts);
+
+  /*
+   * The subgraphs of @F created so far are stale.
+   * The PDG embedded in the IR (if any) no longer matches the code.
+   */
+  pdg->incrementVersionOf(F);
+  if (this->hasPDGAsMetadata(*this->M)) {
+    this->cleanPDGMetadata();
+  }
+
+#ifndef NDEBUG
+  this->verifyDependencesOfFunction(pdg, F);
+#endif
+
+  return;
+}
+
+void PDGGenerator::updateDependencesOfFunction(
+    Function &F,
+    std::set<Instruction *> const &instructionsRemoved,
+    std::set<Instruction *> const &instructionsAdded,
+    std::set<Instruction *> const &instructionsMoved) {
+  assert(!F.empty());
+
+  /*
+   * The code of @F changed, so the function summaries might be stale.
+   */
+  this->invalidateFunctionSummaries();
+
+  /*
+   * Check if the PDG has been computed.
+   */
+  auto pdg = this->programDependenceGraph;
+  if (pdg == nullptr) {
+    return;
+  }
+
+  /*
+   * Fetch the instructions whose dependences must be recomputed in the order
+   * they appear in @F.
+   */
+  std::vector<Instruction *> affected;
+  std::unordered_set<Instruction *> affectedSet;
+  for (auto &inst : instructions(F)) {
+    if ((instructionsAdded.count(&inst) == 0)
+        && (instructionsMoved.count(&inst) == 0)) {
+      continue;
+    }
+    affected.push_back(&inst);
+    affectedSet.insert(&inst);
+  }
+  assert(affected.size()
+         == (instructionsAdded.size() + instructionsMoved.size()));
+
+  /*
+   * Check if the control flow of @F might have changed.
+   * Terminators define the control flow and PHIs depend on it.
+   * A removed node with outgoing control dependences was a terminator.
+   *
+   * In this case, the reachability among the other instructions of @F might
+   * have changed as well, so all dependences of @F are recomputed.
+   */
+  auto controlFlowChanged = false;
+  for (auto inst : affected) {
+    if (inst->isTerminator() || isa<PHINode>(inst)) {
+      controlFlowChanged = true;
+      break;
+    }
+  }
+  for (auto inst : instructionsRemoved) {
+    if (controlFlowChanged || !pdg->isInGraph(inst)) {
+      continue;
+    }
+    auto node = pdg->fetchNode(inst);
+    for (auto edge : node->getOutgoingEdges()) {
+      if (isa<ControlDependence<Value, Value>>(edge)) {
+        controlFlowChanged = true;
+        break;
+      }
+    }
+  }
+  if (controlFlowChanged) {
+    std::vector<Value *> previousValues(instructionsRemoved.begin(),
+                                        instructionsRemoved.end());
+    this->recomputeDependencesOfFunction(F, previousValues);
+    return;
+  }
+  if (verbose >= PDGVerbosity::Maximal) {
+    errs() << "PDGGenerator: Update the dependences of " << affected.size()
+           << " instructions of " << F.getName() << "\n";
+  }
+
+  /*
+   * Drop the removed instructions.
+   * The control flow did not change, so none of them is the entry node.
+   */
+  for (auto inst : instructionsRemoved) {
+    if (!pdg->isInGraph(inst)) {
+      continue;
+    }
+    auto node = pdg->fetchNode(inst);
+    assert(node != pdg->getEntryNode());
+    pdg->removeNode(node);
+  }
+
+  /*
+   * Drop the dependences that lead to the moved instructions and their memory
+   * dependences.
+   * Their users did not change, so the variable dependences to them are still
+   * valid.
+   * Only terminators are sources of control dependences.
+   */
+  for (auto inst : instructionsMoved) {
+    auto node = pdg->fetchNode(inst);
+    assert(node != nullptr);
+    std::unordered_set<DGEdge<Value, Value> *> edgesToRemove;
+    for (auto edge : node->getIncomingEdges()) {
+      edgesToRemove.insert(edge);
+    }
+    for (auto edge : node->getOutgoingEdges()) {
+      if (isa<MemoryDependence<Value, Value>>(edge)) {
+        edgesToRemove.insert(edge);
+      }
+    }
+    for (auto edge : edgesToRemove) {
+      pdg->removeEdge(edge);
+    }
+  }
+
+  /*
+   * Add the new instructions.
+   */
+  for (auto inst : instructionsAdded) {
+    assert(!pdg->isInGraph(inst));
+    pdg->addNode(inst, true);
+  }
+
+  /*
+   * Add the variable dependences.
+   * Dependences between two affected instructions are added once, as
+   * dependences to their destination.
+   */
+  for (auto inst : affected) {
+    for (auto &op : inst->operands()) {
+      auto def = op.get();
+      if (!isa<Instruction>(def) && !isa<Argument>(def)) {
+        continue;
+      }
+      pdg->addVariableDataDependenceEdge(def, inst, DG_DATA_RAW);
+    }
+    if (instructionsAdded.count(inst) == 0) {
+      continue;
+    }
+    for (auto &U : inst->uses()) {
+      auto user = dyn_cast<Instruction>(U.getUser());
+      if ((user == nullptr) || (affectedSet.count(user) > 0)) {
+        continue;
+      }
+      pdg->addVariableDataDependenceEdge(inst, user, DG_DATA_RAW);
+    }
+  }
+
+  /*
+   * Add the control dependences.
+   * The control flow did not change and the affected instructions are neither
+   * terminators nor PHIs, so they depend on the same branches the terminator
+   * of their basic block depends on.
+   */
+  for (auto inst : affected) {
+    auto terminator = inst->getParent()->getTerminator();
+    auto terminatorNode = pdg->fetchNode(terminator);
+    std::vector<Value *> controlProducers;
+    for (auto edge : terminatorNode->getIncomingEdges()) {
+      if (isa<ControlDependence<Value, Value>>(edge)) {
+        controlProducers.push_back(edge->getSrc());
+      }
+    }
+    for (auto producer : controlProducers) {
+      pdg->addControlDependenceEdge(producer, inst);
+    }
+  }
+
+  /*
+   * Add the memory dependences.
+   * The dependences from an affected instruction are computed as for the
+   * whole function.
+   * The dependences to an affected instruction from an unaffected one are
+   * computed pair by pair.
+   * Dependences between unaffected instructions did not change because the
+   * reachability among them did not.
+   */
+  auto &AA = getAnalysis<AAResultsWrapperPass>(F).getAAResults();
+  auto onlyMemoryInstructionFilter = [](Instruction *i) -> bool {
+    return isa<LoadInst>(i) || isa<StoreInst>(i) || isa<CallBase>(i);
+  };
+  auto dfr =
+      this->disableRA
+          ? this->dfa.getFullSets(&F)
+          : this->dfa.runReachableAnalysis(&F, onlyMemoryInstructionFilter);
+  for (auto inst : affected) {
+    if (!PDGGenerator::canAccessMemory(inst)) {
+      continue;
+    }
+    if (auto store = dyn_cast<StoreInst>(inst)) {
+      this->iterateInstForStore(pdg, F, AA, dfr, store);
+    } else if (auto load = dyn_cast<LoadInst>(inst)) {
+      this->iterateInstForLoad(pdg, F, AA, dfr, load);
+    } else if (auto call = dyn_cast<CallBase>(inst)) {
+      this->iterateInstForCall(pdg, F, AA, dfr, call);
+    }
+  }
+  for (auto &other : instructions(F)) {
+    if ((affectedSet.count(&other) > 0)
+        || !PDGGenerator::canAccessMemory(&other)) {
+      continue;
+    }
+    auto &reachableFromOther = dfr->OUT(&other);
+    auto call = dyn_cast<CallBase>(&other);
+    if ((call != nullptr) && !this->canCallHaveMemoryDependences(call)) {
+      continue;
+    }
+    for (auto inst : affected) {
+      if (reachableFromOther.count(inst) == 0) {
+        continue;
+      }
+      if (auto store = dyn_cast<StoreInst>(&other)) {
+        this->addEdgesFromStore(pdg, F, AA, store, inst);
+      } else if (auto load = dyn_cast<LoadInst>(&other)) {
+        this->addEdgesFromLoad(pdg, F, AA, load, inst);
+      } else if (call != nullptr) {
+        this->addEdgesFromCall(pdg, F, AA, dfr, call, inst);
+      }
+    }
+  }
+  delete dfr;
+
+  /*
+   * Trim the new dependences.
+   */
+  this->trimDependencesOf(pdg, F, affected);
+
+  /*
+   * The subgraphs of @F created so far are stale.
+   * The PDG embedded in the IR (if any) no longer matches the code.
+   */
+  pdg->incrementVersionOf(F);
+  if (this->hasPDGAsMetadata(*this->M)) {
+    this->cleanPDGMetadata();
+  }
+
+#ifndef NDEBUG
+  this->verifyDependencesOfFunction(pdg, F);
+#endif
+
+  return;
+}
+
+void PDGGenerator::trimDependencesOf(PDG *pdg,
+                                     Function &F,
+                                     std::vector<Instruction *> const &insts) {
+
+  /*
+   * Check if the dependences should be trimmed.
+   */
+  this->allocAA = &getAnalysis<AllocAA>();
+  if (this->disableAllocAA) {
+    return;
+  }
+
+  /*
+   * The points-to summary of @F describes its old code.
+   * The summaries of the other functions are still valid.
+   */
+  this->mpa.invalidate(&F);
+
+  /*
+   * Collect the dependences of @insts that can be safely removed.
+   */
+  std::unordered_set<DGEdge<Value, Value> *> removeEdges;
+  for (auto inst : insts) {
+    auto node = pdg->fetchNode(inst);
+    for (auto edge : node->getAllEdges()) {
+      if (removeEdges.count(edge) > 0) {
+        continue;
+      }
+      if (this->isEdgeNotUsedByParSchemes(pdg, edge)) {
+        removeEdges.insert(edge);
+      }
+    }
+  }
+
+  /*
+   * Remove the tagged edges.
+   */
+  pdg->removeEdges(removeEdges);
+
+  return;
+}
+
+void PDGGenerator::verifyDependencesOfFunction(PDG *pdg, Function &F) {
+
+  /*
+   * Fetch the current arguments and instructions of @F.
+   */
+  std::unordered_set<Value *> values;
+  for (auto &arg : F.args()) {
+    values.insert(&arg);
+  }
+  for (auto &inst : instructions(F)) {
+    values.insert(&inst);
+  }
+
+  /*
+   * Every instruction must have a node, and every dependence must connect
+   * values that still exist in @F.
+   * A dependence with an endpoint outside @F is stale: it refers to an
+   * instruction that has been erased without being reported.
+   * Such an endpoint might be dangling, so it is not printed.
+   */
+  for (auto value : values) {
+    if (!pdg->isInGraph(value)) {
+      errs() << "PDGGenerator: Error = an instruction of " << F.getName()
+             << " has not been reported as added: " << *value << "\n";
+      abort();
+    }
+    auto node = pdg->fetchNode(value);
+    for (auto edge : node->getAllEdges()) {
+      if ((values.count(edge->getSrc()) == 0)
+          || (values.count(edge->getDst()) == 0)) {
+        errs() << "PDGGenerator: Error = stale dependence in " << F.getName()
+               << " that involves " << *value << "\n";
+        abort();
+      }
+    }
+  }
+
+  return;
+}
+
+} // namespace arcana::noelle
@@ -121,6 +121,11 @@ bool PDGGenerator::runOnModule(Module &M) {
    */
   this->M = &M;
 
+  /*
+   * Index the functions that might be invoked indirectly.
+   */
+  this->indexFunctionsThatMightEscape(M);
+
   /*
    * Initialize SVF.
    */
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_CORE_PERFECT_LOOP_NEST_PERFECTLOOPNEST_H_
+#define NOELLE_SRC_CORE_PERFECT_LOOP_NEST_PERFECTLOOPNEST_H_
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopContent.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Legality checks shared by the transformations that reorder the iterations
+ * of perfect loop nests of depth two (e.g., tiling, interchange).
+ */
+class PerfectLoopNest {
+public:
+  /*
+   * Return true if @loop and its only sub-loop form a perfect nest whose
+   * iterations can be reordered.
+   * This is the case if
+   * - the sub-loop is the innermost one and it runs in every iteration of
+   *   @loop,
+   * - both loops have a pre-header, a single latch, and a single exit edge,
+   * - the code of @loop outside the sub-loop has no side effects,
+   * - no value computed by the nest is used outside it,
+   * - the headers carry only affine variables whose steps are invariant in
+   *   the nest,
+   * - the number of iterations of the sub-loop is invariant in the nest, and
+   * - there is no loop-carried memory dependence in the nest.
+   */
+  static bool canReorderIterations(LoopContent &loop,
+                                   LoopInfo &LI,
+                                   DominatorTree &DT,
+                                   ScalarEvolution &SE);
+
+  /*
+   * Return the only sub-loop of @loop, or nullptr if @loop does not have
+   * exactly one.
+   */
+  static LoopStructure *getInnerLoop(LoopContent &loop);
+
+private:
+  static bool hasOnlyAffineVariablesInHeader(LoopStructure *loop,
+                                             Loop *llvmLoop,
+                                             Loop *outermostLoop,
+                                             ScalarEvolution &SE);
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_CORE_PERFECT_LOOP_NEST_PERFECTLOOPNEST_H_
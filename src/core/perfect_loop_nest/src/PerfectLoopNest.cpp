@@ -0,0 +1,187 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/PerfectLoopNest.hpp"
+
+namespace arcana::noelle {
+
+LoopStructure *PerfectLoopNest::getInnerLoop(LoopContent &loop) {
+  auto loopNode = loop.getLoopHierarchyStructures();
+  auto children = loopNode->getChildren();
+  if (children.size() != 1) {
+    return nullptr;
+  }
+  auto innerNode = *children.begin();
+
+  return innerNode->getLoop();
+}
+
+bool PerfectLoopNest::canReorderIterations(LoopContent &loop,
+                                           LoopInfo &LI,
+                                           DominatorTree &DT,
+                                           ScalarEvolution &SE) {
+
+  /*
+   * Check the nest: the loop must have a single sub-loop, which must be the
+   * innermost one.
+   */
+  auto loopNode = loop.getLoopHierarchyStructures();
+  auto children = loopNode->getChildren();
+  if (children.size() != 1) {
+    return false;
+  }
+  auto innerNode = *children.begin();
+  if (innerNode->getNumberOfSubLoops() > 0) {
+    return false;
+  }
+  auto outerLS = loop.getLoopStructure();
+  auto innerLS = innerNode->getLoop();
+  auto outerLoop = LI.getLoopFor(outerLS->getHeader());
+  auto innerLoop = LI.getLoopFor(innerLS->getHeader());
+  if ((outerLoop == nullptr) || (innerLoop == nullptr)
+      || (innerLoop->getParentLoop() != outerLoop)) {
+    return false;
+  }
+
+  /*
+   * Check the shape of the two loops.
+   */
+  for (auto ls : { outerLS, innerLS }) {
+    if (ls->getPreHeader() == nullptr) {
+      return false;
+    }
+    if (ls->getLatches().size() != 1) {
+      return false;
+    }
+    if (ls->getLoopExitEdges().size() != 1) {
+      return false;
+    }
+  }
+
+  /*
+   * The inner loop must run in every iteration of the outer loop.
+   */
+  auto outerLatch = *outerLS->getLatches().begin();
+  if (!DT.dominates(innerLS->getPreHeader(), outerLatch)) {
+    return false;
+  }
+
+  /*
+   * Check that the nest is perfect.
+   * The code of the outer loop outside the inner one must not have side
+   * effects, as the number of times it runs changes.
+   */
+  for (auto inst : outerLS->getInstructions()) {
+    if (innerLS->isIncluded(inst)) {
+      continue;
+    }
+    if (inst->mayReadOrWriteMemory() || inst->mayHaveSideEffects()) {
+      return false;
+    }
+  }
+
+  /*
+   * The iterations of the two loops run in a different order.
+   * Hence, the values computed by the two loops must not be used outside
+   * them.
+   */
+  for (auto ls : { outerLS, innerLS }) {
+    for (auto inst : ls->getInstructions()) {
+      for (auto user : inst->users()) {
+        auto userInst = dyn_cast<Instruction>(user);
+        if ((userInst == nullptr) || !ls->isIncluded(userInst)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  /*
+   * The two loops can only carry affine variables (e.g., induction variables)
+   * between iterations.
+   * These are the only ones that can be recomputed for any iteration.
+   */
+  if (!hasOnlyAffineVariablesInHeader(outerLS, outerLoop, outerLoop, SE)
+      || !hasOnlyAffineVariablesInHeader(innerLS, innerLoop, outerLoop, SE)) {
+    return false;
+  }
+
+  /*
+   * The number of iterations of the inner loop must be the same for all
+   * iterations of the outer loop.
+   */
+  auto backedgeTakenCount = SE.getBackedgeTakenCount(innerLoop);
+  if (isa<SCEVCouldNotCompute>(backedgeTakenCount)
+      || !SE.isLoopInvariant(backedgeTakenCount, outerLoop)) {
+    return false;
+  }
+
+  /*
+   * Check the dependences.
+   * The loop DG does not describe the direction of dependences.
+   * So, the iterations can be reordered only if there is no loop-carried
+   * memory dependence in the nest.
+   */
+  auto loopDG = loop.getLoopDG();
+  for (auto edge : loopDG->getEdges()) {
+    if (!isa<MemoryDependence<Value, Value>>(edge)) {
+      continue;
+    }
+    if (!edge->isLoopCarriedDependence()) {
+      continue;
+    }
+    auto src = dyn_cast<Instruction>(edge->getSrc());
+    auto dst = dyn_cast<Instruction>(edge->getDst());
+    if ((src == nullptr) || (dst == nullptr)) {
+      continue;
+    }
+    if (outerLS->isIncluded(src) && outerLS->isIncluded(dst)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool PerfectLoopNest::hasOnlyAffineVariablesInHeader(LoopStructure *loop,
+                                                     Loop *llvmLoop,
+                                                     Loop *outermostLoop,
+                                                     ScalarEvolution &SE) {
+  for (auto &phi : loop->getHeader()->phis()) {
+    auto phiSCEV = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(&phi));
+    if ((phiSCEV == nullptr) || (phiSCEV->getLoop() != llvmLoop)
+        || !phiSCEV->isAffine()) {
+      return false;
+    }
+
+    /*
+     * The step must be computable before the nest starts.
+     */
+    auto step = phiSCEV->getStepRecurrence(SE);
+    if (!SE.isLoopInvariant(step, outermostLoop)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace arcana::noelle
@@ -152,6 +152,15 @@ public:
    */
   bool shrinkLoopPrologue(void);
 
+  /*
+   * Shrink the loop prologue as above, and add the instructions removed,
+   * added, and moved to the related sets, which the caller must use to update
+   * the dependences of the function.
+   */
+  bool shrinkLoopPrologue(std::set<Instruction *> &InstructionsRemoved,
+                          std::set<Instruction *> &InstructionsAdded,
+                          std::set<Instruction *> &InstructionsMoved);
+
   /*
    * Debugging
    */
@@ -225,6 +234,14 @@ private:
   bool SafeToDump = true;
   std::set<BasicBlock *> Prologue;
   std::set<BasicBlock *> Body;
+
+  /*
+   * Transformation state --- instructions changed by the last
+   * transformation
+   */
+  std::set<Instruction *> InstructionsRemoved;
+  std::set<Instruction *> InstructionsAdded;
+  std::set<Instruction *> InstructionsMoved;
 };
 
 } // namespace arcana::noelle
@@ -622,10 +622,48 @@ bool LoopScheduler::canQuicklyHandleLoop(void) const {
  * PUBLIC --- Transformation Methods
  * ------------------------------------------------------------------
  */
+bool LoopScheduler::shrinkLoopPrologue(
+    std::set<Instruction *> &InstructionsRemoved,
+    std::set<Instruction *> &InstructionsAdded,
+    std::set<Instruction *> &InstructionsMoved) {
+
+  /*
+   * Shrink the prologue --- the transformation methods record
+   * the instructions they change
+   */
+  auto Modified = this->shrinkLoopPrologue();
+
+  /*
+   * Report the changes --- an instruction moved and then removed
+   * (e.g., a folded PHINode) is only removed, and a clone is only
+   * added
+   */
+  InstructionsRemoved.insert(this->InstructionsRemoved.begin(),
+                             this->InstructionsRemoved.end());
+  InstructionsAdded.insert(this->InstructionsAdded.begin(),
+                           this->InstructionsAdded.end());
+  for (auto Moved : this->InstructionsMoved) {
+    if (false || this->InstructionsRemoved.count(Moved) > 0
+        || this->InstructionsAdded.count(Moved) > 0) {
+      continue;
+    }
+    InstructionsMoved.insert(Moved);
+  }
+
+  return Modified;
+}
+
 bool LoopScheduler::shrinkLoopPrologue(void) {
 
   bool Modified = false;
 
+  /*
+   * Forget the changes of the previous invocation
+   */
+  this->InstructionsRemoved.clear();
+  this->InstructionsAdded.clear();
+  this->InstructionsMoved.clear();
+
   /*
    * Check constraints
    */
@@ -927,7 +965,23 @@ bool LoopScheduler::mergePrologueBasicBlocks(void) {
   errs() << "LoopScheduler:       Attempting to merge prologue blocks\n";
 
   for (auto Block : Prologue) {
-    Modified |= llvm::MergeBlockIntoPredecessor(Block);
+
+    /*
+     * Merging erases the terminator of the predecessor and folds
+     * the PHINodes of @Block --- record them before they are gone
+     */
+    std::set<Instruction *> ToErase;
+    if (auto Pred = Block->getSinglePredecessor()) {
+      ToErase.insert(Pred->getTerminator());
+    }
+    for (auto &PHI : Block->phis()) {
+      ToErase.insert(&PHI);
+    }
+
+    if (llvm::MergeBlockIntoPredecessor(Block)) {
+      this->InstructionsRemoved.insert(ToErase.begin(), ToErase.end());
+      Modified |= true;
+    }
   }
 
   return Modified;
@@ -1121,6 +1175,7 @@ bool LoopScheduler::moveInstIntoSuccessor(Instruction *I,
    */
   Instruction *InsertionPoint = Successor->getFirstNonPHI();
   I->moveBefore(InsertionPoint);
+  this->InstructionsMoved.insert(I);
 
   /*
    * Resolve any successor PHINodes
@@ -1158,6 +1213,7 @@ bool LoopScheduler::cloneInstIntoSuccessor(Instruction *I,
    */
   OriginalsToClones[I] = Clone;
   Clones.insert(Clone);
+  this->InstructionsAdded.insert(Clone);
 
   /*
    * Return success
@@ -1263,9 +1319,15 @@ void LoopScheduler::resolveSuccessorPHIs(Instruction *const Moved,
   for (auto PHI : PHIsToResolve) {
 
     /*
-     * Replace all uses
+     * Replace all uses --- the users now depend on @Replacement
      */
+    for (auto User : PHI->users()) {
+      if (auto UserInst = dyn_cast<Instruction>(User)) {
+        this->InstructionsMoved.insert(UserInst);
+      }
+    }
     PHI->replaceAllUsesWith(Replacement);
+    this->InstructionsRemoved.insert(PHI);
 
     /*
      * Fold the PHINode
@@ -23,15 +23,16 @@
 #define NOELLE_SRC_CORE_TASK_H_
 
 #include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/FunctionsManager.hpp"
 
 namespace arcana::noelle {
 
 class Task {
 public:
-  Task(FunctionType *taskSignature, Module &M);
+  Task(FunctionType *taskSignature, FunctionsManager &fm);
 
   Task(FunctionType *taskSignature,
-       Module &M,
+       FunctionsManager &fm,
        const std::string &taskFunctionNameToUse);
 
   /*
@@ -198,7 +199,7 @@ protected:
   LLVMContext &getLLVMContext(void) const;
 
   void createTask(FunctionType *taskSignature,
-                  Module &M,
+                  FunctionsManager &fm,
                   const std::string &taskFunctionNameToUse,
                   uint32_t taskID);
 
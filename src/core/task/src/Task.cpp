@@ -23,7 +23,7 @@
 
 namespace arcana::noelle {
 
-Task::Task(FunctionType *taskSignature, Module &M)
+Task::Task(FunctionType *taskSignature, FunctionsManager &fm)
   : instanceIndexV{ nullptr },
     envArg{ nullptr } {
 
@@ -36,13 +36,13 @@ Task::Task(FunctionType *taskSignature, Module &M)
   /*
    * Create the task.
    */
-  this->createTask(taskSignature, M, functionName, Task::currentID);
+  this->createTask(taskSignature, fm, functionName, Task::currentID);
 
   return;
 }
 
 Task::Task(FunctionType *taskSignature,
-           Module &M,
+           FunctionsManager &fm,
            const std::string &taskFunctionNameToUse)
   : instanceIndexV{ nullptr },
     envArg{ nullptr } {
@@ -50,13 +50,13 @@ Task::Task(FunctionType *taskSignature,
   /*
    * Create the task.
    */
-  this->createTask(taskSignature, M, taskFunctionNameToUse, Task::currentID);
+  this->createTask(taskSignature, fm, taskFunctionNameToUse, Task::currentID);
 
   return;
 }
 
 void Task::createTask(FunctionType *taskSignature,
-                      Module &M,
+                      FunctionsManager &fm,
                       const std::string &taskFunctionNameToUse,
                       uint32_t taskID) {
 
@@ -68,20 +68,14 @@ void Task::createTask(FunctionType *taskSignature,
 
   /*
    * Create the empty body of the task.
+   * The functions manager aborts if the function already exists.
    */
-  auto functionCallee =
-      M.getOrInsertFunction(taskFunctionNameToUse, taskSignature);
-  this->F = cast<Function>(functionCallee.getCallee());
-  if (!this->F->empty()) {
-    errs() << "Task: ERROR = function " << taskFunctionNameToUse
-           << " already exists in the program.\n";
-    abort();
-  }
+  this->F = fm.newFunction(taskFunctionNameToUse, *taskSignature);
 
   /*
    * Add the entry and exit basic blocks.
    */
-  auto &cxt = M.getContext();
+  auto &cxt = this->F->getContext();
   this->entryBlock = BasicBlock::Create(cxt, "", this->F);
   this->exitBlock = BasicBlock::Create(cxt, "", this->F);
 
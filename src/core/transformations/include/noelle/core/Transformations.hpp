@@ -45,6 +45,19 @@ enum Transformation {
 
 enum LoopContentOptimization { MEMORY_CLONING_ID, THREAD_SAFE_LIBRARY_ID };
 
+/*
+ * How the private copies of reducible live-out variables are combined
+ * - Serial: the main thread walks the private copies one after the other
+ * - Vectorized: the private copies of a variable are next to each other, so
+ *   the main thread loads them with a single vector load and combines them
+ *   with a vector reduction
+ * - Tree: tasks combine their private copies in a binary tree as they finish,
+ *   so the main thread only reads the copy of the first task. This requires
+ *   all tasks to run at the same time; when the runtime cannot reserve enough
+ *   cores, the main thread walks the private copies as in Serial
+ */
+enum class ReductionStrategy { Serial, Vectorized, Tree };
+
 } // namespace arcana::noelle
 
 #endif // NOELLE_SRC_CORE_TRANSFORMATIONS_H_
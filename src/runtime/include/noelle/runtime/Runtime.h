@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_RUNTIME_RUNTIME_H_
+#define NOELLE_SRC_RUNTIME_RUNTIME_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Reference parallel runtime of NOELLE.
+ *
+ * The runtime owns a persistent pool of worker threads that is created the
+ * first time one of the functions below is invoked.
+ * Every worker has its own queue of tasks; idle workers steal tasks from the
+ * queues of the others.
+ *
+ * The runtime can be configured with the following environment variables:
+ *
+ *   NOELLE_RUNTIME_CORES  Number of cores to use, including the core of the
+ *                         thread that dispatches the tasks (default: all the
+ *                         online cores).
+ *   NOELLE_RUNTIME_PIN    Set to 0 to leave the workers unpinned (default: the
+ *                         i-th worker is pinned to the (i+1)-th core).
+ */
+
+/*
+ * Body of a task.
+ * @taskID goes from 0 to @numberOfTasks - 1.
+ */
+typedef void (*NOELLE_TaskBody)(void *env,
+                                int64_t taskID,
+                                int64_t numberOfTasks);
+
+typedef struct {
+  int64_t numberOfThreadsUsed;
+} NOELLE_DispatcherInfo;
+
+/*
+ * Return the number of cores that are not executing tasks.
+ * The core of the caller is included as it executes tasks while waiting for
+ * the ones it dispatches.
+ *
+ * This is the function invoked by the code generated by
+ * Linker::linkTransformedLoopToOriginalFunction to decide whether to run the
+ * parallelized loop or the original one.
+ */
+int32_t NOELLE_getAvailableCores(void);
+
+/*
+ * Return the number of worker threads of the pool.
+ */
+int32_t NOELLE_getNumberOfWorkers(void);
+
+/*
+ * Run @numberOfTasks instances of @task in parallel and wait for all of them
+ * to complete.
+ * Every instance receives @env, its own ID, and @numberOfTasks.
+ */
+NOELLE_DispatcherInfo NOELLE_dispatchTasks(NOELLE_TaskBody task,
+                                           void *env,
+                                           int64_t numberOfTasks);
+
+/*
+ * Run @numberOfTasks instances of @task at the same time and wait for all of
+ * them to complete.
+ * The caller runs the first instance; the others run on workers that are
+ * reserved atomically for them, so instances can wait for each other.
+ *
+ * Return 0 without running any instance if there are not enough idle
+ * workers; return 1 otherwise.
+ */
+int32_t NOELLE_dispatchTasksTogether(NOELLE_TaskBody task,
+                                     void *env,
+                                     int64_t numberOfTasks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
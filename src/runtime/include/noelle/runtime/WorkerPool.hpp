@@ -0,0 +1,135 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_RUNTIME_WORKERPOOL_H_
+#define NOELLE_SRC_RUNTIME_WORKERPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "noelle/runtime/Runtime.h"
+
+namespace arcana::noelle::runtime {
+
+/*
+ * Tasks dispatched together by a single call to WorkerPool::dispatch.
+ */
+struct TaskBatch {
+  std::atomic<int64_t> pendingTasks;
+};
+
+struct TaskInstance {
+  NOELLE_TaskBody body;
+  void *env;
+  int64_t taskID;
+  int64_t numberOfTasks;
+  TaskBatch *batch;
+};
+
+/*
+ * Queue of tasks of a worker.
+ * The owner pops tasks from the back while the other threads steal tasks from
+ * the front.
+ */
+class TaskQueue {
+public:
+  void push(const TaskInstance &task);
+
+  bool pop(TaskInstance &task);
+
+  bool steal(TaskInstance &task);
+
+private:
+  std::mutex lock;
+  std::deque<TaskInstance> tasks;
+};
+
+class WorkerPool {
+public:
+  WorkerPool(uint32_t numberOfCores, bool pinWorkers);
+
+  /*
+   * Return the pool of the process, which is created the first time this
+   * function is invoked.
+   */
+  static WorkerPool &getPool(void);
+
+  uint32_t getNumberOfWorkers(void) const;
+
+  uint32_t getAvailableCores(void) const;
+
+  /*
+   * Run @numberOfTasks instances of @body and return when all of them have
+   * completed.
+   * The caller executes tasks (of any batch) while waiting.
+   */
+  void dispatch(NOELLE_TaskBody body, void *env, int64_t numberOfTasks);
+
+  /*
+   * Run @numberOfTasks instances of @body at the same time and return when all
+   * of them have completed.
+   * The caller runs the first instance and one idle worker is reserved for
+   * each of the others.
+   * Return false without running any instance if the workers cannot be
+   * reserved.
+   */
+  bool dispatchTogether(NOELLE_TaskBody body,
+                        void *env,
+                        int64_t numberOfTasks);
+
+  ~WorkerPool();
+
+private:
+  std::vector<std::thread> workers;
+  std::vector<std::unique_ptr<TaskQueue>> queues;
+  TaskQueue reservedTasks;
+  std::atomic<uint32_t> idleWorkers;
+  std::atomic<int64_t> queuedTasks;
+  std::atomic<uint64_t> nextQueue;
+  std::atomic<bool> isShuttingDown;
+  std::mutex sleepLock;
+  std::condition_variable wakeUp;
+
+  void workerLoop(uint32_t workerID);
+
+  /*
+   * Decrease the number of idle workers by @numberOfWorkers if there are
+   * enough of them.
+   */
+  bool reserveWorkers(uint32_t numberOfWorkers);
+
+  bool fetchTask(uint32_t firstQueue, TaskInstance &task);
+
+  bool fetchReservedTask(TaskInstance &task);
+
+  void execute(const TaskInstance &task);
+
+  static void pinToCore(std::thread &thread, uint32_t core);
+};
+
+} // namespace arcana::noelle::runtime
+
+#endif
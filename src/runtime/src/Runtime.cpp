@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+
+#include "noelle/runtime/Runtime.h"
+#include "noelle/runtime/WorkerPool.hpp"
+
+using namespace arcana::noelle::runtime;
+
+extern "C" {
+
+int32_t NOELLE_getAvailableCores(void) {
+  return WorkerPool::getPool().getAvailableCores();
+}
+
+int32_t NOELLE_getNumberOfWorkers(void) {
+  return WorkerPool::getPool().getNumberOfWorkers();
+}
+
+NOELLE_DispatcherInfo NOELLE_dispatchTasks(NOELLE_TaskBody task,
+                                           void *env,
+                                           int64_t numberOfTasks) {
+  auto &pool = WorkerPool::getPool();
+  pool.dispatch(task, env, numberOfTasks);
+
+  NOELLE_DispatcherInfo info;
+  info.numberOfThreadsUsed = std::min<int64_t>(numberOfTasks,
+                                               pool.getNumberOfWorkers() + 1);
+
+  return info;
+}
+
+int32_t NOELLE_dispatchTasksTogether(NOELLE_TaskBody task,
+                                     void *env,
+                                     int64_t numberOfTasks) {
+  auto &pool = WorkerPool::getPool();
+  auto dispatched = pool.dispatchTogether(task, env, numberOfTasks);
+
+  return dispatched ? 1 : 0;
+}
+}
@@ -0,0 +1,360 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <pthread.h>
+#include <sched.h>
+
+#include "noelle/runtime/WorkerPool.hpp"
+
+namespace arcana::noelle::runtime {
+
+/*
+ * ID of the worker that runs on the current thread (-1 for the threads that
+ * do not belong to the pool).
+ */
+static thread_local int64_t currentWorker = -1;
+
+/*
+ * Number of attempts to find a task before a worker goes to sleep.
+ */
+static const uint32_t spinsBeforeSleeping = 64;
+
+void TaskQueue::push(const TaskInstance &task) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->tasks.push_back(task);
+
+  return;
+}
+
+bool TaskQueue::pop(TaskInstance &task) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  if (this->tasks.empty()) {
+    return false;
+  }
+  task = this->tasks.back();
+  this->tasks.pop_back();
+
+  return true;
+}
+
+bool TaskQueue::steal(TaskInstance &task) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  if (this->tasks.empty()) {
+    return false;
+  }
+  task = this->tasks.front();
+  this->tasks.pop_front();
+
+  return true;
+}
+
+WorkerPool::WorkerPool(uint32_t numberOfCores, bool pinWorkers)
+  : idleWorkers{ 0 },
+    queuedTasks{ 0 },
+    nextQueue{ 0 },
+    isShuttingDown{ false } {
+
+  /*
+   * The core of the thread that dispatches the tasks is not given to a
+   * worker.
+   */
+  auto numberOfWorkers = std::max(numberOfCores, 1u) - 1;
+
+  /*
+   * Allocate one queue per worker.
+   * If there is no worker, the dispatcher executes all tasks from a single
+   * queue.
+   */
+  auto numberOfQueues = std::max(numberOfWorkers, 1u);
+  for (auto i = 0u; i < numberOfQueues; i++) {
+    this->queues.push_back(std::make_unique<TaskQueue>());
+  }
+
+  /*
+   * Spawn the workers.
+   */
+  this->idleWorkers = numberOfWorkers;
+  auto numberOfHardwareCores =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  for (auto i = 0u; i < numberOfWorkers; i++) {
+    this->workers.emplace_back(&WorkerPool::workerLoop, this, i);
+    if (pinWorkers) {
+      WorkerPool::pinToCore(this->workers.back(),
+                            (i + 1) % numberOfHardwareCores);
+    }
+  }
+
+  return;
+}
+
+WorkerPool &WorkerPool::getPool(void) {
+
+  /*
+   * Fetch the configuration.
+   */
+  auto numberOfCores = std::max(std::thread::hardware_concurrency(), 1u);
+  if (auto cores = std::getenv("NOELLE_RUNTIME_CORES")) {
+    numberOfCores = std::max(std::atoi(cores), 1);
+  }
+  auto pinWorkers = true;
+  if (auto pin = std::getenv("NOELLE_RUNTIME_PIN")) {
+    pinWorkers = (std::atoi(pin) != 0);
+  }
+
+  static WorkerPool pool(numberOfCores, pinWorkers);
+
+  return pool;
+}
+
+uint32_t WorkerPool::getNumberOfWorkers(void) const {
+  return this->workers.size();
+}
+
+uint32_t WorkerPool::getAvailableCores(void) const {
+  return this->idleWorkers + 1;
+}
+
+void WorkerPool::dispatch(NOELLE_TaskBody body,
+                          void *env,
+                          int64_t numberOfTasks) {
+  if (numberOfTasks <= 0) {
+    return;
+  }
+
+  /*
+   * Distribute the tasks among the queues in a round-robin fashion.
+   * Consecutive batches start from different queues so that the first tasks
+   * of each batch do not all land on the same worker.
+   */
+  TaskBatch batch;
+  batch.pendingTasks = numberOfTasks;
+  auto firstQueue = this->nextQueue++ % this->queues.size();
+  for (int64_t i = 0; i < numberOfTasks; i++) {
+    TaskInstance task{ body, env, i, numberOfTasks, &batch };
+    this->queues[(firstQueue + i) % this->queues.size()]->push(task);
+  }
+  this->queuedTasks += numberOfTasks;
+
+  /*
+   * Wake up the sleeping workers.
+   * Acquiring the lock guarantees that a worker that is about to sleep sees
+   * the new tasks.
+   */
+  {
+    std::lock_guard<std::mutex> guard(this->sleepLock);
+  }
+  this->wakeUp.notify_all();
+
+  /*
+   * Help executing tasks until all tasks of the batch have completed.
+   */
+  while (batch.pendingTasks > 0) {
+    TaskInstance task;
+    if (this->fetchTask(firstQueue, task)) {
+      this->execute(task);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  return;
+}
+
+bool WorkerPool::dispatchTogether(NOELLE_TaskBody body,
+                                  void *env,
+                                  int64_t numberOfTasks) {
+  if (numberOfTasks <= 0) {
+    return true;
+  }
+
+  /*
+   * Reserve one idle worker for every task but the first one, which is
+   * executed by the caller.
+   */
+  auto workersNeeded = numberOfTasks - 1;
+  if (workersNeeded > static_cast<int64_t>(this->workers.size())) {
+    return false;
+  }
+  if (!this->reserveWorkers(workersNeeded)) {
+    return false;
+  }
+
+  /*
+   * Hand the tasks to the reserved workers.
+   */
+  TaskBatch batch;
+  batch.pendingTasks = numberOfTasks;
+  for (int64_t i = 1; i < numberOfTasks; i++) {
+    TaskInstance task{ body, env, i, numberOfTasks, &batch };
+    this->reservedTasks.push(task);
+  }
+  this->queuedTasks += workersNeeded;
+  {
+    std::lock_guard<std::mutex> guard(this->sleepLock);
+  }
+  this->wakeUp.notify_all();
+
+  /*
+   * Execute the first task and wait for the others.
+   * The caller does not help with other tasks as those could wait for tasks
+   * that are not running.
+   */
+  TaskInstance firstTask{ body, env, 0, numberOfTasks, &batch };
+  this->execute(firstTask);
+  while (batch.pendingTasks > 0) {
+    std::this_thread::yield();
+  }
+
+  return true;
+}
+
+WorkerPool::~WorkerPool() {
+
+  /*
+   * Stop the workers.
+   */
+  {
+    std::lock_guard<std::mutex> guard(this->sleepLock);
+    this->isShuttingDown = true;
+  }
+  this->wakeUp.notify_all();
+  for (auto &worker : this->workers) {
+    worker.join();
+  }
+
+  return;
+}
+
+void WorkerPool::workerLoop(uint32_t workerID) {
+  currentWorker = workerID;
+
+  while (true) {
+
+    /*
+     * Look for a task for a while.
+     *
+     * Tasks dispatched together come first as an idle worker has already been
+     * reserved for each of them.
+     * Any other task requires the worker to stop being idle, which is not
+     * possible if all idle workers are reserved.
+     */
+    TaskInstance task;
+    auto found = false;
+    for (auto i = 0u; (i < spinsBeforeSleeping) && !found; i++) {
+      found = this->fetchReservedTask(task);
+      if ((!found) && this->reserveWorkers(1)) {
+        found = this->fetchTask(workerID, task);
+        if (!found) {
+          this->idleWorkers++;
+        }
+      }
+      if (!found) {
+        std::this_thread::yield();
+      }
+    }
+    if (found) {
+      this->execute(task);
+      this->idleWorkers++;
+      continue;
+    }
+
+    /*
+     * Sleep until new tasks are dispatched.
+     */
+    std::unique_lock<std::mutex> guard(this->sleepLock);
+    this->wakeUp.wait(guard, [this]() {
+      return (this->queuedTasks > 0) || this->isShuttingDown;
+    });
+    if (this->isShuttingDown && (this->queuedTasks <= 0)) {
+      return;
+    }
+  }
+}
+
+bool WorkerPool::reserveWorkers(uint32_t numberOfWorkers) {
+  auto idle = this->idleWorkers.load();
+  while (idle >= numberOfWorkers) {
+    if (this->idleWorkers.compare_exchange_weak(idle,
+                                                idle - numberOfWorkers)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool WorkerPool::fetchTask(uint32_t firstQueue, TaskInstance &task) {
+
+  /*
+   * Workers execute their own tasks first.
+   */
+  auto found = false;
+  if (currentWorker >= 0) {
+    found = this->queues[currentWorker]->pop(task);
+  }
+
+  /*
+   * Steal a task from the other queues.
+   */
+  for (auto i = 0u; (i < this->queues.size()) && !found; i++) {
+    auto queueID = (firstQueue + i) % this->queues.size();
+    if (static_cast<int64_t>(queueID) == currentWorker) {
+      continue;
+    }
+    found = this->queues[queueID]->steal(task);
+  }
+  if (found) {
+    this->queuedTasks--;
+  }
+
+  return found;
+}
+
+bool WorkerPool::fetchReservedTask(TaskInstance &task) {
+  auto found = this->reservedTasks.steal(task);
+  if (found) {
+    this->queuedTasks--;
+  }
+
+  return found;
+}
+
+void WorkerPool::execute(const TaskInstance &task) {
+  task.body(task.env, task.taskID, task.numberOfTasks);
+  task.batch->pendingTasks--;
+
+  return;
+}
+
+void WorkerPool::pinToCore(std::thread &thread, uint32_t core) {
+#ifdef __linux__
+  cpu_set_t cores;
+  CPU_ZERO(&cores);
+  CPU_SET(core, &cores);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cores);
+#endif
+
+  return;
+}
+
+} // namespace arcana::noelle::runtime
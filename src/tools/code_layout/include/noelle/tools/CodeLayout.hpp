@@ -0,0 +1,88 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_TOOLS_CODE_LAYOUT_CODELAYOUT_H_
+#define NOELLE_SRC_TOOLS_CODE_LAYOUT_CODELAYOUT_H_
+
+#include "noelle/core/Noelle.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Lay out the code following the profiles.
+ *
+ * The basic blocks of a function are chained along their hottest branches
+ * (Pettis-Hansen), so these branches become fall-throughs.
+ * The functions of the module are clustered along their hottest calls, and
+ * the hottest clusters are placed first.
+ */
+class CodeLayout : public ModulePass {
+public:
+  static char ID;
+
+  CodeLayout();
+
+  bool doInitialization(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool runOnModule(Module &M) override;
+
+  /*
+   * Return the layout of the basic blocks of @f.
+   * The entry of @f stays first.
+   */
+  std::vector<BasicBlock *> computeBasicBlockLayout(Hot *profiles,
+                                                    Function *f) const;
+
+  /*
+   * Return the layout of the functions with a body of @M.
+   */
+  std::vector<Function *> computeFunctionLayout(Hot *profiles,
+                                                Module &M,
+                                                CallGraph *callGraph) const;
+
+  /*
+   * Return the number of branches of @f that are taken (i.e., that do not
+   * fall through) when its basic blocks are laid out as @layout.
+   */
+  double computeTakenBranches(Hot *profiles,
+                              Function *f,
+                              std::vector<BasicBlock *> const &layout) const;
+
+private:
+  /*
+   * Branch from @source to @target taken @weight times.
+   */
+  struct Branch {
+    BasicBlock *source;
+    BasicBlock *target;
+    double weight;
+  };
+
+  const std::string prefix = "CodeLayout: ";
+
+  std::vector<Branch> getBranches(Hot *profiles, Function *f) const;
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_TOOLS_CODE_LAYOUT_CODELAYOUT_H_
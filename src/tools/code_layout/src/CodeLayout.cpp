@@ -0,0 +1,289 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/CodeLayout.hpp"
+
+namespace arcana::noelle {
+
+CodeLayout::CodeLayout() : ModulePass{ ID } {
+  return;
+}
+
+std::vector<BasicBlock *> CodeLayout::computeBasicBlockLayout(
+    Hot *profiles,
+    Function *f) const {
+
+  /*
+   * Fetch the branches from the hottest one.
+   */
+  auto branches = this->getBranches(profiles, f);
+  std::stable_sort(branches.begin(),
+                   branches.end(),
+                   [](Branch const &a, Branch const &b) -> bool {
+                     return a.weight > b.weight;
+                   });
+
+  /*
+   * Start from a chain per basic block.
+   */
+  std::vector<std::vector<BasicBlock *>> chains;
+  std::unordered_map<BasicBlock *, uint32_t> chainOf;
+  for (auto &bb : *f) {
+    chainOf[&bb] = chains.size();
+    chains.push_back({ &bb });
+  }
+
+  /*
+   * Merge the chains along the hottest branches: a branch becomes a
+   * fall-through when its source ends a chain and its target starts another
+   * one.
+   * The entry of the function must stay at the beginning of its chain.
+   */
+  auto entry = &f->getEntryBlock();
+  for (auto &branch : branches) {
+    if (branch.weight <= 0) {
+      break;
+    }
+    auto sourceChain = chainOf[branch.source];
+    auto targetChain = chainOf[branch.target];
+    if (false || (sourceChain == targetChain) || (branch.target == entry)
+        || (chains[sourceChain].back() != branch.source)
+        || (chains[targetChain].front() != branch.target)) {
+      continue;
+    }
+    for (auto bb : chains[targetChain]) {
+      chains[sourceChain].push_back(bb);
+      chainOf[bb] = sourceChain;
+    }
+    chains[targetChain].clear();
+  }
+
+  /*
+   * Order the chains: the one of the entry first, then the hot ones from the
+   * hottest, and the cold ones last in their original order.
+   */
+  std::vector<uint32_t> chainOrder;
+  for (auto i = 0u; i < chains.size(); i++) {
+    if (chains[i].empty()) {
+      continue;
+    }
+    chainOrder.push_back(i);
+  }
+  auto hotness = [profiles, entry, &chains](uint32_t chain) -> uint64_t {
+    auto head = chains[chain].front();
+    if (head == entry) {
+      return std::numeric_limits<uint64_t>::max();
+    }
+    return profiles->getInvocations(head);
+  };
+  std::stable_sort(chainOrder.begin(),
+                   chainOrder.end(),
+                   [&hotness](uint32_t a, uint32_t b) -> bool {
+                     return hotness(a) > hotness(b);
+                   });
+
+  /*
+   * Concatenate the chains.
+   */
+  std::vector<BasicBlock *> layout;
+  for (auto chain : chainOrder) {
+    layout.insert(layout.end(), chains[chain].begin(), chains[chain].end());
+  }
+
+  return layout;
+}
+
+std::vector<Function *> CodeLayout::computeFunctionLayout(
+    Hot *profiles,
+    Module &M,
+    CallGraph *callGraph) const {
+
+  /*
+   * Start from a cluster per function.
+   */
+  std::vector<std::vector<Function *>> clusters;
+  std::unordered_map<Function *, uint32_t> clusterOf;
+  std::unordered_map<Function *, uint32_t> originalIndex;
+  for (auto &F : M) {
+    if (F.empty()) {
+      continue;
+    }
+    clusterOf[&F] = clusters.size();
+    originalIndex[&F] = clusters.size();
+    clusters.push_back({ &F });
+  }
+
+  /*
+   * Weight the calls between functions by how many times they have been
+   * executed.
+   */
+  std::vector<std::tuple<Function *, Function *, uint64_t>> calls;
+  for (auto edge : callGraph->getEdges()) {
+    auto caller = edge->getCaller()->getFunction();
+    auto callee = edge->getCallee()->getFunction();
+    if (false || (caller == callee) || (clusterOf.count(caller) == 0)
+        || (clusterOf.count(callee) == 0)) {
+      continue;
+    }
+    uint64_t weight = 0;
+    for (auto subEdge : edge->getSubEdges()) {
+      auto callInst = subEdge->getCaller()->getInstruction();
+      weight += profiles->getInvocations(callInst);
+    }
+    if (weight == 0) {
+      continue;
+    }
+    calls.push_back(std::make_tuple(caller, callee, weight));
+  }
+
+  /*
+   * Sort the calls from the hottest one.
+   * The call graph does not order its edges, so ties are broken by the
+   * original order of the functions to keep the layout deterministic.
+   */
+  std::sort(calls.begin(),
+            calls.end(),
+            [&originalIndex](
+                std::tuple<Function *, Function *, uint64_t> const &a,
+                std::tuple<Function *, Function *, uint64_t> const &b) -> bool {
+              if (std::get<2>(a) != std::get<2>(b)) {
+                return std::get<2>(a) > std::get<2>(b);
+              }
+              auto callerA = originalIndex.at(std::get<0>(a));
+              auto callerB = originalIndex.at(std::get<0>(b));
+              if (callerA != callerB) {
+                return callerA < callerB;
+              }
+              return originalIndex.at(std::get<1>(a))
+                     < originalIndex.at(std::get<1>(b));
+            });
+
+  /*
+   * Merge the clusters along the hottest calls: the callee follows its
+   * caller.
+   */
+  for (auto &call : calls) {
+    auto callerCluster = clusterOf[std::get<0>(call)];
+    auto calleeCluster = clusterOf[std::get<1>(call)];
+    if (callerCluster == calleeCluster) {
+      continue;
+    }
+    for (auto f : clusters[calleeCluster]) {
+      clusters[callerCluster].push_back(f);
+      clusterOf[f] = callerCluster;
+    }
+    clusters[calleeCluster].clear();
+  }
+
+  /*
+   * Order the clusters from the hottest one.
+   * The clusters that have not been executed keep their original order.
+   */
+  std::vector<uint32_t> clusterOrder;
+  std::unordered_map<uint32_t, uint64_t> clusterHotness;
+  for (auto i = 0u; i < clusters.size(); i++) {
+    if (clusters[i].empty()) {
+      continue;
+    }
+    clusterOrder.push_back(i);
+    for (auto f : clusters[i]) {
+      clusterHotness[i] += profiles->getSelfInstructions(f);
+    }
+  }
+  std::stable_sort(clusterOrder.begin(),
+                   clusterOrder.end(),
+                   [&clusterHotness](uint32_t a, uint32_t b) -> bool {
+                     return clusterHotness[a] > clusterHotness[b];
+                   });
+
+  /*
+   * Concatenate the clusters.
+   */
+  std::vector<Function *> layout;
+  for (auto cluster : clusterOrder) {
+    layout.insert(layout.end(),
+                  clusters[cluster].begin(),
+                  clusters[cluster].end());
+  }
+
+  return layout;
+}
+
+double CodeLayout::computeTakenBranches(
+    Hot *profiles,
+    Function *f,
+    std::vector<BasicBlock *> const &layout) const {
+
+  /*
+   * Fetch the basic block that follows each basic block in @layout.
+   */
+  std::unordered_map<BasicBlock *, BasicBlock *> next;
+  for (auto i = 0u; (i + 1) < layout.size(); i++) {
+    next[layout[i]] = layout[i + 1];
+  }
+
+  /*
+   * Sum the branches that do not fall through.
+   */
+  double takenBranches = 0;
+  for (auto &branch : this->getBranches(profiles, f)) {
+    if (next[branch.source] == branch.target) {
+      continue;
+    }
+    takenBranches += branch.weight;
+  }
+
+  return takenBranches;
+}
+
+std::vector<CodeLayout::Branch> CodeLayout::getBranches(Hot *profiles,
+                                                        Function *f) const {
+  std::vector<Branch> branches;
+  for (auto &bb : *f) {
+
+    /*
+     * The profiles have branch frequencies only for executed basic blocks
+     * with successors.
+     */
+    if (false || (!profiles->hasBeenExecuted(&bb))
+        || (bb.getTerminator()->getNumSuccessors() == 0)) {
+      continue;
+    }
+    auto invocations = static_cast<double>(profiles->getInvocations(&bb));
+
+    /*
+     * Add a branch per distinct successor.
+     */
+    std::unordered_set<BasicBlock *> targets;
+    for (auto succBB : successors(&bb)) {
+      if (targets.count(succBB) > 0) {
+        continue;
+      }
+      targets.insert(succBB);
+      auto frequency = profiles->getBranchFrequency(&bb, succBB);
+      branches.push_back({ &bb, succBB, invocations * frequency });
+    }
+  }
+
+  return branches;
+}
+
+} // namespace arcana::noelle
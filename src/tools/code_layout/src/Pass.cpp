@@ -0,0 +1,163 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/CodeLayout.hpp"
+
+namespace arcana::noelle {
+
+bool CodeLayout::doInitialization(Module &M) {
+  return false;
+}
+
+void CodeLayout::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+
+  return;
+}
+
+bool CodeLayout::runOnModule(Module &M) {
+
+  /*
+   * Fetch NOELLE.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  auto verbose = noelle.getVerbosity() > Verbosity::Disabled;
+  if (verbose) {
+    errs() << this->prefix << "Start\n";
+  }
+
+  /*
+   * Check the profiles are available.
+   */
+  auto profiles = noelle.getProfiles();
+  if (!profiles->isAvailable()) {
+    if (verbose) {
+      errs() << this->prefix << "  Profiles are not available\n";
+      errs() << this->prefix << "Exit\n";
+    }
+    return false;
+  }
+
+  /*
+   * Lay out the basic blocks of the functions that have been executed.
+   * Moving basic blocks does not change the dependences.
+   */
+  auto modified = false;
+  double takenBranchesBefore = 0;
+  double takenBranchesAfter = 0;
+  for (auto &F : M) {
+    if (F.empty() || !profiles->hasBeenExecuted(&F)) {
+      continue;
+    }
+    std::vector<BasicBlock *> originalLayout;
+    for (auto &bb : F) {
+      originalLayout.push_back(&bb);
+    }
+    auto layout = this->computeBasicBlockLayout(profiles, &F);
+    takenBranchesBefore +=
+        this->computeTakenBranches(profiles, &F, originalLayout);
+    takenBranchesAfter += this->computeTakenBranches(profiles, &F, layout);
+    if (layout == originalLayout) {
+      continue;
+    }
+
+    BasicBlock *previous = nullptr;
+    for (auto bb : layout) {
+      if (previous != nullptr) {
+        bb->moveAfter(previous);
+      }
+      previous = bb;
+    }
+    modified = true;
+  }
+  if (verbose) {
+    errs() << this->prefix << "  Taken branches: " << takenBranchesBefore
+           << " -> " << takenBranchesAfter << "\n";
+    if (takenBranchesBefore > 0) {
+      auto reduction = 100
+                       * (takenBranchesBefore - takenBranchesAfter)
+                       / takenBranchesBefore;
+      errs() << this->prefix << "  Estimated reduction of taken branches: "
+             << reduction << "%\n";
+    }
+  }
+
+  /*
+   * Lay out the functions.
+   */
+  auto fm = noelle.getFunctionsManager();
+  auto pcg = fm->getProgramCallGraph();
+  auto functionLayout = this->computeFunctionLayout(profiles, M, pcg);
+  std::vector<Function *> originalFunctionLayout;
+  for (auto &F : M) {
+    if (F.empty()) {
+      continue;
+    }
+    originalFunctionLayout.push_back(&F);
+  }
+  if (functionLayout != originalFunctionLayout) {
+    for (auto f : functionLayout) {
+      f->removeFromParent();
+      M.getFunctionList().push_back(f);
+    }
+    modified = true;
+  }
+  if (verbose) {
+    uint32_t executedFunctions = 0;
+    for (auto f : functionLayout) {
+      if (profiles->hasBeenExecuted(f)) {
+        executedFunctions++;
+      }
+    }
+    errs() << this->prefix << "  " << executedFunctions
+           << " executed functions placed by call-graph hotness\n";
+  }
+
+  if (verbose) {
+    errs() << this->prefix << "Exit\n";
+  }
+
+  return modified;
+}
+
+// Next there is code to register your pass to "opt"
+char CodeLayout::ID = 0;
+static RegisterPass<CodeLayout> X("CodeLayout",
+                                  "Lay out basic blocks and functions");
+
+// Next there is code to register your pass to "clang"
+static CodeLayout *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new CodeLayout());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new CodeLayout());
+      }
+    }); // ** for -O0
+
+} // namespace arcana::noelle
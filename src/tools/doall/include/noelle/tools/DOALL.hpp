@@ -0,0 +1,126 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_TOOLS_DOALL_DOALL_H_
+#define NOELLE_SRC_TOOLS_DOALL_DOALL_H_
+
+#include "noelle/core/Noelle.hpp"
+#include "noelle/core/Architecture.hpp"
+#include "noelle/core/Task.hpp"
+#include "noelle/core/Linker.hpp"
+#include "noelle/core/LoopEnvironmentBuilder.hpp"
+#include "noelle/core/IVStepperUtility.hpp"
+#include "noelle/core/InductionVariableSCC.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * How iterations are distributed among the tasks of a DOALL loop.
+ * - Static: task i executes chunks i, i + N, i + 2N, ... (N tasks)
+ * - Dynamic: tasks grab the next chunk from a shared counter
+ * - Guided: like Dynamic, but a chunk is a fraction of the remaining
+ *   iterations (never smaller than the chunk size)
+ */
+enum class DOALLChunking { Static, Dynamic, Guided };
+
+/*
+ * Task that executes a DOALL loop.
+ * Its signature is the one of the tasks dispatched by the NOELLE runtime:
+ *   void task(i8 *env, i64 taskID, i64 numberOfTasks)
+ */
+class DOALLTask : public Task {
+public:
+  DOALLTask(FunctionType *taskSignature, FunctionsManager &fm);
+
+  Value *getNumberOfTasks(void) const;
+
+private:
+  Value *numberOfTasksArg;
+};
+
+class DOALL : public ModulePass {
+public:
+  static char ID;
+
+  DOALL();
+
+  bool doInitialization(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool runOnModule(Module &M) override;
+
+  bool canBeAppliedToLoop(Noelle &noelle, LoopContent *loop) const;
+
+  bool apply(Noelle &noelle, LoopContent *loop);
+
+private:
+  DOALLChunking chunking;
+  ReductionStrategy reductionStrategy;
+
+  const std::string prefix = "DOALL: ";
+  const uint64_t pageBytes = 4096;
+
+  /*
+   * Chunk of iterations executed by a task.
+   * @begin is the index of the first iteration of the chunk (from 0) and
+   * @length is the number of iterations of the chunk.
+   */
+  struct Chunk {
+    Value *begin;
+    Value *length;
+  };
+
+  /*
+   * DOALL_chunking.cpp
+   */
+  uint32_t computeChunkSize(LoopContent *loop) const;
+
+  void rewireLoopToIterateChunks(LoopContent *loop,
+                                 DOALLTask *task,
+                                 Value *chunkCounter,
+                                 Value *tripCount,
+                                 uint32_t chunkSize);
+
+  Chunk generateCodeToFetchTheFirstChunk(IRBuilder<> &builder,
+                                         DOALLTask *task,
+                                         Value *chunkCounter,
+                                         Value *tripCount,
+                                         uint32_t chunkSize);
+
+  Chunk generateCodeToFetchTheNextChunk(IRBuilder<> &builder,
+                                        DOALLTask *task,
+                                        Value *currentChunkBegin,
+                                        Value *chunkCounter,
+                                        Value *tripCount,
+                                        uint32_t chunkSize);
+
+  Value *generateCodeToReserveIterations(IRBuilder<> &builder,
+                                         Value *chunkCounter,
+                                         Value *numberOfIterations);
+
+  Value *generateCodeToComputeTheTripCount(IRBuilder<> &builder,
+                                           LoopContent *loop);
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_TOOLS_DOALL_DOALL_H_
@@ -0,0 +1,611 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/DOALL.hpp"
+
+namespace arcana::noelle {
+
+DOALL::DOALL()
+  : ModulePass{ ID },
+    chunking{ DOALLChunking::Static },
+    reductionStrategy{ ReductionStrategy::Serial } {
+  return;
+}
+
+bool DOALL::canBeAppliedToLoop(Noelle &noelle, LoopContent *loop) const {
+  assert(loop != nullptr);
+
+  /*
+   * Fetch the loop abstractions.
+   */
+  auto ls = loop->getLoopStructure();
+  auto header = ls->getHeader();
+  auto ltm = loop->getLoopTransformationsManager();
+  auto ivManager = loop->getInductionVariableManager();
+  auto sccManager = loop->getSCCManager();
+  auto env = loop->getEnvironment();
+
+  /*
+   * Check if DOALL is enabled and there are cores to use.
+   */
+  if (!ltm->isTransformationEnabled(DOALL_ID)) {
+    return false;
+  }
+  if (ltm->getMaximumNumberOfCores() < 2) {
+    return false;
+  }
+
+  /*
+   * The loop must leave from its header to a single exit block.
+   * This is the shape tasks have to re-enter the header when they move to the
+   * next chunk of iterations.
+   */
+  if (ls->getLoopExitBasicBlocks().size() != 1) {
+    return false;
+  }
+  for (auto exitEdge : ls->getLoopExitEdges()) {
+    if (exitEdge.first != header) {
+      return false;
+    }
+  }
+
+  /*
+   * The loop must be governed by an induction variable compared in the header.
+   */
+  auto giv = ivManager->getLoopGoverningInductionVariable(*ls);
+  if (giv == nullptr) {
+    return false;
+  }
+  if (!giv->isSCCContainingIVWellFormed()) {
+    return false;
+  }
+  auto cmp = giv->getHeaderCompareInstructionToComputeExitCondition();
+  if (!cmp->isIntPredicate()) {
+    return false;
+  }
+  if (giv->getValueToCompareAgainstExitConditionValue()
+      != giv->getInductionVariable()->getLoopEntryPHI()) {
+    return false;
+  }
+
+  /*
+   * Every induction variable must be an integer that moves by a constant.
+   * This is what allows tasks to jump to the first iteration of a chunk.
+   */
+  for (auto iv : ivManager->getInductionVariables(*ls)) {
+    if (!iv->getLoopEntryPHI()->getType()->isIntegerTy()) {
+      return false;
+    }
+    if (!isa_and_nonnull<ConstantInt>(iv->getSingleComputedStepValue())) {
+      return false;
+    }
+  }
+
+  /*
+   * Tasks evaluate the header once more per chunk.
+   * So, the header must not have side effects.
+   */
+  for (auto &I : *header) {
+    if (I.mayHaveSideEffects()) {
+      return false;
+    }
+  }
+
+  /*
+   * Only induction variables and reductions can carry data between iterations.
+   */
+  auto lisa = loop->getLoopIterationSpaceAnalysis();
+  auto isDisjointAcrossIterations = [lisa](DGEdge<Value, Value> *dep) -> bool {
+    auto fromInst = dyn_cast<Instruction>(dep->getSrc());
+    auto toInst = dyn_cast<Instruction>(dep->getDst());
+    return lisa
+        ->areInstructionsAccessingDisjointMemoryLocationsBetweenIterations(
+            fromInst,
+            toInst);
+  };
+  for (auto sccInfo : sccManager->getSCCsWithLoopCarriedDataDependencies()) {
+    auto scc = sccInfo->getSCC();
+    if (sccManager->isSCCContainedInSubloop(loop->getLoopHierarchyStructures(),
+                                            scc)) {
+
+      /*
+       * Values of a sub-loop restart at every iteration of @loop.
+       * Memory does not: the sub-loop can access the same locations in
+       * different iterations of @loop (e.g., A[j] += ... in the sub-loop).
+       * So, the SCC is ignored only if its memory accesses are proven to be
+       * disjoint across iterations of @loop.
+       */
+      for (auto dep : sccInfo->getLoopCarriedDependences()) {
+        if (!isa<MemoryDependence<Value, Value>>(dep)) {
+          if (true && scc->isInternal(dep->getSrc())
+              && scc->isInternal(dep->getDst())) {
+            continue;
+          }
+          return false;
+        }
+        if (!isDisjointAcrossIterations(dep)) {
+          return false;
+        }
+      }
+      continue;
+    }
+    if (isa<InductionVariableSCC>(sccInfo)) {
+      continue;
+    }
+    if (isa<BinaryReductionSCC>(sccInfo)) {
+      continue;
+    }
+    return false;
+  }
+
+  /*
+   * Every live-out must be the accumulator of a reduction and it must be used
+   * only by PHIs of the exit block.
+   */
+  auto exitBB = ls->getLoopExitBasicBlocks()[0];
+  auto sccdag = sccManager->getSCCDAG();
+  for (auto envID : env->getEnvIDsOfLiveOutVars()) {
+    auto producer = env->getProducer(envID);
+    auto scc = sccdag->sccOfValue(producer);
+    auto red = dyn_cast<BinaryReductionSCC>(sccManager->getSCCAttrs(scc));
+    if (red == nullptr) {
+      return false;
+    }
+    auto accumulator = red->getPhiThatAccumulatesValuesBetweenLoopIterations();
+    if (producer != accumulator) {
+      return false;
+    }
+    for (auto consumer : env->consumersOf(producer)) {
+      auto phi = dyn_cast<PHINode>(consumer);
+      if ((phi == nullptr) || (phi->getParent() != exitBB)) {
+        return false;
+      }
+    }
+  }
+
+  /*
+   * Guided chunks are sized by the trip count, which is computed before the
+   * loop starts.
+   */
+  if (this->chunking == DOALLChunking::Guided) {
+    auto exitValue = giv->getExitConditionValue();
+    if (auto exitInst = dyn_cast<Instruction>(exitValue)) {
+      if (ls->isIncluded(exitInst)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool DOALL::apply(Noelle &noelle, LoopContent *loop) {
+
+  /*
+   * Fetch the loop abstractions.
+   */
+  auto ls = loop->getLoopStructure();
+  auto header = ls->getHeader();
+  auto preheader = ls->getPreHeader();
+  auto loopFunction = ls->getFunction();
+  auto ltm = loop->getLoopTransformationsManager();
+  auto sccManager = loop->getSCCManager();
+  auto env = loop->getEnvironment();
+  auto &M = *loopFunction->getParent();
+  auto &cxt = M.getContext();
+  auto tm = noelle.getTypesManager();
+  if (noelle.getVerbosity() > Verbosity::Disabled) {
+    errs() << this->prefix << "Parallelizing a loop of \""
+           << loopFunction->getName() << "\"\n";
+  }
+
+  /*
+   * Fetch the number of tasks and the chunk size.
+   */
+  auto numberOfTasks = ltm->getMaximumNumberOfCores();
+  auto chunkSize = this->computeChunkSize(loop);
+
+  /*
+   * Collect the reductions.
+   */
+  auto sccdag = sccManager->getSCCDAG();
+  std::unordered_map<uint32_t, BinaryReductionSCC *> reductions;
+  for (auto envID : env->getEnvIDsOfLiveOutVars()) {
+    auto producer = env->getProducer(envID);
+    auto scc = sccdag->sccOfValue(producer);
+    auto red = cast<BinaryReductionSCC>(sccManager->getSCCAttrs(scc));
+    reductions[envID] = red;
+  }
+
+  /*
+   * Create the environment.
+   * Every task has its own private copy of the reducable variables.
+   */
+  auto envBuilder = new LoopEnvironmentBuilder(
+      cxt,
+      env,
+      [&reductions](uint32_t variableID, bool isLiveOut) -> bool {
+        return isLiveOut && (reductions.count(variableID) > 0);
+      },
+      numberOfTasks,
+      1);
+
+  /*
+   * Set how the private copies of the reducable variables are combined.
+   */
+  auto strategy = ltm->getReductionStrategy();
+  envBuilder->setReductionStrategy(strategy);
+
+  /*
+   * Add the variables shared by the tasks to distribute iterations.
+   */
+  auto int64 = tm->getIntegerType(64);
+  auto chunkCounterID = env->size();
+  auto tripCountID = env->size() + 1;
+  auto treeReductionID = env->size() + 2;
+  if (this->chunking != DOALLChunking::Static) {
+    envBuilder->addVariableToEnvironment(chunkCounterID, int64);
+  }
+  if (this->chunking == DOALLChunking::Guided) {
+    envBuilder->addVariableToEnvironment(tripCountID, int64);
+  }
+
+  /*
+   * Tasks combine their private copies in a tree only if they all run at the
+   * same time.
+   * A flag in the environment tells them whether this is the case.
+   */
+  auto useTree =
+      (strategy == ReductionStrategy::Tree) && (reductions.size() > 0);
+  if (useTree) {
+    envBuilder->addVariableToEnvironment(treeReductionID, int64);
+  }
+
+  /*
+   * Create the task.
+   */
+  auto taskSignature =
+      FunctionType::get(tm->getVoidType(),
+                        ArrayRef<Type *>({ tm->getVoidPointerType(),
+                                           int64,
+                                           int64 }),
+                        false);
+  auto task = new DOALLTask(taskSignature, *noelle.getFunctionsManager());
+
+  /*
+   * Clone the loop within the task.
+   */
+  auto exitBB = ls->getLoopExitBasicBlocks()[0];
+  task->addBasicBlock(preheader, task->getEntry());
+  auto exitStub = task->addBasicBlockStub(exitBB);
+  task->tagBasicBlockAsLastBlock(exitStub);
+  task->cloneAndAddBasicBlocks(ls->getBasicBlocks());
+
+  /*
+   * Load the live-in variables from the environment.
+   */
+  auto envUser = envBuilder->getUser(0);
+  IRBuilder<> entryBuilder(task->getEntry());
+  auto envArray = entryBuilder.CreateBitCast(
+      task->getEnvironment(),
+      PointerType::getUnqual(envBuilder->getEnvironmentArrayType()));
+  envUser->setEnvironmentArray(envArray);
+  for (auto envID : env->getEnvIDsOfLiveInVars()) {
+    auto producer = env->getProducer(envID);
+    envUser->addLiveIn(envID);
+    auto envPtr =
+        envUser->createEnvironmentVariablePointer(entryBuilder,
+                                                  envID,
+                                                  producer->getType());
+    auto envLoad = entryBuilder.CreateLoad(envPtr);
+    task->addLiveIn(producer, envLoad);
+  }
+
+  /*
+   * Fetch the pointers of the variables shared by the tasks.
+   */
+  Value *chunkCounter = nullptr;
+  Value *tripCount = nullptr;
+  if (this->chunking != DOALLChunking::Static) {
+    envUser->addLiveIn(chunkCounterID);
+    chunkCounter = envUser->createEnvironmentVariablePointer(entryBuilder,
+                                                             chunkCounterID,
+                                                             int64);
+  }
+  if (this->chunking == DOALLChunking::Guided) {
+    envUser->addLiveIn(tripCountID);
+    auto tripCountPtr =
+        envUser->createEnvironmentVariablePointer(entryBuilder,
+                                                  tripCountID,
+                                                  int64);
+    tripCount = entryBuilder.CreateLoad(tripCountPtr);
+  }
+  Value *isTreeReduction = nullptr;
+  if (useTree) {
+    envUser->addLiveIn(treeReductionID);
+    auto treeReductionPtr =
+        envUser->createEnvironmentVariablePointer(entryBuilder,
+                                                  treeReductionID,
+                                                  int64);
+    isTreeReduction =
+        entryBuilder.CreateICmpNE(entryBuilder.CreateLoad(treeReductionPtr),
+                                  ConstantInt::get(int64, 0));
+  }
+
+  /*
+   * Compute the pointers of the private copies of the live-out variables.
+   */
+  for (auto envID : env->getEnvIDsOfLiveOutVars()) {
+    auto producer = env->getProducer(envID);
+    envUser->addLiveOut(envID);
+    envUser->createReducableEnvPtr(entryBuilder,
+                                   envID,
+                                   producer->getType(),
+                                   numberOfTasks,
+                                   task->getTaskInstanceID());
+  }
+
+  /*
+   * Jump to the loop.
+   */
+  auto headerClone = task->getCloneOfOriginalBasicBlock(header);
+  entryBuilder.CreateBr(headerClone);
+
+  /*
+   * Store the live-out variables when the task exits.
+   */
+  IRBuilder<> exitBuilder(exitStub);
+  for (auto envID : env->getEnvIDsOfLiveOutVars()) {
+    auto producer = cast<Instruction>(env->getProducer(envID));
+    auto producerClone = task->getCloneOfOriginalInstruction(producer);
+    exitBuilder.CreateStore(producerClone, envUser->getEnvPtr(envID));
+    task->addLiveOut(producer, producerClone);
+  }
+
+  /*
+   * Tasks combine their private copies among themselves before exiting when
+   * the reduction is done in a tree.
+   */
+  auto lastBB = exitStub;
+  if (useTree) {
+    std::unordered_map<uint32_t, Instruction::BinaryOps> reductionOps;
+    for (auto reduction : reductions) {
+      reductionOps[reduction.first] =
+          reduction.second->getReductionOperation();
+    }
+    auto treeBB = BasicBlock::Create(cxt, "", task->getTaskBody());
+    lastBB = BasicBlock::Create(cxt, "", task->getTaskBody());
+    exitBuilder.CreateCondBr(isTreeReduction, treeBB, lastBB);
+    auto lastTreeBB =
+        envUser->createTreeReduction(treeBB,
+                                     reductionOps,
+                                     task->getTaskInstanceID(),
+                                     task->getNumberOfTasks());
+    IRBuilder<> lastTreeBuilder(lastTreeBB);
+    lastTreeBuilder.CreateBr(lastBB);
+  }
+  IRBuilder<> lastBuilder(lastBB);
+  lastBuilder.CreateBr(task->getExit());
+
+  /*
+   * Link the cloned instructions and basic blocks among themselves.
+   */
+  task->adjustDataAndControlFlowToUseClones();
+
+  /*
+   * The private accumulators start from the identity of their reduction.
+   */
+  for (auto reduction : reductions) {
+    auto red = reduction.second;
+    auto phi = red->getPhiThatAccumulatesValuesBetweenLoopIterations();
+    auto phiClone = cast<PHINode>(task->getCloneOfOriginalInstruction(phi));
+    auto entryIndex = phiClone->getBasicBlockIndex(task->getEntry());
+    assert(entryIndex >= 0);
+    phiClone->setIncomingValue(entryIndex, red->getIdentityValue());
+  }
+
+  /*
+   * Make the task iterate over chunks of iterations.
+   */
+  this->rewireLoopToIterateChunks(loop,
+                                  task,
+                                  chunkCounter,
+                                  tripCount,
+                                  chunkSize);
+
+  /*
+   * Allocate the environment in the caller.
+   */
+  auto &entryBlockOfCaller = loopFunction->getEntryBlock();
+  IRBuilder<> allocaBuilder(&*entryBlockOfCaller.getFirstInsertionPt());
+  envBuilder->allocateEnvironmentArray(allocaBuilder);
+  envBuilder->generateEnvVariables(allocaBuilder);
+
+  /*
+   * Create the code that dispatches the tasks.
+   */
+  auto startBB = BasicBlock::Create(cxt, "", loopFunction);
+  auto endBB = BasicBlock::Create(cxt, "", loopFunction);
+  IRBuilder<> startBuilder(startBB);
+  for (auto envID : env->getEnvIDsOfLiveInVars()) {
+    if (!envBuilder->isIncludedEnvironmentVariable(envID)) {
+      continue;
+    }
+    startBuilder.CreateStore(env->getProducer(envID),
+                             envBuilder->getEnvironmentVariable(envID));
+  }
+  if (this->chunking != DOALLChunking::Static) {
+    auto chunkCounterPtr = envBuilder->getEnvironmentVariable(chunkCounterID);
+    startBuilder.CreateStore(ConstantInt::get(int64, 0), chunkCounterPtr);
+  }
+  if (this->chunking == DOALLChunking::Guided) {
+    auto tripCountValue =
+        this->generateCodeToComputeTheTripCount(startBuilder, loop);
+    startBuilder.CreateStore(tripCountValue,
+                             envBuilder->getEnvironmentVariable(tripCountID));
+  }
+  auto numberOfTasksValue = ConstantInt::get(int64, numberOfTasks);
+  auto dispatcherType = FunctionType::get(
+      int64,
+      ArrayRef<Type *>({ PointerType::getUnqual(taskSignature),
+                         tm->getVoidPointerType(),
+                         int64 }),
+      false);
+  auto dispatcher =
+      M.getOrInsertFunction("NOELLE_dispatchTasks", dispatcherType);
+  auto reductionBB = startBB;
+  Value *numberOfPrivateCopies =
+      ConstantInt::get(tm->getIntegerType(32), numberOfTasks);
+  if (useTree) {
+
+    /*
+     * A task of a tree reduction waits for the tasks it combines.
+     * So, the runtime must reserve a core for every task.
+     * If it cannot, the tasks do not combine their private copies and the
+     * main thread walks all of them.
+     */
+    envBuilder->clearReadyFlagsOfReducers(startBuilder);
+    auto treeReductionPtr = envBuilder->getEnvironmentVariable(treeReductionID);
+    startBuilder.CreateStore(ConstantInt::get(int64, 1), treeReductionPtr);
+    auto dispatcherTogetherType = FunctionType::get(
+        tm->getIntegerType(32),
+        ArrayRef<Type *>({ PointerType::getUnqual(taskSignature),
+                           tm->getVoidPointerType(),
+                           int64 }),
+        false);
+    auto dispatcherTogether =
+        M.getOrInsertFunction("NOELLE_dispatchTasksTogether",
+                              dispatcherTogetherType);
+    auto dispatchedTogether = startBuilder.CreateCall(
+        dispatcherTogether,
+        ArrayRef<Value *>({ task->getTaskBody(),
+                            envBuilder->getEnvironmentArrayVoidPtr(),
+                            numberOfTasksValue }));
+    auto areTasksCombined = startBuilder.CreateICmpNE(
+        dispatchedTogether,
+        ConstantInt::get(tm->getIntegerType(32), 0));
+    auto fallbackBB = BasicBlock::Create(cxt, "", loopFunction);
+    reductionBB = BasicBlock::Create(cxt, "", loopFunction);
+    startBuilder.CreateCondBr(areTasksCombined, reductionBB, fallbackBB);
+
+    IRBuilder<> fallbackBuilder(fallbackBB);
+    fallbackBuilder.CreateStore(ConstantInt::get(int64, 0), treeReductionPtr);
+    fallbackBuilder.CreateCall(dispatcher,
+                               ArrayRef<Value *>(
+                                   { task->getTaskBody(),
+                                     envBuilder->getEnvironmentArrayVoidPtr(),
+                                     numberOfTasksValue }));
+    fallbackBuilder.CreateBr(reductionBB);
+
+    /*
+     * Only the private copy of the first task is left when the tasks have
+     * combined their copies.
+     */
+    IRBuilder<> reductionBuilder(reductionBB);
+    auto privateCopies = reductionBuilder.CreatePHI(tm->getIntegerType(32), 2);
+    privateCopies->addIncoming(ConstantInt::get(tm->getIntegerType(32), 1),
+                               startBB);
+    privateCopies->addIncoming(numberOfPrivateCopies, fallbackBB);
+    numberOfPrivateCopies = privateCopies;
+
+  } else {
+    startBuilder.CreateCall(dispatcher,
+                            ArrayRef<Value *>(
+                                { task->getTaskBody(),
+                                  envBuilder->getEnvironmentArrayVoidPtr(),
+                                  numberOfTasksValue }));
+  }
+
+  /*
+   * Combine the private copies of the live-out variables.
+   */
+  IRBuilder<> reductionBuilder(reductionBB);
+  auto afterReductionBB = envBuilder->reduceLiveOutVariables(
+      reductionBB,
+      reductionBuilder,
+      reductions,
+      numberOfPrivateCopies,
+      [](ReductionSCC *red) -> Value * { return red->getInitialValue(); });
+  IRBuilder<> afterReductionBuilder(afterReductionBB);
+  afterReductionBuilder.CreateBr(endBB);
+
+  /*
+   * Propagate the reduced values to their consumers.
+   */
+  for (auto envID : env->getEnvIDsOfLiveOutVars()) {
+    auto producer = env->getProducer(envID);
+    auto reducedValue =
+        envBuilder->getAccumulatedReducedEnvironmentVariable(envID);
+    for (auto consumer : env->consumersOf(producer)) {
+      auto phi = cast<PHINode>(consumer);
+      phi->addIncoming(reducedValue, endBB);
+    }
+  }
+
+  /*
+   * Values defined before the loop that reach the exit block flow through the
+   * parallelized loop unchanged.
+   * Constants are handled by the linker.
+   */
+  for (auto &phi : exitBB->phis()) {
+    auto incomingIndex = phi.getBasicBlockIndex(header);
+    if (incomingIndex < 0) {
+      continue;
+    }
+    auto incomingValue = phi.getIncomingValue(incomingIndex);
+    if (isa<Constant>(incomingValue)) {
+      continue;
+    }
+    if (auto incomingInst = dyn_cast<Instruction>(incomingValue)) {
+      if (ls->isIncluded(incomingInst)) {
+        continue;
+      }
+    }
+    phi.addIncoming(incomingValue, endBB);
+  }
+
+  /*
+   * Link the parallelized loop to the original function.
+   * The original loop is kept to run when there are not enough idle cores.
+   */
+  M.getOrInsertFunction("NOELLE_getAvailableCores",
+                        FunctionType::get(tm->getIntegerType(32), false));
+  std::vector<BasicBlock *> exitBlocks{ exitBB };
+  Linker linker(M, tm);
+  linker.linkTransformedLoopToOriginalFunction(
+      preheader,
+      startBB,
+      endBB,
+      envBuilder->getEnvironmentArray(),
+      nullptr,
+      exitBlocks,
+      2);
+
+  /*
+   * Free the memory.
+   */
+  delete envBuilder;
+  delete task;
+
+  return true;
+}
+
+} // namespace arcana::noelle
@@ -0,0 +1,360 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/DOALL.hpp"
+
+namespace arcana::noelle {
+
+uint32_t DOALL::computeChunkSize(LoopContent *loop) const {
+
+  /*
+   * Fetch the chunk size requested for the loop.
+   */
+  auto ltm = loop->getLoopTransformationsManager();
+  auto chunkSize = std::max(ltm->getChunkSize(), 1u);
+
+  /*
+   * Fetch the smallest number of bytes stored per iteration into an array
+   * indexed by the loop (e.g., a[i] = ...).
+   */
+  auto ls = loop->getLoopStructure();
+  auto loopNode = loop->getLoopHierarchyStructures();
+  auto iterationSpace = loop->getLoopIterationSpaceAnalysis();
+  auto &DL = ls->getFunction()->getParent()->getDataLayout();
+  uint64_t bytesPerIteration = 0;
+  for (auto inst : ls->getInstructions()) {
+    auto store = dyn_cast<StoreInst>(inst);
+    if (store == nullptr) {
+      continue;
+    }
+    if (loopNode->getInnermostLoopThatContains(store) != ls) {
+      continue;
+    }
+    if (iterationSpace->getMemoryAccessor(store) == nullptr) {
+      continue;
+    }
+    auto bytes = DL.getTypeStoreSize(store->getValueOperand()->getType());
+    if ((bytesPerIteration == 0) || (bytes < bytesPerIteration)) {
+      bytesPerIteration = bytes;
+    }
+  }
+  if (bytesPerIteration == 0) {
+    return chunkSize;
+  }
+
+  /*
+   * Chunks of different tasks must not write to the same cache line (false
+   * sharing).
+   * On machines with several NUMA nodes, chunks cover whole pages instead:
+   * pages are placed in the node of the core that touches them first, so the
+   * data written by a task stays local to it.
+   */
+  uint64_t bytesPerChunk = Architecture::getCacheLineBytes();
+  if (Architecture::getNumberOfNUMANodes() > 1) {
+    bytesPerChunk = this->pageBytes;
+  }
+  uint64_t iterations =
+      (bytesPerChunk + bytesPerIteration - 1) / bytesPerIteration;
+  if (iterations > chunkSize) {
+    chunkSize = iterations;
+  }
+
+  return chunkSize;
+}
+
+void DOALL::rewireLoopToIterateChunks(LoopContent *loop,
+                                      DOALLTask *task,
+                                      Value *chunkCounter,
+                                      Value *tripCount,
+                                      uint32_t chunkSize) {
+
+  /*
+   * Fetch the loop abstractions.
+   */
+  auto ls = loop->getLoopStructure();
+  auto ivManager = loop->getInductionVariableManager();
+  auto headerClone = task->getCloneOfOriginalBasicBlock(ls->getHeader());
+  auto entry = task->getEntry();
+  auto int64 = IntegerType::get(entry->getContext(), 64);
+
+  /*
+   * Fetch the first chunk of the task.
+   */
+  IRBuilder<> entryBuilder(entry->getTerminator());
+  auto firstChunk = this->generateCodeToFetchTheFirstChunk(entryBuilder,
+                                                           task,
+                                                           chunkCounter,
+                                                           tripCount,
+                                                           chunkSize);
+
+  /*
+   * Start the induction variables from the first iteration of the chunk.
+   */
+  std::unordered_map<PHINode *, Value *> ivStartValues;
+  std::unordered_map<PHINode *, Value *> ivStepValues;
+  for (auto iv : ivManager->getInductionVariables(*ls)) {
+    auto phi = iv->getLoopEntryPHI();
+    auto phiClone = cast<PHINode>(task->getCloneOfOriginalInstruction(phi));
+    auto entryIndex = phiClone->getBasicBlockIndex(entry);
+    assert(entryIndex >= 0);
+    auto startValue = phiClone->getIncomingValue(entryIndex);
+    auto stepValue = iv->getSingleComputedStepValue();
+    ivStartValues[phiClone] = startValue;
+    ivStepValues[phiClone] = stepValue;
+
+    auto firstValue =
+        IVUtility::computeInductionVariableValueForIteration(entry,
+                                                             phiClone,
+                                                             startValue,
+                                                             stepValue,
+                                                             firstChunk.begin);
+    phiClone->setIncomingValue(entryIndex, firstValue);
+  }
+
+  /*
+   * Keep track of the current chunk and of the iteration within it.
+   */
+  IRBuilder<> headerBuilder(headerClone->getFirstNonPHI());
+  auto chunkBegin = headerBuilder.CreatePHI(int64, 2, "chunkBegin");
+  auto chunkLength = headerBuilder.CreatePHI(int64, 2, "chunkLength");
+  auto chunkIteration = headerBuilder.CreatePHI(int64, 2, "chunkIteration");
+  chunkBegin->addIncoming(firstChunk.begin, entry);
+  chunkLength->addIncoming(firstChunk.length, entry);
+  chunkIteration->addIncoming(ConstantInt::get(int64, 0), entry);
+  std::unordered_set<PHINode *> chunkPHIs{ chunkBegin,
+                                           chunkLength,
+                                           chunkIteration };
+
+  /*
+   * Check at every latch whether the current chunk has been completed.
+   */
+  for (auto latch : ls->getLatches()) {
+    auto latchClone = task->getCloneOfOriginalBasicBlock(latch);
+    auto checkBB = task->newBasicBlock();
+    auto nextChunkBB = task->newBasicBlock();
+
+    /*
+     * Go to the check rather than to the header.
+     */
+    auto latchTerminator = latchClone->getTerminator();
+    for (auto i = 0u; i < latchTerminator->getNumSuccessors(); i++) {
+      if (latchTerminator->getSuccessor(i) == headerClone) {
+        latchTerminator->setSuccessor(i, checkBB);
+      }
+    }
+
+    /*
+     * Move to the next iteration of the chunk if there is one left.
+     */
+    IRBuilder<> checkBuilder(checkBB);
+    auto nextIteration =
+        checkBuilder.CreateAdd(chunkIteration, ConstantInt::get(int64, 1));
+    auto isChunkCompleted =
+        checkBuilder.CreateICmpEQ(nextIteration, chunkLength);
+    checkBuilder.CreateCondBr(isChunkCompleted, nextChunkBB, headerClone);
+
+    /*
+     * Fetch the next chunk otherwise.
+     */
+    IRBuilder<> nextChunkBuilder(nextChunkBB);
+    auto nextChunk = this->generateCodeToFetchTheNextChunk(nextChunkBuilder,
+                                                           task,
+                                                           chunkBegin,
+                                                           chunkCounter,
+                                                           tripCount,
+                                                           chunkSize);
+    nextChunkBuilder.CreateBr(headerClone);
+
+    /*
+     * Fix the PHIs of the header.
+     * Induction variables jump to the first iteration of the next chunk while
+     * the other variables (i.e., reductions) keep their values.
+     */
+    for (auto &phi : headerClone->phis()) {
+      if (chunkPHIs.count(&phi) > 0) {
+        continue;
+      }
+      auto latchIndex = phi.getBasicBlockIndex(latchClone);
+      assert(latchIndex >= 0);
+      auto latchValue = phi.getIncomingValue(latchIndex);
+      phi.setIncomingBlock(latchIndex, checkBB);
+
+      Value *nextChunkValue = latchValue;
+      if (ivStartValues.count(&phi) > 0) {
+        nextChunkValue = IVUtility::computeInductionVariableValueForIteration(
+            nextChunkBB,
+            &phi,
+            ivStartValues[&phi],
+            ivStepValues[&phi],
+            nextChunk.begin);
+      }
+      phi.addIncoming(nextChunkValue, nextChunkBB);
+    }
+    chunkBegin->addIncoming(chunkBegin, checkBB);
+    chunkBegin->addIncoming(nextChunk.begin, nextChunkBB);
+    chunkLength->addIncoming(chunkLength, checkBB);
+    chunkLength->addIncoming(nextChunk.length, nextChunkBB);
+    chunkIteration->addIncoming(nextIteration, checkBB);
+    chunkIteration->addIncoming(ConstantInt::get(int64, 0), nextChunkBB);
+  }
+
+  /*
+   * Chunks make the induction variables jump.
+   * So, the exit condition needs to catch values past the last iteration.
+   */
+  auto giv = ivManager->getLoopGoverningInductionVariable(*ls);
+  auto cmp = giv->getHeaderCompareInstructionToComputeExitCondition();
+  auto cmpClone = cast<CmpInst>(task->getCloneOfOriginalInstruction(cmp));
+  auto brClone = cast<BranchInst>(
+      task->getCloneOfOriginalInstruction(giv->getHeaderBrInst()));
+  LoopGoverningIVUtility givUtility(ls, *ivManager, *giv);
+  givUtility.updateConditionAndBranchToCatchIteratingPastExitValue(
+      cmpClone,
+      brClone,
+      task->getLastBlock(0));
+
+  return;
+}
+
+DOALL::Chunk DOALL::generateCodeToFetchTheFirstChunk(IRBuilder<> &builder,
+                                                     DOALLTask *task,
+                                                     Value *chunkCounter,
+                                                     Value *tripCount,
+                                                     uint32_t chunkSize) {
+  Chunk chunk;
+  auto int64 = builder.getInt64Ty();
+  auto chunkSizeValue = ConstantInt::get(int64, chunkSize);
+
+  switch (this->chunking) {
+    case DOALLChunking::Static:
+
+      /*
+       * Task i starts from the i-th chunk.
+       */
+      chunk.begin =
+          builder.CreateMul(task->getTaskInstanceID(), chunkSizeValue);
+      chunk.length = chunkSizeValue;
+      break;
+
+    case DOALLChunking::Dynamic:
+      chunk.begin = this->generateCodeToReserveIterations(builder,
+                                                          chunkCounter,
+                                                          chunkSizeValue);
+      chunk.length = chunkSizeValue;
+      break;
+
+    case DOALLChunking::Guided: {
+
+      /*
+       * Split the iterations left among the tasks.
+       * The counter is read atomically as other tasks update it concurrently.
+       */
+      auto iterationsReserved =
+          this->generateCodeToReserveIterations(builder,
+                                                chunkCounter,
+                                                ConstantInt::get(int64, 0));
+      auto iterationsLeft = builder.CreateSub(tripCount, iterationsReserved);
+      auto iterationsPerTask =
+          builder.CreateSDiv(iterationsLeft, task->getNumberOfTasks());
+      auto isLargerThanChunkSize =
+          builder.CreateICmpSGT(iterationsPerTask, chunkSizeValue);
+      chunk.length = builder.CreateSelect(isLargerThanChunkSize,
+                                          iterationsPerTask,
+                                          chunkSizeValue);
+      chunk.begin = this->generateCodeToReserveIterations(builder,
+                                                          chunkCounter,
+                                                          chunk.length);
+      break;
+    }
+  }
+
+  return chunk;
+}
+
+DOALL::Chunk DOALL::generateCodeToFetchTheNextChunk(IRBuilder<> &builder,
+                                                    DOALLTask *task,
+                                                    Value *currentChunkBegin,
+                                                    Value *chunkCounter,
+                                                    Value *tripCount,
+                                                    uint32_t chunkSize) {
+
+  /*
+   * Tasks that share a counter fetch every chunk the same way.
+   */
+  if (this->chunking != DOALLChunking::Static) {
+    return this->generateCodeToFetchTheFirstChunk(builder,
+                                                  task,
+                                                  chunkCounter,
+                                                  tripCount,
+                                                  chunkSize);
+  }
+
+  /*
+   * Skip the chunks of the other tasks.
+   */
+  Chunk chunk;
+  auto chunkSizeValue = ConstantInt::get(builder.getInt64Ty(), chunkSize);
+  auto stride = builder.CreateMul(task->getNumberOfTasks(), chunkSizeValue);
+  chunk.begin = builder.CreateAdd(currentChunkBegin, stride);
+  chunk.length = chunkSizeValue;
+
+  return chunk;
+}
+
+Value *DOALL::generateCodeToReserveIterations(IRBuilder<> &builder,
+                                              Value *chunkCounter,
+                                              Value *numberOfIterations) {
+  assert(chunkCounter != nullptr);
+
+  /*
+   * Atomically move the counter forward.
+   * The old value of the counter is the first iteration reserved.
+   */
+  auto firstIteration = builder.CreateAtomicRMW(AtomicRMWInst::Add,
+                                                chunkCounter,
+                                                numberOfIterations,
+                                                AtomicOrdering::Monotonic);
+
+  return firstIteration;
+}
+
+Value *DOALL::generateCodeToComputeTheTripCount(IRBuilder<> &builder,
+                                                LoopContent *loop) {
+
+  /*
+   * Fetch the loop governing induction variable.
+   */
+  auto ls = loop->getLoopStructure();
+  auto ivManager = loop->getInductionVariableManager();
+  auto giv = ivManager->getLoopGoverningInductionVariable(*ls);
+  assert(giv != nullptr);
+
+  /*
+   * Compute the trip count with the type used by the chunks.
+   */
+  LoopGoverningIVUtility givUtility(ls, *ivManager, *giv);
+  auto tripCount = givUtility.generateCodeToComputeTheTripCount(builder);
+  auto tripCount64 = builder.CreateZExtOrTrunc(tripCount, builder.getInt64Ty());
+
+  return tripCount64;
+}
+
+} // namespace arcana::noelle
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/DOALL.hpp"
+
+static cl::opt<std::string> Chunking(
+    "noelle-doall-chunking",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("How DOALL distributes iterations (static, dynamic, guided)"));
+
+static cl::opt<std::string> Reduction(
+    "noelle-doall-reduction",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("How DOALL combines private copies (serial, vectorized, tree)"));
+
+namespace arcana::noelle {
+
+bool DOALL::doInitialization(Module &M) {
+
+  /*
+   * Fetch the chunking scheme.
+   */
+  if (Chunking.getNumOccurrences() > 0) {
+    auto scheme = Chunking.getValue();
+    if (scheme == "static") {
+      this->chunking = DOALLChunking::Static;
+    } else if (scheme == "dynamic") {
+      this->chunking = DOALLChunking::Dynamic;
+    } else if (scheme == "guided") {
+      this->chunking = DOALLChunking::Guided;
+    } else {
+      errs() << this->prefix << "ERROR: chunking scheme \"" << scheme
+             << "\" is not supported\n";
+      abort();
+    }
+  }
+
+  /*
+   * Fetch the reduction strategy.
+   */
+  if (Reduction.getNumOccurrences() > 0) {
+    auto strategy = Reduction.getValue();
+    if (strategy == "serial") {
+      this->reductionStrategy = ReductionStrategy::Serial;
+    } else if (strategy == "vectorized") {
+      this->reductionStrategy = ReductionStrategy::Vectorized;
+    } else if (strategy == "tree") {
+      this->reductionStrategy = ReductionStrategy::Tree;
+    } else {
+      errs() << this->prefix << "ERROR: reduction strategy \"" << strategy
+             << "\" is not supported\n";
+      abort();
+    }
+  }
+
+  return false;
+}
+
+void DOALL::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+
+  return;
+}
+
+bool DOALL::runOnModule(Module &M) {
+
+  /*
+   * Fetch NOELLE.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  auto verbose = noelle.getVerbosity() > Verbosity::Disabled;
+  if (verbose) {
+    errs() << this->prefix << "Start\n";
+  }
+  if (noelle.getVerbosity() >= Verbosity::Maximal) {
+    Architecture::print(errs());
+  }
+
+  /*
+   * Fetch the loops and organize them in their nesting forest.
+   */
+  auto loopStructures = noelle.getLoopStructures();
+  auto forest = noelle.organizeLoopsInTheirNestingForest(*loopStructures);
+
+  /*
+   * Select the loops to parallelize.
+   *
+   * Loops are visited from the outermost ones and from the hottest ones.
+   * The sub-loops of a selected loop are not considered as they will run
+   * within a task.
+   *
+   * At most one loop per function is selected: parallelizing a loop rewrites
+   * its function, which invalidates the abstractions (e.g., PDG) of the other
+   * loops of that function.
+   * The other loops can be parallelized by invoking DOALL again.
+   */
+  std::vector<LoopContent *> selectedLoops;
+  std::set<Function *> functionsWithSelectedLoops;
+  std::vector<LoopTree *> worklist = noelle.sortByHotness(forest->getTrees());
+  for (auto i = 0u; i < worklist.size(); i++) {
+    auto node = worklist[i];
+    auto ls = node->getLoop();
+    if (functionsWithSelectedLoops.count(ls->getFunction()) > 0) {
+      continue;
+    }
+    auto loop = noelle.getLoopContent(ls);
+    auto ltm = loop->getLoopTransformationsManager();
+    ltm->setReductionStrategy(this->reductionStrategy);
+    if (this->canBeAppliedToLoop(noelle, loop)) {
+      selectedLoops.push_back(loop);
+      functionsWithSelectedLoops.insert(ls->getFunction());
+      continue;
+    }
+    delete loop;
+
+    /*
+     * The loop cannot be parallelized; try its sub-loops.
+     */
+    for (auto child : noelle.sortByHotness(node->getChildren())) {
+      worklist.push_back(child);
+    }
+  }
+  if (verbose) {
+    errs() << this->prefix << "  " << selectedLoops.size()
+           << " loops selected\n";
+  }
+
+  /*
+   * Parallelize the selected loops.
+   */
+  auto modified = false;
+  for (auto loop : selectedLoops) {
+    modified |= this->apply(noelle, loop);
+    delete loop;
+  }
+
+  /*
+   * Free the memory.
+   */
+  delete forest;
+  delete loopStructures;
+
+  if (verbose) {
+    errs() << this->prefix << "Exit\n";
+  }
+
+  return modified;
+}
+
+// Next there is code to register your pass to "opt"
+char DOALL::ID = 0;
+static RegisterPass<DOALL> X("DOALL", "Parallelize DOALL loops");
+
+// Next there is code to register your pass to "clang"
+static DOALL *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(PassManagerBuilder::EP_OptimizerLast,
+                                        [](const PassManagerBuilder &,
+                                           legacy::PassManagerBase &PM) {
+                                          if (!_PassMaker) {
+                                            PM.add(_PassMaker = new DOALL());
+                                          }
+                                        }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new DOALL());
+      }
+    }); // ** for -O0
+
+} // namespace arcana::noelle
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_TOOLS_FIXED_POINT_FIXEDPOINT_H_
+#define NOELLE_SRC_TOOLS_FIXED_POINT_FIXEDPOINT_H_
+
+#include "llvm/ADT/Hashing.h"
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/Noelle.hpp"
+#include "noelle/tools/LoopInvariantCodeMotion.hpp"
+#include "noelle/tools/SCEVSimplification.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Run the loop enablers (LICM, SCEV simplification, whilifier, and
+ * distribution) within a single process until the code stops changing.
+ *
+ * At every iteration, only the functions modified by the previous iteration
+ * are considered again, and only their dependences are updated.
+ */
+class FixedPoint : public ModulePass {
+public:
+  /*
+   * Class fields
+   */
+  static char ID;
+
+  /*
+   * Methods
+   */
+  FixedPoint();
+
+  bool doInitialization(Module &M) override;
+
+  bool runOnModule(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+private:
+  /*
+   * Fields
+   */
+  bool enableFixedPoint;
+  bool enableNormalization;
+  uint32_t maximumIterations;
+  uint64_t nextLoopID;
+
+  /*
+   * Methods
+   */
+  bool applyEnablers(Noelle &noelle,
+                     Function &F,
+                     LoopInvariantCodeMotion &licm,
+                     SCEVSimplification &scevSimplifier);
+
+  bool applyEnablers(Noelle &noelle,
+                     LoopContent *loop,
+                     LoopInvariantCodeMotion &licm,
+                     SCEVSimplification &scevSimplifier);
+
+  bool applyLoopDistribution(Noelle &noelle, LoopContent *loop);
+
+  void normalize(Function &F);
+
+  void normalize(Module &M);
+
+  void assignLoopIDs(Function &F);
+
+  static uint64_t fetchNextLoopID(Module &M);
+
+  static std::vector<Value *> fetchValues(Function &F);
+
+  static hash_code computeFingerprint(Function &F);
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_TOOLS_FIXED_POINT_FIXEDPOINT_H_
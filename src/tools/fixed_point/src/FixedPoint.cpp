@@ -0,0 +1,313 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/FunctionAttrs.h"
+#include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Utils.h"
+#include "llvm/Transforms/Utils/UnifyFunctionExitNodes.h"
+
+#include "noelle/tools/FixedPoint.hpp"
+
+namespace arcana::noelle {
+
+FixedPoint::FixedPoint()
+  : ModulePass{ ID },
+    enableFixedPoint{ true },
+    enableNormalization{ true },
+    maximumIterations{ 0 },
+    nextLoopID{ 0 } {
+  return;
+}
+
+bool FixedPoint::runOnModule(Module &M) {
+
+  /*
+   * Check if the fixed point has been enabled.
+   */
+  if (!this->enableFixedPoint) {
+    return false;
+  }
+
+  /*
+   * Fetch NOELLE.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  auto verbosity = noelle.getVerbosity();
+  if (verbosity != Verbosity::Disabled) {
+    errs() << "FixedPoint: Start\n";
+  }
+
+  /*
+   * Allocate the enablers that keep no state across loops.
+   */
+  LoopInvariantCodeMotion licm{ noelle };
+  SCEVSimplification scevSimplifier{ noelle };
+
+  /*
+   * Fetch the functions that include the loops to consider.
+   * All of them are candidates of the first iteration.
+   */
+  std::vector<Function *> candidates;
+  std::set<Function *> functionsWithLoops;
+  auto loopStructures = noelle.getLoopStructures();
+  for (auto ls : *loopStructures) {
+    auto f = ls->getFunction();
+    if (functionsWithLoops.insert(f).second) {
+      candidates.push_back(f);
+    }
+  }
+  delete loopStructures;
+
+  /*
+   * Compute the PDG once.
+   * From now on, only the dependences of the modified functions are
+   * updated.
+   */
+  noelle.getProgramDependenceGraph();
+
+  /*
+   * Loops created by the enablers get IDs that follow the ones in use.
+   */
+  this->nextLoopID = FixedPoint::fetchNextLoopID(M);
+
+  /*
+   * Run the enablers until no function changes.
+   */
+  auto modified = false;
+  uint32_t iteration = 0;
+  while (!candidates.empty()) {
+    if ((this->maximumIterations > 0)
+        && (iteration == this->maximumIterations)) {
+      errs() << "FixedPoint:   The maximum number of iterations ("
+             << this->maximumIterations << ") has been reached\n";
+      break;
+    }
+    if (verbosity != Verbosity::Disabled) {
+      errs() << "FixedPoint:   Iteration " << iteration << " on "
+             << candidates.size() << " functions\n";
+    }
+
+    std::vector<Function *> modifiedFunctions;
+    for (auto f : candidates) {
+
+      /*
+       * Remember the code of @f before applying the enablers.
+       */
+      auto previousFingerprint = FixedPoint::computeFingerprint(*f);
+
+      /*
+       * Apply the enablers.
+       * They keep the dependences of @f up to date.
+       */
+      if (!this->applyEnablers(noelle, *f, licm, scevSimplifier)) {
+        continue;
+      }
+
+      /*
+       * Normalize @f.
+       * The normalization passes do not track their changes, so the
+       * dependences of @f are recomputed.
+       */
+      if (this->enableNormalization) {
+        auto valuesBeforeNormalization = FixedPoint::fetchValues(*f);
+        this->normalize(*f);
+        this->assignLoopIDs(*f);
+        noelle.recomputeDependencesOf(f, valuesBeforeNormalization);
+      }
+
+      /*
+       * Check whether the code of @f actually changed.
+       * If it didn't, @f has reached its fixed point even if an enabler claims
+       * otherwise.
+       */
+      if (FixedPoint::computeFingerprint(*f) == previousFingerprint) {
+        continue;
+      }
+      if (verbosity != Verbosity::Disabled) {
+        errs() << "FixedPoint:     " << f->getName() << " has been modified\n";
+      }
+      modifiedFunctions.push_back(f);
+      modified = true;
+    }
+
+    /*
+     * Finish the normalization with the module-level steps of noelle-norm.
+     */
+    if (this->enableNormalization && !modifiedFunctions.empty()) {
+      this->normalize(M);
+    }
+
+    /*
+     * Only the functions modified in this iteration can change in the next
+     * one: the code and the dependences of the others are the same.
+     */
+    candidates = std::move(modifiedFunctions);
+    iteration++;
+  }
+
+  if (verbosity != Verbosity::Disabled) {
+    errs() << "FixedPoint:   Iteration count = " << iteration << "\n";
+    errs() << "FixedPoint: Exit\n";
+  }
+
+  return modified;
+}
+
+void FixedPoint::normalize(Function &F) {
+
+  /*
+   * Bring @F back to the form NOELLE expects by running the function-level
+   * passes of noelle-norm.
+   */
+  legacy::FunctionPassManager fpm(F.getParent());
+  fpm.add(createPromoteMemoryToRegisterPass());
+  fpm.add(createCFGSimplificationPass());
+  fpm.add(createLowerSwitchPass());
+  fpm.add(createUnifyFunctionExitNodesPass());
+  fpm.add(createBreakCriticalEdgesPass());
+  fpm.add(createLoopSimplifyPass());
+  fpm.add(createLCSSAPass());
+  fpm.add(createIndVarSimplifyPass());
+  fpm.doInitialization();
+  fpm.run(F);
+  fpm.doFinalization();
+
+  return;
+}
+
+void FixedPoint::normalize(Module &M) {
+
+  /*
+   * Infer the attributes of the functions as noelle-norm does.
+   */
+  legacy::PassManager pm;
+  pm.add(createPostOrderFunctionAttrsLegacyPass());
+  pm.add(createReversePostOrderFunctionAttrsPass());
+  pm.run(M);
+
+  return;
+}
+
+void FixedPoint::assignLoopIDs(Function &F) {
+
+  /*
+   * Give an ID to the loops of @F created by the enablers (like
+   * noelle-meta-loop-embed does).
+   * The other loops keep theirs, so IDs stay the same across iterations.
+   * A copy of a loop (e.g., made by the distribution) might carry the ID of
+   * the original: the first loop in pre-order keeps it and the others get a
+   * new one.
+   */
+  DominatorTree DT(F);
+  LoopInfo LI(DT);
+  std::set<uint64_t> usedIDs;
+  for (auto loop : LI.getLoopsInPreorder()) {
+    LoopStructure ls{ loop };
+    auto loopID = ls.getID();
+    if (loopID && usedIDs.insert(*loopID).second) {
+      continue;
+    }
+    ls.setID(this->nextLoopID);
+    this->nextLoopID++;
+  }
+
+  return;
+}
+
+uint64_t FixedPoint::fetchNextLoopID(Module &M) {
+  uint64_t nextLoopID = 0;
+
+  for (auto &F : M) {
+    if (F.empty()) {
+      continue;
+    }
+    DominatorTree DT(F);
+    LoopInfo LI(DT);
+    for (auto loop : LI.getLoopsInPreorder()) {
+      LoopStructure ls{ loop };
+      auto loopID = ls.getID();
+      if (loopID) {
+        nextLoopID = std::max(nextLoopID, *loopID + 1);
+      }
+    }
+  }
+
+  return nextLoopID;
+}
+
+std::vector<Value *> FixedPoint::fetchValues(Function &F) {
+  std::vector<Value *> values;
+
+  for (auto &arg : F.args()) {
+    values.push_back(&arg);
+  }
+  for (auto &inst : instructions(F)) {
+    values.push_back(&inst);
+  }
+
+  return values;
+}
+
+hash_code FixedPoint::computeFingerprint(Function &F) {
+
+  /*
+   * Number the arguments, basic blocks, and instructions of @F in layout
+   * order.
+   * Operands are hashed by their number rather than their address, so the
+   * fingerprint only changes when the code does.
+   */
+  std::unordered_map<Value *, uint64_t> numbers;
+  uint64_t nextNumber = 0;
+  for (auto &arg : F.args()) {
+    numbers[&arg] = nextNumber++;
+  }
+  for (auto &bb : F) {
+    numbers[&bb] = nextNumber++;
+    for (auto &inst : bb) {
+      numbers[&inst] = nextNumber++;
+    }
+  }
+
+  /*
+   * Hash every instruction: its opcode, type, predicate, and operands.
+   * Constants and globals are uniqued, so their address is stable.
+   */
+  auto fingerprint = hash_value(nextNumber);
+  for (auto &inst : instructions(F)) {
+    fingerprint = hash_combine(fingerprint, inst.getOpcode(), inst.getType());
+    if (auto cmpInst = dyn_cast<CmpInst>(&inst)) {
+      fingerprint = hash_combine(fingerprint, cmpInst->getPredicate());
+    }
+    for (auto &op : inst.operands()) {
+      auto opNumber = numbers.find(op.get());
+      if (opNumber != numbers.end()) {
+        fingerprint = hash_combine(fingerprint, opNumber->second);
+      } else {
+        fingerprint = hash_combine(fingerprint, op.get());
+      }
+    }
+  }
+
+  return fingerprint;
+}
+
+} // namespace arcana::noelle
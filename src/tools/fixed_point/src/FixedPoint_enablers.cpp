@@ -0,0 +1,171 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopCarriedUnknownSCC.hpp"
+#include "noelle/tools/FixedPoint.hpp"
+
+namespace arcana::noelle {
+
+bool FixedPoint::applyEnablers(Noelle &noelle,
+                               Function &F,
+                               LoopInvariantCodeMotion &licm,
+                               SCEVSimplification &scevSimplifier) {
+
+  /*
+   * Fetch the IDs of the loops of @F.
+   * Every one of them is considered once; loops created by the enablers are
+   * considered in the next iteration.
+   */
+  std::set<uint64_t> loopsToConsider;
+  auto loopStructures = noelle.getLoopStructures(&F);
+  for (auto ls : *loopStructures) {
+    auto loopID = ls->getID();
+    assert(loopID);
+    loopsToConsider.insert(*loopID);
+  }
+  delete loopStructures;
+
+  /*
+   * Apply the enablers to one loop at a time starting from the hottest one.
+   * The enablers keep the dependences of @F up to date. Yet, once @F is
+   * modified, the contents of its loops are stale, so they are computed again
+   * before considering the remaining loops.
+   */
+  auto modified = false;
+  auto loopsAreStale = true;
+  while (loopsAreStale && !loopsToConsider.empty()) {
+    loopsAreStale = false;
+    auto loops = noelle.getLoopContents(&F);
+    noelle.sortByHotness(*loops);
+    for (auto loop : *loops) {
+      auto loopID = loop->getLoopStructure()->getID();
+      if (loopsToConsider.erase(*loopID) == 0) {
+        continue;
+      }
+      if (this->applyEnablers(noelle, loop, licm, scevSimplifier)) {
+        modified = true;
+        loopsAreStale = true;
+        break;
+      }
+    }
+
+    /*
+     * Free the memory.
+     */
+    for (auto loop : *loops) {
+      delete loop;
+    }
+    delete loops;
+
+    /*
+     * Give an ID to the loops created by the enablers, as NOELLE requires
+     * every loop to have one.
+     */
+    if (loopsAreStale) {
+      this->assignLoopIDs(F);
+    }
+  }
+
+  return modified;
+}
+
+bool FixedPoint::applyEnablers(Noelle &noelle,
+                               LoopContent *loop,
+                               LoopInvariantCodeMotion &licm,
+                               SCEVSimplification &scevSimplifier) {
+  auto ltm = loop->getLoopTransformationsManager();
+  auto isEnabled = [&noelle, ltm](Transformation t) -> bool {
+    return noelle.isTransformationEnabled(t) && ltm->isTransformationEnabled(t);
+  };
+
+  /*
+   * Hoist loop invariants and promote memory locations to registers.
+   */
+  if (isEnabled(LOOP_INVARIANT_CODE_MOTION_ID)
+      && licm.extractInvariantsFromLoop(*loop)) {
+    return true;
+  }
+
+  /*
+   * Simplify the computation that derives from induction variables.
+   * The simplification does not track its changes, so the dependences of the
+   * function are recomputed.
+   */
+  if (isEnabled(SCEV_SIMPLIFICATION_ID)) {
+    auto loopFunction = loop->getLoopStructure()->getFunction();
+    auto previousValues = FixedPoint::fetchValues(*loopFunction);
+    if (scevSimplifier.simplifyIVRelatedSCEVs(*loop)) {
+      noelle.recomputeDependencesOf(loopFunction, previousValues);
+      return true;
+    }
+  }
+
+  /*
+   * Transform the loop into a while loop.
+   */
+  if (isEnabled(LOOP_WHILIFIER_ID)
+      && noelle.getLoopTransformer().whilifyLoop(loop)) {
+    return true;
+  }
+
+  /*
+   * Pull sequential SCCs out of the loop.
+   */
+  if (isEnabled(LOOP_DISTRIBUTION_ID)
+      && this->applyLoopDistribution(noelle, loop)) {
+    return true;
+  }
+
+  return false;
+}
+
+bool FixedPoint::applyLoopDistribution(Noelle &noelle, LoopContent *loop) {
+
+  /*
+   * Fetch the SCCDAG of the loop.
+   */
+  auto sccManager = loop->getSCCManager();
+  auto sccdag = sccManager->getSCCDAG();
+
+  /*
+   * Try to move one SCC that must run sequentially to a separate loop.
+   * The loop transformer updates the dependences of the function.
+   */
+  auto &loopTransformer = noelle.getLoopTransformer();
+  auto modified = false;
+  sccdag->iterateOverSCCs([&](SCC *scc) -> bool {
+    auto sccInfo = sccManager->getSCCAttrs(scc);
+    if (!isa<LoopCarriedUnknownSCC>(sccInfo)) {
+      return false;
+    }
+    std::set<Instruction *> instructionsRemoved;
+    std::set<Instruction *> instructionsAdded;
+    modified = loopTransformer.splitLoop(loop,
+                                         { scc },
+                                         instructionsRemoved,
+                                         instructionsAdded);
+    return modified;
+  });
+
+  return modified;
+}
+
+} // namespace arcana::noelle
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/FixedPoint.hpp"
+
+namespace arcana::noelle {
+
+static cl::opt<bool> DisableFixedPoint(
+    "noelle-disable-fixed-point",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("Disable the in-process fixed point of the enablers"));
+
+static cl::opt<bool> DisableNormalization(
+    "noelle-fixed-point-disable-normalization",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("Do not normalize the functions modified by the enablers"));
+
+static cl::opt<uint32_t> MaximumIterations(
+    "noelle-fixed-point-max-iterations",
+    cl::init(0),
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("Maximum number of iterations (0 means no limit)"));
+
+bool FixedPoint::doInitialization(Module &M) {
+  this->enableFixedPoint =
+      (DisableFixedPoint.getNumOccurrences() == 0) ? true : false;
+  this->enableNormalization =
+      (DisableNormalization.getNumOccurrences() == 0) ? true : false;
+  this->maximumIterations = MaximumIterations.getValue();
+
+  return false;
+}
+
+void FixedPoint::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+
+  return;
+}
+
+// Next there is code to register your pass to "opt"
+char FixedPoint::ID = 0;
+static RegisterPass<FixedPoint> X(
+    "FixedPoint",
+    "Run the loop enablers until the code stops changing");
+
+// Next there is code to register your pass to "clang"
+static FixedPoint *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(PassManagerBuilder::EP_OptimizerLast,
+                                        [](const PassManagerBuilder &,
+                                           legacy::PassManagerBase &PM) {
+                                          if (!_PassMaker) {
+                                            PM.add(_PassMaker =
+                                                       new FixedPoint());
+                                          }
+                                        }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new FixedPoint());
+      }
+    }); // ** for -O0
+
+} // namespace arcana::noelle
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_TOOLS_HOT_COLD_SPLITTING_HOTCOLDSPLITTING_H_
+#define NOELLE_SRC_TOOLS_HOT_COLD_SPLITTING_HOTCOLDSPLITTING_H_
+
+#include "noelle/core/Noelle.hpp"
+#include "noelle/core/Outliner.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Outline the code of hot loops and hot functions that the profiles show as
+ * never or rarely executed (e.g., error paths) into cold functions.
+ *
+ * This shrinks the hot code, and it gives smaller loop bodies with fewer
+ * live-ins to the transformations that follow (e.g., the parallelizers).
+ */
+class HotColdSplitting : public ModulePass {
+public:
+  static char ID;
+
+  HotColdSplitting();
+
+  bool doInitialization(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool runOnModule(Module &M) override;
+
+  /*
+   * Return the basic blocks of @f that are cold within the hot loops @loops
+   * of @f and, if @f is hot, within @f.
+   */
+  std::unordered_set<BasicBlock *> getColdBasicBlocks(
+      Hot *profiles,
+      Function *f,
+      bool isFunctionHot,
+      std::vector<LoopStructure *> const &loops) const;
+
+  /*
+   * Group @coldBasicBlocks of @f into single-entry regions that can be
+   * outlined.
+   */
+  std::vector<std::unordered_set<BasicBlock *>> getColdRegions(
+      Function *f,
+      std::unordered_set<BasicBlock *> const &coldBasicBlocks,
+      DominatorSummary &DS) const;
+
+private:
+  double coldRatio;
+
+  const uint32_t minimumInstructionsToOutline = 3;
+
+  const std::string prefix = "HotColdSplitting: ";
+
+  bool isCold(Hot *profiles,
+              BasicBlock *bb,
+              uint64_t invocationsOfTheEntry) const;
+
+  uint64_t getNumberOfInstructions(
+      std::unordered_set<BasicBlock *> const &region) const;
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_TOOLS_HOT_COLD_SPLITTING_HOTCOLDSPLITTING_H_
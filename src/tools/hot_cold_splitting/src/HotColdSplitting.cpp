@@ -0,0 +1,179 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "llvm/ADT/PostOrderIterator.h"
+
+#include "noelle/tools/HotColdSplitting.hpp"
+
+namespace arcana::noelle {
+
+HotColdSplitting::HotColdSplitting() : ModulePass{ ID }, coldRatio{ 0.001 } {
+  return;
+}
+
+std::unordered_set<BasicBlock *> HotColdSplitting::getColdBasicBlocks(
+    Hot *profiles,
+    Function *f,
+    bool isFunctionHot,
+    std::vector<LoopStructure *> const &loops) const {
+  std::unordered_set<BasicBlock *> coldBasicBlocks;
+
+  /*
+   * Collect the basic blocks that are cold with respect to the invocations of
+   * the function.
+   */
+  if (isFunctionHot) {
+    auto entryInvocations = profiles->getInvocations(&f->getEntryBlock());
+    for (auto &bb : *f) {
+      if (this->isCold(profiles, &bb, entryInvocations)) {
+        coldBasicBlocks.insert(&bb);
+      }
+    }
+  }
+
+  /*
+   * Collect the basic blocks that are cold with respect to the iterations of
+   * the hot loops.
+   */
+  for (auto loop : loops) {
+    auto headerInvocations = profiles->getInvocations(loop->getHeader());
+    for (auto bb : loop->getBasicBlocks()) {
+      if (this->isCold(profiles, bb, headerInvocations)) {
+        coldBasicBlocks.insert(bb);
+      }
+    }
+  }
+
+  return coldBasicBlocks;
+}
+
+std::vector<std::unordered_set<BasicBlock *>> HotColdSplitting::
+    getColdRegions(Function *f,
+                   std::unordered_set<BasicBlock *> const &coldBasicBlocks,
+                   DominatorSummary &DS) const {
+  std::vector<std::unordered_set<BasicBlock *>> regions;
+
+  /*
+   * Visit the basic blocks in reverse post-order, so the entry of a region is
+   * visited before the rest of the region.
+   */
+  std::unordered_set<BasicBlock *> assigned;
+  ReversePostOrderTraversal<Function *> rpot(f);
+  for (auto entry : rpot) {
+    if (false || (coldBasicBlocks.count(entry) == 0)
+        || (assigned.count(entry) > 0) || (entry == &f->getEntryBlock())) {
+      continue;
+    }
+
+    /*
+     * Grow the region with the cold basic blocks dominated by its entry.
+     */
+    std::unordered_set<BasicBlock *> region;
+    std::queue<BasicBlock *> worklist;
+    worklist.push(entry);
+    while (!worklist.empty()) {
+      auto bb = worklist.front();
+      worklist.pop();
+      if (region.count(bb) > 0) {
+        continue;
+      }
+      region.insert(bb);
+      for (auto successor : successors(bb)) {
+        if (false || (coldBasicBlocks.count(successor) == 0)
+            || (assigned.count(successor) > 0)
+            || (!DS.DT.dominates(entry, successor))) {
+          continue;
+        }
+        worklist.push(successor);
+      }
+    }
+
+    /*
+     * Drop the basic blocks that can be reached without going through the
+     * entry of the region.
+     */
+    auto modified = true;
+    while (modified) {
+      modified = false;
+      for (auto bb : region) {
+        if (bb == entry) {
+          continue;
+        }
+        auto isReachableFromOutside = false;
+        for (auto predecessor : predecessors(bb)) {
+          if (region.count(predecessor) == 0) {
+            isReachableFromOutside = true;
+            break;
+          }
+        }
+        if (isReachableFromOutside) {
+          region.erase(bb);
+          modified = true;
+          break;
+        }
+      }
+    }
+
+    /*
+     * Keep the region only if outlining it can pay off the call.
+     */
+    assigned.insert(region.begin(), region.end());
+    if (this->getNumberOfInstructions(region)
+        < this->minimumInstructionsToOutline) {
+      continue;
+    }
+    regions.push_back(region);
+  }
+
+  return regions;
+}
+
+bool HotColdSplitting::isCold(Hot *profiles,
+                              BasicBlock *bb,
+                              uint64_t invocationsOfTheEntry) const {
+  if (!profiles->hasBeenExecuted(bb)) {
+    return true;
+  }
+  auto invocations = static_cast<double>(profiles->getInvocations(bb));
+  if (invocations <= (this->coldRatio * invocationsOfTheEntry)) {
+    return true;
+  }
+
+  return false;
+}
+
+uint64_t HotColdSplitting::getNumberOfInstructions(
+    std::unordered_set<BasicBlock *> const &region) const {
+  uint64_t instructions = 0;
+  for (auto bb : region) {
+    for (auto &inst : *bb) {
+      if (false || isa<PHINode>(&inst) || inst.isTerminator()
+          || isa<DbgInfoIntrinsic>(&inst)) {
+        continue;
+      }
+      instructions++;
+    }
+  }
+
+  return instructions;
+}
+
+} // namespace arcana::noelle
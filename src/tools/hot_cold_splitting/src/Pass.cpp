@@ -0,0 +1,180 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/HotColdSplitting.hpp"
+
+static cl::opt<double> ColdRatio(
+    "noelle-hot-cold-ratio",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("Maximum ratio between the invocations of a cold basic block and "
+             "the ones of its loop header or function entry"));
+
+namespace arcana::noelle {
+
+bool HotColdSplitting::doInitialization(Module &M) {
+
+  /*
+   * Fetch the ratio that defines cold code.
+   */
+  if (ColdRatio.getNumOccurrences() > 0) {
+    this->coldRatio = ColdRatio.getValue();
+  }
+
+  return false;
+}
+
+void HotColdSplitting::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+
+  return;
+}
+
+bool HotColdSplitting::runOnModule(Module &M) {
+
+  /*
+   * Fetch NOELLE.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  auto verbose = noelle.getVerbosity() > Verbosity::Disabled;
+  if (verbose) {
+    errs() << this->prefix << "Start\n";
+  }
+
+  /*
+   * Check the profiles are available.
+   */
+  auto profiles = noelle.getProfiles();
+  if (!profiles->isAvailable()) {
+    if (verbose) {
+      errs() << this->prefix << "  Profiles are not available\n";
+      errs() << this->prefix << "Exit\n";
+    }
+    return false;
+  }
+
+  /*
+   * Fetch the hot loops and organize them per function.
+   */
+  auto loopStructures = noelle.getLoopStructures();
+  std::unordered_map<Function *, std::vector<LoopStructure *>> hotLoops;
+  for (auto ls : *loopStructures) {
+    hotLoops[ls->getFunction()].push_back(ls);
+  }
+
+  /*
+   * Outline the cold code of every function.
+   */
+  auto modified = false;
+  uint32_t outlinedRegions = 0;
+  uint64_t outlinedInstructions = 0;
+  auto minimumHotness = noelle.getMinimumHotness();
+  auto fm = noelle.getFunctionsManager();
+  Outliner outliner;
+  for (auto &F : M) {
+    if (F.empty()) {
+      continue;
+    }
+
+    /*
+     * Fetch the cold code of the function.
+     */
+    auto isFunctionHot = (profiles->getDynamicTotalInstructionCoverage(&F)
+                          >= minimumHotness);
+    auto coldBasicBlocks =
+        this->getColdBasicBlocks(profiles, &F, isFunctionHot, hotLoops[&F]);
+    if (coldBasicBlocks.empty()) {
+      continue;
+    }
+    auto DS = noelle.getDominators(&F);
+    auto regions = this->getColdRegions(&F, coldBasicBlocks, *DS);
+    delete DS;
+
+    /*
+     * Outline the cold regions.
+     * The regions are disjoint, so outlining one of them does not affect the
+     * others.
+     */
+    for (auto &region : regions) {
+      auto instructions = this->getNumberOfInstructions(region);
+      auto coldFunction = outliner.outline(region, nullptr, *fm);
+      if (coldFunction == nullptr) {
+        continue;
+      }
+      coldFunction->addFnAttr(Attribute::Cold);
+      coldFunction->addFnAttr(Attribute::NoInline);
+      for (auto user : coldFunction->users()) {
+        if (auto call = dyn_cast<CallInst>(user)) {
+          call->addAttribute(AttributeList::FunctionIndex, Attribute::Cold);
+        }
+      }
+      modified = true;
+      outlinedRegions++;
+      outlinedInstructions += instructions;
+
+      if (verbose) {
+        errs() << this->prefix << "  Function \"" << F.getName() << "\": "
+               << instructions << " instructions outlined to \""
+               << coldFunction->getName() << "\"\n";
+      }
+    }
+  }
+  if (verbose) {
+    errs() << this->prefix << "  " << outlinedRegions << " cold regions ("
+           << outlinedInstructions << " instructions) outlined\n";
+  }
+
+  /*
+   * Free the memory.
+   */
+  delete loopStructures;
+
+  if (verbose) {
+    errs() << this->prefix << "Exit\n";
+  }
+
+  return modified;
+}
+
+// Next there is code to register your pass to "opt"
+char HotColdSplitting::ID = 0;
+static RegisterPass<HotColdSplitting> X(
+    "HotColdSplitting",
+    "Outline the cold code of hot loops and functions");
+
+// Next there is code to register your pass to "clang"
+static HotColdSplitting *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new HotColdSplitting());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new HotColdSplitting());
+      }
+    }); // ** for -O0
+
+} // namespace arcana::noelle
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_TOOLS_LOOP_FUSER_LOOPFUSER_H_
+#define NOELLE_SRC_TOOLS_LOOP_FUSER_LOOPFUSER_H_
+
+#include "noelle/core/Noelle.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Fuse adjacent loops that iterate the same number of times when this
+ * preserves their dependences.
+ *
+ * When profiles are available, the tool reports an estimate of the bytes that
+ * the fused loops do not bring back from memory.
+ */
+class LoopFuser : public ModulePass {
+public:
+  static char ID;
+
+  LoopFuser();
+
+  bool doInitialization(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool runOnModule(Module &M) override;
+
+  /*
+   * Fuse a pair of adjacent loops of @f.
+   * @bytesSaved is increased by the estimated bytes saved by the fusion.
+   */
+  bool fuseAdjacentLoopsOf(Noelle &noelle, Function *f, uint64_t &bytesSaved);
+
+private:
+  const std::string prefix = "LoopFuser: ";
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_TOOLS_LOOP_FUSER_LOOPFUSER_H_
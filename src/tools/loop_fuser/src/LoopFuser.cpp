@@ -0,0 +1,119 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/LoopFuser.hpp"
+
+namespace arcana::noelle {
+
+LoopFuser::LoopFuser() : ModulePass{ ID } {
+  return;
+}
+
+bool LoopFuser::fuseAdjacentLoopsOf(Noelle &noelle,
+                                    Function *f,
+                                    uint64_t &bytesSaved) {
+  auto verbose = noelle.getVerbosity() > Verbosity::Disabled;
+
+  /*
+   * Fetch the loops of @f.
+   */
+  auto loopStructures = noelle.getLoopStructures(f);
+  std::unordered_map<BasicBlock *, LoopStructure *> preHeaderToLoop;
+  for (auto ls : *loopStructures) {
+    preHeaderToLoop[ls->getPreHeader()] = ls;
+  }
+
+  /*
+   * Fuse the first pair of adjacent loops that can be fused.
+   * The second loop of a pair starts where the first loop exits.
+   */
+  auto &transformer = noelle.getLoopTransformer();
+  auto fused = false;
+  for (auto ls : *loopStructures) {
+    auto exitBlocks = ls->getLoopExitBasicBlocks();
+    if (exitBlocks.size() != 1) {
+      continue;
+    }
+    if (preHeaderToLoop.find(exitBlocks[0]) == preHeaderToLoop.end()) {
+      continue;
+    }
+    auto nextLS = preHeaderToLoop[exitBlocks[0]];
+
+    /*
+     * Estimate the benefits of the fusion before the loops change.
+     */
+    auto first = noelle.getLoopContent(ls);
+    auto second = noelle.getLoopContent(nextLS);
+    auto bytes = transformer.estimateBytesSavedByFusion(first,
+                                                        second,
+                                                        noelle.getProfiles());
+    if (verbose) {
+      auto firstInst = ls->getHeader()->getFirstNonPHI();
+      errs() << this->prefix << "  Loop \"" << *firstInst
+             << "\" is followed by an adjacent loop\n";
+    }
+
+    /*
+     * Fuse the loops.
+     */
+    std::set<Instruction *> instructionsRemoved;
+    std::set<Instruction *> instructionsAdded;
+    std::set<Instruction *> instructionsMoved;
+    fused = transformer.fuseLoops(first,
+                                  second,
+                                  instructionsRemoved,
+                                  instructionsAdded,
+                                  instructionsMoved);
+    delete first;
+    delete second;
+    if (!fused) {
+      if (verbose) {
+        errs() << this->prefix << "    The loops cannot be fused\n";
+      }
+      continue;
+    }
+    if (verbose) {
+      errs() << this->prefix << "    The loops have been fused (" << bytes
+             << " bytes saved)\n";
+    }
+    bytesSaved += bytes;
+
+    /*
+     * Update the dependences of @f.
+     * The loops of @f are now stale, so fusing more of them requires to
+     * fetch them again.
+     */
+    noelle.updateDependencesOf(f,
+                               instructionsRemoved,
+                               instructionsAdded,
+                               instructionsMoved);
+    break;
+  }
+
+  /*
+   * Free the memory.
+   */
+  delete loopStructures;
+
+  return fused;
+}
+
+} // namespace arcana::noelle
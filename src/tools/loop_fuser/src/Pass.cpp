@@ -0,0 +1,99 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/LoopFuser.hpp"
+
+namespace arcana::noelle {
+
+bool LoopFuser::doInitialization(Module &M) {
+  return false;
+}
+
+void LoopFuser::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+
+  return;
+}
+
+bool LoopFuser::runOnModule(Module &M) {
+
+  /*
+   * Fetch NOELLE.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  auto verbose = noelle.getVerbosity() > Verbosity::Disabled;
+  if (verbose) {
+    errs() << this->prefix << "Start\n";
+  }
+
+  /*
+   * Fuse the adjacent loops of every function until no more pairs can be
+   * fused.
+   */
+  auto modified = false;
+  uint32_t fusions = 0;
+  uint64_t bytesSaved = 0;
+  for (auto &F : M) {
+    if (F.empty()) {
+      continue;
+    }
+    while (this->fuseAdjacentLoopsOf(noelle, &F, bytesSaved)) {
+      modified = true;
+      fusions++;
+    }
+  }
+  if (verbose) {
+    errs() << this->prefix << "  " << fusions << " loops fused\n";
+    if (noelle.getProfiles()->isAvailable()) {
+      errs() << this->prefix << "  " << bytesSaved
+             << " bytes are estimated to be no longer loaded from memory\n";
+    }
+  }
+
+  if (verbose) {
+    errs() << this->prefix << "Exit\n";
+  }
+
+  return modified;
+}
+
+// Next there is code to register your pass to "opt"
+char LoopFuser::ID = 0;
+static RegisterPass<LoopFuser> X("LoopFuser", "Fuse adjacent loops");
+
+// Next there is code to register your pass to "clang"
+static LoopFuser *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopFuser());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopFuser());
+      }
+    }); // ** for -O0
+
+} // namespace arcana::noelle
@@ -19,6 +19,7 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include "noelle/core/Utils.hpp"
 #include "noelle/tools/LoopInvariantCodeMotion.hpp"
 #include "Mem2RegNonAlloca.hpp"
 
@@ -31,10 +32,38 @@ LoopInvariantCodeMotion::LoopInvariantCodeMotion(Noelle &noelle)
 
 bool LoopInvariantCodeMotion::promoteMemoryLocationsToRegisters(
     LoopContent const &LDI) {
-  Mem2RegNonAlloca mem2Reg(LDI, this->noelle);
+  auto loopFunction = LDI.getLoopStructure()->getFunction();
+
+  /*
+   * Remember the code before promoting memory locations.
+   */
+  auto handles = Utils::fetchInstructionHandles(*loopFunction);
 
+  /*
+   * Promote memory locations.
+   */
+  Mem2RegNonAlloca mem2Reg(LDI, this->noelle);
   auto result = mem2Reg.promoteMemoryToRegister();
 
+  /*
+   * Update the dependences of the function.
+   * The users of the promoted loads now use new PHIs, which makes the update
+   * recompute all the dependences of the function.
+   */
+  if (result) {
+    std::set<Instruction *> instructionsRemoved;
+    std::set<Instruction *> instructionsAdded;
+    std::set<Instruction *> instructionsMoved;
+    Utils::diffInstructions(*loopFunction,
+                            handles,
+                            instructionsRemoved,
+                            instructionsAdded);
+    this->noelle.updateDependencesOf(loopFunction,
+                                     instructionsRemoved,
+                                     instructionsAdded,
+                                     instructionsMoved);
+  }
+
   return result;
 }
 
@@ -45,8 +74,7 @@ bool LoopInvariantCodeMotion::extractInvariantsFromLoop(
     return true;
   }
 
-  Mem2RegNonAlloca mem2Reg(LDI, noelle);
-  if (mem2Reg.promoteMemoryToRegister()) {
+  if (this->promoteMemoryLocationsToRegisters(LDI)) {
     return true;
   }
 
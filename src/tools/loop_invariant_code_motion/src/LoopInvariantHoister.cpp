@@ -48,6 +48,7 @@ bool LoopInvariantCodeMotion::hoistInvariantValues(LoopContent const &LDI) {
   std::vector<Instruction *> instructionsToHoistToPreheader{};
   std::map<Instruction *, std::set<Instruction *>> conditionalHoisting{};
   std::unordered_set<PHINode *> phisToRemove{};
+  std::set<Instruction *> instructionsMoved{};
   for (auto B : loopStructure->getBasicBlocks()) {
     for (auto &I : *B) {
 
@@ -214,6 +215,9 @@ bool LoopInvariantCodeMotion::hoistInvariantValues(LoopContent const &LDI) {
       std::unordered_set<User *> users(phi->user_begin(), phi->user_end());
       for (auto user : users) {
         user->replaceUsesOfWith(phi, valueToReplacePHI);
+        if (auto userInst = dyn_cast<Instruction>(user)) {
+          instructionsMoved.insert(userInst);
+        }
         modified = true;
       }
       phisToRemove.insert(phi);
@@ -421,6 +425,25 @@ bool LoopInvariantCodeMotion::hoistInvariantValues(LoopContent const &LDI) {
     errs() << "LICM:   The loop has not been modified\n";
   }
 
+  /*
+   * Update the dependences of the function.
+   * The hoisted instructions and the users of the removed PHIs changed.
+   */
+  if (modified) {
+    std::set<Instruction *> instructionsRemoved(phisToRemove.begin(),
+                                                phisToRemove.end());
+    std::set<Instruction *> instructionsAdded{};
+    instructionsMoved.insert(instructionsToHoistToPreheader.begin(),
+                             instructionsToHoistToPreheader.end());
+    for (auto phi : phisToRemove) {
+      instructionsMoved.erase(phi);
+    }
+    this->noelle.updateDependencesOf(loopFunction,
+                                     instructionsRemoved,
+                                     instructionsAdded,
+                                     instructionsMoved);
+  }
+
   /*
    * Free the memory.
    */
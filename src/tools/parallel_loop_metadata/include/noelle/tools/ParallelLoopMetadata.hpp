@@ -0,0 +1,61 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_SRC_TOOLS_PARALLEL_LOOP_METADATA_PARALLELLOOPMETADATA_H_
+#define NOELLE_SRC_TOOLS_PARALLEL_LOOP_METADATA_PARALLELLOOPMETADATA_H_
+
+#include "noelle/core/Noelle.hpp"
+
+namespace arcana::noelle {
+
+/*
+ * Export the loops that NOELLE proves free of loop-carried memory dependences
+ * to LLVM.
+ *
+ * The memory instructions of such loops are added to an access group
+ * (llvm.access.group) and the loop ID (llvm.loop) lists this group in its
+ * llvm.loop.parallel_accesses property.
+ * The LLVM transformations that follow (e.g., the loop vectorizer) can then
+ * rely on dependences that their alias analyses cannot prove.
+ */
+class ParallelLoopMetadata : public ModulePass {
+public:
+  static char ID;
+
+  ParallelLoopMetadata();
+
+  bool doInitialization(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool runOnModule(Module &M) override;
+
+  bool hasLoopCarriedMemoryDependences(LoopContent *loop) const;
+
+  bool annotateLoop(LoopContent *loop);
+
+private:
+  const std::string prefix = "ParallelLoopMetadata: ";
+};
+
+} // namespace arcana::noelle
+
+#endif // NOELLE_SRC_TOOLS_PARALLEL_LOOP_METADATA_PARALLELLOOPMETADATA_H_
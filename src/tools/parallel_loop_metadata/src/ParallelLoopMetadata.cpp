@@ -0,0 +1,126 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "llvm/Analysis/VectorUtils.h"
+
+#include "noelle/tools/ParallelLoopMetadata.hpp"
+
+namespace arcana::noelle {
+
+ParallelLoopMetadata::ParallelLoopMetadata() : ModulePass{ ID } {
+  return;
+}
+
+bool ParallelLoopMetadata::hasLoopCarriedMemoryDependences(
+    LoopContent *loop) const {
+
+  /*
+   * Check the dependences that make SCCs loop-carried.
+   * Loop-carried dependences through registers are still allowed as the
+   * metadata only describes memory accesses.
+   */
+  auto sccManager = loop->getSCCManager();
+  for (auto scc : sccManager->getSCCsWithLoopCarriedDependencies()) {
+    for (auto dep : scc->getLoopCarriedDependences()) {
+      if (isa<MemoryDependence<Value, Value>>(dep)) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+bool ParallelLoopMetadata::annotateLoop(LoopContent *loop) {
+
+  /*
+   * Fetch the instructions of the loop that access memory.
+   * This includes the ones of the sub-loops.
+   */
+  auto ls = loop->getLoopStructure();
+  std::vector<Instruction *> memoryInstructions;
+  for (auto bb : ls->getBasicBlocks()) {
+    for (auto &inst : *bb) {
+      if (inst.mayReadOrWriteMemory()) {
+        memoryInstructions.push_back(&inst);
+      }
+    }
+  }
+  if (memoryInstructions.size() == 0) {
+    return false;
+  }
+
+  /*
+   * Add the memory instructions to a new access group.
+   * An instruction can belong to the groups of all loops that contain it.
+   */
+  auto &context = ls->getHeader()->getContext();
+  auto accessGroup = MDNode::getDistinct(context, {});
+  for (auto inst : memoryInstructions) {
+    auto groups = inst->getMetadata(LLVMContext::MD_access_group);
+    inst->setMetadata(LLVMContext::MD_access_group,
+                      uniteAccessGroups(groups, accessGroup));
+  }
+
+  /*
+   * Fetch the current properties of the loop.
+   * The loop ID is attached to the terminators of all latches.
+   */
+  auto latches = ls->getLatches();
+  MDNode *currentLoopID = nullptr;
+  for (auto latch : latches) {
+    auto loopID = latch->getTerminator()->getMetadata(LLVMContext::MD_loop);
+    if (loopID != nullptr) {
+      currentLoopID = loopID;
+      break;
+    }
+  }
+
+  /*
+   * Create the new loop ID.
+   * The first operand of a loop ID is the loop ID itself.
+   */
+  SmallVector<Metadata *, 4> properties;
+  properties.push_back(nullptr);
+  if (currentLoopID != nullptr) {
+    for (auto i = 1u; i < currentLoopID->getNumOperands(); i++) {
+      properties.push_back(currentLoopID->getOperand(i));
+    }
+  }
+  Metadata *parallelAccesses[] = {
+    MDString::get(context, "llvm.loop.parallel_accesses"),
+    accessGroup
+  };
+  properties.push_back(MDNode::get(context, parallelAccesses));
+  auto newLoopID = MDNode::getDistinct(context, properties);
+  newLoopID->replaceOperandWith(0, newLoopID);
+
+  /*
+   * Attach the new loop ID.
+   */
+  for (auto latch : latches) {
+    latch->getTerminator()->setMetadata(LLVMContext::MD_loop, newLoopID);
+  }
+
+  return true;
+}
+
+} // namespace arcana::noelle
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/tools/ParallelLoopMetadata.hpp"
+
+namespace arcana::noelle {
+
+bool ParallelLoopMetadata::doInitialization(Module &M) {
+  return false;
+}
+
+void ParallelLoopMetadata::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+
+  return;
+}
+
+bool ParallelLoopMetadata::runOnModule(Module &M) {
+
+  /*
+   * Fetch NOELLE.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  auto verbose = noelle.getVerbosity() > Verbosity::Disabled;
+  if (verbose) {
+    errs() << this->prefix << "Start\n";
+  }
+
+  /*
+   * Fetch the loops.
+   */
+  auto loops = noelle.getLoopContents();
+
+  /*
+   * Annotate the loops without loop-carried memory dependences.
+   * Only metadata is added, so the dependences computed for the other loops
+   * remain valid.
+   */
+  auto modified = false;
+  uint32_t annotatedLoops = 0;
+  for (auto loop : *loops) {
+    if (this->hasLoopCarriedMemoryDependences(loop)) {
+      continue;
+    }
+    if (!this->annotateLoop(loop)) {
+      continue;
+    }
+    modified = true;
+    annotatedLoops++;
+
+    if (verbose) {
+      auto ls = loop->getLoopStructure();
+      auto firstInst = ls->getHeader()->getFirstNonPHI();
+      errs() << this->prefix << "  Loop \"" << *firstInst
+             << "\" has parallel accesses\n";
+    }
+  }
+  if (verbose) {
+    errs() << this->prefix << "  " << annotatedLoops << " out of "
+           << loops->size() << " loops annotated\n";
+  }
+
+  /*
+   * Free the memory.
+   */
+  for (auto loop : *loops) {
+    delete loop;
+  }
+  delete loops;
+
+  if (verbose) {
+    errs() << this->prefix << "Exit\n";
+  }
+
+  return modified;
+}
+
+// Next there is code to register your pass to "opt"
+char ParallelLoopMetadata::ID = 0;
+static RegisterPass<ParallelLoopMetadata> X(
+    "ParallelLoopMetadata",
+    "Export loops without loop-carried memory dependences to LLVM");
+
+// Next there is code to register your pass to "clang"
+// The pass runs before the vectorizer, which is the main client of the
+// metadata.
+static ParallelLoopMetadata *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_VectorizerStart,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new ParallelLoopMetadata());
+      }
+    }); // ** for -Ox
+
+} // namespace arcana::noelle
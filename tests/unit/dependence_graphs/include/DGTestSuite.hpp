@@ -69,8 +69,19 @@ private:
                                                    TestSuite &suite);
   static Values sccdagExternalNodesOfOutermostLoop(ModulePass &pass,
                                                    TestSuite &suite);
+  static Values pdgUpdatedAfterAddingAnInstruction(ModulePass &pass,
+                                                   TestSuite &suite);
+  static Values pdgUpdatedAfterChangingOperands(ModulePass &pass,
+                                                TestSuite &suite);
+  static Values pdgUpdatedAfterRemovingAnInstruction(ModulePass &pass,
+                                                     TestSuite &suite);
 
   Values getSCCValues(std::set<SCC *> sccs);
+  Values getEdgeValues(PDG *dg);
+  void rebuildPDG(void);
+  Values getMismatchesWithPDGBuiltFromScratch(void);
+  Instruction *getInstructionToDuplicate(void);
+  std::set<Instruction *> redirectUsers(Instruction *from, Instruction *to);
 
   TestSuite *suite;
   Module *M;
@@ -54,7 +54,10 @@ const char *DGTestSuite::tests[] = {
   "pdg leaf values",
   "pdg disjoint values",
   "sccdag internal nodes (of outermost loop)",
-  "sccdag external nodes (of outermost loop)"
+  "sccdag external nodes (of outermost loop)",
+  "pdg edges updated after adding an instruction",
+  "pdg edges updated after changing operands",
+  "pdg edges updated after removing an instruction"
 };
 
 TestFunction DGTestSuite::testFns[] = {
@@ -65,7 +68,10 @@ TestFunction DGTestSuite::testFns[] = {
   DGTestSuite::pdgIdentifiesLeafValues,
   DGTestSuite::pdgIdentifiesDisconnectedValueSets,
   DGTestSuite::sccdagInternalNodesOfOutermostLoop,
-  DGTestSuite::sccdagExternalNodesOfOutermostLoop
+  DGTestSuite::sccdagExternalNodesOfOutermostLoop,
+  DGTestSuite::pdgUpdatedAfterAddingAnInstruction,
+  DGTestSuite::pdgUpdatedAfterChangingOperands,
+  DGTestSuite::pdgUpdatedAfterRemovingAnInstruction
 };
 
 bool DGTestSuite::doInitialization(Module &M) {
@@ -118,18 +124,7 @@ Values DGTestSuite::pdgHasAllValuesInProgram(ModulePass &pass,
 Values DGTestSuite::pdgHasAllDGEdgesInProgram(ModulePass &pass,
                                               TestSuite &suite) {
   DGTestSuite &dgPass = static_cast<DGTestSuite &>(pass);
-  Values valueNames;
-  for (auto edge : dgPass.fdg->getEdges()) {
-    std::string outName = suite.valueToString(edge->getSrc());
-    std::string inName = suite.valueToString(edge->getDst());
-    std::string type =
-        isa<ControlDependence<Value, Value>>(edge)
-            ? "control"
-            : (isa<MemoryDependence<Value, Value>>(edge) ? "memory" : "data");
-    std::string delim = suite.orderedValueDelimiter;
-    valueNames.insert(outName + delim + inName + delim + type);
-  }
-  return valueNames;
+  return dgPass.getEdgeValues(dgPass.fdg);
 }
 
 Values DGTestSuite::ldgHasOnlyValuesOfLoop(ModulePass &pass, TestSuite &suite) {
@@ -224,3 +219,174 @@ Values DGTestSuite::getSCCValues(std::set<SCC *> sccs) {
   }
   return sccStrings;
 }
+
+Values DGTestSuite::getEdgeValues(PDG *dg) {
+  Values valueNames;
+  for (auto edge : dg->getEdges()) {
+    std::string outName = suite->valueToString(edge->getSrc());
+    std::string inName = suite->valueToString(edge->getDst());
+    std::string type =
+        isa<ControlDependence<Value, Value>>(edge)
+            ? "control"
+            : (isa<MemoryDependence<Value, Value>>(edge) ? "memory" : "data");
+    std::string delim = suite->orderedValueDelimiter;
+    valueNames.insert(outName + delim + inName + delim + type);
+  }
+  return valueNames;
+}
+
+// Drop the PDG and build it again from the current code of the program.
+void DGTestSuite::rebuildPDG(void) {
+  auto &pdgGenerator = getAnalysis<PDGGenerator>();
+  pdgGenerator.releaseMemory();
+  pdgGenerator.getPDG();
+}
+
+// Return the edges of main that differ between the incrementally updated PDG
+// and a PDG built from scratch; the expected result is none.
+// The PDG built from scratch replaces the updated one.
+Values DGTestSuite::getMismatchesWithPDGBuiltFromScratch(void) {
+  auto &pdgGenerator = getAnalysis<PDGGenerator>();
+
+  auto updatedFDG = pdgGenerator.getPDG()->createFunctionSubgraph(*mainF);
+  auto updatedEdges = getEdgeValues(updatedFDG);
+  delete updatedFDG;
+
+  rebuildPDG();
+  auto scratchFDG = pdgGenerator.getPDG()->createFunctionSubgraph(*mainF);
+  auto scratchEdges = getEdgeValues(scratchFDG);
+  delete scratchFDG;
+
+  Values mismatches;
+  for (auto edge : updatedEdges) {
+    if (scratchEdges.find(edge) == scratchEdges.end()) {
+      mismatches.insert(edge);
+    }
+  }
+  for (auto edge : scratchEdges) {
+    if (updatedEdges.find(edge) == updatedEdges.end()) {
+      mismatches.insert(edge);
+    }
+  }
+  return mismatches;
+}
+
+// Return the first load or binary operator of the outermost loop of main whose
+// users are neither PHIs nor terminators, so duplicating it and redirecting
+// its users leave the control flow untouched.
+Instruction *DGTestSuite::getInstructionToDuplicate(void) {
+  auto &LI = getAnalysis<LoopInfoWrapperPass>(*mainF).getLoopInfo();
+  auto l = LI.getLoopsInPreorder()[0];
+  for (auto bb : l->getBlocks()) {
+    for (auto &inst : *bb) {
+      if (!isa<LoadInst>(&inst) && !isa<BinaryOperator>(&inst)) {
+        continue;
+      }
+      auto canBeDuplicated = inst.getNumUses() > 0;
+      for (auto user : inst.users()) {
+        if (isa<PHINode>(user) || cast<Instruction>(user)->isTerminator()) {
+          canBeDuplicated = false;
+        }
+      }
+      if (canBeDuplicated) {
+        return &inst;
+      }
+    }
+  }
+  return nullptr;
+}
+
+// Make the users of @from use @to instead; return these users.
+std::set<Instruction *> DGTestSuite::redirectUsers(Instruction *from,
+                                                   Instruction *to) {
+  std::set<Instruction *> users;
+  for (auto user : from->users()) {
+    if (user != to) {
+      users.insert(cast<Instruction>(user));
+    }
+  }
+  for (auto user : users) {
+    user->replaceUsesOfWith(from, to);
+  }
+  return users;
+}
+
+Values DGTestSuite::pdgUpdatedAfterAddingAnInstruction(ModulePass &pass,
+                                                       TestSuite &suite) {
+  DGTestSuite &dgPass = static_cast<DGTestSuite &>(pass);
+  auto original = dgPass.getInstructionToDuplicate();
+  if (original == nullptr) {
+    return Values();
+  }
+
+  // Add a copy of the original instruction and make its users use the copy.
+  auto copy = original->clone();
+  copy->insertAfter(original);
+  auto users = dgPass.redirectUsers(original, copy);
+
+  dgPass.getAnalysis<PDGGenerator>().updateDependencesOfFunction(*dgPass.mainF,
+                                                                 {},
+                                                                 { copy },
+                                                                 users);
+  auto mismatches = dgPass.getMismatchesWithPDGBuiltFromScratch();
+
+  // Restore main.
+  dgPass.redirectUsers(copy, original);
+  copy->eraseFromParent();
+  dgPass.rebuildPDG();
+
+  return mismatches;
+}
+
+Values DGTestSuite::pdgUpdatedAfterChangingOperands(ModulePass &pass,
+                                                    TestSuite &suite) {
+  DGTestSuite &dgPass = static_cast<DGTestSuite &>(pass);
+  auto original = dgPass.getInstructionToDuplicate();
+  if (original == nullptr) {
+    return Values();
+  }
+
+  // Add a copy of the original instruction that nothing uses yet.
+  auto copy = original->clone();
+  copy->insertAfter(original);
+  dgPass.rebuildPDG();
+
+  // Make the users of the original instruction use the copy.
+  auto users = dgPass.redirectUsers(original, copy);
+
+  dgPass.getAnalysis<PDGGenerator>().updateDependencesOfFunction(*dgPass.mainF,
+                                                                 {},
+                                                                 {},
+                                                                 users);
+  auto mismatches = dgPass.getMismatchesWithPDGBuiltFromScratch();
+
+  // Restore main.
+  dgPass.redirectUsers(copy, original);
+  copy->eraseFromParent();
+  dgPass.rebuildPDG();
+
+  return mismatches;
+}
+
+Values DGTestSuite::pdgUpdatedAfterRemovingAnInstruction(ModulePass &pass,
+                                                         TestSuite &suite) {
+  DGTestSuite &dgPass = static_cast<DGTestSuite &>(pass);
+  auto original = dgPass.getInstructionToDuplicate();
+  if (original == nullptr) {
+    return Values();
+  }
+
+  // Add a copy of the original instruction that nothing uses.
+  auto copy = original->clone();
+  copy->insertAfter(original);
+  dgPass.rebuildPDG();
+
+  // Remove the copy.
+  copy->eraseFromParent();
+
+  dgPass.getAnalysis<PDGGenerator>().updateDependencesOfFunction(*dgPass.mainF,
+                                                                 { copy },
+                                                                 {},
+                                                                 {});
+  return dgPass.getMismatchesWithPDGBuiltFromScratch();
+}
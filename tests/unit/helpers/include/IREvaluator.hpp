@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016 - 2019  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/DataLayout.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace llvm;
+using namespace std;
+
+namespace parallelizertests {
+
+  /*
+   * Interpreter of the integer subset of the IR (e.g., loops over arrays of
+   * integers and calls to the functions of the module).
+   *
+   * It is used by unit tests to check that a transformation preserves the
+   * semantics of a function: the function is evaluated before and after the
+   * transformation, and the memory of the global variables is compared.
+   *
+   * Every run starts from the same memory: global variables are filled with a
+   * pattern that depends only on their position in the module.
+   */
+  class IREvaluator {
+   public:
+
+    IREvaluator (Module &M);
+
+    /*
+     * Run @F with @arguments.
+     * Return false if @F uses code that is not supported or if it does not
+     * return within @maximumSteps instructions.
+     */
+    bool run (Function &F, std::vector<uint64_t> const &arguments, uint64_t maximumSteps = 100000000);
+
+    /*
+     * Bytes of @global at the end of the last run.
+     */
+    std::vector<uint8_t> getMemoryOf (GlobalVariable *global) ;
+
+    /*
+     * Value returned by the last run.
+     */
+    uint64_t getReturnValue (void) const ;
+
+    std::string getError (void) const ;
+
+   private:
+
+    void initializeMemory (void) ;
+
+    bool runFunction (Function &F, std::vector<uint64_t> const &arguments, uint64_t &result) ;
+
+    bool call (CallInst *call, std::vector<uint64_t> const &arguments, uint64_t &result) ;
+
+    bool allocate (AllocaInst *alloca, uint64_t elements, uint64_t &address) ;
+
+    bool execute (Instruction *inst) ;
+
+    bool evaluate (Value *value, uint64_t &result) ;
+
+    bool load (uint64_t address, uint64_t bytes, uint64_t &result) ;
+
+    bool store (uint64_t address, uint64_t bytes, uint64_t value) ;
+
+    bool computeGEPOffset (GetElementPtrInst *gep, uint64_t &offset) ;
+
+    bool fail (std::string const &error) ;
+
+    uint64_t getBitWidth (Type *type) const ;
+
+    uint64_t truncate (uint64_t value, Type *type) const ;
+
+    static int64_t signExtend (uint64_t value, uint64_t bitWidth) ;
+
+    Module &M;
+    const DataLayout &DL;
+    std::vector<uint8_t> memory;
+    std::unordered_map<GlobalVariable *, std::pair<uint64_t, uint64_t>> globals;
+    std::unordered_map<Value *, uint64_t> frame;
+    uint64_t globalsEnd;
+    uint64_t stackTop;
+    uint64_t steps;
+    uint64_t maximumSteps;
+    uint64_t returnValue;
+    std::string error;
+  };
+
+}
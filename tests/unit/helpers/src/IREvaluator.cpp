@@ -0,0 +1,546 @@
+/*
+ * Copyright 2016 - 2019  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/GetElementPtrTypeIterator.h"
+
+#include "IREvaluator.hpp"
+
+namespace parallelizertests {
+
+IREvaluator::IREvaluator (Module &M)
+  : M{M}, DL{M.getDataLayout()}, steps{0}, maximumSteps{0}, returnValue{0} {
+
+  /*
+   * Assign a memory region to every global variable.
+   * Address 0 is left for null pointers.
+   */
+  uint64_t nextAddress = 16;
+  for (auto &global : M.globals()) {
+    auto bytes = DL.getTypeAllocSize(global.getValueType());
+    this->globals[&global] = std::make_pair(nextAddress, bytes);
+    nextAddress += (bytes + 15) & ~((uint64_t)15);
+  }
+  this->memory.resize(nextAddress);
+  this->globalsEnd = nextAddress;
+  this->stackTop = nextAddress;
+
+  return ;
+}
+
+bool IREvaluator::run (Function &F, std::vector<uint64_t> const &arguments, uint64_t maximumSteps) {
+  this->initializeMemory();
+  this->frame.clear();
+  this->stackTop = this->globalsEnd;
+  this->steps = 0;
+  this->maximumSteps = maximumSteps;
+  this->returnValue = 0;
+  this->error.clear();
+
+  return this->runFunction(F, arguments, this->returnValue);
+}
+
+bool IREvaluator::runFunction (Function &F, std::vector<uint64_t> const &arguments, uint64_t &result) {
+  result = 0;
+
+  /*
+   * Bind the arguments.
+   */
+  if (F.empty()) {
+    return this->fail("call to a function without a body");
+  }
+  if (arguments.size() != F.arg_size()) {
+    return this->fail("wrong number of arguments");
+  }
+  auto argIndex = 0;
+  for (auto &arg : F.args()) {
+    this->frame[&arg] = this->truncate(arguments[argIndex++], arg.getType());
+  }
+
+  /*
+   * Run the basic blocks.
+   */
+  BasicBlock *previous = nullptr;
+  auto current = &F.getEntryBlock();
+  while (current != nullptr) {
+
+    /*
+     * The PHIs of a basic block are evaluated all together.
+     */
+    std::vector<std::pair<PHINode *, uint64_t>> phiValues;
+    for (auto &phi : current->phis()) {
+      auto index = (previous == nullptr) ? -1 : phi.getBasicBlockIndex(previous);
+      if (index < 0) {
+        return this->fail("PHI without a value for the predecessor");
+      }
+      uint64_t value;
+      if (!this->evaluate(phi.getIncomingValue(index), value)) {
+        return false;
+      }
+      phiValues.push_back(std::make_pair(&phi, value));
+    }
+    for (auto &pair : phiValues) {
+      this->frame[pair.first] = pair.second;
+    }
+
+    /*
+     * Run the rest of the basic block.
+     */
+    BasicBlock *next = nullptr;
+    for (auto &inst : *current) {
+      if (isa<PHINode>(&inst)) {
+        continue;
+      }
+      this->steps++;
+      if (this->steps > this->maximumSteps) {
+        return this->fail("too many steps");
+      }
+
+      if (auto br = dyn_cast<BranchInst>(&inst)) {
+        if (br->isUnconditional()) {
+          next = br->getSuccessor(0);
+          break;
+        }
+        uint64_t condition;
+        if (!this->evaluate(br->getCondition(), condition)) {
+          return false;
+        }
+        next = br->getSuccessor((condition != 0) ? 0 : 1);
+        break;
+      }
+
+      if (auto sw = dyn_cast<SwitchInst>(&inst)) {
+        uint64_t condition;
+        if (!this->evaluate(sw->getCondition(), condition)) {
+          return false;
+        }
+        next = sw->getDefaultDest();
+        for (auto &c : sw->cases()) {
+          if (c.getCaseValue()->getZExtValue() == condition) {
+            next = c.getCaseSuccessor();
+            break;
+          }
+        }
+        break;
+      }
+
+      if (auto ret = dyn_cast<ReturnInst>(&inst)) {
+        if (auto retValue = ret->getReturnValue()) {
+          return this->evaluate(retValue, result);
+        }
+        return true;
+      }
+
+      if (!this->execute(&inst)) {
+        return false;
+      }
+    }
+    if (next == nullptr) {
+      return this->fail("basic block without a supported terminator");
+    }
+    previous = current;
+    current = next;
+  }
+
+  return true;
+}
+
+bool IREvaluator::call (CallInst *call, std::vector<uint64_t> const &arguments, uint64_t &result) {
+
+  /*
+   * Only direct calls to the functions of the module are supported.
+   */
+  auto callee = dyn_cast<Function>(call->getCalledOperand()->stripPointerCasts());
+  if (callee == nullptr) {
+    return this->fail("indirect call");
+  }
+
+  /*
+   * The callee runs in its own frame, and its stack is released when it
+   * returns.
+   */
+  std::vector<uint64_t> calleeArguments(arguments.begin(), arguments.begin() + callee->arg_size());
+  auto callerFrame = std::move(this->frame);
+  auto callerStackTop = this->stackTop;
+  this->frame.clear();
+  auto executed = this->runFunction(*callee, calleeArguments, result);
+  this->frame = std::move(callerFrame);
+  this->stackTop = callerStackTop;
+
+  return executed;
+}
+
+bool IREvaluator::allocate (AllocaInst *alloca, uint64_t elements, uint64_t &address) {
+  auto bytes = DL.getTypeAllocSize(alloca->getAllocatedType()) * elements;
+  address = this->stackTop;
+  this->stackTop += (bytes + 15) & ~((uint64_t)15);
+  if (this->stackTop > this->memory.size()) {
+    this->memory.resize(this->stackTop);
+  }
+
+  return true;
+}
+
+std::vector<uint8_t> IREvaluator::getMemoryOf (GlobalVariable *global) {
+  std::vector<uint8_t> bytes;
+  if (this->globals.count(global) == 0) {
+    return bytes;
+  }
+  auto region = this->globals.at(global);
+  auto begin = this->memory.begin() + region.first;
+  bytes.insert(bytes.end(), begin, begin + region.second);
+
+  return bytes;
+}
+
+uint64_t IREvaluator::getReturnValue (void) const {
+  return this->returnValue;
+}
+
+std::string IREvaluator::getError (void) const {
+  return this->error;
+}
+
+void IREvaluator::initializeMemory (void) {
+  std::fill(this->memory.begin(), this->memory.end(), 0);
+
+  /*
+   * Fill the global variables with a pattern that depends only on their
+   * position in the module.
+   * The pattern is irregular, so both sides of the branches that depend on
+   * the values in memory are likely to run.
+   */
+  uint64_t globalIndex = 0;
+  for (auto &global : this->M.globals()) {
+    auto region = this->globals.at(&global);
+    for (uint64_t i = 0; i < region.second; i++) {
+      auto hash = ((i + 1) * 2654435761u) + (globalIndex * 40503u);
+      this->memory[region.first + i] = (uint8_t)(hash >> 16);
+    }
+    globalIndex++;
+  }
+
+  return ;
+}
+
+bool IREvaluator::execute (Instruction *inst) {
+
+  /*
+   * Debug information and lifetime markers do not affect the semantics.
+   */
+  if (isa<DbgInfoIntrinsic>(inst)) {
+    return true;
+  }
+  if (auto intrinsic = dyn_cast<IntrinsicInst>(inst)) {
+    if (false
+        || (intrinsic->getIntrinsicID() == Intrinsic::lifetime_start)
+        || (intrinsic->getIntrinsicID() == Intrinsic::lifetime_end)) {
+      return true;
+    }
+  }
+
+  /*
+   * Fetch the operands.
+   */
+  std::vector<uint64_t> ops;
+  for (auto &op : inst->operands()) {
+    if (isa<BasicBlock>(op.get())) {
+      continue;
+    }
+    uint64_t value;
+    if (!this->evaluate(op.get(), value)) {
+      return false;
+    }
+    ops.push_back(value);
+  }
+
+  uint64_t result = 0;
+  if (auto binOp = dyn_cast<BinaryOperator>(inst)) {
+    auto bits = this->getBitWidth(binOp->getType());
+    auto a = ops[0];
+    auto b = ops[1];
+    switch (binOp->getOpcode()) {
+      case Instruction::Add:
+        result = a + b;
+        break ;
+      case Instruction::Sub:
+        result = a - b;
+        break ;
+      case Instruction::Mul:
+        result = a * b;
+        break ;
+      case Instruction::And:
+        result = a & b;
+        break ;
+      case Instruction::Or:
+        result = a | b;
+        break ;
+      case Instruction::Xor:
+        result = a ^ b;
+        break ;
+      case Instruction::Shl:
+        result = (b >= bits) ? 0 : (a << b);
+        break ;
+      case Instruction::LShr:
+        result = (b >= bits) ? 0 : (a >> b);
+        break ;
+      case Instruction::AShr:
+        result = (uint64_t)(signExtend(a, bits) >> std::min<uint64_t>(b, bits - 1));
+        break ;
+      case Instruction::UDiv:
+      case Instruction::URem:
+        if (b == 0) {
+          return this->fail("division by zero");
+        }
+        result = (binOp->getOpcode() == Instruction::UDiv) ? (a / b) : (a % b);
+        break ;
+      case Instruction::SDiv:
+      case Instruction::SRem:
+        if (b == 0) {
+          return this->fail("division by zero");
+        }
+        result = (binOp->getOpcode() == Instruction::SDiv)
+          ? (uint64_t)(signExtend(a, bits) / signExtend(b, bits))
+          : (uint64_t)(signExtend(a, bits) % signExtend(b, bits));
+        break ;
+      default:
+        return this->fail("unsupported binary operator");
+    }
+
+  } else if (auto cmp = dyn_cast<ICmpInst>(inst)) {
+    auto bits = this->getBitWidth(cmp->getOperand(0)->getType());
+    auto a = ops[0];
+    auto b = ops[1];
+    auto sa = signExtend(a, bits);
+    auto sb = signExtend(b, bits);
+    switch (cmp->getPredicate()) {
+      case ICmpInst::ICMP_EQ:
+        result = (a == b);
+        break ;
+      case ICmpInst::ICMP_NE:
+        result = (a != b);
+        break ;
+      case ICmpInst::ICMP_UGT:
+        result = (a > b);
+        break ;
+      case ICmpInst::ICMP_UGE:
+        result = (a >= b);
+        break ;
+      case ICmpInst::ICMP_ULT:
+        result = (a < b);
+        break ;
+      case ICmpInst::ICMP_ULE:
+        result = (a <= b);
+        break ;
+      case ICmpInst::ICMP_SGT:
+        result = (sa > sb);
+        break ;
+      case ICmpInst::ICMP_SGE:
+        result = (sa >= sb);
+        break ;
+      case ICmpInst::ICMP_SLT:
+        result = (sa < sb);
+        break ;
+      case ICmpInst::ICMP_SLE:
+        result = (sa <= sb);
+        break ;
+      default:
+        return this->fail("unsupported comparison");
+    }
+
+  } else if (auto castInst = dyn_cast<CastInst>(inst)) {
+    switch (castInst->getOpcode()) {
+      case Instruction::SExt:
+        result = (uint64_t)signExtend(ops[0], this->getBitWidth(castInst->getSrcTy()));
+        break ;
+      case Instruction::ZExt:
+      case Instruction::Trunc:
+      case Instruction::BitCast:
+      case Instruction::PtrToInt:
+      case Instruction::IntToPtr:
+        result = ops[0];
+        break ;
+      default:
+        return this->fail("unsupported cast");
+    }
+
+  } else if (isa<SelectInst>(inst)) {
+    result = (ops[0] != 0) ? ops[1] : ops[2];
+
+  } else if (auto gep = dyn_cast<GetElementPtrInst>(inst)) {
+    uint64_t offset;
+    if (!this->computeGEPOffset(gep, offset)) {
+      return false;
+    }
+    result = ops[0] + offset;
+
+  } else if (auto alloca = dyn_cast<AllocaInst>(inst)) {
+    if (!this->allocate(alloca, ops[0], result)) {
+      return false;
+    }
+
+  } else if (auto callInst = dyn_cast<CallInst>(inst)) {
+    if (!this->call(callInst, ops, result)) {
+      return false;
+    }
+    if (callInst->getType()->isVoidTy()) {
+      return true;
+    }
+
+  } else if (auto loadInst = dyn_cast<LoadInst>(inst)) {
+    auto bytes = DL.getTypeStoreSize(loadInst->getType());
+    if (!this->load(ops[0], bytes, result)) {
+      return false;
+    }
+
+  } else if (auto storeInst = dyn_cast<StoreInst>(inst)) {
+    auto bytes = DL.getTypeStoreSize(storeInst->getValueOperand()->getType());
+    return this->store(ops[1], bytes, ops[0]);
+
+  } else {
+    return this->fail("unsupported instruction " + std::string(inst->getOpcodeName()));
+  }
+
+  this->frame[inst] = this->truncate(result, inst->getType());
+
+  return true;
+}
+
+bool IREvaluator::evaluate (Value *value, uint64_t &result) {
+  if (this->frame.count(value) > 0) {
+    result = this->frame.at(value);
+    return true;
+  }
+
+  if (auto constInt = dyn_cast<ConstantInt>(value)) {
+    if (constInt->getBitWidth() > 64) {
+      return this->fail("unsupported integer width");
+    }
+    result = constInt->getZExtValue();
+    return true;
+  }
+  if (isa<ConstantPointerNull>(value) || isa<UndefValue>(value)) {
+    result = 0;
+    return true;
+  }
+  if (isa<Function>(value)) {
+
+    /*
+     * Functions are only called directly, so they do not need an address.
+     */
+    result = 0;
+    return true;
+  }
+  if (auto global = dyn_cast<GlobalVariable>(value)) {
+    if (this->globals.count(global) == 0) {
+      return this->fail("unknown global variable");
+    }
+    result = this->globals.at(global).first;
+    return true;
+  }
+
+  /*
+   * Constant expressions are evaluated as the instructions they represent.
+   */
+  if (auto constExpr = dyn_cast<ConstantExpr>(value)) {
+    auto inst = constExpr->getAsInstruction();
+    auto executed = this->execute(inst);
+    if (executed) {
+      result = this->frame.at(inst);
+      this->frame.erase(inst);
+    }
+    inst->deleteValue();
+    return executed;
+  }
+
+  return this->fail("value without a definition");
+}
+
+bool IREvaluator::load (uint64_t address, uint64_t bytes, uint64_t &result) {
+  if ((address == 0) || (bytes > 8) || ((address + bytes) > this->memory.size())) {
+    return this->fail("load out of bounds");
+  }
+  result = 0;
+  for (uint64_t i = 0; i < bytes; i++) {
+    result |= ((uint64_t)this->memory[address + i]) << (8 * i);
+  }
+
+  return true;
+}
+
+bool IREvaluator::store (uint64_t address, uint64_t bytes, uint64_t value) {
+  if ((address == 0) || (bytes > 8) || ((address + bytes) > this->memory.size())) {
+    return this->fail("store out of bounds");
+  }
+  for (uint64_t i = 0; i < bytes; i++) {
+    this->memory[address + i] = (uint8_t)(value >> (8 * i));
+  }
+
+  return true;
+}
+
+bool IREvaluator::computeGEPOffset (GetElementPtrInst *gep, uint64_t &offset) {
+  offset = 0;
+  for (auto GTI = gep_type_begin(gep), GTE = gep_type_end(gep); GTI != GTE; ++GTI) {
+    uint64_t index;
+    if (!this->evaluate(GTI.getOperand(), index)) {
+      return false;
+    }
+    auto indexBits = this->getBitWidth(GTI.getOperand()->getType());
+    if (auto structType = GTI.getStructTypeOrNull()) {
+      auto layout = DL.getStructLayout(structType);
+      offset += layout->getElementOffset(index);
+      continue;
+    }
+    auto elementBytes = DL.getTypeAllocSize(GTI.getIndexedType());
+    offset += (uint64_t)signExtend(index, indexBits) * elementBytes;
+  }
+
+  return true;
+}
+
+bool IREvaluator::fail (std::string const &error) {
+  this->error = error;
+
+  return false;
+}
+
+uint64_t IREvaluator::getBitWidth (Type *type) const {
+  if (type->isPointerTy()) {
+    return 64;
+  }
+  if (type->isIntegerTy()) {
+    return type->getIntegerBitWidth();
+  }
+
+  return 0;
+}
+
+uint64_t IREvaluator::truncate (uint64_t value, Type *type) const {
+  auto bits = this->getBitWidth(type);
+  if ((bits == 0) || (bits >= 64)) {
+    return value;
+  }
+
+  return value & ((((uint64_t)1) << bits) - 1);
+}
+
+int64_t IREvaluator::signExtend (uint64_t value, uint64_t bitWidth) {
+  if ((bitWidth == 0) || (bitWidth >= 64)) {
+    return (int64_t)value;
+  }
+  auto shift = 64 - bitWidth;
+
+  return ((int64_t)(value << shift)) >> shift;
+}
+
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "LoopFusionTestSuite.hpp"
+
+namespace arcana::noelle {
+
+// Register pass to "opt"
+char LoopFusionTestSuite::ID = 0;
+static RegisterPass<LoopFusionTestSuite> X("UnitTester",
+                                           "Loop Fusion Unit Tester");
+
+// Register pass to "clang"
+static LoopFusionTestSuite *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopFusionTestSuite());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopFusionTestSuite());
+      }
+    }); // ** for -O0
+
+const char *LoopFusionTestSuite::tests[] = {
+  "loops are fused",
+  "number of loops after fusion",
+  "loop IDs after fusion",
+  "evaluation errors",
+  "global variables that differ from the original code"
+};
+
+TestFunction LoopFusionTestSuite::testFns[] = {
+  LoopFusionTestSuite::loopsAreFused,
+  LoopFusionTestSuite::numberOfLoopsAfterFusion,
+  LoopFusionTestSuite::loopIDsAfterFusion,
+  LoopFusionTestSuite::evaluationErrors,
+  LoopFusionTestSuite::globalsThatDiffer
+};
+
+bool LoopFusionTestSuite::doInitialization(Module &M) {
+  errs() << "LoopFusionTestSuite: Initialize\n";
+  const int numTests = sizeof(tests) / sizeof(tests[0]);
+  this->suite = new TestSuite("LoopFusionTestSuite",
+                              tests,
+                              testFns,
+                              numTests,
+                              "test.txt");
+  this->M = &M;
+  return false;
+}
+
+void LoopFusionTestSuite::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+}
+
+bool LoopFusionTestSuite::runOnModule(Module &M) {
+  errs() << "LoopFusionTestSuite: Start\n";
+
+  /*
+   * Fetch the loops of the function.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  this->updateF = M.getFunction("update");
+  auto loops = noelle.getLoopContents(this->updateF);
+  assert(loops->size() == 2);
+
+  /*
+   * Give an ID to the loops, in the order of their headers.
+   */
+  std::map<BasicBlock *, LoopContent *> headerToLoop;
+  for (auto loop : *loops) {
+    headerToLoop[loop->getLoopStructure()->getHeader()] = loop;
+  }
+  std::vector<LoopContent *> loopsInOrder;
+  for (auto &bb : *this->updateF) {
+    if (headerToLoop.count(&bb) == 0) {
+      continue;
+    }
+    auto loop = headerToLoop.at(&bb);
+    loop->getLoopStructure()->setID(loopsInOrder.size());
+    loopsInOrder.push_back(loop);
+  }
+
+  /*
+   * Run the original code.
+   */
+  IREvaluator evaluator(M);
+  this->memoryBeforeFusion = this->runUpdate(evaluator, "before fusion");
+
+  errs() << "LoopFusionTestSuite: Fusing the loops\n";
+  auto &transformer = noelle.getLoopTransformer();
+  std::set<Instruction *> instructionsRemoved;
+  std::set<Instruction *> instructionsAdded;
+  std::set<Instruction *> instructionsMoved;
+  this->fused = transformer.fuseLoops(loopsInOrder[0],
+                                      loopsInOrder[1],
+                                      instructionsRemoved,
+                                      instructionsAdded,
+                                      instructionsMoved);
+
+  /*
+   * Run the fused code.
+   */
+  this->memoryAfterFusion = this->runUpdate(evaluator, "after fusion");
+
+  errs() << "LoopFusionTestSuite: Running tests\n";
+  suite->runTests((ModulePass &)*this);
+
+  errs() << "LoopFusionTestSuite: Freeing memory\n";
+  for (auto loop : *loops) {
+    delete loop;
+  }
+  delete loops;
+  delete this->suite;
+
+  return this->fused;
+}
+
+std::map<std::string, std::vector<uint8_t>> LoopFusionTestSuite::runUpdate(
+    IREvaluator &evaluator,
+    std::string const &when) {
+  std::map<std::string, std::vector<uint8_t>> memory;
+
+  if (!evaluator.run(*this->updateF, { 10 })) {
+    this->errors.insert(when + ": " + evaluator.getError());
+    return memory;
+  }
+  for (auto &global : this->M->globals()) {
+    memory[global.getName().str()] = evaluator.getMemoryOf(&global);
+  }
+
+  return memory;
+}
+
+Values LoopFusionTestSuite::loopsAreFused(ModulePass &pass, TestSuite &suite) {
+  auto &testPass = static_cast<LoopFusionTestSuite &>(pass);
+
+  Values values;
+  values.insert(testPass.fused ? "true" : "false");
+
+  return values;
+}
+
+Values LoopFusionTestSuite::numberOfLoopsAfterFusion(ModulePass &pass,
+                                                     TestSuite &suite) {
+  auto &testPass = static_cast<LoopFusionTestSuite &>(pass);
+
+  DominatorTree DT(*testPass.updateF);
+  LoopInfo LI(DT);
+
+  Values values;
+  values.insert(std::to_string(LI.getLoopsInPreorder().size()));
+
+  return values;
+}
+
+Values LoopFusionTestSuite::loopIDsAfterFusion(ModulePass &pass,
+                                               TestSuite &suite) {
+  auto &testPass = static_cast<LoopFusionTestSuite &>(pass);
+
+  /*
+   * The fused loop keeps the ID of the first loop.
+   */
+  DominatorTree DT(*testPass.updateF);
+  LoopInfo LI(DT);
+  Values values;
+  for (auto l : LI.getLoopsInPreorder()) {
+    LoopStructure ls{ l };
+    auto loopID = ls.getID();
+    values.insert(loopID ? std::to_string(loopID.value()) : "none");
+  }
+
+  return values;
+}
+
+Values LoopFusionTestSuite::evaluationErrors(ModulePass &pass,
+                                             TestSuite &suite) {
+  auto &testPass = static_cast<LoopFusionTestSuite &>(pass);
+
+  Values values(testPass.errors.begin(), testPass.errors.end());
+
+  return values;
+}
+
+Values LoopFusionTestSuite::globalsThatDiffer(ModulePass &pass,
+                                              TestSuite &suite) {
+  auto &testPass = static_cast<LoopFusionTestSuite &>(pass);
+
+  /*
+   * The fused code must write the same values to memory.
+   */
+  Values values;
+  for (auto &pair : testPass.memoryBeforeFusion) {
+    auto name = pair.first;
+    if (false || (testPass.memoryAfterFusion.count(name) == 0)
+        || (testPass.memoryAfterFusion.at(name) != pair.second)) {
+      values.insert(name);
+    }
+  }
+
+  return values;
+}
+
+} // namespace arcana::noelle
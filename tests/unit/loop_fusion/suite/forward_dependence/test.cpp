@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define N 64
+
+long long int A[N + 1];
+long long int B[N + 1];
+long long int C[N + 1];
+
+extern "C" void update (long long int n){
+  long long int i = 0;
+  do {
+    B[i] = A[i] * 2;
+    i++;
+  } while (i < n);
+  long long int j = 0;
+  do {
+    // B[j + 1] is written by the next iteration of the first loop
+    C[j] = B[j + 1] + 1;
+    j++;
+  } while (j < n);
+}
+
+int main (int argc, char *argv[]){
+
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if ((iterations < 1) || (iterations > N)){
+    return -1;
+  }
+
+  for (auto i = 0; i <= N; ++i) {
+    A[i] = i;
+  }
+
+  update(iterations);
+
+  printf("%lld\n", C[iterations - 1]);
+  return 0;
+}
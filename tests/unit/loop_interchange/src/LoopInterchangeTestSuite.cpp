@@ -0,0 +1,220 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "LoopInterchangeTestSuite.hpp"
+
+namespace arcana::noelle {
+
+// Register pass to "opt"
+char LoopInterchangeTestSuite::ID = 0;
+static RegisterPass<LoopInterchangeTestSuite> X("UnitTester",
+                                           "Loop Interchange Unit Tester");
+
+// Register pass to "clang"
+static LoopInterchangeTestSuite *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopInterchangeTestSuite());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopInterchangeTestSuite());
+      }
+    }); // ** for -O0
+
+const char *LoopInterchangeTestSuite::tests[] = {
+  "loops are interchanged",
+  "number of loops after interchange",
+  "loops without a dedicated pre-header",
+  "evaluation errors",
+  "global variables that differ from the original code"
+};
+
+TestFunction LoopInterchangeTestSuite::testFns[] = {
+  LoopInterchangeTestSuite::loopsAreInterchanged,
+  LoopInterchangeTestSuite::numberOfLoopsAfterInterchange,
+  LoopInterchangeTestSuite::loopsWithoutDedicatedPreheader,
+  LoopInterchangeTestSuite::evaluationErrors,
+  LoopInterchangeTestSuite::globalsThatDiffer
+};
+
+bool LoopInterchangeTestSuite::doInitialization(Module &M) {
+  errs() << "LoopInterchangeTestSuite: Initialize\n";
+  const int numTests = sizeof(tests) / sizeof(tests[0]);
+  this->suite = new TestSuite("LoopInterchangeTestSuite",
+                              tests,
+                              testFns,
+                              numTests,
+                              "test.txt");
+  this->M = &M;
+  return false;
+}
+
+void LoopInterchangeTestSuite::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+}
+
+bool LoopInterchangeTestSuite::runOnModule(Module &M) {
+  errs() << "LoopInterchangeTestSuite: Start\n";
+
+  /*
+   * Fetch the outermost loop of the nest to interchange.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  this->incrementF = M.getFunction("increment");
+  auto loops = noelle.getLoopContents(this->incrementF);
+  assert(loops->size() == 2);
+  LoopContent *outermostLoop = nullptr;
+  for (auto loop : *loops) {
+    if (loop->getLoopStructure()->getNestingLevel() == 1) {
+      outermostLoop = loop;
+    }
+  }
+  assert(outermostLoop != nullptr);
+
+  /*
+   * Run the original code.
+   */
+  IREvaluator evaluator(M);
+  this->memoryBeforeInterchange =
+      this->runIncrement(evaluator, "before interchange");
+
+  errs() << "LoopInterchangeTestSuite: Interchanging the loops\n";
+  auto &transformer = noelle.getLoopTransformer();
+  std::set<Instruction *> instructionsAdded;
+  this->interchanged =
+      transformer.interchangeLoop(outermostLoop, instructionsAdded);
+
+  /*
+   * Run the interchanged code.
+   */
+  this->memoryAfterInterchange =
+      this->runIncrement(evaluator, "after interchange");
+
+  errs() << "LoopInterchangeTestSuite: Running tests\n";
+  suite->runTests((ModulePass &)*this);
+
+  errs() << "LoopInterchangeTestSuite: Freeing memory\n";
+  for (auto loop : *loops) {
+    delete loop;
+  }
+  delete loops;
+  delete this->suite;
+
+  return this->interchanged;
+}
+
+std::map<std::string, std::vector<uint8_t>> LoopInterchangeTestSuite::
+    runIncrement(IREvaluator &evaluator, std::string const &when) {
+  std::map<std::string, std::vector<uint8_t>> memory;
+
+  /*
+   * The two loops run a different number of iterations.
+   */
+  if (!evaluator.run(*this->incrementF, { 10, 7 })) {
+    this->errors.insert(when + ": " + evaluator.getError());
+    return memory;
+  }
+  for (auto &global : this->M->globals()) {
+    memory[global.getName().str()] = evaluator.getMemoryOf(&global);
+  }
+
+  return memory;
+}
+
+Values LoopInterchangeTestSuite::loopsAreInterchanged(ModulePass &pass,
+                                                      TestSuite &suite) {
+  auto &testPass = static_cast<LoopInterchangeTestSuite &>(pass);
+
+  Values values;
+  values.insert(testPass.interchanged ? "true" : "false");
+
+  return values;
+}
+
+Values LoopInterchangeTestSuite::numberOfLoopsAfterInterchange(
+    ModulePass &pass,
+    TestSuite &suite) {
+  auto &testPass = static_cast<LoopInterchangeTestSuite &>(pass);
+
+  /*
+   * The interchange reuses the loops of the nest.
+   */
+  DominatorTree DT(*testPass.incrementF);
+  LoopInfo LI(DT);
+
+  Values values;
+  values.insert(std::to_string(LI.getLoopsInPreorder().size()));
+
+  return values;
+}
+
+Values LoopInterchangeTestSuite::loopsWithoutDedicatedPreheader(
+    ModulePass &pass,
+    TestSuite &suite) {
+  auto &testPass = static_cast<LoopInterchangeTestSuite &>(pass);
+
+  DominatorTree DT(*testPass.incrementF);
+  LoopInfo LI(DT);
+  Values values;
+  for (auto l : LI.getLoopsInPreorder()) {
+    if (l->getLoopPreheader() == nullptr) {
+      values.insert(suite.printAsOperandToString(l->getHeader()));
+    }
+  }
+
+  return values;
+}
+
+Values LoopInterchangeTestSuite::evaluationErrors(ModulePass &pass,
+                                                  TestSuite &suite) {
+  auto &testPass = static_cast<LoopInterchangeTestSuite &>(pass);
+
+  Values values(testPass.errors.begin(), testPass.errors.end());
+
+  return values;
+}
+
+Values LoopInterchangeTestSuite::globalsThatDiffer(ModulePass &pass,
+                                                   TestSuite &suite) {
+  auto &testPass = static_cast<LoopInterchangeTestSuite &>(pass);
+
+  /*
+   * The interchanged code must write the same values to memory.
+   */
+  Values values;
+  for (auto &pair : testPass.memoryBeforeInterchange) {
+    auto name = pair.first;
+    if (false || (testPass.memoryAfterInterchange.count(name) == 0)
+        || (testPass.memoryAfterInterchange.at(name) != pair.second)) {
+      values.insert(name);
+    }
+  }
+
+  return values;
+}
+
+} // namespace arcana::noelle
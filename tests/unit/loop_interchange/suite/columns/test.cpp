@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define N 64
+
+long long int A[N][N];
+long long int B[N][N];
+
+extern "C" void increment (long long int n, long long int m){
+  long long int i = 0;
+  do {
+    long long int j = 0;
+    do {
+      B[j][i] = A[j][i] + i;
+      j++;
+    } while (j < m);
+    i++;
+  } while (i < n);
+}
+
+int main (int argc, char *argv[]){
+
+  if (argc < 3){
+    fprintf(stderr, "USAGE: %s COLUMNS ROWS\n", argv[0]);
+    return -1;
+  }
+  auto columns = atoll(argv[1]);
+  auto rows = atoll(argv[2]);
+  if ((columns < 1) || (columns > N) || (rows < 1) || (rows > N)){
+    return -1;
+  }
+
+  for (auto i = 0; i < N; ++i) {
+    for (auto j = 0; j < N; ++j) {
+      A[i][j] = i * N + j;
+    }
+  }
+
+  increment(columns, rows);
+
+  printf("%lld\n", B[rows - 1][columns - 1]);
+  return 0;
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "LoopTilingTestSuite.hpp"
+
+namespace arcana::noelle {
+
+// Register pass to "opt"
+char LoopTilingTestSuite::ID = 0;
+static RegisterPass<LoopTilingTestSuite> X("UnitTester",
+                                           "Loop Tiling Unit Tester");
+
+// Register pass to "clang"
+static LoopTilingTestSuite *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopTilingTestSuite());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopTilingTestSuite());
+      }
+    }); // ** for -O0
+
+const char *LoopTilingTestSuite::tests[] = {
+  "loop nest is tiled",
+  "number of loops after tiling",
+  "depth of the loop nest after tiling",
+  "loops without a dedicated pre-header",
+  "evaluation errors",
+  "global variables that differ from the original code"
+};
+
+TestFunction LoopTilingTestSuite::testFns[] = {
+  LoopTilingTestSuite::loopNestIsTiled,
+  LoopTilingTestSuite::numberOfLoopsAfterTiling,
+  LoopTilingTestSuite::depthOfLoopNestAfterTiling,
+  LoopTilingTestSuite::loopsWithoutDedicatedPreheader,
+  LoopTilingTestSuite::evaluationErrors,
+  LoopTilingTestSuite::globalsThatDiffer
+};
+
+bool LoopTilingTestSuite::doInitialization(Module &M) {
+  errs() << "LoopTilingTestSuite: Initialize\n";
+  const int numTests = sizeof(tests) / sizeof(tests[0]);
+  this->suite = new TestSuite("LoopTilingTestSuite",
+                              tests,
+                              testFns,
+                              numTests,
+                              "test.txt");
+  this->M = &M;
+  return false;
+}
+
+void LoopTilingTestSuite::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+}
+
+bool LoopTilingTestSuite::runOnModule(Module &M) {
+  errs() << "LoopTilingTestSuite: Start\n";
+
+  /*
+   * Fetch the outermost loop of the nest to tile.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  this->transposeF = M.getFunction("transpose");
+  auto loops = noelle.getLoopContents(this->transposeF);
+  assert(loops->size() == 2);
+  LoopContent *outermostLoop = nullptr;
+  for (auto loop : *loops) {
+    if (loop->getLoopStructure()->getNestingLevel() == 1) {
+      outermostLoop = loop;
+    }
+  }
+  assert(outermostLoop != nullptr);
+
+  /*
+   * Run the original code.
+   */
+  IREvaluator evaluator(M);
+  this->memoryBeforeTiling = this->runTranspose(evaluator, "before tiling");
+
+  /*
+   * Use a tile size that does not divide the number of iterations, so the
+   * last tile is partial.
+   */
+  errs() << "LoopTilingTestSuite: Tiling the loop nest\n";
+  auto ltm = outermostLoop->getLoopTransformationsManager();
+  ltm->setTileSize(4);
+  auto &transformer = noelle.getLoopTransformer();
+  std::set<Instruction *> instructionsAdded;
+  this->tiled = transformer.tileLoop(outermostLoop, instructionsAdded);
+
+  /*
+   * Run the tiled code.
+   */
+  this->memoryAfterTiling = this->runTranspose(evaluator, "after tiling");
+
+  errs() << "LoopTilingTestSuite: Running tests\n";
+  suite->runTests((ModulePass &)*this);
+
+  errs() << "LoopTilingTestSuite: Freeing memory\n";
+  for (auto loop : *loops) {
+    delete loop;
+  }
+  delete loops;
+  delete this->suite;
+
+  return this->tiled;
+}
+
+std::map<std::string, std::vector<uint8_t>> LoopTilingTestSuite::runTranspose(
+    IREvaluator &evaluator,
+    std::string const &when) {
+  std::map<std::string, std::vector<uint8_t>> memory;
+
+  /*
+   * The number of iterations is not a multiple of the tile size.
+   */
+  if (!evaluator.run(*this->transposeF, { 10 })) {
+    this->errors.insert(when + ": " + evaluator.getError());
+    return memory;
+  }
+  for (auto &global : this->M->globals()) {
+    memory[global.getName().str()] = evaluator.getMemoryOf(&global);
+  }
+
+  return memory;
+}
+
+Values LoopTilingTestSuite::loopNestIsTiled(ModulePass &pass,
+                                            TestSuite &suite) {
+  auto &testPass = static_cast<LoopTilingTestSuite &>(pass);
+
+  Values values;
+  values.insert(testPass.tiled ? "true" : "false");
+
+  return values;
+}
+
+Values LoopTilingTestSuite::numberOfLoopsAfterTiling(ModulePass &pass,
+                                                     TestSuite &suite) {
+  auto &testPass = static_cast<LoopTilingTestSuite &>(pass);
+
+  /*
+   * The loop that iterates over tiles is added around the nest.
+   */
+  DominatorTree DT(*testPass.transposeF);
+  LoopInfo LI(DT);
+
+  Values values;
+  values.insert(std::to_string(LI.getLoopsInPreorder().size()));
+
+  return values;
+}
+
+Values LoopTilingTestSuite::depthOfLoopNestAfterTiling(ModulePass &pass,
+                                                       TestSuite &suite) {
+  auto &testPass = static_cast<LoopTilingTestSuite &>(pass);
+
+  DominatorTree DT(*testPass.transposeF);
+  LoopInfo LI(DT);
+  uint32_t depth = 0;
+  for (auto l : LI.getLoopsInPreorder()) {
+    depth = std::max(depth, l->getLoopDepth());
+  }
+
+  Values values;
+  values.insert(std::to_string(depth));
+
+  return values;
+}
+
+Values LoopTilingTestSuite::loopsWithoutDedicatedPreheader(ModulePass &pass,
+                                                           TestSuite &suite) {
+  auto &testPass = static_cast<LoopTilingTestSuite &>(pass);
+
+  DominatorTree DT(*testPass.transposeF);
+  LoopInfo LI(DT);
+  Values values;
+  for (auto l : LI.getLoopsInPreorder()) {
+    if (l->getLoopPreheader() == nullptr) {
+      values.insert(suite.printAsOperandToString(l->getHeader()));
+    }
+  }
+
+  return values;
+}
+
+Values LoopTilingTestSuite::evaluationErrors(ModulePass &pass,
+                                             TestSuite &suite) {
+  auto &testPass = static_cast<LoopTilingTestSuite &>(pass);
+
+  Values values(testPass.errors.begin(), testPass.errors.end());
+
+  return values;
+}
+
+Values LoopTilingTestSuite::globalsThatDiffer(ModulePass &pass,
+                                              TestSuite &suite) {
+  auto &testPass = static_cast<LoopTilingTestSuite &>(pass);
+
+  /*
+   * The tiled code must write the same values to memory.
+   */
+  Values values;
+  for (auto &pair : testPass.memoryBeforeTiling) {
+    auto name = pair.first;
+    if (false || (testPass.memoryAfterTiling.count(name) == 0)
+        || (testPass.memoryAfterTiling.at(name) != pair.second)) {
+      values.insert(name);
+    }
+  }
+
+  return values;
+}
+
+} // namespace arcana::noelle
@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define N 64
+
+long long int A[N][N];
+long long int B[N][N];
+
+extern "C" void transpose (long long int n){
+  for (long long int i = 0; i < n; ++i) {
+    for (long long int j = 0; j < n; ++j) {
+      B[i][j] = A[j][i];
+    }
+  }
+}
+
+int main (int argc, char *argv[]){
+
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations > N){
+    iterations = N;
+  }
+
+  for (auto i = 0; i < N; ++i) {
+    for (auto j = 0; j < N; ++j) {
+      A[i][j] = i * N + j;
+    }
+  }
+
+  transpose(iterations);
+
+  printf("%lld\n", B[iterations - 1][0]);
+  return 0;
+}
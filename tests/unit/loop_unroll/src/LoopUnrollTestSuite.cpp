@@ -0,0 +1,245 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "LoopUnrollTestSuite.hpp"
+
+namespace arcana::noelle {
+
+// Register pass to "opt"
+char LoopUnrollTestSuite::ID = 0;
+static RegisterPass<LoopUnrollTestSuite> X("UnitTester",
+                                           "Loop Unroll Unit Tester");
+
+// Register pass to "clang"
+static LoopUnrollTestSuite *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopUnrollTestSuite());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopUnrollTestSuite());
+      }
+    }); // ** for -O0
+
+const char *LoopUnrollTestSuite::tests[] = {
+  "loop is unrolled",
+  "loop IDs after unrolling",
+  "loops that changed their ID",
+  "loop IDs outside of loop headers",
+  "instructions that lost their pdg ID"
+};
+
+TestFunction LoopUnrollTestSuite::testFns[] = {
+  LoopUnrollTestSuite::loopIsUnrolled,
+  LoopUnrollTestSuite::loopIDsAfterUnrolling,
+  LoopUnrollTestSuite::loopsThatChangedID,
+  LoopUnrollTestSuite::loopIDsOutsideHeaders,
+  LoopUnrollTestSuite::instructionsThatLostPDGID
+};
+
+bool LoopUnrollTestSuite::doInitialization(Module &M) {
+  errs() << "LoopUnrollTestSuite: Initialize\n";
+  const int numTests = sizeof(tests) / sizeof(tests[0]);
+  this->suite = new TestSuite("LoopUnrollTestSuite",
+                              tests,
+                              testFns,
+                              numTests,
+                              "test.txt");
+  this->M = &M;
+  return false;
+}
+
+void LoopUnrollTestSuite::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+}
+
+bool LoopUnrollTestSuite::runOnModule(Module &M) {
+  errs() << "LoopUnrollTestSuite: Start\n";
+
+  /*
+   * Fetch the loops of the function.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  this->accumulateF = M.getFunction("accumulate");
+  auto loops = noelle.getLoopContents(this->accumulateF);
+  assert(loops->size() == 2);
+
+  /*
+   * Give an ID to the loops, in the order of their headers.
+   */
+  std::map<BasicBlock *, LoopContent *> headerToLoop;
+  for (auto loop : *loops) {
+    headerToLoop[loop->getLoopStructure()->getHeader()] = loop;
+  }
+  LoopContent *loopToUnroll = nullptr;
+  for (auto &bb : *this->accumulateF) {
+    if (headerToLoop.count(&bb) == 0) {
+      continue;
+    }
+    auto loop = headerToLoop.at(&bb);
+    auto ls = loop->getLoopStructure();
+    auto loopID = this->headersAndIDs.size();
+    ls->setID(loopID);
+    this->headersAndIDs.push_back(std::make_pair(&bb, loopID));
+    if (loopToUnroll == nullptr) {
+      loopToUnroll = loop;
+    }
+  }
+
+  /*
+   * Give an ID to every instruction, as the embedded PDG does.
+   */
+  auto int64 = IntegerType::get(M.getContext(), 64);
+  uint64_t instID = 0;
+  for (auto &inst : instructions(this->accumulateF)) {
+    auto id = ConstantInt::get(int64, instID++);
+    auto m = MDNode::get(M.getContext(), ConstantAsMetadata::get(id));
+    inst.setMetadata("noelle.pdg.inst.id", m);
+    this->pdgIDs.push_back(std::make_pair(WeakVH(&inst), m));
+  }
+
+  errs() << "LoopUnrollTestSuite: Unrolling the first loop\n";
+  auto &transformer = noelle.getLoopTransformer();
+  auto result = transformer.unrollLoop(loopToUnroll, 2);
+  this->unrolled = (result == LoopUnrollResult::PartiallyUnrolled);
+
+  errs() << "LoopUnrollTestSuite: Running tests\n";
+  suite->runTests((ModulePass &)*this);
+
+  errs() << "LoopUnrollTestSuite: Freeing memory\n";
+  for (auto loop : *loops) {
+    delete loop;
+  }
+  delete loops;
+  delete this->suite;
+
+  return true;
+}
+
+Values LoopUnrollTestSuite::loopIsUnrolled(ModulePass &pass,
+                                           TestSuite &suite) {
+  auto &testPass = static_cast<LoopUnrollTestSuite &>(pass);
+
+  Values values;
+  values.insert(testPass.unrolled ? "true" : "false");
+
+  return values;
+}
+
+Values LoopUnrollTestSuite::loopIDsAfterUnrolling(ModulePass &pass,
+                                                  TestSuite &suite) {
+  auto &testPass = static_cast<LoopUnrollTestSuite &>(pass);
+
+  /*
+   * The remainder loop gets a new ID.
+   */
+  DominatorTree DT(*testPass.accumulateF);
+  LoopInfo LI(DT);
+  Values values;
+  for (auto l : LI.getLoopsInPreorder()) {
+    LoopStructure ls{ l };
+    auto loopID = ls.getID();
+    values.insert(loopID ? std::to_string(loopID.value()) : "none");
+  }
+
+  return values;
+}
+
+Values LoopUnrollTestSuite::loopsThatChangedID(ModulePass &pass,
+                                               TestSuite &suite) {
+  auto &testPass = static_cast<LoopUnrollTestSuite &>(pass);
+
+  /*
+   * The unrolled loop keeps its header, and both loops keep their ID.
+   */
+  DominatorTree DT(*testPass.accumulateF);
+  LoopInfo LI(DT);
+  Values values;
+  for (auto headerAndID : testPass.headersAndIDs) {
+    auto header = headerAndID.first;
+    auto l = LI.getLoopFor(header);
+    if ((l == nullptr) || (l->getHeader() != header)) {
+      values.insert(std::to_string(headerAndID.second));
+      continue;
+    }
+    LoopStructure ls{ l };
+    auto loopID = ls.getID();
+    if ((!loopID) || (loopID.value() != headerAndID.second)) {
+      values.insert(std::to_string(headerAndID.second));
+    }
+  }
+
+  return values;
+}
+
+Values LoopUnrollTestSuite::loopIDsOutsideHeaders(ModulePass &pass,
+                                                  TestSuite &suite) {
+  auto &testPass = static_cast<LoopUnrollTestSuite &>(pass);
+
+  /*
+   * The copies of the header created by the unrolling must not keep the ID.
+   */
+  DominatorTree DT(*testPass.accumulateF);
+  LoopInfo LI(DT);
+  Values values;
+  for (auto &bb : *testPass.accumulateF) {
+    auto node = bb.getTerminator()->getMetadata(LoopStructure::metadataKeyID);
+    if (node == nullptr) {
+      continue;
+    }
+    auto l = LI.getLoopFor(&bb);
+    if ((l != nullptr) && (l->getHeader() == &bb)) {
+      continue;
+    }
+    values.insert(cast<MDString>(node->getOperand(0))->getString().str());
+  }
+
+  return values;
+}
+
+Values LoopUnrollTestSuite::instructionsThatLostPDGID(ModulePass &pass,
+                                                      TestSuite &suite) {
+  auto &testPass = static_cast<LoopUnrollTestSuite &>(pass);
+
+  /*
+   * The instructions that survived the unrolling keep their ID.
+   */
+  Values values;
+  for (auto &instAndID : testPass.pdgIDs) {
+    auto inst = cast_or_null<Instruction>((Value *)instAndID.first);
+    if (inst == nullptr) {
+      continue;
+    }
+    if (inst->getMetadata("noelle.pdg.inst.id") != instAndID.second) {
+      values.insert(suite.printToString(inst));
+    }
+  }
+
+  return values;
+}
+
+} // namespace arcana::noelle
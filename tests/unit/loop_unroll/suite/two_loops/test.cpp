@@ -0,0 +1,32 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+extern "C" long long int accumulate (long long int *array, long long int n){
+  long long int sum = 0;
+  for (long long int i = 0; i < n; ++i) {
+    sum += array[i];
+  }
+  for (long long int i = 0; i < n; ++i) {
+    array[i] = sum;
+  }
+
+  return sum;
+}
+
+int main (int argc, char *argv[]){
+
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+
+  long long int *array = (long long int *) calloc(iterations, sizeof(long long int));
+  for (auto i = 0; i < iterations; ++i) {
+    array[i] = i;
+  }
+
+  printf("%lld\n", accumulate(array, iterations));
+  return 0;
+}
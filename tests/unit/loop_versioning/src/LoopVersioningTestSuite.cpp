@@ -0,0 +1,279 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "LoopVersioningTestSuite.hpp"
+
+namespace arcana::noelle {
+
+// Register pass to "opt"
+char LoopVersioningTestSuite::ID = 0;
+static RegisterPass<LoopVersioningTestSuite> X("UnitTester",
+                                               "Loop Versioning Unit Tester");
+
+// Register pass to "clang"
+static LoopVersioningTestSuite *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopVersioningTestSuite());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new LoopVersioningTestSuite());
+      }
+    }); // ** for -O0
+
+const char *LoopVersioningTestSuite::tests[] = {
+  "loop is versioned",
+  "number of loops after versioning",
+  "loops without a dedicated pre-header",
+  "guarded dependences in the fast path",
+  "guarded dependences missing from the pdg",
+  "loop-carried memory dependences in the fast path",
+  "pre-header of the fast path"
+};
+
+TestFunction LoopVersioningTestSuite::testFns[] = {
+  LoopVersioningTestSuite::loopIsVersioned,
+  LoopVersioningTestSuite::numberOfLoopsAfterVersioning,
+  LoopVersioningTestSuite::loopsWithoutDedicatedPreheader,
+  LoopVersioningTestSuite::guardedDependencesInFastPath,
+  LoopVersioningTestSuite::guardedDependencesMissingFromPDG,
+  LoopVersioningTestSuite::loopCarriedMemoryDependencesInFastPath,
+  LoopVersioningTestSuite::preheaderOfFastPath
+};
+
+bool LoopVersioningTestSuite::doInitialization(Module &M) {
+  errs() << "LoopVersioningTestSuite: Initialize\n";
+  const int numTests = sizeof(tests) / sizeof(tests[0]);
+  this->suite = new TestSuite("LoopVersioningTestSuite",
+                              tests,
+                              testFns,
+                              numTests,
+                              "test.txt");
+  this->M = &M;
+  return false;
+}
+
+void LoopVersioningTestSuite::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+}
+
+bool LoopVersioningTestSuite::runOnModule(Module &M) {
+  errs() << "LoopVersioningTestSuite: Start\n";
+
+  /*
+   * Fetch the loop to version.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  this->shiftF = M.getFunction("shift");
+  this->pdg = noelle.getProgramDependenceGraph();
+  auto loops = noelle.getLoopContents(this->shiftF);
+  assert(loops->size() == 1);
+  this->loop = (*loops)[0];
+
+  /*
+   * Collect the may memory dependences between loads and stores of the loop.
+   */
+  auto loopDG = this->loop->getLoopDG();
+  for (auto edge : loopDG->getSortedDependences()) {
+    if (!isa<MayMemoryDependence<Value, Value>>(edge)) {
+      continue;
+    }
+    auto src = dyn_cast<Instruction>(edge->getSrc());
+    auto dst = dyn_cast<Instruction>(edge->getDst());
+    if ((src == nullptr) || (dst == nullptr)) {
+      continue;
+    }
+    if (isa<LoadInst>(src) == isa<LoadInst>(dst)) {
+      continue;
+    }
+    this->mayDependences.insert(std::make_pair(src, dst));
+  }
+
+  errs() << "LoopVersioningTestSuite: Versioning the loop\n";
+  auto &transformer = noelle.getLoopTransformer();
+  std::set<Instruction *> instructionsAdded;
+  this->fastLoop =
+      transformer.versionLoopWithAliasChecks(this->loop, instructionsAdded);
+
+  errs() << "LoopVersioningTestSuite: Running tests\n";
+  suite->runTests((ModulePass &)*this);
+
+  errs() << "LoopVersioningTestSuite: Freeing memory\n";
+  auto versioned = (this->fastLoop != nullptr);
+  delete this->fastLoop;
+  delete this->loop;
+  delete loops;
+  delete this->suite;
+
+  return versioned;
+}
+
+Values LoopVersioningTestSuite::loopIsVersioned(ModulePass &pass,
+                                                TestSuite &suite) {
+  auto &testPass = static_cast<LoopVersioningTestSuite &>(pass);
+
+  Values values;
+  values.insert((testPass.fastLoop != nullptr) ? "true" : "false");
+
+  return values;
+}
+
+Values LoopVersioningTestSuite::numberOfLoopsAfterVersioning(
+    ModulePass &pass,
+    TestSuite &suite) {
+  auto &testPass = static_cast<LoopVersioningTestSuite &>(pass);
+
+  DominatorTree DT(*testPass.shiftF);
+  LoopInfo LI(DT);
+
+  Values values;
+  values.insert(std::to_string(LI.getLoopsInPreorder().size()));
+
+  return values;
+}
+
+Values LoopVersioningTestSuite::loopsWithoutDedicatedPreheader(
+    ModulePass &pass,
+    TestSuite &suite) {
+  auto &testPass = static_cast<LoopVersioningTestSuite &>(pass);
+
+  /*
+   * Both versions must have a pre-header.
+   */
+  DominatorTree DT(*testPass.shiftF);
+  LoopInfo LI(DT);
+  Values values;
+  for (auto l : LI.getLoopsInPreorder()) {
+    if (l->getLoopPreheader() == nullptr) {
+      values.insert(suite.printAsOperandToString(l->getHeader()));
+    }
+  }
+
+  return values;
+}
+
+Values LoopVersioningTestSuite::guardedDependencesInFastPath(
+    ModulePass &pass,
+    TestSuite &suite) {
+  auto &testPass = static_cast<LoopVersioningTestSuite &>(pass);
+
+  /*
+   * The loads and stores of the loop access different arrays, so all their
+   * may dependences are guarded by the check.
+   */
+  std::set<std::pair<Instruction *, Instruction *>> deps;
+  auto loopDG = testPass.fastLoop->getLoopDG();
+  for (auto dep : testPass.mayDependences) {
+    if (hasMayMemoryDependence(loopDG, dep.first, dep.second)) {
+      deps.insert(dep);
+    }
+  }
+
+  return printDependences(suite, deps);
+}
+
+Values LoopVersioningTestSuite::guardedDependencesMissingFromPDG(
+    ModulePass &pass,
+    TestSuite &suite) {
+  auto &testPass = static_cast<LoopVersioningTestSuite &>(pass);
+
+  /*
+   * The slow path still needs the dependences of the program.
+   */
+  std::set<std::pair<Instruction *, Instruction *>> deps;
+  for (auto dep : testPass.mayDependences) {
+    if (!hasMayMemoryDependence(testPass.pdg, dep.first, dep.second)) {
+      deps.insert(dep);
+    }
+  }
+
+  return printDependences(suite, deps);
+}
+
+Values LoopVersioningTestSuite::loopCarriedMemoryDependencesInFastPath(
+    ModulePass &pass,
+    TestSuite &suite) {
+  auto &testPass = static_cast<LoopVersioningTestSuite &>(pass);
+
+  /*
+   * The SCCs of the fast path must not include the guarded dependences.
+   */
+  std::set<std::pair<Instruction *, Instruction *>> deps;
+  auto sccManager = testPass.fastLoop->getSCCManager();
+  for (auto sccInfo : sccManager->getSCCsWithLoopCarriedDataDependencies()) {
+    for (auto dep : sccInfo->getLoopCarriedDependences()) {
+      if (!isa<MemoryDependence<Value, Value>>(dep)) {
+        continue;
+      }
+      auto src = dyn_cast<Instruction>(dep->getSrc());
+      auto dst = dyn_cast<Instruction>(dep->getDst());
+      if ((src == nullptr) || (dst == nullptr)) {
+        continue;
+      }
+      deps.insert(std::make_pair(src, dst));
+    }
+  }
+
+  return printDependences(suite, deps);
+}
+
+Values LoopVersioningTestSuite::preheaderOfFastPath(ModulePass &pass,
+                                                    TestSuite &suite) {
+  auto &testPass = static_cast<LoopVersioningTestSuite &>(pass);
+
+  Values values;
+  auto ls = testPass.fastLoop->getLoopStructure();
+  values.insert(ls->getPreHeader()->getName().str());
+
+  return values;
+}
+
+Values LoopVersioningTestSuite::printDependences(
+    TestSuite &suite,
+    std::set<std::pair<Instruction *, Instruction *>> const &deps) {
+  Values values;
+  for (auto dep : deps) {
+    values.insert(suite.printToString(dep.first) + " -> "
+                  + suite.printToString(dep.second));
+  }
+
+  return values;
+}
+
+bool LoopVersioningTestSuite::hasMayMemoryDependence(PDG *dg,
+                                                     Instruction *src,
+                                                     Instruction *dst) {
+  for (auto edge : dg->getDependences(src, dst)) {
+    if (isa<MayMemoryDependence<Value, Value>>(edge)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace arcana::noelle
@@ -0,0 +1,26 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+extern "C" void shift (long long int *dst, long long int *src, long long int n){
+  for (long long int i = 0; i < n; ++i) {
+    dst[i] = src[i] + 1;
+  }
+}
+
+int main (int argc, char *argv[]){
+
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+
+  long long int *array = (long long int *) calloc(iterations + 1, sizeof(long long int));
+
+  // The two arrays overlap, so the slow path runs
+  shift(array + 1, array, iterations);
+
+  printf("%lld\n", array[iterations]);
+  return 0;
+}
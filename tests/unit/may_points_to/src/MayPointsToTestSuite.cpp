@@ -0,0 +1,188 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "MayPointsToTestSuite.hpp"
+
+namespace arcana::noelle {
+
+// Register pass to "opt"
+char MayPointsToTestSuite::ID = 0;
+static RegisterPass<MayPointsToTestSuite> X("UnitTester",
+                                            "May Points-To Unit Tester");
+
+// Register pass to "clang"
+static MayPointsToTestSuite *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new MayPointsToTestSuite());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new MayPointsToTestSuite());
+      }
+    }); // ** for -O0
+
+const char *MayPointsToTestSuite::tests[] = {
+  "pointer pairs where the batched query differs (intra-procedural)",
+  "pointer pairs where the batched query differs (inter-procedural)",
+  "some pointers cannot alias"
+};
+
+TestFunction MayPointsToTestSuite::testFns[] = {
+  MayPointsToTestSuite::batchDiffersFromSingleQueriesIntraprocedural,
+  MayPointsToTestSuite::batchDiffersFromSingleQueriesInterprocedural,
+  MayPointsToTestSuite::somePointersCannotAlias
+};
+
+bool MayPointsToTestSuite::doInitialization(Module &M) {
+  errs() << "MayPointsToTestSuite: Initialize\n";
+  const int numTests = sizeof(tests) / sizeof(tests[0]);
+  this->suite = new TestSuite("MayPointsToTestSuite",
+                              tests,
+                              testFns,
+                              numTests,
+                              "test.txt");
+  this->someNoAlias = false;
+  return false;
+}
+
+void MayPointsToTestSuite::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+}
+
+bool MayPointsToTestSuite::runOnModule(Module &M) {
+  errs() << "MayPointsToTestSuite: Start\n";
+
+  /*
+   * Fetch the functions with a body.
+   */
+  for (auto &F : M) {
+    if (F.empty()) {
+      continue;
+    }
+    this->functions.push_back(&F);
+  }
+
+  /*
+   * Compare the batched queries with the single ones.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  auto fm = noelle.getFunctionsManager();
+  MayPointsToAnalysis intraMPA;
+  MayPointsToAnalysis interMPA(M, fm->getProgramCallGraph());
+  for (auto F : this->functions) {
+    auto intraMismatches = this->compareBatchToSingleQueries(intraMPA, *F);
+    this->intraproceduralMismatches.insert(intraMismatches.begin(),
+                                           intraMismatches.end());
+    auto interMismatches = this->compareBatchToSingleQueries(interMPA, *F);
+    this->interproceduralMismatches.insert(interMismatches.begin(),
+                                           interMismatches.end());
+  }
+
+  errs() << "MayPointsToTestSuite: Running tests\n";
+  suite->runTests((ModulePass &)*this);
+
+  errs() << "MayPointsToTestSuite: Freeing memory\n";
+  delete this->suite;
+
+  return false;
+}
+
+std::set<std::string> MayPointsToTestSuite::compareBatchToSingleQueries(
+    MayPointsToAnalysis &mpa,
+    Function &F) {
+  std::set<std::string> mismatches;
+
+  /*
+   * Collect the pointers accessed by loads and stores.
+   */
+  std::vector<Value *> pointers;
+  for (auto &inst : instructions(F)) {
+    auto pointer = getLoadStorePointerOperand(&inst);
+    if (pointer == nullptr) {
+      continue;
+    }
+    pointers.push_back(pointer);
+  }
+
+  /*
+   * Entry (i, j) of the batch must be the answer of the single query.
+   */
+  auto mayAliasMatrix = mpa.mayAlias(pointers);
+  assert(mayAliasMatrix.size() == pointers.size());
+  for (auto i = 0u; i < pointers.size(); i++) {
+    for (auto j = 0u; j < pointers.size(); j++) {
+      auto mayAlias = mpa.mayAlias(pointers[i], pointers[j]);
+      if (!mayAlias) {
+        this->someNoAlias = true;
+      }
+      if (mayAliasMatrix[i][j] != mayAlias) {
+        mismatches.insert(F.getName().str() + ": " + std::to_string(i) + ", "
+                          + std::to_string(j));
+      }
+    }
+  }
+
+  return mismatches;
+}
+
+Values MayPointsToTestSuite::batchDiffersFromSingleQueriesIntraprocedural(
+    ModulePass &pass,
+    TestSuite &suite) {
+  auto &testPass = static_cast<MayPointsToTestSuite &>(pass);
+
+  Values values(testPass.intraproceduralMismatches.begin(),
+                testPass.intraproceduralMismatches.end());
+
+  return values;
+}
+
+Values MayPointsToTestSuite::batchDiffersFromSingleQueriesInterprocedural(
+    ModulePass &pass,
+    TestSuite &suite) {
+  auto &testPass = static_cast<MayPointsToTestSuite &>(pass);
+
+  Values values(testPass.interproceduralMismatches.begin(),
+                testPass.interproceduralMismatches.end());
+
+  return values;
+}
+
+Values MayPointsToTestSuite::somePointersCannotAlias(ModulePass &pass,
+                                                     TestSuite &suite) {
+  auto &testPass = static_cast<MayPointsToTestSuite &>(pass);
+
+  /*
+   * The comparisons above are meaningful only if not every answer is "may
+   * alias".
+   */
+  Values values;
+  values.insert(testPass.someNoAlias ? "true" : "false");
+
+  return values;
+}
+
+} // namespace arcana::noelle
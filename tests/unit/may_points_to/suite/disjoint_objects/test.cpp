@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define N 64
+
+long long int A[N];
+long long int B[N];
+
+extern "C" void accumulate (long long int *dst, long long int n){
+  long long int *tmp = (long long int *) malloc(n * sizeof(long long int));
+  for (long long int i = 0; i < n; i++) {
+    tmp[i] = A[i] * 2;
+  }
+  for (long long int i = 0; i < n; i++) {
+    B[i] = tmp[i] + dst[i];
+    dst[i] = B[i];
+  }
+  free(tmp);
+}
+
+int main (int argc, char *argv[]){
+
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if ((iterations < 1) || (iterations > N)){
+    return -1;
+  }
+
+  auto dst = (long long int *) calloc(iterations, sizeof(long long int));
+  for (auto i = 0; i < N; ++i) {
+    A[i] = i;
+  }
+
+  accumulate(dst, iterations);
+  accumulate(A, iterations);
+
+  printf("%lld %lld\n", dst[iterations - 1], A[iterations - 1]);
+  free(dst);
+  return 0;
+}
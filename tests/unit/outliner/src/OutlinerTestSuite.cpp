@@ -0,0 +1,287 @@
+/*
+ * Copyright 2024  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "OutlinerTestSuite.hpp"
+
+namespace arcana::noelle {
+
+// Register pass to "opt"
+char OutlinerTestSuite::ID = 0;
+static RegisterPass<OutlinerTestSuite> X("UnitTester",
+                                           "Outliner Unit Tester");
+
+// Register pass to "clang"
+static OutlinerTestSuite *_PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(
+    PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new OutlinerTestSuite());
+      }
+    }); // ** for -Ox
+static RegisterStandardPasses _RegPass2(
+    PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder &, legacy::PassManagerBase &PM) {
+      if (!_PassMaker) {
+        PM.add(_PassMaker = new OutlinerTestSuite());
+      }
+    }); // ** for -O0
+
+const char *OutlinerTestSuite::tests[] = {
+  "region is outlined",
+  "outlined function is known by the functions manager",
+  "calls to the outlined function",
+  "function of the cold store",
+  "functions without a name",
+  "evaluation errors",
+  "global variables that differ from the original code",
+  "return value differs from the original code"
+};
+
+TestFunction OutlinerTestSuite::testFns[] = {
+  OutlinerTestSuite::regionIsOutlined,
+  OutlinerTestSuite::outlinedFunctionIsKnown,
+  OutlinerTestSuite::callsToOutlinedFunction,
+  OutlinerTestSuite::functionOfColdStore,
+  OutlinerTestSuite::functionsWithoutName,
+  OutlinerTestSuite::evaluationErrors,
+  OutlinerTestSuite::globalsThatDiffer,
+  OutlinerTestSuite::returnValueDiffers
+};
+
+bool OutlinerTestSuite::doInitialization(Module &M) {
+  errs() << "OutlinerTestSuite: Initialize\n";
+  const int numTests = sizeof(tests) / sizeof(tests[0]);
+  this->suite = new TestSuite("OutlinerTestSuite",
+                              tests,
+                              testFns,
+                              numTests,
+                              "test.txt");
+  this->M = &M;
+  return false;
+}
+
+void OutlinerTestSuite::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<PDGGenerator>();
+  AU.addRequired<Noelle>();
+}
+
+bool OutlinerTestSuite::runOnModule(Module &M) {
+  errs() << "OutlinerTestSuite: Start\n";
+
+  /*
+   * Fetch the cold region: the basic block that stores to B.
+   */
+  auto &noelle = getAnalysis<Noelle>();
+  this->fm = noelle.getFunctionsManager();
+  this->computeF = M.getFunction("compute");
+  auto B = M.getGlobalVariable("B");
+  this->coldStore = nullptr;
+  for (auto &inst : instructions(this->computeF)) {
+    auto store = dyn_cast<StoreInst>(&inst);
+    if (store == nullptr) {
+      continue;
+    }
+    auto gep = dyn_cast<GetElementPtrInst>(store->getPointerOperand());
+    if ((gep != nullptr) && (gep->getPointerOperand() == B)) {
+      this->coldStore = store;
+    }
+  }
+  assert(this->coldStore != nullptr);
+  std::unordered_set<BasicBlock *> region{ this->coldStore->getParent() };
+
+  /*
+   * Run the original code.
+   */
+  IREvaluator evaluator(M);
+  this->memoryBeforeOutlining =
+      this->runCompute(evaluator,
+                       "before outlining",
+                       this->returnValueBeforeOutlining);
+
+  errs() << "OutlinerTestSuite: Outlining the cold region\n";
+  Outliner outliner;
+  this->outlinedFunction = outliner.outline(region, nullptr, *this->fm);
+
+  /*
+   * Run the code that calls the outlined function.
+   */
+  this->memoryAfterOutlining =
+      this->runCompute(evaluator,
+                       "after outlining",
+                       this->returnValueAfterOutlining);
+
+  errs() << "OutlinerTestSuite: Running tests\n";
+  suite->runTests((ModulePass &)*this);
+
+  errs() << "OutlinerTestSuite: Freeing memory\n";
+  delete this->suite;
+
+  return (this->outlinedFunction != nullptr);
+}
+
+std::map<std::string, std::vector<uint8_t>> OutlinerTestSuite::runCompute(
+    IREvaluator &evaluator,
+    std::string const &when,
+    uint64_t &returnValue) {
+  std::map<std::string, std::vector<uint8_t>> memory;
+
+  returnValue = 0;
+  if (!evaluator.run(*this->computeF, { 10 })) {
+    this->errors.insert(when + ": " + evaluator.getError());
+    return memory;
+  }
+  returnValue = evaluator.getReturnValue();
+  for (auto &global : this->M->globals()) {
+    memory[global.getName().str()] = evaluator.getMemoryOf(&global);
+  }
+
+  return memory;
+}
+
+Values OutlinerTestSuite::regionIsOutlined(ModulePass &pass, TestSuite &suite) {
+  auto &testPass = static_cast<OutlinerTestSuite &>(pass);
+
+  Values values;
+  values.insert((testPass.outlinedFunction != nullptr) ? "true" : "false");
+
+  return values;
+}
+
+Values OutlinerTestSuite::outlinedFunctionIsKnown(ModulePass &pass,
+                                                  TestSuite &suite) {
+  auto &testPass = static_cast<OutlinerTestSuite &>(pass);
+
+  /*
+   * The outlined function must be created through the functions manager,
+   * which registers it to the PDG generator as a function that might be
+   * invoked indirectly.
+   * Nothing else takes its address, so this is the only way it can be there.
+   */
+  auto isKnown = false;
+  if (testPass.outlinedFunction != nullptr) {
+    auto &pdgGenerator = testPass.getAnalysis<PDGGenerator>();
+    auto signature = testPass.outlinedFunction->getFunctionType();
+    auto &functions =
+        pdgGenerator.getFunctionsThatMightEscapeWithSignature(signature);
+    isKnown = (functions.count(testPass.outlinedFunction) > 0);
+  }
+
+  Values values;
+  values.insert(isKnown ? "true" : "false");
+
+  return values;
+}
+
+Values OutlinerTestSuite::callsToOutlinedFunction(ModulePass &pass,
+                                                  TestSuite &suite) {
+  auto &testPass = static_cast<OutlinerTestSuite &>(pass);
+
+  uint32_t calls = 0;
+  if (testPass.outlinedFunction != nullptr) {
+    for (auto user : testPass.outlinedFunction->users()) {
+      auto call = dyn_cast<CallInst>(user);
+      if ((call != nullptr) && (call->getFunction() == testPass.computeF)) {
+        calls++;
+      }
+    }
+  }
+
+  Values values;
+  values.insert(std::to_string(calls));
+
+  return values;
+}
+
+Values OutlinerTestSuite::functionOfColdStore(ModulePass &pass,
+                                              TestSuite &suite) {
+  auto &testPass = static_cast<OutlinerTestSuite &>(pass);
+
+  Values values;
+  auto f = testPass.coldStore->getFunction();
+  if (f == testPass.outlinedFunction) {
+    values.insert("outlined function");
+  } else {
+    values.insert(f->getName().str());
+  }
+
+  return values;
+}
+
+Values OutlinerTestSuite::functionsWithoutName(ModulePass &pass,
+                                               TestSuite &suite) {
+  auto &testPass = static_cast<OutlinerTestSuite &>(pass);
+
+  /*
+   * The function created by the code extractor must be gone.
+   */
+  Values values;
+  for (auto &f : *testPass.M) {
+    if (!f.hasName()) {
+      values.insert(suite.printAsOperandToString(&f));
+    }
+  }
+
+  return values;
+}
+
+Values OutlinerTestSuite::evaluationErrors(ModulePass &pass, TestSuite &suite) {
+  auto &testPass = static_cast<OutlinerTestSuite &>(pass);
+
+  Values values(testPass.errors.begin(), testPass.errors.end());
+
+  return values;
+}
+
+Values OutlinerTestSuite::globalsThatDiffer(ModulePass &pass,
+                                            TestSuite &suite) {
+  auto &testPass = static_cast<OutlinerTestSuite &>(pass);
+
+  /*
+   * The code with the call to the outlined function must write the same
+   * values to memory.
+   */
+  Values values;
+  for (auto &pair : testPass.memoryBeforeOutlining) {
+    auto name = pair.first;
+    if (false || (testPass.memoryAfterOutlining.count(name) == 0)
+        || (testPass.memoryAfterOutlining.at(name) != pair.second)) {
+      values.insert(name);
+    }
+  }
+
+  return values;
+}
+
+Values OutlinerTestSuite::returnValueDiffers(ModulePass &pass,
+                                             TestSuite &suite) {
+  auto &testPass = static_cast<OutlinerTestSuite &>(pass);
+
+  auto differs = (testPass.returnValueBeforeOutlining
+                  != testPass.returnValueAfterOutlining);
+
+  Values values;
+  values.insert(differs ? "true" : "false");
+
+  return values;
+}
+
+} // namespace arcana::noelle
@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define N 64
+
+long long int A[N];
+long long int B[N];
+
+extern "C" long long int compute (long long int n){
+  long long int result = 0;
+  for (long long int i = 0; i < n; ++i) {
+    if (A[i] < 0) {
+      result -= A[i] * 3;
+      B[i] = result;
+    } else {
+      result += A[i];
+    }
+  }
+
+  return result;
+}
+
+int main (int argc, char *argv[]){
+
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations > N){
+    iterations = N;
+  }
+
+  for (auto i = 0; i < N; ++i) {
+    A[i] = i;
+  }
+
+  printf("%lld\n", compute(iterations));
+  return 0;
+}